@@ -5,6 +5,48 @@
 # Uses grub-mkrescue to create hybrid UEFI/BIOS bootable images without sudo.
 # =============================================================================
 
+# =============================================================================
+# Initramfs
+# =============================================================================
+# Packs NYROS_INITRAMFS_DIR plus the user programs (bin/<name>, see user/CMakeLists.txt) into a
+# ustar (restricted pax) archive that GRUB loads as a multiboot module. The kernel indexes it in
+# place (kernel/src/fs/initramfs.cpp). The tree is staged in the build directory so the source
+# directory never sees build outputs. Only cmake -E is used, so this target works without the
+# image tools.
+set(NYROS_INITRAMFS_IMAGE ${CMAKE_BINARY_DIR}/initramfs.tar)
+set(NYROS_INITRAMFS_STAGING_DIR ${CMAKE_BINARY_DIR}/initramfs-root)
+
+set(NYROS_INITRAMFS_FILES)
+set(NYROS_INITRAMFS_COPY_COMMANDS)
+
+if(EXISTS ${NYROS_INITRAMFS_DIR})
+    file(GLOB_RECURSE NYROS_INITRAMFS_FILES CONFIGURE_DEPENDS ${NYROS_INITRAMFS_DIR}/*)
+    list(APPEND NYROS_INITRAMFS_COPY_COMMANDS
+        COMMAND ${CMAKE_COMMAND} -E copy_directory ${NYROS_INITRAMFS_DIR} ${NYROS_INITRAMFS_STAGING_DIR}
+    )
+endif()
+
+get_property(NYROS_USER_PROGRAMS GLOBAL PROPERTY NYROS_USER_PROGRAMS)
+foreach(program ${NYROS_USER_PROGRAMS})
+    list(APPEND NYROS_INITRAMFS_COPY_COMMANDS
+        COMMAND ${CMAKE_COMMAND} -E copy $<TARGET_FILE:${program}> ${NYROS_INITRAMFS_STAGING_DIR}/bin/
+    )
+endforeach()
+
+add_custom_command(
+    OUTPUT ${NYROS_INITRAMFS_IMAGE}
+    COMMAND ${CMAKE_COMMAND} -E rm -rf ${NYROS_INITRAMFS_STAGING_DIR}
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${NYROS_INITRAMFS_STAGING_DIR}/bin
+    ${NYROS_INITRAMFS_COPY_COMMANDS}
+    COMMAND ${CMAKE_COMMAND} -E chdir ${NYROS_INITRAMFS_STAGING_DIR}
+        ${CMAKE_COMMAND} -E tar cf ${NYROS_INITRAMFS_IMAGE} --format=paxr .
+    DEPENDS ${NYROS_INITRAMFS_FILES} ${NYROS_USER_PROGRAMS}
+    COMMENT "Packing ${NYROS_INITRAMFS_DIR} and the user programs into initramfs.tar"
+    VERBATIM
+)
+
+add_custom_target(nyros-initramfs DEPENDS ${NYROS_INITRAMFS_IMAGE})
+
 if(NOT NYROS_CAN_BUILD_IMAGE)
     return()
 endif()
@@ -40,6 +82,11 @@ add_custom_target(nyros-image-uefi
         ${CMAKE_BINARY_DIR}/kernel/nyros-kernel 
         ${CMAKE_BINARY_DIR}/iso-root/boot/nyros-kernel
     
+    # Copy initramfs
+    COMMAND ${CMAKE_COMMAND} -E copy
+        ${NYROS_INITRAMFS_IMAGE}
+        ${CMAKE_BINARY_DIR}/iso-root/boot/initramfs.tar
+
     # Copy GRUB configuration
     COMMAND ${CMAKE_COMMAND} -E copy 
         ${NYROS_GRUB_CFG} 
@@ -57,7 +104,7 @@ add_custom_target(nyros-image-uefi
         --
         -volid NYROS
         
-    DEPENDS nyros-kernel
+    DEPENDS nyros-kernel nyros-initramfs
     BYPRODUCTS ${NYROS_IMAGE_OUTPUT_DIR}/nyros.img
     WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
 )
@@ -41,6 +41,12 @@ endif()
 
 # Function to create GRUB configuration
 function(nyros_create_grub_config output_file)
+    # Load the initramfs next to the kernel when there is a directory to pack
+    set(MODULE_LINES "")
+    if(EXISTS ${NYROS_INITRAMFS_DIR})
+        set(MODULE_LINES "\n    module2 /boot/initramfs.tar initramfs")
+    endif()
+
     file(WRITE ${output_file} "
 set timeout=5
 set default=0
@@ -55,12 +61,12 @@ else
 fi
 
 menuentry \"Nyros ${PROJECT_VERSION}\" {
-    multiboot2 /boot/nyros-kernel
+    multiboot2 /boot/nyros-kernel${MODULE_LINES}
     boot
 }
 
 menuentry \"Nyros ${PROJECT_VERSION} (Recovery)\" {
-    multiboot2 /boot/nyros-kernel recovery=true
+    multiboot2 /boot/nyros-kernel recovery=true${MODULE_LINES}
     boot
 }
 ")
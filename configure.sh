@@ -57,6 +57,26 @@ while [[ $# -gt 0 ]]; do
             EXTRA_ARGS="$EXTRA_ARGS -DNYROS_ENABLE_LTO=ON"
             shift
             ;;
+        --enable-profiler)
+            EXTRA_ARGS="$EXTRA_ARGS -DNYROS_ENABLE_PROFILER=ON"
+            shift
+            ;;
+        --enable-benchmarks)
+            EXTRA_ARGS="$EXTRA_ARGS -DNYROS_BUILD_BENCHMARKS=ON"
+            shift
+            ;;
+        --initramfs-dir)
+            EXTRA_ARGS="$EXTRA_ARGS -DNYROS_INITRAMFS_DIR=$2"
+            shift 2
+            ;;
+        --disable-tracepoints)
+            EXTRA_ARGS="$EXTRA_ARGS -DNYROS_ENABLE_TRACEPOINTS=OFF"
+            shift
+            ;;
+        --enable-lock-stats)
+            EXTRA_ARGS="$EXTRA_ARGS -DNYROS_ENABLE_LOCK_STATS=ON"
+            shift
+            ;;
         --verbose)
             EXTRA_ARGS="$EXTRA_ARGS -DNYROS_VERBOSE_BUILD=ON"
             shift
@@ -81,6 +101,11 @@ while [[ $# -gt 0 ]]; do
             echo "  --generator GEN   Set CMake generator (default: Ninja)"
             echo "  --enable-tests    Enable unit tests"
             echo "  --enable-lto      Enable Link-Time Optimization"
+            echo "  --enable-profiler Stream sampling profiler data over IRIS"
+            echo "  --disable-tracepoints Compile out scoped tracepoint cycle accounting"
+            echo "  --enable-benchmarks Run in-kernel benchmarks at boot"
+            echo "  --enable-lock-stats Count lock contention and hold times"
+            echo "  --initramfs-dir DIR Directory packed into the initramfs (default: initramfs)"
             echo "  --verbose         Enable verbose builds"
             echo "  -O<level>         Override optimization level (0, 1, 2, 3, s, z)"
             echo "  --help            Show this help"
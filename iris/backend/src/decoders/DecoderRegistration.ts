@@ -1,17 +1,112 @@
 import { decoderRegistry } from './DecoderRegistry';
 import { GdtDecoder } from './boot/GdtDecoder';
 import { TssDecoder } from './boot/TssDecoder';
+import { BootPhaseDecoder } from './boot/BootPhaseDecoder';
+import { BootCompleteDecoder } from './boot/BootCompleteDecoder';
+import { CpuFeaturesDecoder } from './boot/CpuFeaturesDecoder';
+import { ProfileSampleDecoder } from './profiler/ProfileSampleDecoder';
+import { TraceScopeDecoder } from './system/TraceScopeDecoder';
+import { TracepointStatsDecoder } from './system/TracepointStatsDecoder';
+import { BenchmarkResultDecoder } from './system/BenchmarkResultDecoder';
+import { InitramfsMountedDecoder } from './fs/InitramfsMountedDecoder';
+import { NetDeviceDecoder } from './network/NetDeviceDecoder';
+import { NetQueueStatsDecoder } from './network/NetQueueStatsDecoder';
+import { ContextSwitchDecoder } from './process/ContextSwitchDecoder';
+import { TaskMigratedDecoder } from './process/TaskMigratedDecoder';
+import { SchedCpuStatsDecoder } from './process/SchedCpuStatsDecoder';
+import { CpuUtilizationDecoder } from './process/CpuUtilizationDecoder';
+import { ProcessStartDecoder } from './process/ProcessStartDecoder';
+import { ProcessExitDecoder } from './process/ProcessExitDecoder';
+import { PmmInitDecoder } from './memory/PmmInitDecoder';
+import { ExceptionDecoder } from './interrupt/ExceptionDecoder';
+import { IpiSendDecoder } from './interrupt/IpiSendDecoder';
+import { IpiReceiveDecoder } from './interrupt/IpiReceiveDecoder';
+import { InterruptStatsDecoder } from './interrupt/InterruptStatsDecoder';
+import { LockStatsDecoder } from './sync/LockStatsDecoder';
+import { PciDeviceDecoder } from './io/PciDeviceDecoder';
+import { PciEnumerationDecoder } from './io/PciEnumerationDecoder';
+import { BlockDeviceDecoder } from './io/BlockDeviceDecoder';
+import { BlockQueueStatsDecoder } from './io/BlockQueueStatsDecoder';
+import { BufferCacheStatsDecoder } from './io/BufferCacheStatsDecoder';
 
 // Event type constants (must match kernel)
+const EVENT_PROFILE_SAMPLE = 0x0002;
+const EVENT_TRACE_SCOPE = 0x0003;
+const EVENT_TRACEPOINT_STATS = 0x0004;
+const EVENT_BENCHMARK_RESULT = 0x0005;
 const EVENT_GDT_LOADED = 0x0101;
 const EVENT_TSS_LOADED = 0x0102;
+const EVENT_PMM_INIT_DONE = 0x0106;
+const EVENT_BOOT_PHASE = 0x0107;
+const EVENT_BOOT_COMPLETE = 0x0108;
+const EVENT_CPU_FEATURES = 0x0109;
+const EVENT_CONTEXT_SWITCH = 0x0200;
+const EVENT_TASK_MIGRATED = 0x0201;
+const EVENT_SCHED_CPU_STATS = 0x0202;
+const EVENT_PROCESS_START = 0x0203;
+const EVENT_PROCESS_EXIT = 0x0204;
+const EVENT_CPU_UTILIZATION = 0x0205;
+const EVENT_CPU_EXCEPTION = 0x0400;
+const EVENT_IPI_SEND = 0x0401;
+const EVENT_IPI_RECEIVE = 0x0402;
+const EVENT_INTERRUPT_STATS = 0x0403;
+const EVENT_LOCK_STATS = 0x0500;
+const EVENT_PCI_DEVICE = 0x0600;
+const EVENT_PCI_ENUMERATION = 0x0601;
+const EVENT_BLOCK_DEVICE = 0x0602;
+const EVENT_BLOCK_QUEUE_STATS = 0x0603;
+const EVENT_BUFFER_CACHE_STATS = 0x0604;
+const EVENT_INITRAMFS_MOUNTED = 0x0700;
+const EVENT_NET_DEVICE = 0x0800;
+const EVENT_NET_QUEUE_STATS = 0x0801;
 
 /**
  * Register all payload decoders with the registry.
  * This should be called during application initialization.
  */
 export function registerAllDecoders(): void {
+    // System event decoders
+    decoderRegistry.register(EVENT_PROFILE_SAMPLE, new ProfileSampleDecoder());
+    decoderRegistry.register(EVENT_TRACE_SCOPE, new TraceScopeDecoder());
+    decoderRegistry.register(EVENT_TRACEPOINT_STATS, new TracepointStatsDecoder());
+    decoderRegistry.register(EVENT_BENCHMARK_RESULT, new BenchmarkResultDecoder());
+
     // Boot event decoders
     decoderRegistry.register(EVENT_GDT_LOADED, new GdtDecoder());
     decoderRegistry.register(EVENT_TSS_LOADED, new TssDecoder());
+    decoderRegistry.register(EVENT_PMM_INIT_DONE, new PmmInitDecoder());
+    decoderRegistry.register(EVENT_BOOT_PHASE, new BootPhaseDecoder());
+    decoderRegistry.register(EVENT_BOOT_COMPLETE, new BootCompleteDecoder());
+    decoderRegistry.register(EVENT_CPU_FEATURES, new CpuFeaturesDecoder());
+
+    // Process event decoders
+    decoderRegistry.register(EVENT_CONTEXT_SWITCH, new ContextSwitchDecoder());
+    decoderRegistry.register(EVENT_TASK_MIGRATED, new TaskMigratedDecoder());
+    decoderRegistry.register(EVENT_SCHED_CPU_STATS, new SchedCpuStatsDecoder());
+    decoderRegistry.register(EVENT_PROCESS_START, new ProcessStartDecoder());
+    decoderRegistry.register(EVENT_PROCESS_EXIT, new ProcessExitDecoder());
+    decoderRegistry.register(EVENT_CPU_UTILIZATION, new CpuUtilizationDecoder());
+
+    // Interrupt event decoders
+    decoderRegistry.register(EVENT_CPU_EXCEPTION, new ExceptionDecoder());
+    decoderRegistry.register(EVENT_IPI_SEND, new IpiSendDecoder());
+    decoderRegistry.register(EVENT_IPI_RECEIVE, new IpiReceiveDecoder());
+    decoderRegistry.register(EVENT_INTERRUPT_STATS, new InterruptStatsDecoder());
+
+    // Synchronization event decoders
+    decoderRegistry.register(EVENT_LOCK_STATS, new LockStatsDecoder());
+
+    // I/O event decoders
+    decoderRegistry.register(EVENT_PCI_DEVICE, new PciDeviceDecoder());
+    decoderRegistry.register(EVENT_PCI_ENUMERATION, new PciEnumerationDecoder());
+    decoderRegistry.register(EVENT_BLOCK_DEVICE, new BlockDeviceDecoder());
+    decoderRegistry.register(EVENT_BLOCK_QUEUE_STATS, new BlockQueueStatsDecoder());
+    decoderRegistry.register(EVENT_BUFFER_CACHE_STATS, new BufferCacheStatsDecoder());
+
+    // Filesystem event decoders
+    decoderRegistry.register(EVENT_INITRAMFS_MOUNTED, new InitramfsMountedDecoder());
+
+    // Network event decoders
+    decoderRegistry.register(EVENT_NET_DEVICE, new NetDeviceDecoder());
+    decoderRegistry.register(EVENT_NET_QUEUE_STATS, new NetQueueStatsDecoder());
 }
@@ -0,0 +1,28 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for the boot-to-idle summary event.
+ * Layout matches boot::boot_summary_payload in kernel/include/boot/boot_timing.h.
+ */
+export class BootCompleteDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const entryTsc = payload.readBigUInt64LE(0);
+        const idleTsc = payload.readBigUInt64LE(8);
+        const tscFrequency = Number(payload.readBigUInt64LE(16));
+        const bootToIdleNs = Number(payload.readBigUInt64LE(24));
+
+        return {
+            entryTsc: entryTsc.toString(),
+            idleTsc: idleTsc.toString(),
+            bootCycles: Number(idleTsc - entryTsc),
+            tscFrequencyHz: tscFrequency,
+            bootToIdleUs: bootToIdleNs / 1000,
+            // QEMU starts the TSC at VM reset, so this covers firmware and bootloader
+            resetToEntryUs: tscFrequency > 0 ? Number(entryTsc) * 1e6 / tscFrequency : 0
+        };
+    }
+
+    getDescription(): string {
+        return 'Boot-to-idle summary decoder';
+    }
+}
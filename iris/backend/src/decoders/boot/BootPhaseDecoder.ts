@@ -0,0 +1,40 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+// Must match boot::boot_phase in kernel/include/boot/boot_timing.h
+const BOOT_PHASE_NAMES: string[] = [
+    'BOOTSTRAP_ENTRY',
+    'PAGE_TABLES_START',
+    'PAGE_TABLES_DONE',
+    'LONG_MODE_ENTRY',
+    'SERIAL_READY',
+    'IRIS_READY',
+    'GDT_READY',
+    'PER_CPU_READY',
+    'IDT_READY',
+    'LAPIC_READY',
+    'ARCH_READY',
+    'IDLE_REACHED'
+];
+
+/**
+ * Decoder for boot milestone events.
+ * Layout matches boot::boot_phase_payload in kernel/include/boot/boot_timing.h.
+ */
+export class BootPhaseDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const tsc = payload.readBigUInt64LE(0);
+        const cycles = payload.readBigUInt64LE(8);
+        const phase = payload.readUInt16LE(16);
+
+        return {
+            phase,
+            name: BOOT_PHASE_NAMES[phase] || `PHASE_${phase}`,
+            tsc: tsc.toString(),
+            cycles: Number(cycles)
+        };
+    }
+
+    getDescription(): string {
+        return 'Boot phase timing decoder';
+    }
+}
@@ -0,0 +1,63 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+// Must match arch::x86::cpuid_word and cpu_feature in kernel/include/arch/x86/cpu/features.h
+const WORD_COUNT = 9;
+
+const FEATURE_BITS: Array<[number, number, string]> = [
+    [0, 3, 'MONITOR'],
+    [0, 17, 'PCID'],
+    [0, 21, 'X2APIC'],
+    [0, 24, 'TSC_DEADLINE'],
+    [0, 26, 'XSAVE'],
+    [0, 30, 'RDRAND'],
+    [0, 31, 'HYPERVISOR'],
+    [1, 4, 'TSC'],
+    [1, 9, 'APIC'],
+    [1, 13, 'PGE'],
+    [2, 0, 'MWAIT_EXTENSIONS'],
+    [2, 1, 'MWAIT_INTERRUPT_BREAK'],
+    [3, 0, 'FSGSBASE'],
+    [3, 7, 'SMEP'],
+    [3, 9, 'ERMS'],
+    [3, 10, 'INVPCID'],
+    [3, 20, 'SMAP'],
+    [5, 4, 'FSRM'],
+    [7, 11, 'SYSCALL'],
+    [7, 20, 'NX'],
+    [7, 26, 'PAGE_1GB'],
+    [7, 27, 'RDTSCP'],
+    [8, 8, 'INVARIANT_TSC']
+];
+
+/**
+ * Decoder for the CPUID features one CPU reported at bring-up.
+ * Layout matches arch::x86::cpu_features_payload in kernel/include/arch/x86/cpu/features.h.
+ */
+export class CpuFeaturesDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const words: number[] = [];
+        for (let i = 0; i < WORD_COUNT; i++) {
+            words.push(payload.readUInt32LE(i * 4));
+        }
+
+        const features = FEATURE_BITS
+            .filter(([word, bit]) => ((words[word] >>> bit) & 1) !== 0)
+            .map(([, , name]) => name);
+
+        return {
+            vendor: payload.toString('ascii', 44, 56).replace(/\0+$/, ''),
+            family: payload.readUInt8(56),
+            model: payload.readUInt8(57),
+            stepping: payload.readUInt8(58),
+            maxLeaf: payload.readUInt32LE(36),
+            maxExtendedLeaf: payload.readUInt32LE(40),
+            mismatch: payload.readUInt8(59) !== 0,
+            features,
+            words: words.map(word => '0x' + word.toString(16).padStart(8, '0'))
+        };
+    }
+
+    getDescription(): string {
+        return 'CPUID feature decoder';
+    }
+}
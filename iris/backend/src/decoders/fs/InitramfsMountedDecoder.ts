@@ -0,0 +1,25 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for initramfs mount events.
+ * Layout matches fs::initramfs::mount_payload in kernel/include/fs/initramfs.h.
+ */
+export class InitramfsMountedDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const physStart = payload.readBigUInt64LE(0);
+        const size = Number(payload.readBigUInt64LE(8));
+        const totalBytes = Number(payload.readBigUInt64LE(16));
+        const fileCount = payload.readUInt32LE(24);
+
+        return {
+            physStart: `0x${physStart.toString(16).padStart(16, '0').toUpperCase()}`,
+            size,
+            totalBytes,
+            fileCount
+        };
+    }
+
+    getDescription(): string {
+        return 'Initramfs mount decoder';
+    }
+}
@@ -0,0 +1,64 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for unhandled CPU exception events.
+ * Layout matches arch::x86::interrupt_frame in kernel/include/arch/x86/idt/idt.h.
+ */
+export class ExceptionDecoder implements IPayloadDecoder {
+    private static readonly REGISTERS = [
+        'r15', 'r14', 'r13', 'r12', 'r11', 'r10', 'r9', 'r8',
+        'rbp', 'rdi', 'rsi', 'rdx', 'rcx', 'rbx', 'rax',
+        'vector', 'errorCode', 'rip', 'cs', 'rflags', 'rsp', 'ss'
+    ];
+
+    private static readonly EXCEPTION_NAMES: Record<number, string> = {
+        0: 'Divide Error',
+        1: 'Debug',
+        2: 'Non-Maskable Interrupt',
+        3: 'Breakpoint',
+        4: 'Overflow',
+        5: 'Bound Range Exceeded',
+        6: 'Invalid Opcode',
+        7: 'Device Not Available',
+        8: 'Double Fault',
+        10: 'Invalid TSS',
+        11: 'Segment Not Present',
+        12: 'Stack-Segment Fault',
+        13: 'General Protection Fault',
+        14: 'Page Fault',
+        16: 'x87 Floating-Point Exception',
+        17: 'Alignment Check',
+        18: 'Machine Check',
+        19: 'SIMD Floating-Point Exception',
+        20: 'Virtualization Exception',
+        21: 'Control Protection Exception',
+    };
+
+    decode(payload: Buffer): any {
+        const registers: Record<string, string> = {};
+        let vector = 0;
+
+        ExceptionDecoder.REGISTERS.forEach((name, i) => {
+            const offset = i * 8;
+            if (offset + 8 > payload.length) {
+                return;
+            }
+
+            const value = payload.readBigUInt64LE(offset);
+            if (name === 'vector') {
+                vector = Number(value);
+            }
+            registers[name] = `0x${value.toString(16).padStart(16, '0').toUpperCase()}`;
+        });
+
+        return {
+            vector,
+            name: ExceptionDecoder.EXCEPTION_NAMES[vector] || 'Reserved',
+            registers
+        };
+    }
+
+    getDescription(): string {
+        return 'CPU exception frame decoder';
+    }
+}
@@ -0,0 +1,25 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for per-CPU, per-vector interrupt counts.
+ * Layout matches arch::x86::interrupt_stats_payload in kernel/include/arch/x86/irq/irq.h.
+ */
+export class InterruptStatsDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const windowCycles = Number(payload.readBigUInt64LE(16));
+        const windowCount = Number(payload.readBigUInt64LE(8));
+
+        return {
+            count: Number(payload.readBigUInt64LE(0)),
+            windowCount,
+            windowCycles,
+            vector: payload.readUInt8(24),
+            name: payload.toString('ascii', 32, 48).replace(/\0+$/, ''),
+            countPerMillionCycles: windowCycles > 0 ? windowCount * 1e6 / windowCycles : 0
+        };
+    }
+
+    getDescription(): string {
+        return 'Interrupt statistics decoder';
+    }
+}
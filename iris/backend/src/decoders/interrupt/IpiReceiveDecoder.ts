@@ -0,0 +1,19 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for cross-CPU call receive events.
+ * Layout matches arch::x86::ipi_receive_payload in kernel/include/arch/x86/smp/ipi.h.
+ */
+export class IpiReceiveDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        return {
+            tsc: Number(payload.readBigUInt64LE(0)),
+            latencyCycles: Number(payload.readBigUInt64LE(8)),
+            calls: payload.readUInt32LE(16)
+        };
+    }
+
+    getDescription(): string {
+        return 'IPI receive decoder';
+    }
+}
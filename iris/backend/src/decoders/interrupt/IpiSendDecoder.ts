@@ -0,0 +1,27 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for cross-CPU call send events.
+ * Layout matches arch::x86::ipi_send_payload in kernel/include/arch/x86/smp/ipi.h.
+ */
+export class IpiSendDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const targetMask = payload.readBigUInt64LE(8);
+        const targets: number[] = [];
+        for (let cpu = 0; cpu < 64; cpu++) {
+            if ((targetMask >> BigInt(cpu)) & 1n) {
+                targets.push(cpu);
+            }
+        }
+
+        return {
+            tsc: Number(payload.readBigUInt64LE(0)),
+            targets,
+            ipisSent: payload.readUInt32LE(16)
+        };
+    }
+
+    getDescription(): string {
+        return 'IPI send decoder';
+    }
+}
@@ -0,0 +1,29 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for attached block devices.
+ * Layout matches virtio::blk::device_payload in kernel/include/virtio/blk.h.
+ */
+export class BlockDeviceDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const sectorCount = Number(payload.readBigUInt64LE(0));
+        const features = payload.readBigUInt64LE(8);
+
+        return {
+            name: payload.toString('ascii', 32, 40).replace(/\0+$/, ''),
+            sectorCount,
+            sizeMiB: sectorCount * 512 / (1024 * 1024),
+            features: `0x${features.toString(16).padStart(16, '0').toUpperCase()}`,
+            blockSize: payload.readUInt32LE(16),
+            maxSegments: payload.readUInt32LE(20),
+            queueCount: payload.readUInt16LE(24),
+            queueSize: payload.readUInt16LE(26),
+            interrupts: payload.readUInt8(28) !== 0,
+            readOnly: payload.readUInt8(29) !== 0
+        };
+    }
+
+    getDescription(): string {
+        return 'Block device decoder';
+    }
+}
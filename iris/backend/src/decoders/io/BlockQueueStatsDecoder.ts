@@ -0,0 +1,28 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for per-queue block request counters.
+ * Layout matches virtio::blk::queue_stats_payload in kernel/include/virtio/blk.h.
+ */
+export class BlockQueueStatsDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const requests = Number(payload.readBigUInt64LE(0));
+        const commands = Number(payload.readBigUInt64LE(8));
+        const notifications = Number(payload.readBigUInt64LE(16));
+
+        return {
+            name: payload.toString('ascii', 40, 48).replace(/\0+$/, ''),
+            queue: payload.readUInt16LE(32),
+            requests,
+            commands,
+            notifications,
+            interrupts: Number(payload.readBigUInt64LE(24)),
+            requestsPerCommand: commands > 0 ? requests / commands : 0,
+            requestsPerNotification: notifications > 0 ? requests / notifications : 0
+        };
+    }
+
+    getDescription(): string {
+        return 'Block queue statistics decoder';
+    }
+}
@@ -0,0 +1,35 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for buffer cache counters.
+ * Layout matches block::cache::stats_payload in kernel/include/block/cache.h.
+ */
+export class BufferCacheStatsDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const hits = Number(payload.readBigUInt64LE(0));
+        const misses = Number(payload.readBigUInt64LE(8));
+        const readAhead = Number(payload.readBigUInt64LE(16));
+        const readAheadHits = Number(payload.readBigUInt64LE(24));
+        const writebacks = Number(payload.readBigUInt64LE(40));
+        const writebackRounds = Number(payload.readBigUInt64LE(48));
+
+        return {
+            hits,
+            misses,
+            readAhead,
+            readAheadHits,
+            evictions: Number(payload.readBigUInt64LE(32)),
+            writebacks,
+            writebackRounds,
+            buffers: payload.readUInt32LE(56),
+            dirty: payload.readUInt32LE(60),
+            hitRate: hits + misses > 0 ? hits / (hits + misses) : 0,
+            readAheadAccuracy: readAhead > 0 ? readAheadHits / readAhead : 0,
+            blocksPerWritebackRound: writebackRounds > 0 ? writebacks / writebackRounds : 0
+        };
+    }
+
+    getDescription(): string {
+        return 'Buffer cache statistics decoder';
+    }
+}
@@ -0,0 +1,40 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+const hex = (value: number, digits: number) =>
+    value.toString(16).padStart(digits, '0').toUpperCase();
+
+/**
+ * Decoder for PCI functions found by enumeration.
+ * Layout matches pci::device_payload in kernel/include/pci/pci.h.
+ */
+export class PciDeviceDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const segment = payload.readUInt16LE(0);
+        const bus = payload.readUInt8(2);
+        const slot = payload.readUInt8(3);
+        const fn = payload.readUInt8(4);
+        const capabilities = payload.readUInt8(19);
+
+        return {
+            address: `${hex(segment, 4)}:${hex(bus, 2)}:${hex(slot, 2)}.${fn}`,
+            classCode: payload.readUInt8(5),
+            subclass: payload.readUInt8(6),
+            progIf: payload.readUInt8(7),
+            vendorId: `0x${hex(payload.readUInt16LE(8), 4)}`,
+            deviceId: `0x${hex(payload.readUInt16LE(10), 4)}`,
+            subsystemVendorId: `0x${hex(payload.readUInt16LE(12), 4)}`,
+            subsystemId: `0x${hex(payload.readUInt16LE(14), 4)}`,
+            revision: payload.readUInt8(16),
+            headerType: payload.readUInt8(17),
+            interruptPin: payload.readUInt8(18),
+            msi: (capabilities & 0x1) !== 0,
+            msix: (capabilities & 0x2) !== 0,
+            pcie: (capabilities & 0x4) !== 0,
+            driver: payload.toString('ascii', 24, 40).replace(/\0+$/, '')
+        };
+    }
+
+    getDescription(): string {
+        return 'PCI device decoder';
+    }
+}
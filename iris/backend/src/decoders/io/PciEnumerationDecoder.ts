@@ -0,0 +1,26 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for the PCI enumeration summary.
+ * Layout matches pci::enumeration_payload in kernel/include/pci/pci.h.
+ */
+export class PciEnumerationDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const ecamRegions = payload.readUInt8(26);
+
+        return {
+            cycles: Number(payload.readBigUInt64LE(0)),
+            nanoseconds: Number(payload.readBigUInt64LE(8)),
+            deviceCount: payload.readUInt32LE(16),
+            boundCount: payload.readUInt32LE(20),
+            busesScanned: payload.readUInt16LE(24),
+            ecamRegions,
+            mechanism: ecamRegions > 0 ? 'ECAM' : 'Port I/O',
+            truncated: payload.readUInt8(27) !== 0
+        };
+    }
+
+    getDescription(): string {
+        return 'PCI enumeration decoder';
+    }
+}
@@ -0,0 +1,19 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for the physical frame allocator initialization summary.
+ * Layout matches memory::pmm::init_payload in kernel/include/memory/pmm.h.
+ */
+export class PmmInitDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        return {
+            availableFrames: Number(payload.readBigUInt64LE(0)),
+            freeFrames: Number(payload.readBigUInt64LE(8)),
+            initCycles: Number(payload.readBigUInt64LE(16))
+        };
+    }
+
+    getDescription(): string {
+        return 'PMM initialization decoder';
+    }
+}
@@ -0,0 +1,33 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for attached network devices.
+ * Layout matches virtio::net::device_payload in kernel/include/virtio/net.h.
+ */
+export class NetDeviceDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const features = payload.readBigUInt64LE(0);
+        const mac = Array.from(payload.subarray(8, 14))
+            .map(byte => byte.toString(16).padStart(2, '0'))
+            .join(':');
+        const checksumOffload = payload.readUInt8(25);
+
+        return {
+            name: payload.toString('ascii', 32, 40).replace(/\0+$/, ''),
+            mac,
+            features: `0x${features.toString(16).padStart(16, '0').toUpperCase()}`,
+            mtu: payload.readUInt16LE(14),
+            queuePairs: payload.readUInt16LE(16),
+            maxQueuePairs: payload.readUInt16LE(18),
+            receiveQueueSize: payload.readUInt16LE(20),
+            transmitQueueSize: payload.readUInt16LE(22),
+            interrupts: payload.readUInt8(24) !== 0,
+            transmitChecksumOffload: (checksumOffload & 1) !== 0,
+            receiveChecksumOffload: (checksumOffload & 2) !== 0
+        };
+    }
+
+    getDescription(): string {
+        return 'Network device decoder';
+    }
+}
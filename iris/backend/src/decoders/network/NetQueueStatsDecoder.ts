@@ -0,0 +1,34 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for per-queue-pair packet counters.
+ * Layout matches virtio::net::queue_stats_payload in kernel/include/virtio/net.h.
+ */
+export class NetQueueStatsDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const receivePackets = Number(payload.readBigUInt64LE(0));
+        const transmitPackets = Number(payload.readBigUInt64LE(16));
+        const transmitReaps = Number(payload.readBigUInt64LE(32));
+        const notifications = Number(payload.readBigUInt64LE(40));
+
+        return {
+            name: payload.toString('ascii', 64, 72).replace(/\0+$/, ''),
+            queue: payload.readUInt16LE(60),
+            receivePackets,
+            receiveBytes: Number(payload.readBigUInt64LE(8)),
+            transmitPackets,
+            transmitBytes: Number(payload.readBigUInt64LE(24)),
+            transmitReaps,
+            notifications,
+            interrupts: Number(payload.readBigUInt64LE(48)),
+            refillFailures: payload.readUInt32LE(56),
+            packetsPerReap: transmitReaps > 0 ? transmitPackets / transmitReaps : 0,
+            packetsPerNotification:
+                notifications > 0 ? (receivePackets + transmitPackets) / notifications : 0
+        };
+    }
+
+    getDescription(): string {
+        return 'Network queue statistics decoder';
+    }
+}
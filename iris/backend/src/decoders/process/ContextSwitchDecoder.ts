@@ -0,0 +1,19 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for scheduler context switches.
+ * Layout matches sched::context_switch_payload in kernel/include/sched/sched.h.
+ */
+export class ContextSwitchDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        return {
+            tsc: Number(payload.readBigUInt64LE(0)),
+            prevTid: payload.readUInt32LE(8),
+            nextTid: payload.readUInt32LE(12)
+        };
+    }
+
+    getDescription(): string {
+        return 'Scheduler context switch decoder';
+    }
+}
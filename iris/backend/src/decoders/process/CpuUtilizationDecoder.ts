@@ -0,0 +1,31 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+const IDLE_METHODS: Record<number, string> = {
+    0: 'hlt',
+    1: 'mwait'
+};
+
+/**
+ * Decoder for per-CPU idle and busy time over one report window.
+ * Layout matches sched::cpu_utilization_payload in kernel/include/sched/sched.h.
+ */
+export class CpuUtilizationDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const windowCycles = Number(payload.readBigUInt64LE(0));
+        const idleCycles = Number(payload.readBigUInt64LE(8));
+        const method = payload.readUInt8(24);
+
+        return {
+            windowCycles,
+            idleCycles,
+            busyCycles: windowCycles - idleCycles,
+            utilization: windowCycles > 0 ? (windowCycles - idleCycles) / windowCycles : 0,
+            wakeups: Number(payload.readBigUInt64LE(16)),
+            idleMethod: IDLE_METHODS[method] || `method_${method}`
+        };
+    }
+
+    getDescription(): string {
+        return 'CPU utilization decoder';
+    }
+}
@@ -0,0 +1,23 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for user process exit statistics.
+ * Layout matches proc::process_exit_payload in kernel/include/proc/process.h.
+ */
+export class ProcessExitDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        return {
+            runtimeCycles: Number(payload.readBigUInt64LE(0)),
+            fileFaults: Number(payload.readBigUInt64LE(8)),
+            zeroFaults: Number(payload.readBigUInt64LE(16)),
+            cowFaults: Number(payload.readBigUInt64LE(24)),
+            faultCycles: Number(payload.readBigUInt64LE(32)),
+            pid: payload.readUInt32LE(40),
+            exitCode: payload.readInt32LE(44)
+        };
+    }
+
+    getDescription(): string {
+        return 'Process exit decoder';
+    }
+}
@@ -0,0 +1,21 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for user process startup latency.
+ * Layout matches proc::process_start_payload in kernel/include/proc/process.h.
+ */
+export class ProcessStartDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        return {
+            spawnTsc: Number(payload.readBigUInt64LE(0)),
+            startupCycles: Number(payload.readBigUInt64LE(8)),
+            entry: '0x' + payload.readBigUInt64LE(16).toString(16),
+            pid: payload.readUInt32LE(24),
+            regionCount: payload.readUInt16LE(28)
+        };
+    }
+
+    getDescription(): string {
+        return 'Process start decoder';
+    }
+}
@@ -0,0 +1,20 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for per-CPU scheduler counters.
+ * Layout matches sched::cpu_stats_payload in kernel/include/sched/sched.h.
+ */
+export class SchedCpuStatsDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        return {
+            contextSwitches: Number(payload.readBigUInt64LE(0)),
+            migrations: Number(payload.readBigUInt64LE(8)),
+            tasksCompleted: Number(payload.readBigUInt64LE(16)),
+            droppedEvents: Number(payload.readBigUInt64LE(24))
+        };
+    }
+
+    getDescription(): string {
+        return 'Scheduler CPU statistics decoder';
+    }
+}
@@ -0,0 +1,20 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for tasks stolen from another CPU's run queue.
+ * Layout matches sched::task_migrated_payload in kernel/include/sched/sched.h.
+ */
+export class TaskMigratedDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        return {
+            tsc: Number(payload.readBigUInt64LE(0)),
+            tid: payload.readUInt32LE(8),
+            fromCpu: payload.readUInt16LE(12),
+            toCpu: payload.readUInt16LE(14)
+        };
+    }
+
+    getDescription(): string {
+        return 'Task migration decoder';
+    }
+}
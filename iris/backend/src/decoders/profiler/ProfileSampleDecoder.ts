@@ -0,0 +1,41 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for sampling profiler events.
+ * Layout matches iris::profiler::sample in kernel/include/iris/profiler.h.
+ */
+export class ProfileSampleDecoder implements IPayloadDecoder {
+    private static readonly HEADER_SIZE = 16;
+
+    decode(payload: Buffer): any {
+        const tsc = payload.readBigUInt64LE(0);
+        const depth = payload.readUInt32LE(8);
+        const dropped = payload.readUInt32LE(12);
+
+        // Never trust depth beyond what was actually received
+        const available = Math.floor((payload.length - ProfileSampleDecoder.HEADER_SIZE) / 8);
+        const frameCount = Math.min(depth, available);
+
+        const stack: string[] = [];
+        for (let i = 0; i < frameCount; i++) {
+            const ip = payload.readBigUInt64LE(ProfileSampleDecoder.HEADER_SIZE + i * 8);
+            stack.push(this.formatAddress(ip));
+        }
+
+        return {
+            tsc: tsc.toString(),
+            depth: frameCount,
+            dropped,
+            stack
+        };
+    }
+
+    getDescription(): string {
+        return 'Sampling profiler stack sample decoder';
+    }
+
+    private formatAddress(addr: bigint): string {
+        const hex = addr.toString(16).padStart(16, '0').toUpperCase();
+        return `0x${hex}`;
+    }
+}
@@ -0,0 +1,32 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+
+/**
+ * Decoder for lock contention counters.
+ * Layout matches sync::lock_stats_payload in kernel/include/sync/lock_stats.h.
+ */
+export class LockStatsDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const acquisitions = Number(payload.readBigUInt64LE(0));
+        const contended = Number(payload.readBigUInt64LE(8));
+        const spinCycles = Number(payload.readBigUInt64LE(16));
+        const maxHoldCycles = Number(payload.readBigUInt64LE(24));
+
+        const nameBytes = payload.subarray(32, 64);
+        const nameEnd = nameBytes.indexOf(0);
+        const name = nameBytes.toString('ascii', 0, nameEnd >= 0 ? nameEnd : nameBytes.length);
+
+        return {
+            name,
+            acquisitions,
+            contended,
+            contentionRate: acquisitions > 0 ? contended / acquisitions : 0,
+            spinCycles,
+            avgSpinCycles: contended > 0 ? Math.round(spinCycles / contended) : 0,
+            maxHoldCycles
+        };
+    }
+
+    getDescription(): string {
+        return 'Lock contention statistics decoder';
+    }
+}
@@ -0,0 +1,89 @@
+/**
+ * Benchmark identifiers, must match bench::benchmark_id in kernel/include/bench/bench.h.
+ */
+export const BENCHMARK_NAMES: Record<number, string> = {
+    0: 'initramfs_open',
+    1: 'initramfs_read',
+    2: 'port_io_inb_loop',
+    3: 'port_io_insb',
+    4: 'port_io_inw_loop',
+    5: 'port_io_insw',
+    6: 'port_io_outb_loop',
+    7: 'port_io_outsb',
+    8: 'spinlock_1cpu',
+    9: 'spinlock_2cpu',
+    10: 'spinlock_3cpu',
+    11: 'spinlock_4cpu',
+    12: 'mcs_lock_1cpu',
+    13: 'mcs_lock_2cpu',
+    14: 'mcs_lock_3cpu',
+    15: 'mcs_lock_4cpu',
+    16: 'sched_spawn_throughput',
+    17: 'sched_ping_pong',
+    18: 'sched_ping_pong_fpu',
+    19: 'syscall_null_round_trip',
+    20: 'proc_fork_exit_64mib',
+    21: 'tlb_switch_pcid',
+    22: 'tlb_switch_flush',
+    23: 'tlb_shootdown_1cpu',
+    24: 'tlb_shootdown_2cpu',
+    25: 'tlb_shootdown_3cpu',
+    26: 'tlb_shootdown_4cpu',
+    27: 'tlb_shootdown_batched',
+    28: 'tlb_shootdown_unbatched',
+    29: 'ipi_round_trip_1cpu',
+    30: 'ipi_round_trip_2cpu',
+    31: 'ipi_round_trip_3cpu',
+    32: 'rcu_read_1cpu',
+    33: 'rcu_read_2cpu',
+    34: 'rcu_read_3cpu',
+    35: 'rcu_read_4cpu',
+    36: 'spinlock_read_1cpu',
+    37: 'spinlock_read_2cpu',
+    38: 'spinlock_read_3cpu',
+    39: 'spinlock_read_4cpu',
+    40: 'rcu_synchronize',
+    41: 'container_intrusive_list',
+    42: 'container_spsc_ring',
+    43: 'container_mpsc_queue',
+    44: 'container_mpmc_queue',
+    45: 'container_hash_map_insert_erase',
+    46: 'container_hash_map_lookup',
+    47: 'container_radix_tree_insert_erase',
+    48: 'container_radix_tree_lookup',
+    49: 'iris_emit_blocking',
+    50: 'iris_emit_async',
+    51: 'serial_loopback_blocking',
+    52: 'serial_loopback_async',
+    53: 'sched_idle_wakeup',
+    54: 'irq_dispatch_local',
+    55: 'irq_dispatch_remote',
+    56: 'block_random_read_qd1',
+    57: 'block_random_read_qd2',
+    58: 'block_random_read_qd4',
+    59: 'block_random_read_qd8',
+    60: 'block_random_read_qd16',
+    61: 'block_random_read_qd32',
+    62: 'block_random_read_qd64',
+    63: 'block_random_read_qd128',
+    64: 'block_sequential_read_qd1',
+    65: 'block_sequential_read_qd2',
+    66: 'block_sequential_read_qd4',
+    67: 'block_sequential_read_qd8',
+    68: 'block_sequential_read_qd16',
+    69: 'block_sequential_read_qd32',
+    70: 'block_sequential_read_qd64',
+    71: 'block_sequential_read_qd128',
+    72: 'buffer_cache_sequential_read',
+    73: 'buffer_cache_random_read',
+    74: 'buffer_cache_hot_read',
+    75: 'buffer_cache_write_back',
+    76: 'net_round_trip_small',
+    77: 'net_round_trip_large',
+    78: 'net_stream_small',
+    79: 'net_stream_large'
+};
+
+export function benchmarkName(id: number): string {
+    return BENCHMARK_NAMES[id] || `benchmark_${id}`;
+}
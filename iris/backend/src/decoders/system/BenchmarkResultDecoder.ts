@@ -0,0 +1,38 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+import { benchmarkName } from './BenchmarkNames';
+
+/**
+ * Decoder for in-kernel benchmark results.
+ * Layout matches bench::result_payload in kernel/include/bench/bench.h.
+ */
+export class BenchmarkResultDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const iterations = Number(payload.readBigUInt64LE(0));
+        const totalCycles = Number(payload.readBigUInt64LE(8));
+        const minCycles = Number(payload.readBigUInt64LE(16));
+        const maxCycles = Number(payload.readBigUInt64LE(24));
+        const bytes = Number(payload.readBigUInt64LE(32));
+        const tscFrequency = Number(payload.readBigUInt64LE(40));
+        const id = payload.readUInt16LE(48);
+
+        const avgCycles = iterations > 0 ? totalCycles / iterations : 0;
+        const seconds = tscFrequency > 0 ? totalCycles / tscFrequency : 0;
+
+        return {
+            benchmark: id,
+            name: benchmarkName(id),
+            iterations,
+            avgCycles: Math.round(avgCycles),
+            minCycles,
+            maxCycles,
+            bytes,
+            avgNs: tscFrequency > 0 ? Math.round(avgCycles * 1e9 / tscFrequency) : 0,
+            throughputMBps: seconds > 0 && bytes > 0 ? bytes / seconds / (1024 * 1024) : 0,
+            operationsPerSecond: seconds > 0 ? iterations / seconds : 0
+        };
+    }
+
+    getDescription(): string {
+        return 'In-kernel benchmark result decoder';
+    }
+}
@@ -0,0 +1,25 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+import { tracepointName } from './TracepointNames';
+
+/**
+ * Decoder for traced scope duration events.
+ * Layout matches iris::trace_scope_payload in kernel/include/iris/tracepoint.h.
+ */
+export class TraceScopeDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const startTsc = payload.readBigUInt64LE(0);
+        const cycles = payload.readBigUInt64LE(8);
+        const id = payload.readUInt16LE(16);
+
+        return {
+            tracepoint: id,
+            name: tracepointName(id),
+            startTsc: startTsc.toString(),
+            cycles: Number(cycles)
+        };
+    }
+
+    getDescription(): string {
+        return 'Traced scope duration decoder';
+    }
+}
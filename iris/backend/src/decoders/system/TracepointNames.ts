@@ -0,0 +1,17 @@
+/**
+ * Tracepoint identifiers, must match iris::tracepoint in kernel/include/iris/tracepoint.h.
+ */
+export const TRACEPOINT_NAMES: Record<number, string> = {
+    0: 'arch::x86::init_gdt',
+    1: 'serial::init_port',
+    2: 'iris::init',
+    3: 'memory::memcmp',
+    4: 'memory::memcpy',
+    5: 'memory::memmove',
+    6: 'memory::memset',
+    7: 'memory::memzero'
+};
+
+export function tracepointName(id: number): string {
+    return TRACEPOINT_NAMES[id] || `tracepoint_${id}`;
+}
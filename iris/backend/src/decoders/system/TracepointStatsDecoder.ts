@@ -0,0 +1,28 @@
+import { IPayloadDecoder } from '../IPayloadDecoder';
+import { tracepointName } from './TracepointNames';
+
+/**
+ * Decoder for per-CPU tracepoint counter events.
+ * Layout matches iris::tracepoint_stats_payload in kernel/include/iris/tracepoint.h.
+ */
+export class TracepointStatsDecoder implements IPayloadDecoder {
+    decode(payload: Buffer): any {
+        const calls = Number(payload.readBigUInt64LE(0));
+        const totalCycles = Number(payload.readBigUInt64LE(8));
+        const maxCycles = Number(payload.readBigUInt64LE(16));
+        const id = payload.readUInt16LE(24);
+
+        return {
+            tracepoint: id,
+            name: tracepointName(id),
+            calls,
+            totalCycles,
+            maxCycles,
+            avgCycles: calls > 0 ? Math.round(totalCycles / calls) : 0
+        };
+    }
+
+    getDescription(): string {
+        return 'Tracepoint cycle counter decoder';
+    }
+}
@@ -1,5 +1,6 @@
 #!/usr/bin/env node
 
+import * as path from 'path';
 import fastify, { FastifyInstance } from 'fastify';
 import websocketPlugin from '@fastify/websocket';
 import cors from '@fastify/cors';
@@ -7,8 +8,14 @@ import { IrisBackend } from './IrisBackend';
 import { UnixSocketDataSource } from './transport/UnixSocketDataSource';
 import { WebSocketServer } from './server/WebSocketServer';
 import { registerAllDecoders } from './decoders/DecoderRegistration';
+import { DefaultEventProcessor } from './processor/DefaultEventProcessor';
+import { CompositeEventProcessor } from './processor/CompositeEventProcessor';
+import { SymbolTable } from './profiler/SymbolTable';
+import { ProfileAggregator } from './profiler/ProfileAggregator';
 
 const SOCKET_PATH = '/tmp/nyros-debug.sock';
+const KERNEL_MAP_PATH = process.env.NYROS_KERNEL_MAP ||
+    path.resolve(__dirname, '../../../build/kernel/nyros-kernel.map');
 const HTTP_PORT = 3001;
 const HTTP_HOST = '0.0.0.0';
 
@@ -16,6 +23,7 @@ class IrisApplication {
     private backend?: IrisBackend;
     private server?: FastifyInstance;
     private wsServer?: WebSocketServer;
+    private profileAggregator = new ProfileAggregator(new SymbolTable(KERNEL_MAP_PATH));
     private reconnectTimer?: NodeJS.Timeout;
     private readonly RECONNECT_DELAY = 2000; // 2 seconds
 
@@ -25,6 +33,7 @@ class IrisApplication {
         console.log('=====================================');
         console.log(`[INFO] Socket path: ${SOCKET_PATH}`);
         console.log(`[INFO] WebSocket server: ws://localhost:${HTTP_PORT}/ws`);
+        console.log(`[INFO] Kernel symbol map: ${KERNEL_MAP_PATH}`);
         console.log('[INFO] Waiting for kernel connection...\n');
 
         // Register payload decoders
@@ -74,6 +83,22 @@ class IrisApplication {
             };
         });
 
+        // Profiler output in folded stack format (feed to flamegraph.pl or speedscope)
+        this.server.get('/profile/folded', async (request, reply) => {
+            const query = request.query as { perCpu?: string };
+            reply.type('text/plain');
+            return this.profileAggregator.toFolded(query.perCpu === '1');
+        });
+
+        this.server.get('/profile/stats', async () => {
+            return this.profileAggregator.getStats();
+        });
+
+        this.server.post('/profile/reset', async () => {
+            this.profileAggregator.reset();
+            return { status: 'reset' };
+        });
+
         // Start server
         try {
             await this.server.listen({ port: HTTP_PORT, host: HTTP_HOST });
@@ -100,7 +125,10 @@ class IrisApplication {
                 dataSource,
                 undefined, // Use default decoder
                 undefined, // Use default parser
-                undefined, // Use default processor
+                new CompositeEventProcessor([
+                    new DefaultEventProcessor(),
+                    this.profileAggregator
+                ]),
                 this.wsServer // Pass WebSocket server for broadcasting
             );
             await this.backend.start();
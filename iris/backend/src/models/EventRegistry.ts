@@ -86,20 +86,53 @@ export class EventRegistry {
     private registerDefaultEvents(): void {
         // System Events (0x0000 - 0x00FF)
         this.register({ id: 0x0001, name: 'IRIS_INIT', category: EventCategory.SYSTEM, description: 'IRIS debug system initialized', severity: EventSeverity.INFO });
+        this.register({ id: 0x0002, name: 'PROFILE_SAMPLE', category: EventCategory.SYSTEM, description: 'Sampling profiler stack sample', severity: EventSeverity.DEBUG });
+        this.register({ id: 0x0003, name: 'TRACE_SCOPE', category: EventCategory.SYSTEM, description: 'Duration of a traced kernel scope', severity: EventSeverity.DEBUG });
+        this.register({ id: 0x0004, name: 'TRACEPOINT_STATS', category: EventCategory.SYSTEM, description: 'Per-CPU tracepoint cycle counters', severity: EventSeverity.INFO });
+        this.register({ id: 0x0005, name: 'BENCHMARK_RESULT', category: EventCategory.SYSTEM, description: 'In-kernel benchmark result', severity: EventSeverity.INFO });
 
         // Boot Events (0x0100 - 0x01FF)
         this.register({ id: 0x0100, name: 'BOOT_START', category: EventCategory.BOOT, description: 'Kernel boot sequence started', severity: EventSeverity.INFO });
         this.register({ id: 0x0101, name: 'GDT_LOADED', category: EventCategory.BOOT, description: 'Global Descriptor Table loaded', severity: EventSeverity.INFO });
         this.register({ id: 0x0102, name: 'TSS_LOADED', category: EventCategory.BOOT, description: 'Task State Segment configured', severity: EventSeverity.INFO });
+        this.register({ id: 0x0106, name: 'PMM_INIT_DONE', category: EventCategory.BOOT, description: 'Physical frame allocator initialized', severity: EventSeverity.INFO });
+        this.register({ id: 0x0107, name: 'BOOT_PHASE', category: EventCategory.BOOT, description: 'Boot milestone reached', severity: EventSeverity.DEBUG });
+        this.register({ id: 0x0108, name: 'BOOT_COMPLETE', category: EventCategory.BOOT, description: 'Kernel reached the idle loop', severity: EventSeverity.INFO });
+        this.register({ id: 0x0109, name: 'CPU_FEATURES', category: EventCategory.BOOT, description: 'CPUID features of one CPU', severity: EventSeverity.INFO });
 
-        // Future event categories will be added here as they're implemented in the kernel
         // Process/Thread Events (0x0200 - 0x02FF)
-        // Memory Events (0x0300 - 0x03FF)
+        this.register({ id: 0x0200, name: 'CONTEXT_SWITCH', category: EventCategory.PROCESS, description: 'Scheduler switched tasks', severity: EventSeverity.DEBUG });
+        this.register({ id: 0x0201, name: 'TASK_MIGRATED', category: EventCategory.PROCESS, description: 'Task stolen by another CPU', severity: EventSeverity.DEBUG });
+        this.register({ id: 0x0202, name: 'SCHED_CPU_STATS', category: EventCategory.PROCESS, description: 'Per-CPU scheduler counters', severity: EventSeverity.INFO });
+        this.register({ id: 0x0203, name: 'PROCESS_START', category: EventCategory.PROCESS, description: 'User process entered user mode', severity: EventSeverity.INFO });
+        this.register({ id: 0x0204, name: 'PROCESS_EXIT', category: EventCategory.PROCESS, description: 'User process exited', severity: EventSeverity.INFO });
+        this.register({ id: 0x0205, name: 'CPU_UTILIZATION', category: EventCategory.PROCESS, description: 'Per-CPU idle and busy cycles', severity: EventSeverity.DEBUG });
+
         // Interrupt Events (0x0400 - 0x04FF)
+        this.register({ id: 0x0400, name: 'CPU_EXCEPTION', category: EventCategory.INTERRUPT, description: 'Unhandled CPU exception', severity: EventSeverity.CRITICAL });
+        this.register({ id: 0x0401, name: 'IPI_SEND', category: EventCategory.INTERRUPT, description: 'Cross-CPU call queued', severity: EventSeverity.DEBUG });
+        this.register({ id: 0x0402, name: 'IPI_RECEIVE', category: EventCategory.INTERRUPT, description: 'Cross-CPU calls served', severity: EventSeverity.DEBUG });
+        this.register({ id: 0x0403, name: 'INTERRUPT_STATS', category: EventCategory.INTERRUPT, description: 'Interrupts of one vector on one CPU', severity: EventSeverity.DEBUG });
+
         // Synchronization Events (0x0500 - 0x05FF)
+        this.register({ id: 0x0500, name: 'LOCK_STATS', category: EventCategory.SYNC, description: 'Lock contention counters', severity: EventSeverity.INFO });
+
         // I/O Events (0x0600 - 0x06FF)
+        this.register({ id: 0x0600, name: 'PCI_DEVICE', category: EventCategory.IO, description: 'PCI function found by enumeration', severity: EventSeverity.INFO });
+        this.register({ id: 0x0601, name: 'PCI_ENUMERATION', category: EventCategory.IO, description: 'PCI enumeration summary and time', severity: EventSeverity.INFO });
+        this.register({ id: 0x0602, name: 'BLOCK_DEVICE', category: EventCategory.IO, description: 'Block device attached', severity: EventSeverity.INFO });
+        this.register({ id: 0x0603, name: 'BLOCK_QUEUE_STATS', category: EventCategory.IO, description: 'Per-queue block request counters', severity: EventSeverity.INFO });
+        this.register({ id: 0x0604, name: 'BUFFER_CACHE_STATS', category: EventCategory.IO, description: 'Buffer cache hit and write counters', severity: EventSeverity.INFO });
+
         // Filesystem Events (0x0700 - 0x07FF)
+        this.register({ id: 0x0700, name: 'INITRAMFS_MOUNTED', category: EventCategory.FILESYSTEM, description: 'Initramfs boot module indexed', severity: EventSeverity.INFO });
+
         // Network Events (0x0800 - 0x08FF)
+        this.register({ id: 0x0800, name: 'NET_DEVICE', category: EventCategory.NETWORK, description: 'Network device attached', severity: EventSeverity.INFO });
+        this.register({ id: 0x0801, name: 'NET_QUEUE_STATS', category: EventCategory.NETWORK, description: 'Per-queue-pair packet counters', severity: EventSeverity.INFO });
+
+        // Future event categories will be added here as they're implemented in the kernel
+        // Memory Events (0x0300 - 0x03FF)
     }
 }
 
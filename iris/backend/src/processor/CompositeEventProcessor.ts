@@ -0,0 +1,15 @@
+import { IEventProcessor } from './IEventProcessor';
+import { IrisPacket } from '../models/IrisPacket';
+
+/**
+ * Event processor that forwards every packet to a list of processors in order.
+ */
+export class CompositeEventProcessor implements IEventProcessor {
+    constructor(private readonly processors: IEventProcessor[]) { }
+
+    process(packet: IrisPacket): void {
+        for (const processor of this.processors) {
+            processor.process(packet);
+        }
+    }
+}
@@ -0,0 +1,80 @@
+import { IEventProcessor } from '../processor/IEventProcessor';
+import { IrisPacket } from '../models/IrisPacket';
+import { SymbolTable } from './SymbolTable';
+
+// Event type constant (must match kernel)
+const EVENT_PROFILE_SAMPLE = 0x0002;
+
+/**
+ * Aggregates sampling profiler events into folded stacks.
+ *
+ * The output uses the folded format understood by flamegraph.pl, speedscope and
+ * inferno: one line per unique stack, frames root-first separated by ';',
+ * followed by the number of samples. Symbol names are emitted mangled; pipe the
+ * output through c++filt for readable C++ names.
+ */
+export class ProfileAggregator implements IEventProcessor {
+    private stacks = new Map<string, number>();
+    private totalSamples = 0;
+    private droppedSamples = 0;
+
+    constructor(private readonly symbols: SymbolTable) { }
+
+    process(packet: IrisPacket): void {
+        if (packet.eventType !== EVENT_PROFILE_SAMPLE || !packet.decodedPayload) {
+            return;
+        }
+
+        const { stack, dropped } = packet.decodedPayload as { stack: string[]; dropped: number };
+        if (!stack || stack.length === 0) {
+            return;
+        }
+
+        // Innermost frame first in the sample, flame graphs want the root first
+        const frames = stack.map((ip, depth) => {
+            const address = BigInt(ip);
+
+            // Return addresses point past the call, step back into the calling instruction
+            return this.symbols.resolve(depth === 0 ? address : address - 1n);
+        }).reverse();
+
+        const key = [`cpu${packet.cpuId}`, ...frames].join(';');
+        this.stacks.set(key, (this.stacks.get(key) || 0) + 1);
+
+        this.totalSamples++;
+        this.droppedSamples += dropped;
+    }
+
+    /**
+     * Render all collected samples in folded stack format.
+     * @param perCpu Keep the leading per-CPU frame to split the graph by core.
+     */
+    toFolded(perCpu = false): string {
+        const merged = new Map<string, number>();
+
+        for (const [key, count] of this.stacks) {
+            const folded = perCpu ? key : key.substring(key.indexOf(';') + 1);
+            merged.set(folded, (merged.get(folded) || 0) + count);
+        }
+
+        return Array.from(merged.entries())
+            .sort((a, b) => b[1] - a[1])
+            .map(([stack, count]) => `${stack} ${count}`)
+            .join('\n') + '\n';
+    }
+
+    getStats() {
+        return {
+            totalSamples: this.totalSamples,
+            droppedSamples: this.droppedSamples,
+            uniqueStacks: this.stacks.size,
+            symbols: this.symbols.size
+        };
+    }
+
+    reset(): void {
+        this.stacks.clear();
+        this.totalSamples = 0;
+        this.droppedSamples = 0;
+    }
+}
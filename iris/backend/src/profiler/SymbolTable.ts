@@ -0,0 +1,80 @@
+import * as fs from 'fs';
+
+interface KernelSymbol {
+    address: bigint;
+    name: string;
+}
+
+/**
+ * Kernel symbol table loaded from the `nm -n` map generated next to the kernel
+ * binary (build/kernel/nyros-kernel.map). Used to turn sampled instruction
+ * pointers into function names.
+ */
+export class SymbolTable {
+    private symbols: KernelSymbol[] = [];
+
+    constructor(private readonly mapPath: string) {
+        this.reload();
+    }
+
+    /**
+     * Re-read the map file, e.g. after the kernel has been rebuilt.
+     */
+    reload(): void {
+        this.symbols = [];
+
+        if (!fs.existsSync(this.mapPath)) {
+            console.warn(`[Profiler] Kernel symbol map not found: ${this.mapPath}`);
+            return;
+        }
+
+        const lines = fs.readFileSync(this.mapPath, 'utf8').split('\n');
+        for (const line of lines) {
+            const parts = line.trim().split(/\s+/);
+            if (parts.length < 3) {
+                continue;
+            }
+
+            // Only code symbols are useful for attributing samples
+            const type = parts[1];
+            if (!['T', 't', 'W', 'w'].includes(type)) {
+                continue;
+            }
+
+            this.symbols.push({ address: BigInt(`0x${parts[0]}`), name: parts[2] });
+        }
+
+        // nm -n already sorts by address, but don't rely on it
+        this.symbols.sort((a, b) => (a.address < b.address ? -1 : a.address > b.address ? 1 : 0));
+    }
+
+    get size(): number {
+        return this.symbols.length;
+    }
+
+    /**
+     * Resolve an address to the name of the function containing it.
+     * Returns the raw hex address if no symbol covers it.
+     */
+    resolve(address: bigint): string {
+        let low = 0;
+        let high = this.symbols.length - 1;
+        let match = -1;
+
+        while (low <= high) {
+            const mid = (low + high) >> 1;
+            if (this.symbols[mid].address <= address) {
+                match = mid;
+                low = mid + 1;
+            } else {
+                high = mid - 1;
+            }
+        }
+
+        if (match === -1) {
+            return `0x${address.toString(16)}`;
+        }
+
+        return this.symbols[match].name;
+    }
+}
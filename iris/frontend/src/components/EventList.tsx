@@ -5,6 +5,10 @@ import { memo } from 'react';
 // Map event types to readable names (we'll expand this later)
 const EVENT_NAMES: Record<number, string> = {
   0x0001: 'IRIS_INIT',
+  0x0002: 'PROFILE_SAMPLE',
+  0x0003: 'TRACE_SCOPE',
+  0x0004: 'TRACEPOINT_STATS',
+  0x0005: 'BENCHMARK_RESULT',
   0x0100: 'BOOT_START',
   0x0101: 'GDT_LOADED',
   0x0102: 'TSS_LOADED',
@@ -12,6 +16,28 @@ const EVENT_NAMES: Record<number, string> = {
   0x0104: 'MEMORY_MAP_PARSED',
   0x0105: 'PMM_INIT_START',
   0x0106: 'PMM_INIT_DONE',
+  0x0107: 'BOOT_PHASE',
+  0x0108: 'BOOT_COMPLETE',
+  0x0109: 'CPU_FEATURES',
+  0x0200: 'CONTEXT_SWITCH',
+  0x0201: 'TASK_MIGRATED',
+  0x0202: 'SCHED_CPU_STATS',
+  0x0203: 'PROCESS_START',
+  0x0204: 'PROCESS_EXIT',
+  0x0205: 'CPU_UTILIZATION',
+  0x0400: 'CPU_EXCEPTION',
+  0x0401: 'IPI_SEND',
+  0x0402: 'IPI_RECEIVE',
+  0x0403: 'INTERRUPT_STATS',
+  0x0500: 'LOCK_STATS',
+  0x0600: 'PCI_DEVICE',
+  0x0601: 'PCI_ENUMERATION',
+  0x0602: 'BLOCK_DEVICE',
+  0x0603: 'BLOCK_QUEUE_STATS',
+  0x0604: 'BUFFER_CACHE_STATS',
+  0x0700: 'INITRAMFS_MOUNTED',
+  0x0800: 'NET_DEVICE',
+  0x0801: 'NET_QUEUE_STATS',
 };
 
 // Get severity color based on event type
@@ -0,0 +1,45 @@
+#ifdef ARCH_X86_64
+#ifndef ACPI_H
+#define ACPI_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+// Common header of every ACPI system description table
+struct acpi_table_header {
+    char signature[4];
+    uint32_t length; // Of the whole table, header included
+    uint8_t revision;
+    uint8_t checksum;
+    char oem_id[6];
+    char oem_table_id[8];
+    uint32_t oem_revision;
+    uint32_t creator_id;
+    uint32_t creator_revision;
+} __attribute__((packed));
+
+static_assert(sizeof(acpi_table_header) == 36, "ACPI table header must be 36 bytes");
+
+/**
+ * @brief Locates the root table through the RSDP the bootloader passed.
+ *
+ * The ACPI 2.0 RSDP (XSDT) is preferred over the ACPI 1.0 one (RSDT).
+ *
+ * @return true If a root table with a valid checksum was found.
+ * @return false If there is no RSDP tag or the root table is invalid.
+ */
+bool init_acpi();
+
+/**
+ * @brief Returns the first table with a signature and a valid checksum, or nullptr.
+ *
+ * Tables outside the boot-time mapping are identity mapped as needed, so the
+ * result stays valid for the lifetime of the kernel.
+ *
+ * @param signature Four-character table signature such as "APIC" or "MCFG".
+ */
+const acpi_table_header* find_acpi_table(const char* signature);
+} // namespace arch::x86
+
+#endif // ACPI_H
+#endif // ARCH_X86_64
@@ -0,0 +1,57 @@
+#ifdef ARCH_X86_64
+#ifndef MADT_H
+#define MADT_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+// Largest number of I/O APICs kept from the MADT
+inline constexpr size_t MAX_IO_APICS = 8;
+
+// ISA IRQ lines, identity mapped to GSIs 0-15 unless the MADT overrides them
+inline constexpr size_t ISA_IRQ_COUNT = 16;
+
+// MPS INTI flags of an interrupt source override
+inline constexpr uint16_t MADT_POLARITY_MASK = 0x3;
+inline constexpr uint16_t MADT_POLARITY_ACTIVE_LOW = 0x3;
+inline constexpr uint16_t MADT_TRIGGER_MASK = 0xC;
+inline constexpr uint16_t MADT_TRIGGER_LEVEL = 0xC;
+
+struct io_apic_info {
+    uint64_t address;  // Physical base of the register window
+    uint32_t gsi_base; // First global system interrupt of its inputs
+    uint8_t id;
+};
+
+// Where an ISA IRQ arrives at the I/O APICs
+struct isa_irq_route {
+    uint32_t gsi;
+    bool active_low;
+    bool level_triggered;
+};
+
+// What the MADT describes about the interrupt controllers
+struct madt_info {
+    io_apic_info io_apics[MAX_IO_APICS];
+    size_t io_apic_count;
+    isa_irq_route isa_irqs[ISA_IRQ_COUNT];
+    uint32_t cpu_count; // Enabled or online-capable local APICs
+    bool found;
+};
+
+/**
+ * @brief Records the entries of the MADT, called once after init_acpi().
+ *
+ * @return true If a MADT with a valid checksum was found.
+ * @return false If there is no MADT, ISA IRQs then keep their identity routes.
+ */
+bool init_madt();
+
+/**
+ * @brief Returns the interrupt controller layout recorded by init_madt().
+ */
+const madt_info* madt();
+} // namespace arch::x86
+
+#endif // MADT_H
+#endif // ARCH_X86_64
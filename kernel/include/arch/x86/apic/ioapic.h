@@ -0,0 +1,66 @@
+#ifdef ARCH_X86_64
+#ifndef IOAPIC_H
+#define IOAPIC_H
+
+#include <arch/x86/irq/irq.h>
+#include <core/types.h>
+
+namespace arch::x86 {
+// Largest number of global system interrupts that can be routed
+inline constexpr size_t MAX_GSIS = 256;
+
+/**
+ * @brief Maps every I/O APIC the MADT lists and masks all of their inputs.
+ *
+ * Called once on the BSP after init_madt() and init_lapic().
+ *
+ * @return true If at least one I/O APIC is ready, device interrupts then bypass the legacy PIC.
+ * @return false If the MADT lists none or none could be mapped.
+ */
+bool init_ioapics();
+
+/**
+ * @brief Returns whether init_ioapics() found an I/O APIC.
+ */
+bool ioapic_available();
+
+/**
+ * @brief Routes a global system interrupt to a handler on a CPU and unmasks it.
+ *
+ * @param gsi Global system interrupt, the I/O APIC input plus its GSI base.
+ * @param active_low Polarity of the input, PCI interrupt lines are active low.
+ * @param level_triggered Trigger mode of the input, PCI interrupt lines are level triggered.
+ * @param cpu Logical CPU to deliver the interrupt to.
+ * @param name Source name for interrupt statistics, see allocate_irq_vector().
+ * @return true If the input was routed.
+ * @return false If no I/O APIC has the input, it is already routed or the CPU has no free vector.
+ */
+bool route_gsi(uint32_t gsi, bool active_low, bool level_triggered, int cpu,
+               irq_handler_t handler, void* context, const char* name);
+
+/**
+ * @brief Routes a legacy ISA IRQ, applying the MADT's interrupt source overrides.
+ *
+ * @param irq ISA IRQ line (0-15).
+ */
+bool route_isa_irq(uint8_t irq, int cpu, irq_handler_t handler, void* context, const char* name);
+
+/**
+ * @brief Moves a routed global system interrupt to another CPU.
+ *
+ * A vector is allocated on the new CPU before the entry is repointed, the
+ * old vector is freed afterwards.
+ *
+ * @return true If the interrupt is now delivered to `cpu`.
+ * @return false If the input is not routed or the CPU has no free vector.
+ */
+bool set_gsi_affinity(uint32_t gsi, int cpu);
+
+/**
+ * @brief Masks a routed global system interrupt and frees its vector.
+ */
+void unroute_gsi(uint32_t gsi);
+} // namespace arch::x86
+
+#endif // IOAPIC_H
+#endif // ARCH_X86_64
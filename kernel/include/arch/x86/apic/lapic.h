@@ -0,0 +1,129 @@
+#ifdef ARCH_X86_64
+#ifndef LAPIC_H
+#define LAPIC_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+// Local APIC register offsets (xAPIC MMIO layout)
+inline constexpr uint32_t LAPIC_REG_ID = 0x020;
+inline constexpr uint32_t LAPIC_REG_VERSION = 0x030;
+inline constexpr uint32_t LAPIC_REG_TASK_PRIORITY = 0x080;
+inline constexpr uint32_t LAPIC_REG_EOI = 0x0B0;
+inline constexpr uint32_t LAPIC_REG_SPURIOUS = 0x0F0;
+inline constexpr uint32_t LAPIC_REG_ERROR_STATUS = 0x280;
+inline constexpr uint32_t LAPIC_REG_ICR_LOW = 0x300;
+inline constexpr uint32_t LAPIC_REG_ICR_HIGH = 0x310;
+inline constexpr uint32_t LAPIC_REG_LVT_TIMER = 0x320;
+inline constexpr uint32_t LAPIC_REG_LVT_LINT0 = 0x350;
+inline constexpr uint32_t LAPIC_REG_LVT_LINT1 = 0x360;
+inline constexpr uint32_t LAPIC_REG_LVT_ERROR = 0x370;
+inline constexpr uint32_t LAPIC_REG_TIMER_INITIAL_COUNT = 0x380;
+inline constexpr uint32_t LAPIC_REG_TIMER_CURRENT_COUNT = 0x390;
+inline constexpr uint32_t LAPIC_REG_TIMER_DIVIDE = 0x3E0;
+
+// LVT flags
+inline constexpr uint32_t LAPIC_LVT_MASKED = 1U << 16;
+inline constexpr uint32_t LAPIC_LVT_TIMER_PERIODIC = 1U << 17;
+inline constexpr uint32_t LAPIC_LVT_DELIVERY_EXTINT = 0x7U << 8;
+
+// Interrupt command register fields
+inline constexpr uint32_t LAPIC_ICR_DELIVERY_INIT = 0x5U << 8;
+inline constexpr uint32_t LAPIC_ICR_DELIVERY_STARTUP = 0x6U << 8;
+inline constexpr uint32_t LAPIC_ICR_DELIVERY_PENDING = 1U << 12;
+inline constexpr uint32_t LAPIC_ICR_LEVEL_ASSERT = 1U << 14;
+inline constexpr uint32_t LAPIC_ICR_DEST_ALL_EXCLUDING_SELF = 0x3U << 18;
+
+// Spurious interrupt vector register flags
+inline constexpr uint32_t LAPIC_SOFTWARE_ENABLE = 1U << 8;
+
+// Interrupt vectors owned by the local APIC
+inline constexpr uint8_t LAPIC_TIMER_VECTOR = 0x30;
+inline constexpr uint8_t LAPIC_ERROR_VECTOR = 0xFE;
+inline constexpr uint8_t LAPIC_SPURIOUS_VECTOR = 0xFF;
+
+// Frequency of the periodic kernel tick
+inline constexpr uint32_t LAPIC_TIMER_FREQUENCY_HZ = 100;
+
+/**
+ * @brief Enables the local APIC of the bootstrapping processor.
+ *
+ * Switches to x2APIC mode if the CPU supports it, otherwise maps the xAPIC
+ * register page. Then software-enables the APIC and calibrates the APIC
+ * timer against PIT channel 2. Must run before start_application_processors().
+ *
+ * @return true If the local APIC is ready for use.
+ * @return false If the register page could not be mapped.
+ */
+bool init_lapic();
+
+/**
+ * @brief Enables the local APIC of an application processor.
+ *
+ * The mode, register page mapping and timer calibration of the BSP are reused.
+ */
+void init_ap_lapic();
+
+uint32_t lapic_read(uint32_t reg);
+void lapic_write(uint32_t reg, uint32_t value);
+
+/**
+ * @brief Returns the APIC ID of the calling CPU, 32 bits wide in x2APIC mode.
+ */
+uint32_t lapic_id();
+
+/**
+ * @brief Returns whether the local APICs run in x2APIC mode.
+ */
+bool x2apic_enabled();
+
+/**
+ * @brief Lets the legacy PIC deliver its interrupts through LINT0 of the calling CPU.
+ *
+ * Puts the BSP in virtual wire mode so legacy device IRQs unmasked with
+ * enable_legacy_irq() reach the CPU until an I/O APIC driver takes over.
+ * Such interrupts are acknowledged at the PIC, not with lapic_send_eoi().
+ */
+void lapic_route_legacy_pic();
+
+/**
+ * @brief Sends an inter-processor interrupt and waits until the local APIC accepted it.
+ *
+ * @param destination APIC ID of the target, ignored for destination shorthands.
+ * @param command Low half of the interrupt command register (vector, delivery mode, shorthand).
+ */
+void lapic_send_ipi(uint32_t destination, uint32_t command);
+
+/**
+ * @brief Signals end-of-interrupt for the interrupt currently being serviced.
+ */
+void lapic_send_eoi();
+
+/**
+ * @brief Starts the local APIC timer in periodic mode on the calling CPU.
+ *
+ * @param frequency_hz Number of timer interrupts per second.
+ */
+void start_lapic_timer(uint32_t frequency_hz);
+
+/**
+ * @brief Masks and stops the local APIC timer on the calling CPU.
+ */
+void stop_lapic_timer();
+
+/**
+ * @brief Returns the calibrated number of APIC timer ticks per second (divide by 16).
+ */
+uint64_t lapic_timer_frequency();
+
+/**
+ * @brief Returns the number of TSC ticks per second.
+ *
+ * The TSC is calibrated against the same PIT window as the APIC timer, so
+ * this returns 0 until init_lapic has run.
+ */
+uint64_t tsc_frequency();
+} // namespace arch::x86
+
+#endif // LAPIC_H
+#endif // ARCH_X86_64
@@ -0,0 +1,208 @@
+#ifdef ARCH_X86_64
+#ifndef CPU_H
+#define CPU_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+// Model specific registers
+inline constexpr uint32_t IA32_APIC_BASE_MSR = 0x1B;
+inline constexpr uint32_t IA32_EFER_MSR = 0xC0000080;
+inline constexpr uint32_t IA32_STAR_MSR = 0xC0000081;
+inline constexpr uint32_t IA32_LSTAR_MSR = 0xC0000082;
+inline constexpr uint32_t IA32_FMASK_MSR = 0xC0000084;
+inline constexpr uint32_t IA32_FS_BASE_MSR = 0xC0000100;
+inline constexpr uint32_t IA32_GS_BASE_MSR = 0xC0000101;
+inline constexpr uint32_t IA32_KERNEL_GS_BASE_MSR = 0xC0000102;
+
+// IA32_EFER bits
+inline constexpr uint64_t EFER_SYSCALL_ENABLE = 1ULL << 0;
+
+// RFLAGS bits
+inline constexpr uint64_t RFLAGS_TRAP = 1ULL << 8;
+inline constexpr uint64_t RFLAGS_INTERRUPT_ENABLE = 1ULL << 9;
+inline constexpr uint64_t RFLAGS_DIRECTION = 1ULL << 10;
+inline constexpr uint64_t RFLAGS_ALIGNMENT_CHECK = 1ULL << 18;
+
+/**
+ * @brief Reads the 64-bit value of a model specific register.
+ *
+ * @param msr The index of the MSR to read.
+ * @return uint64_t The current value of the MSR.
+ */
+inline uint64_t read_msr(uint32_t msr) {
+    uint32_t low;
+    uint32_t high;
+    asm volatile("rdmsr" : "=a"(low), "=d"(high) : "c"(msr));
+    return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+/**
+ * @brief Writes a 64-bit value into a model specific register.
+ *
+ * @param msr The index of the MSR to write.
+ * @param value The value to store in the MSR.
+ */
+inline void write_msr(uint32_t msr, uint64_t value) {
+    asm volatile("wrmsr"
+                 :
+                 : "c"(msr), "a"(static_cast<uint32_t>(value)),
+                   "d"(static_cast<uint32_t>(value >> 32))
+                 : "memory");
+}
+
+/**
+ * @brief Reads the Time Stamp Counter.
+ *
+ * RDTSC is not serializing, so the read may be reordered with surrounding
+ * instructions by a few cycles. This is acceptable for sampling and coarse
+ * duration measurements.
+ *
+ * @return uint64_t The current TSC value.
+ */
+inline uint64_t rdtsc() {
+    uint32_t low;
+    uint32_t high;
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+    return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+/**
+ * @brief Executes the CPUID instruction for the given leaf and subleaf.
+ */
+inline void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t* eax, uint32_t* ebx, uint32_t* ecx,
+                  uint32_t* edx) {
+    asm volatile("cpuid"
+                 : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx)
+                 : "a"(leaf), "c"(subleaf));
+}
+
+/**
+ * @brief Enables maskable hardware interrupts on the current CPU.
+ */
+inline void enable_interrupts() {
+    asm volatile("sti" ::: "memory");
+}
+
+/**
+ * @brief Disables maskable hardware interrupts on the current CPU.
+ */
+inline void disable_interrupts() {
+    asm volatile("cli" ::: "memory");
+}
+
+/**
+ * @brief Returns the current value of the RFLAGS register.
+ */
+inline uint64_t read_rflags() {
+    uint64_t rflags;
+    asm volatile("pushfq; pop %0" : "=r"(rflags));
+    return rflags;
+}
+
+/**
+ * @brief Disables interrupts and returns the previous RFLAGS for restore_interrupts().
+ */
+inline uint64_t save_and_disable_interrupts() {
+    uint64_t rflags = read_rflags();
+    disable_interrupts();
+    return rflags;
+}
+
+/**
+ * @brief Re-enables interrupts if they were enabled when `rflags` was saved.
+ */
+inline void restore_interrupts(uint64_t rflags) {
+    if (rflags & RFLAGS_INTERRUPT_ENABLE) {
+        enable_interrupts();
+    }
+}
+
+/**
+ * @brief Spin-wait hint that reduces power and memory order violation penalties.
+ */
+inline void cpu_relax() {
+    asm volatile("pause" ::: "memory");
+}
+
+/**
+ * @brief Halts the current CPU until the next interrupt arrives.
+ */
+inline void halt() {
+    asm volatile("hlt" ::: "memory");
+}
+
+/**
+ * @brief Enables interrupts and halts in one step.
+ *
+ * STI only takes effect after the following instruction, so an interrupt that
+ * became pending while they were disabled wakes the HLT instead of being
+ * serviced before it and lost as a wakeup.
+ */
+inline void enable_interrupts_and_halt() {
+    asm volatile("sti; hlt" ::: "memory");
+}
+
+/**
+ * @brief Arms address monitoring on the cache line containing `address` for a following mwait().
+ */
+inline void monitor(const volatile void* address) {
+    asm volatile("monitor" : : "a"(address), "c"(0), "d"(0) : "memory");
+}
+
+/**
+ * @brief Waits until the monitored cache line is written or another break event occurs.
+ *
+ * @param hints Target C-state in EAX, 0 requests C1.
+ * @param extensions ECX, bit 0 makes an interrupt end the wait even while interrupts are disabled.
+ */
+inline void mwait(uint32_t hints, uint32_t extensions) {
+    asm volatile("mwait" : : "a"(hints), "c"(extensions) : "memory");
+}
+
+inline uint64_t read_cr0() {
+    uint64_t cr0;
+    asm volatile("mov %%cr0, %0" : "=r"(cr0));
+    return cr0;
+}
+
+inline void write_cr0(uint64_t cr0) {
+    asm volatile("mov %0, %%cr0" : : "r"(cr0) : "memory");
+}
+
+inline uint64_t read_cr2() {
+    uint64_t cr2;
+    asm volatile("mov %%cr2, %0" : "=r"(cr2));
+    return cr2;
+}
+
+inline uint64_t read_cr3() {
+    uint64_t cr3;
+    asm volatile("mov %%cr3, %0" : "=r"(cr3));
+    return cr3;
+}
+
+inline void write_cr3(uint64_t cr3) {
+    asm volatile("mov %0, %%cr3" : : "r"(cr3) : "memory");
+}
+
+inline uint64_t read_cr4() {
+    uint64_t cr4;
+    asm volatile("mov %%cr4, %0" : "=r"(cr4));
+    return cr4;
+}
+
+inline void write_cr4(uint64_t cr4) {
+    asm volatile("mov %0, %%cr4" : : "r"(cr4) : "memory");
+}
+
+/**
+ * @brief Invalidates the TLB entry that maps the given virtual address.
+ */
+inline void invlpg(uint64_t virt) {
+    asm volatile("invlpg (%0)" : : "r"(virt) : "memory");
+}
+} // namespace arch::x86
+
+#endif // CPU_H
+#endif // ARCH_X86_64
@@ -0,0 +1,123 @@
+#ifdef ARCH_X86_64
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+/*
+    CPUID is serializing and costs hundreds of cycles under a hypervisor, so
+    every CPU runs it once at bring-up and stores the registers that carry
+    feature flags. Everything else asks has_feature(), which only tests a bit
+    of the BSP's copy. Code on hot paths goes one step further and selects
+    its implementation with a static key (static_key.h) at boot.
+*/
+
+// CPUID output registers kept per CPU, a feature is a bit in one of them
+enum class cpuid_word : uint8_t {
+    LEAF_1_ECX = 0,
+    LEAF_1_EDX = 1,
+    LEAF_5_ECX = 2,     // MONITOR/MWAIT
+    LEAF_7_EBX = 3,     // Structured extended features, subleaf 0
+    LEAF_7_ECX = 4,
+    LEAF_7_EDX = 5,
+    EXT_LEAF_1_ECX = 6, // 0x80000001
+    EXT_LEAF_1_EDX = 7,
+    EXT_LEAF_7_EDX = 8, // 0x80000007, advanced power management
+};
+
+inline constexpr size_t CPUID_WORD_COUNT = 9;
+
+constexpr uint16_t cpuid_bit(cpuid_word word, uint8_t bit) {
+    return static_cast<uint16_t>(static_cast<uint16_t>(word) * 32 + bit);
+}
+
+// Feature flags by the word and bit CPUID reports them in
+enum class cpu_feature : uint16_t {
+    MONITOR = cpuid_bit(cpuid_word::LEAF_1_ECX, 3),
+    PCID = cpuid_bit(cpuid_word::LEAF_1_ECX, 17),
+    X2APIC = cpuid_bit(cpuid_word::LEAF_1_ECX, 21),
+    TSC_DEADLINE = cpuid_bit(cpuid_word::LEAF_1_ECX, 24),
+    XSAVE = cpuid_bit(cpuid_word::LEAF_1_ECX, 26),
+    RDRAND = cpuid_bit(cpuid_word::LEAF_1_ECX, 30),
+    HYPERVISOR = cpuid_bit(cpuid_word::LEAF_1_ECX, 31),
+    TSC = cpuid_bit(cpuid_word::LEAF_1_EDX, 4),
+    APIC = cpuid_bit(cpuid_word::LEAF_1_EDX, 9),
+    PGE = cpuid_bit(cpuid_word::LEAF_1_EDX, 13),
+    MWAIT_EXTENSIONS = cpuid_bit(cpuid_word::LEAF_5_ECX, 0),
+    MWAIT_INTERRUPT_BREAK = cpuid_bit(cpuid_word::LEAF_5_ECX, 1),
+    FSGSBASE = cpuid_bit(cpuid_word::LEAF_7_EBX, 0),
+    SMEP = cpuid_bit(cpuid_word::LEAF_7_EBX, 7),
+    ERMS = cpuid_bit(cpuid_word::LEAF_7_EBX, 9),
+    INVPCID = cpuid_bit(cpuid_word::LEAF_7_EBX, 10),
+    SMAP = cpuid_bit(cpuid_word::LEAF_7_EBX, 20),
+    FSRM = cpuid_bit(cpuid_word::LEAF_7_EDX, 4),
+    SYSCALL = cpuid_bit(cpuid_word::EXT_LEAF_1_EDX, 11),
+    NX = cpuid_bit(cpuid_word::EXT_LEAF_1_EDX, 20),
+    PAGE_1GB = cpuid_bit(cpuid_word::EXT_LEAF_1_EDX, 26),
+    RDTSCP = cpuid_bit(cpuid_word::EXT_LEAF_1_EDX, 27),
+    INVARIANT_TSC = cpuid_bit(cpuid_word::EXT_LEAF_7_EDX, 8),
+};
+
+// What one CPU reported at bring-up
+struct cpu_features {
+    uint32_t words[CPUID_WORD_COUNT];
+    uint32_t max_leaf;
+    uint32_t max_extended_leaf;
+    char vendor[12];
+    uint8_t family; // Display family, extended family included
+    uint8_t model;  // Display model, extended model included
+    uint8_t stepping;
+    bool probed;
+};
+
+// Payload of EVENT_CPU_FEATURES
+struct cpu_features_payload {
+    uint32_t words[CPUID_WORD_COUNT];
+    uint32_t max_leaf;
+    uint32_t max_extended_leaf;
+    char vendor[12];
+    uint8_t family;
+    uint8_t model;
+    uint8_t stepping;
+    uint8_t mismatch; // 1 if this CPU lacks a feature the BSP has
+    uint32_t reserved;
+} __attribute__((packed));
+
+static_assert(sizeof(cpu_features_payload) == 64, "CPU features payload must be 64 bytes");
+
+// The BSP's features, written once by init_cpu_features(0) and only read afterwards
+extern cpu_features g_boot_cpu_features;
+
+/**
+ * @brief Runs CPUID on the calling CPU and records its features.
+ *
+ * Called once per CPU before anything on it asks has_feature(): by
+ * arch_first_stage_init() on the BSP and by ap_main() on every AP.
+ */
+void init_cpu_features(int cpu);
+
+/**
+ * @brief Returns whether the BSP reported a feature, without running CPUID.
+ *
+ * APs are expected to be the same model; emit_cpu_features() flags any that
+ * lack one of the BSP's features.
+ */
+inline bool has_feature(cpu_feature feature) {
+    auto index = static_cast<uint16_t>(feature);
+    return (g_boot_cpu_features.words[index / 32] >> (index % 32)) & 1;
+}
+
+/**
+ * @brief Returns the features a CPU reported, nullptr if it has not been probed.
+ */
+const cpu_features* cpu_features_of(int cpu);
+
+/**
+ * @brief Emits one EVENT_CPU_FEATURES event per probed CPU.
+ */
+void emit_cpu_features();
+} // namespace arch::x86
+
+#endif // CPU_FEATURES_H
+#endif // ARCH_X86_64
@@ -0,0 +1,91 @@
+#ifdef ARCH_X86_64
+#ifndef STATIC_KEY_H
+#define STATIC_KEY_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+/*
+    A static key is a boolean decided once at boot, typically from a CPU
+    feature. Every test of it compiles to a 5-byte instruction in the code
+    stream, a NOP or a JMP to the other branch, and an entry in the
+    .static_keys section naming that site. set_static_key() rewrites the
+    sites of its key, so the chosen path then costs no load, compare or
+    branch prediction slot at run time.
+
+    Kernel text is mapped writable and patching happens before the APs run,
+    so a site is rewritten in place without any cross-modifying code protocol.
+*/
+
+// Disabled until set_static_key(), a zero-initialized key is disabled
+struct static_key {
+    bool enabled;
+};
+
+// One site testing a key, emitted into .static_keys next to the site
+struct static_key_entry {
+    uint64_t site;   // Address of the 5-byte NOP or JMP
+    uint64_t target; // Branch the JMP goes to
+    uint64_t key;    // static_key address, bit 0 set for a static_branch_likely() site
+};
+
+inline constexpr size_t STATIC_KEY_SITE_SIZE = 5;
+
+/**
+ * @brief Tests a key expected to be disabled, the enabled branch is laid out off the hot path.
+ *
+ * The site is a NOP until the key is enabled, then a JMP to the enabled branch.
+ */
+[[gnu::always_inline]] inline bool static_branch_unlikely(static_key& key) {
+    asm goto("1: .byte 0x0f, 0x1f, 0x44, 0x00, 0x00\n\t"
+             ".pushsection .static_keys, \"aw\"\n\t"
+             ".balign 8\n\t"
+             ".quad 1b, %l[enabled], %c0\n\t"
+             ".popsection"
+             :
+             : "i"(&key)
+             :
+             : enabled);
+    return false;
+enabled:
+    return true;
+}
+
+/**
+ * @brief Tests a key expected to be enabled, the enabled branch is the fall-through path.
+ *
+ * The site is a JMP to the disabled branch until the key is enabled, then a NOP.
+ */
+[[gnu::always_inline]] inline bool static_branch_likely(static_key& key) {
+    asm goto("1: .byte 0xe9\n\t"
+             ".long %l[disabled] - 2f\n\t"
+             "2:\n\t"
+             ".pushsection .static_keys, \"aw\"\n\t"
+             ".balign 8\n\t"
+             ".quad 1b, %l[disabled], %c0 + 1\n\t"
+             ".popsection"
+             :
+             : "i"(&key)
+             :
+             : disabled);
+    return true;
+disabled:
+    return false;
+}
+
+/**
+ * @brief Enables or disables a key and rewrites every site that tests it.
+ *
+ * Boot only: must run on the BSP before start_application_processors(), no
+ * other CPU may be executing the sites being rewritten.
+ */
+void set_static_key(static_key* key, bool enabled);
+
+/**
+ * @brief Returns the number of sites in the kernel image that test a key.
+ */
+size_t static_key_site_count();
+} // namespace arch::x86
+
+#endif // STATIC_KEY_H
+#endif // ARCH_X86_64
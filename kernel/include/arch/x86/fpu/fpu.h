@@ -0,0 +1,69 @@
+#ifdef ARCH_X86_64
+#ifndef FPU_H
+#define FPU_H
+
+#include <arch/x86/cpu/cpu.h>
+#include <core/types.h>
+
+namespace arch::x86 {
+inline constexpr uint64_t CR0_MONITOR_COPROCESSOR = 1ULL << 1;
+inline constexpr uint64_t CR0_EMULATION = 1ULL << 2;
+inline constexpr uint64_t CR0_TASK_SWITCHED = 1ULL << 3;
+inline constexpr uint64_t CR0_NUMERIC_ERROR = 1ULL << 5;
+
+inline constexpr uint64_t CR4_OSFXSR = 1ULL << 9;
+inline constexpr uint64_t CR4_OSXMMEXCPT = 1ULL << 10;
+
+// Size of the FXSAVE area holding the x87, MMX and SSE registers
+inline constexpr size_t FPU_STATE_SIZE = 512;
+
+// Saved x87/SSE register file of one thread, FXSAVE requires 16-byte alignment
+struct alignas(16) fpu_state {
+    uint8_t data[FPU_STATE_SIZE];
+};
+
+/**
+ * @brief Enables x87 and SSE on the calling CPU with CR0.TS set.
+ *
+ * The first FPU or SIMD instruction after this raises #NM, which is where the
+ * scheduler loads the state of the thread that used it. The BSP also records
+ * the power-on register state that new threads start from.
+ */
+void init_fpu();
+
+/**
+ * @brief Copies the initial FPU state recorded by init_fpu() into `state`.
+ */
+void reset_fpu_state(fpu_state* state);
+
+/**
+ * @brief Saves the FPU and SSE registers of the calling CPU.
+ */
+inline void save_fpu_state(fpu_state* state) {
+    asm volatile("fxsave64 %0" : "=m"(*state));
+}
+
+/**
+ * @brief Loads the FPU and SSE registers of the calling CPU.
+ */
+inline void restore_fpu_state(const fpu_state* state) {
+    asm volatile("fxrstor64 %0" : : "m"(*state));
+}
+
+/**
+ * @brief Sets CR0.TS so the next FPU or SIMD instruction raises #NM.
+ */
+inline void set_task_switched() {
+    write_cr0(read_cr0() | CR0_TASK_SWITCHED);
+}
+
+/**
+ * @brief Clears CR0.TS so FPU and SIMD instructions execute without trapping.
+ */
+inline void clear_task_switched() {
+    asm volatile("clts" ::: "memory");
+}
+} // namespace arch::x86
+
+#endif // FPU_H
+#endif // ARCH_X86_64
@@ -185,6 +185,22 @@ void init_gdt(int cpu, uint64_t system_stack);
  * interrupts and switching tasks in protected or long mode.
  */
 void reload_task_register();
+
+/**
+ * @brief Sets the stack the CPU switches to when an interrupt arrives in user mode.
+ * @param cpu The CPU whose TSS is updated, must be the calling CPU.
+ * @param rsp0 Top of the kernel stack of the thread about to run.
+ *
+ * Only the rsp0 field of the TSS and the matching per-CPU slot used by the
+ * SYSCALL entry are written. The CPU reads rsp0 on every privilege change, so
+ * the Task Register does not need to be reloaded.
+ */
+void set_kernel_stack(int cpu, uint64_t rsp0);
+
+/**
+ * @brief Returns the rsp0 field of a CPU's TSS.
+ */
+uint64_t kernel_stack(int cpu);
 } // namespace arch::x86
 
 #endif // GDT_H
@@ -0,0 +1,125 @@
+#ifdef ARCH_X86_64
+#ifndef IDT_H
+#define IDT_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+inline constexpr size_t IDT_ENTRIES = 256;
+
+// Architecturally defined exception vectors
+inline constexpr uint8_t EXCEPTION_DIVIDE_ERROR = 0;
+inline constexpr uint8_t EXCEPTION_DEBUG = 1;
+inline constexpr uint8_t EXCEPTION_NMI = 2;
+inline constexpr uint8_t EXCEPTION_BREAKPOINT = 3;
+inline constexpr uint8_t EXCEPTION_INVALID_OPCODE = 6;
+inline constexpr uint8_t EXCEPTION_DEVICE_NOT_AVAILABLE = 7;
+inline constexpr uint8_t EXCEPTION_DOUBLE_FAULT = 8;
+inline constexpr uint8_t EXCEPTION_GENERAL_PROTECTION = 13;
+inline constexpr uint8_t EXCEPTION_PAGE_FAULT = 14;
+
+// First vector available for external and software interrupts
+inline constexpr uint8_t IRQ_BASE_VECTOR = 32;
+
+// Gate type attributes
+inline constexpr uint8_t IDT_INTERRUPT_GATE = 0x8E; // Present, DPL0, 64-bit interrupt gate
+inline constexpr uint8_t IDT_TRAP_GATE = 0x8F;      // Present, DPL0, 64-bit trap gate
+
+struct idt_desc {
+    uint16_t limit; // Size of the IDT
+    uint64_t base;  // Base address of the IDT
+} __attribute__((packed));
+
+struct idt_gate_descriptor {
+    uint16_t offset_low;
+    uint16_t selector;
+    uint8_t ist;       // Interrupt Stack Table index (0 = don't switch stacks)
+    uint8_t type_attr; // Gate type, DPL and present bit
+    uint16_t offset_mid;
+    uint32_t offset_high;
+    uint32_t reserved;
+} __attribute__((packed));
+
+static_assert(sizeof(idt_gate_descriptor) == 16, "IDT gate descriptor must be 16 bytes");
+
+/*
+    Register state saved by the common interrupt entry stub (isr.S).
+    The layout mirrors the push order of the stub, lowest address first.
+*/
+struct interrupt_frame {
+    uint64_t r15;
+    uint64_t r14;
+    uint64_t r13;
+    uint64_t r12;
+    uint64_t r11;
+    uint64_t r10;
+    uint64_t r9;
+    uint64_t r8;
+    uint64_t rbp;
+    uint64_t rdi;
+    uint64_t rsi;
+    uint64_t rdx;
+    uint64_t rcx;
+    uint64_t rbx;
+    uint64_t rax;
+
+    uint64_t vector;
+    uint64_t error_code; // Pushed by the CPU for some exceptions, 0 otherwise
+
+    // Pushed by the CPU on interrupt entry
+    uint64_t rip;
+    uint64_t cs;
+    uint64_t rflags;
+    uint64_t rsp;
+    uint64_t ss;
+} __attribute__((packed));
+
+static_assert(sizeof(interrupt_frame) == 22 * 8, "Unexpected interrupt frame size");
+
+using interrupt_handler_t = void (*)(interrupt_frame* frame);
+
+/**
+ * @brief Builds the Interrupt Descriptor Table and loads it on the calling CPU.
+ *
+ * Every vector is routed to a common entry stub that saves the general purpose
+ * registers and dispatches to the handler registered for that vector. Unhandled
+ * exceptions are reported over IRIS and halt the CPU.
+ */
+void init_idt();
+
+/**
+ * @brief Loads the already initialized IDT on the calling CPU.
+ *
+ * Used by application processors which share the IDT built by the BSP.
+ */
+void load_idt();
+
+/**
+ * @brief Registers a handler for an interrupt vector.
+ *
+ * The handler runs with interrupts disabled. Handlers of external interrupts
+ * are responsible for signaling end-of-interrupt to their controller.
+ *
+ * @param vector The interrupt vector to handle.
+ * @param handler The function to invoke, or nullptr to remove the handler.
+ */
+void register_interrupt_handler(uint8_t vector, interrupt_handler_t handler);
+
+/**
+ * @brief Reports an exception that cannot be handled over IRIS and halts the CPU.
+ *
+ * Used for vectors without a handler and by handlers that give up on a fault.
+ */
+[[noreturn]] void handle_unhandled_exception(interrupt_frame* frame);
+
+/**
+ * @brief Sets the Interrupt Stack Table index used when entering a vector.
+ *
+ * @param vector The interrupt vector to configure.
+ * @param ist IST slot (1-7) in the TSS, or 0 to stay on the current stack.
+ */
+void set_interrupt_stack(uint8_t vector, uint8_t ist);
+} // namespace arch::x86
+
+#endif // IDT_H
+#endif // ARCH_X86_64
@@ -0,0 +1,109 @@
+#ifdef ARCH_X86_64
+#ifndef IRQ_H
+#define IRQ_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+/*
+    Device interrupts get a vector on the CPU they should run on. Every CPU
+    has its own table of the vectors between DEVICE_VECTOR_FIRST and
+    DEVICE_VECTOR_LAST, so the same vector number can belong to different
+    devices on different CPUs and each CPU offers the whole range. A source
+    is steered to another core by allocating a vector there and pointing
+    the I/O APIC entry or the MSI message at it.
+*/
+
+// Above the legacy PIC range and the LAPIC timer, below the IPI and APIC vectors
+inline constexpr uint8_t DEVICE_VECTOR_FIRST = 0x40;
+inline constexpr uint8_t DEVICE_VECTOR_LAST = 0xEF;
+inline constexpr size_t DEVICE_VECTOR_COUNT = DEVICE_VECTOR_LAST - DEVICE_VECTOR_FIRST + 1;
+
+// Longest source name kept for EVENT_INTERRUPT_STATS, without the terminator
+inline constexpr size_t IRQ_NAME_LENGTH = 15;
+
+// Interval of EVENT_INTERRUPT_STATS reports
+inline constexpr uint64_t INTERRUPT_STATS_INTERVAL_MS = 1000;
+
+// Runs in interrupt context on the vector's CPU, end-of-interrupt is sent afterwards
+using irq_handler_t = void (*)(void* context);
+
+// A vector on one CPU, vector 0 if none is allocated
+struct irq_vector {
+    int cpu;
+    uint8_t vector;
+};
+
+// Address and data a device writes to raise an MSI or MSI-X interrupt
+struct msi_message {
+    uint64_t address;
+    uint32_t data;
+};
+
+// Payload of EVENT_INTERRUPT_STATS, one per CPU and vector that fired during the window
+struct interrupt_stats_payload {
+    uint64_t count;         // Since boot
+    uint64_t window_count;  // Since the previous report
+    uint64_t window_cycles; // TSC cycles since the previous report
+    uint8_t vector;
+    uint8_t reserved[7];
+    char name[IRQ_NAME_LENGTH + 1]; // Source of the vector, NUL-padded
+} __attribute__((packed));
+
+static_assert(sizeof(interrupt_stats_payload) == 48, "Interrupt stats payload must be 48 bytes");
+
+/**
+ * @brief Routes every device vector to the per-CPU dispatcher, called once on the BSP.
+ */
+void init_irq();
+
+/**
+ * @brief Allocates a free device vector on a CPU and installs its handler.
+ *
+ * @param cpu Logical CPU the interrupt will be delivered to.
+ * @param handler Called with `context` for every interrupt on the vector.
+ * @param name Source name for interrupt statistics, kept by pointer, truncated to IRQ_NAME_LENGTH.
+ * @param out Receives the allocated vector.
+ * @return true If a vector was allocated.
+ * @return false If the CPU is out of range or all its device vectors are in use.
+ */
+bool allocate_irq_vector(int cpu, irq_handler_t handler, void* context, const char* name,
+                         irq_vector* out);
+
+/**
+ * @brief Removes the handler of a vector and makes it available again.
+ *
+ * The source must be masked or pointed elsewhere first. An interrupt already
+ * in flight to the vector is acknowledged without running a handler.
+ */
+void free_irq_vector(irq_vector vector);
+
+/**
+ * @brief Returns the APIC ID interrupts for a logical CPU are addressed to.
+ */
+uint32_t irq_destination(int cpu);
+
+/**
+ * @brief Builds the MSI message that delivers an edge-triggered interrupt to a vector.
+ *
+ * @return true If the message was built.
+ * @return false If the CPU's APIC ID does not fit the 8-bit MSI destination field.
+ */
+bool compose_msi_message(irq_vector vector, msi_message* out);
+
+/**
+ * @brief Counts an interrupt on the calling CPU, called by the common interrupt entry.
+ */
+void count_interrupt(uint8_t vector);
+
+/**
+ * @brief Emits EVENT_INTERRUPT_STATS for every CPU and vector that fired since the last report.
+ *
+ * Does nothing until INTERRUPT_STATS_INTERVAL_MS passed since the last
+ * report. Must only be called from one CPU at a time, the BSP's idle loop.
+ */
+void flush_interrupt_stats();
+} // namespace arch::x86
+
+#endif // IRQ_H
+#endif // ARCH_X86_64
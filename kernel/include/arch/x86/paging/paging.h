@@ -0,0 +1,172 @@
+#ifdef ARCH_X86_64
+#ifndef PAGING_H
+#define PAGING_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+// Virtual base of the higher-half kernel mapping (must match nyros.ld)
+inline constexpr uint64_t KERNEL_OFFSET = 0xffffffff80000000;
+
+inline constexpr uint64_t PAGE_SIZE = 0x1000;
+inline constexpr uint64_t LARGE_PAGE_SIZE = 0x200000;
+inline constexpr uint64_t PAGE_TABLE_ENTRIES = 512;
+
+// Physical memory mapped by boot.S with 2MB pages, both identity and at KERNEL_OFFSET
+inline constexpr uint64_t BOOT_MAPPED_MEMORY_SIZE = 0x40000000;
+
+// User address spaces, PML4 entry 0 stays shared with the kernel for the identity and MMIO maps
+inline constexpr uint64_t USER_SPACE_START = 0x0000008000000000;
+inline constexpr uint64_t USER_SPACE_END = 0x0000800000000000;
+
+// Page table entry flags
+inline constexpr uint64_t PTE_PRESENT = 1ULL << 0;
+inline constexpr uint64_t PTE_WRITABLE = 1ULL << 1;
+inline constexpr uint64_t PTE_USER = 1ULL << 2;
+inline constexpr uint64_t PTE_WRITE_THROUGH = 1ULL << 3;
+inline constexpr uint64_t PTE_CACHE_DISABLE = 1ULL << 4;
+inline constexpr uint64_t PTE_ACCESSED = 1ULL << 5;
+inline constexpr uint64_t PTE_DIRTY = 1ULL << 6;
+inline constexpr uint64_t PTE_HUGE = 1ULL << 7;
+inline constexpr uint64_t PTE_GLOBAL = 1ULL << 8;
+inline constexpr uint64_t PTE_COPY_ON_WRITE = 1ULL << 9; // Software bit, shared until written
+inline constexpr uint64_t PTE_NO_EXECUTE = 1ULL << 63;
+inline constexpr uint64_t PTE_ADDRESS_MASK = 0x000FFFFFFFFFF000;
+inline constexpr uint64_t PTE_LARGE_ADDRESS_MASK = 0x000FFFFFFFE00000;
+
+// Flags used for memory-mapped device registers
+inline constexpr uint64_t PTE_MMIO_FLAGS =
+    PTE_PRESENT | PTE_WRITABLE | PTE_WRITE_THROUGH | PTE_CACHE_DISABLE | PTE_NO_EXECUTE;
+
+/**
+ * @brief Converts a physical address inside the boot-time kernel mapping
+ * (below BOOT_MAPPED_MEMORY_SIZE) to its higher-half virtual address.
+ */
+inline void* phys_to_virt(uint64_t phys) {
+    return reinterpret_cast<void*>(phys + KERNEL_OFFSET);
+}
+
+/**
+ * @brief Converts a higher-half kernel image virtual address to its physical address.
+ */
+inline uint64_t virt_to_phys(const void* virt) {
+    return reinterpret_cast<uint64_t>(virt) - KERNEL_OFFSET;
+}
+
+/**
+ * @brief Maps a single 4KB page into the currently active address space.
+ *
+ * Intermediate page tables that do not exist yet are taken from a small static
+ * pool reserved in the kernel image, so this function can be used before any
+ * physical memory allocator is available. A 2MB page covering the address is
+ * split into 4KB pages with the same attributes first. If `flags` contains
+ * PTE_USER, the intermediate entries on the way are made user-accessible too.
+ *
+ * @param virt Page-aligned virtual address to map.
+ * @param phys Page-aligned physical address to map it to.
+ * @param flags Page table entry flags for the final level entry.
+ * @return true If the page was mapped.
+ * @return false If the page table pool is exhausted or the address is covered by a 1GB page.
+ */
+bool map_page(uint64_t virt, uint64_t phys, uint64_t flags);
+
+/**
+ * @brief Identity maps a memory-mapped device region as uncacheable.
+ *
+ * @param phys Physical base address of the register block.
+ * @param size Size of the register block in bytes.
+ * @return void* Virtual address of the mapped region, or nullptr on failure.
+ */
+void* map_mmio(uint64_t phys, size_t size);
+
+/**
+ * @brief Identity maps a large memory-mapped device region as uncacheable with 2MB pages.
+ *
+ * Used for regions such as the PCIe configuration space, which would take a
+ * page table per 2MB with map_mmio(). Parts of the region that do not cover
+ * a whole 2MB page, or whose 2MB range already has a page table, are mapped
+ * with 4KB pages.
+ *
+ * @param phys Physical base address of the region.
+ * @param size Size of the region in bytes.
+ * @return void* Virtual address of the mapped region, or nullptr on failure.
+ */
+void* map_mmio_large(uint64_t phys, size_t size);
+
+/**
+ * @brief Returns the physical address of the kernel PML4 built by boot.S.
+ *
+ * Also the handle of the kernel address space, its ID is 0 (see tlb.h). Kernel
+ * threads and idle tasks run in it.
+ */
+uint64_t kernel_address_space();
+
+/**
+ * @brief Creates an empty user address space.
+ *
+ * The new PML4 comes from the physical frame allocator and shares every
+ * kernel entry (entry 0 and the upper half) with the kernel address space,
+ * so kernel mappings need no copying. Kernel top-level entries created later
+ * are not propagated.
+ *
+ * @return uint64_t Handle of the new address space, the PML4's physical address tagged with
+ * its address space ID, or 0 if physical memory or address space IDs are exhausted.
+ */
+uint64_t create_address_space();
+
+/**
+ * @brief Maps a single 4KB page into a user address space.
+ *
+ * Missing page tables are allocated from the physical frame allocator. The
+ * TLB entry is invalidated if the address space is the active one.
+ *
+ * @param pml4 Handle returned by create_address_space.
+ * @param virt Page-aligned virtual address between USER_SPACE_START and USER_SPACE_END.
+ * @param phys Page-aligned physical address to map it to.
+ * @param flags Page table entry flags for the final level entry.
+ * @return true If the page was mapped.
+ * @return false If a page table could not be allocated.
+ */
+bool map_user_page(uint64_t pml4, uint64_t virt, uint64_t phys, uint64_t flags);
+
+/**
+ * @brief Clones a user address space, sharing every mapped frame copy-on-write.
+ *
+ * Only the page tables are copied. Writable pages lose PTE_WRITABLE and gain
+ * PTE_COPY_ON_WRITE in both address spaces, and every shared frame gets one
+ * more reference. The source address space is flushed from every TLB with a
+ * single shootdown.
+ *
+ * @param pml4 Handle of the address space to clone.
+ * @return uint64_t Handle of the clone, or 0 if physical memory or address space IDs are
+ * exhausted.
+ */
+uint64_t clone_address_space(uint64_t pml4);
+
+/**
+ * @brief Resolves a write fault on a copy-on-write page.
+ *
+ * The last reference to a frame makes it writable in place, otherwise the
+ * page is copied into a new frame and the shared one loses a reference.
+ *
+ * @param pml4 Handle of the active address space.
+ * @param virt Faulting virtual address.
+ * @return true If the page is writable now.
+ * @return false If the page is not copy-on-write or no frame is left.
+ */
+bool resolve_copy_on_write(uint64_t pml4, uint64_t virt);
+
+/**
+ * @brief Frees a user address space and its page tables and drops a reference to every
+ * frame mapped in it.
+ *
+ * No task may run in the address space anymore, CPUs that still have it
+ * loaded in lazy TLB mode are switched away first.
+ *
+ * @param pml4 Handle returned by create_address_space.
+ */
+void destroy_address_space(uint64_t pml4);
+} // namespace arch::x86
+
+#endif // PAGING_H
+#endif // ARCH_X86_64
@@ -0,0 +1,121 @@
+#ifdef ARCH_X86_64
+#ifndef TLB_H
+#define TLB_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+inline constexpr uint64_t CR4_PCIDE = 1ULL << 17;
+
+// Loading CR3 with this bit set keeps the TLB entries tagged with the new PCID
+inline constexpr uint64_t CR3_NO_FLUSH = 1ULL << 63;
+
+/*
+    Address space handles are CR3 values: the PML4's physical address with an
+    address space ID in bits 0-11. With PCIDs enabled the ID is the PCID, so
+    entries of several address spaces coexist in the TLB. ID 0 belongs to the
+    kernel address space.
+*/
+inline constexpr size_t MAX_ADDRESS_SPACES = 128;
+inline constexpr uint64_t ADDRESS_SPACE_ID_MASK = 0xFFF;
+
+// Pages invalidated one by one, larger batches flush the whole address space instead
+inline constexpr size_t TLB_BATCH_MAX_PAGES = 32;
+
+// Invalidations of one address space collected by the caller and sent as a single shootdown
+struct tlb_batch {
+    uint64_t cr3;
+    uint64_t pages[TLB_BATCH_MAX_PAGES];
+    size_t count;
+    bool flush_all;
+};
+
+/**
+ * @brief Enables PCIDs on the calling CPU if supported and starts TLB tracking.
+ *
+ * The BSP also detects PCID and INVPCID support. Must run before the CPU
+ * loads any user address space.
+ */
+void init_tlb(int cpu);
+
+/**
+ * @brief Returns whether address spaces are tagged with PCIDs.
+ */
+bool pcid_enabled();
+
+/**
+ * @brief Returns whether the INVPCID instruction is used to flush one address space.
+ */
+bool invpcid_supported();
+
+/**
+ * @brief Allocates an address space ID for a new PML4.
+ *
+ * @return uint64_t The ID (1 to MAX_ADDRESS_SPACES - 1), or 0 if every ID is taken.
+ */
+uint64_t allocate_address_space_id();
+
+/**
+ * @brief Makes every CPU stop using an address space and frees its ID.
+ *
+ * CPUs that still have it loaded lazily switch to the kernel address space,
+ * so its page tables can be freed afterwards.
+ *
+ * @param cr3 Handle returned by create_address_space.
+ */
+void release_address_space_id(uint64_t cr3);
+
+/**
+ * @brief Loads an address space on the calling CPU, called with interrupts disabled.
+ *
+ * Switching to the kernel address space leaves the previous one loaded (lazy
+ * TLB mode): kernel mappings are identical everywhere and the next user task
+ * often belongs to the same process. The TLB entries of an address space
+ * survive switching away and back unless it was changed in between.
+ *
+ * @param cr3 Handle returned by create_address_space, or kernel_address_space().
+ */
+void activate_address_space(uint64_t cr3);
+
+/**
+ * @brief Invalidates one page of an address space on every CPU that may cache it.
+ *
+ * Only CPUs running the address space are interrupted (smp_call_function),
+ * the others flush it the next time they load it. Returns once every
+ * interrupted CPU is done.
+ */
+void flush_tlb_page(uint64_t cr3, uint64_t virt);
+
+/**
+ * @brief Invalidates every user page of an address space on every CPU that may cache it.
+ */
+void flush_tlb_all(uint64_t cr3);
+
+/**
+ * @brief Adds a page to a batch, which turns into a full flush once it overflows.
+ */
+inline void tlb_batch_add(tlb_batch* batch, uint64_t virt) {
+    if (batch->count < TLB_BATCH_MAX_PAGES) {
+        batch->pages[batch->count] = virt;
+    } else {
+        batch->flush_all = true;
+    }
+    ++batch->count;
+}
+
+/**
+ * @brief Invalidates every page of a batch with a single IPI per CPU and empties it.
+ */
+void flush_tlb_batch(tlb_batch* batch);
+
+/**
+ * @brief Turns keeping TLB entries across address space switches on or off.
+ *
+ * Off, every switch to another address space flushes as without PCIDs.
+ * Used by benchmarks to measure what PCIDs save.
+ */
+void set_tlb_retention(bool enabled);
+} // namespace arch::x86
+
+#endif // TLB_H
+#endif // ARCH_X86_64
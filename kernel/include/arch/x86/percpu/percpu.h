@@ -0,0 +1,165 @@
+#ifdef ARCH_X86_64
+#ifndef PERCPU_H
+#define PERCPU_H
+
+#include <core/types.h>
+
+/*
+    Per-CPU variables live in the .percpu section of the kernel image, which acts
+    as a template. Every CPU receives its own copy of that section and the GS base
+    of that CPU points at the start of its copy, so a variable is reached through
+    its offset from __per_cpu_start (see this_cpu_read in common.S).
+*/
+#define DEFINE_PER_CPU(type, name) __attribute__((section(".percpu"))) type name
+#define DECLARE_PER_CPU(type, name) extern type name
+
+EXTERN_C uint8_t __per_cpu_start[];
+EXTERN_C uint8_t __per_cpu_end[];
+
+namespace arch::x86 {
+// Maximum number of CPUs the kernel keeps per-CPU state for
+inline constexpr int MAX_CPUS = 64;
+
+// Space reserved for each CPU's copy of the .percpu section
+inline constexpr size_t PER_CPU_AREA_SIZE = 0x2000;
+
+DECLARE_PER_CPU(uint64_t, g_this_cpu_base);
+DECLARE_PER_CPU(int, g_this_cpu_id);
+
+// Set once the bootstrapping processor's GS base points at its per-CPU area
+extern bool g_per_cpu_online;
+
+/**
+ * @brief Returns whether GS-relative per-CPU accesses are valid.
+ *
+ * Code that can run before arch_first_stage_init (serial, IRIS, memory
+ * routines) must check this before touching per-CPU variables, since the GS
+ * base is zero until the per-CPU area has been set up.
+ */
+inline bool per_cpu_online() {
+    return __atomic_load_n(&g_per_cpu_online, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Returns the offset of a per-CPU variable inside a per-CPU area.
+ */
+template <typename T>
+inline uint64_t per_cpu_offset(T* var) {
+    return reinterpret_cast<uint64_t>(var) - reinterpret_cast<uint64_t>(__per_cpu_start);
+}
+
+/**
+ * @brief Reads a scalar per-CPU variable of the current CPU with a single GS-relative load.
+ *
+ * The load is a single instruction, so it cannot be torn by an interrupt and
+ * needs no preemption protection.
+ */
+template <typename T>
+inline T this_cpu_read(T* var) {
+    uint64_t offset = per_cpu_offset(var);
+
+    if constexpr (sizeof(T) == sizeof(uint64_t)) {
+        uint64_t value;
+        asm volatile("movq %%gs:(%1), %0" : "=r"(value) : "r"(offset));
+        return __builtin_bit_cast(T, value);
+    } else if constexpr (sizeof(T) == sizeof(uint32_t)) {
+        uint32_t value;
+        asm volatile("movl %%gs:(%1), %0" : "=r"(value) : "r"(offset));
+        return __builtin_bit_cast(T, value);
+    } else {
+        static_assert(sizeof(T) == sizeof(uint8_t), "this_cpu_read supports scalar values only");
+        uint8_t value;
+        asm volatile("movb %%gs:(%1), %0" : "=q"(value) : "r"(offset));
+        return __builtin_bit_cast(T, value);
+    }
+}
+
+/**
+ * @brief Writes a scalar per-CPU variable of the current CPU with a single GS-relative store.
+ */
+template <typename T>
+inline void this_cpu_write(T* var, T value) {
+    uint64_t offset = per_cpu_offset(var);
+
+    if constexpr (sizeof(T) == sizeof(uint64_t)) {
+        asm volatile("movq %0, %%gs:(%1)"
+                     :
+                     : "r"(__builtin_bit_cast(uint64_t, value)), "r"(offset)
+                     : "memory");
+    } else if constexpr (sizeof(T) == sizeof(uint32_t)) {
+        asm volatile("movl %0, %%gs:(%1)"
+                     :
+                     : "r"(__builtin_bit_cast(uint32_t, value)), "r"(offset)
+                     : "memory");
+    } else {
+        static_assert(sizeof(T) == sizeof(uint8_t), "this_cpu_write supports scalar values only");
+        asm volatile("movb %0, %%gs:(%1)"
+                     :
+                     : "q"(__builtin_bit_cast(uint8_t, value)), "r"(offset)
+                     : "memory");
+    }
+}
+
+/**
+ * @brief Adds to a 64-bit per-CPU counter of the current CPU with a single GS-relative add.
+ *
+ * Being a single instruction, the update cannot be lost to an interrupt on the same CPU.
+ */
+template <typename T>
+inline void this_cpu_add(T* var, T value) {
+    static_assert(sizeof(T) == sizeof(uint64_t), "this_cpu_add supports 64-bit values only");
+
+    asm volatile("addq %0, %%gs:(%1)"
+                 :
+                 : "r"(__builtin_bit_cast(uint64_t, value)), "r"(per_cpu_offset(var))
+                 : "memory", "cc");
+}
+
+/**
+ * @brief Returns a pointer to the current CPU's instance of a per-CPU variable.
+ */
+template <typename T>
+inline T* this_cpu_ptr(T* var) {
+    return reinterpret_cast<T*>(this_cpu_read(&g_this_cpu_base) + per_cpu_offset(var));
+}
+
+/**
+ * @brief Returns the logical ID of the CPU executing this code.
+ */
+inline int current_cpu() {
+    return this_cpu_read(&g_this_cpu_id);
+}
+
+/**
+ * @brief Returns the base address of the given CPU's per-CPU area.
+ */
+uint64_t per_cpu_area_base(int cpu);
+
+/**
+ * @brief Returns a pointer to the given CPU's instance of a per-CPU variable.
+ */
+template <typename T>
+inline T* per_cpu_ptr(T* var, int cpu) {
+    return reinterpret_cast<T*>(per_cpu_area_base(cpu) + per_cpu_offset(var));
+}
+
+/**
+ * @brief Initializes the per-CPU area of the calling CPU and points its GS base at it.
+ *
+ * Reloading the GS selector clears the GS base, asm_flush_gdt therefore
+ * leaves FS and GS untouched so the area survives later GDT reloads.
+ *
+ * @param cpu The logical ID of the calling CPU.
+ * @return true If the area was initialized.
+ * @return false If the CPU ID is out of range or the .percpu section does not fit.
+ */
+bool init_per_cpu_area(int cpu);
+
+/**
+ * @brief Initializes the per-CPU area for the bootstrapping processor.
+ */
+bool init_bsp_per_cpu_area();
+} // namespace arch::x86
+
+#endif // PERCPU_H
+#endif // ARCH_X86_64
@@ -0,0 +1,51 @@
+#ifdef ARCH_X86_64
+#ifndef PIC_H
+#define PIC_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+// Legacy 8259 PIC I/O ports
+inline constexpr uint16_t PIC1_COMMAND_PORT = 0x20;
+inline constexpr uint16_t PIC1_DATA_PORT = 0x21;
+inline constexpr uint16_t PIC2_COMMAND_PORT = 0xA0;
+inline constexpr uint16_t PIC2_DATA_PORT = 0xA1;
+
+// Vectors the legacy PIC lines are remapped to, clear of the CPU exception range
+inline constexpr uint8_t PIC1_VECTOR_OFFSET = 0x20;
+inline constexpr uint8_t PIC2_VECTOR_OFFSET = 0x28;
+
+// Legacy IRQ lines of the serial ports
+inline constexpr uint8_t LEGACY_IRQ_COM2 = 3;
+inline constexpr uint8_t LEGACY_IRQ_COM1 = 4;
+
+/**
+ * @brief Remaps the legacy 8259 PICs away from the exception vectors and masks every line.
+ *
+ * The local APIC is used for all interrupt delivery, but the firmware may leave
+ * the PIC programmed with vectors that overlap CPU exceptions. Remapping first
+ * ensures any spurious PIC interrupt cannot be mistaken for an exception.
+ */
+void disable_legacy_pic();
+
+/**
+ * @brief Unmasks a single legacy IRQ line, delivered at PIC1_VECTOR_OFFSET + irq.
+ *
+ * Lines on the slave controller also unmask the cascade line on the master.
+ * Delivery requires the local APIC to pass the PIC through LINT0, see
+ * lapic_route_legacy_pic().
+ *
+ * @param irq Legacy IRQ line (0-15).
+ */
+void enable_legacy_irq(uint8_t irq);
+
+/**
+ * @brief Signals end-of-interrupt to the PIC(s) for a legacy IRQ line.
+ *
+ * @param irq Legacy IRQ line (0-15) that was serviced.
+ */
+void send_legacy_pic_eoi(uint8_t irq);
+} // namespace arch::x86
+
+#endif // PIC_H
+#endif // ARCH_X86_64
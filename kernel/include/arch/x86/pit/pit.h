@@ -0,0 +1,29 @@
+#ifdef ARCH_X86_64
+#ifndef PIT_H
+#define PIT_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+// Input clock of the 8253/8254 Programmable Interval Timer
+inline constexpr uint32_t PIT_FREQUENCY_HZ = 1193182;
+
+/**
+ * @brief Arms PIT channel 2 as a one-shot countdown.
+ *
+ * Channel 2 is gated through port 0x61 and its output can be polled without
+ * involving any interrupt controller, which makes it the reference clock for
+ * calibrating the local APIC timer and the TSC.
+ *
+ * @param microseconds Countdown duration, at most ~54ms.
+ */
+void pit_start_oneshot(uint32_t microseconds);
+
+/**
+ * @brief Checks whether the countdown started by pit_start_oneshot has elapsed.
+ */
+bool pit_oneshot_expired();
+} // namespace arch::x86
+
+#endif // PIT_H
+#endif // ARCH_X86_64
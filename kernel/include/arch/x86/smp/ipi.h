@@ -0,0 +1,71 @@
+#ifdef ARCH_X86_64
+#ifndef IPI_H
+#define IPI_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+inline constexpr uint8_t CALL_FUNCTION_VECTOR = 0xFD;
+
+// Number of IPI events buffered per CPU between two flush_ipi_events() calls
+inline constexpr size_t IPI_EVENT_BUFFER_SIZE = 128;
+
+// Function run on other CPUs through smp_call_function()
+using ipi_function = void (*)(void* arg);
+
+// Payload of EVENT_IPI_SEND
+struct ipi_send_payload {
+    uint64_t tsc;
+    uint64_t target_mask; // CPUs the call was queued on
+    uint32_t ipis_sent;   // Fewer than the targets if some already had an IPI pending
+    uint32_t reserved;
+} __attribute__((packed));
+
+// Payload of EVENT_IPI_RECEIVE
+struct ipi_receive_payload {
+    uint64_t tsc;
+    uint64_t latency_cycles; // From queueing the oldest call to running it
+    uint32_t calls;          // Calls served by this interrupt
+    uint32_t reserved;
+} __attribute__((packed));
+
+static_assert(sizeof(ipi_send_payload) == 24, "IPI send payload must be 24 bytes");
+static_assert(sizeof(ipi_receive_payload) == sizeof(ipi_send_payload),
+              "IPI event payloads must have the same size");
+
+/**
+ * @brief Registers the cross-CPU call handler, called once on the BSP.
+ */
+void init_ipi();
+
+/**
+ * @brief Runs `fn(arg)` on every online CPU in a mask and waits until all of them returned.
+ *
+ * Each target gets the call pushed onto its lock-free call queue, an IPI is
+ * only sent if the queue was empty, so calls posted to a CPU before it takes
+ * the interrupt are all served by one IPI. On other CPUs `fn` runs in
+ * interrupt context, on the calling CPU (if in the mask) it runs directly,
+ * both with interrupts disabled. Calls queued for the calling CPU are served
+ * while it waits, so two CPUs calling each other cannot deadlock.
+ *
+ * @param cpu_mask Bit n selects logical CPU n, offline CPUs are ignored.
+ * @param fn Function to run, must not call smp_call_function itself.
+ * @param arg Passed to fn.
+ */
+void smp_call_function(uint64_t cpu_mask, ipi_function fn, void* arg);
+
+/**
+ * @brief Enables or disables buffering of EVENT_IPI_SEND and EVENT_IPI_RECEIVE.
+ */
+void set_ipi_event_tracing(bool enabled);
+
+/**
+ * @brief Emits the IPI events buffered by every CPU.
+ *
+ * Must only be called from one CPU at a time, the BSP's idle loop.
+ */
+void flush_ipi_events();
+} // namespace arch::x86
+
+#endif // IPI_H
+#endif // ARCH_X86_64
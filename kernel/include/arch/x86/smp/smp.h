@@ -0,0 +1,61 @@
+#ifdef ARCH_X86_64
+#ifndef SMP_H
+#define SMP_H
+
+#include <core/types.h>
+
+namespace arch::x86 {
+// Physical address the real-mode AP entry code is copied to, must be page aligned and below 1MB
+inline constexpr uint64_t AP_TRAMPOLINE_BASE = 0x8000;
+
+// Kernel stack of each application processor
+inline constexpr size_t AP_STACK_SIZE = 0x4000;
+
+// Function run on an application processor through run_on_cpu()
+using cpu_work_fn = void (*)(void* arg);
+
+/**
+ * @brief Starts every application processor and waits until they are online.
+ *
+ * Broadcasts INIT-SIPI-SIPI to all other CPUs, so no firmware tables are
+ * needed. Each AP claims the next logical CPU ID, sets up its per-CPU area,
+ * GDT, IDT and local APIC timer and then waits in an idle loop for work posted
+ * with run_on_cpu(). APs come online in ID order: one that does not finish in
+ * time is parked together with every AP after it. Requires a calibrated local
+ * APIC.
+ *
+ * @return int The number of CPUs online, including the BSP.
+ */
+int start_application_processors();
+
+/**
+ * @brief Returns the number of CPUs online, including the BSP.
+ *
+ * Logical CPU IDs are dense, so CPUs 0 to online_cpu_count() - 1 are online. The
+ * count is final once start_application_processors() returns.
+ */
+int online_cpu_count();
+
+/**
+ * @brief Returns the local APIC ID of an online CPU, the destination of IPIs sent to it.
+ */
+uint32_t cpu_apic_id(int cpu);
+
+/**
+ * @brief Asks an idle application processor to run `fn(arg)` and returns immediately.
+ *
+ * The AP notices the work on its next wakeup, at the latest on its next timer tick.
+ *
+ * @return true If the work was posted.
+ * @return false If the CPU is not an online AP or is still running earlier work.
+ */
+bool run_on_cpu(int cpu, cpu_work_fn fn, void* arg);
+
+/**
+ * @brief Waits until an application processor has finished the work posted with run_on_cpu().
+ */
+void wait_for_cpu(int cpu);
+} // namespace arch::x86
+
+#endif // SMP_H
+#endif // ARCH_X86_64
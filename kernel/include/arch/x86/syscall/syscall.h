@@ -0,0 +1,79 @@
+#ifdef ARCH_X86_64
+#ifndef X86_SYSCALL_H
+#define X86_SYSCALL_H
+
+#include <arch/x86/gdt/gdt.h>
+#include <arch/x86/percpu/percpu.h>
+#include <core/types.h>
+
+// Per-CPU slot read by the SYSCALL entry at a fixed GS offset (syscall.S)
+EXTERN_C uint64_t g_syscall_kernel_stack;
+
+namespace arch::x86 {
+/*
+    SYSRET loads SS from STAR[63:48] + 8 and CS from STAR[63:48] + 16, so the
+    user data descriptor must sit right below the user code descriptor. The
+    base itself is never loaded in 64-bit mode, here it points into the TSS.
+*/
+inline constexpr uint16_t SYSRET_SELECTOR_BASE = (USER_DS - 8) | 3;
+static_assert(USER_CS == USER_DS + 8, "SYSRET requires the user data descriptor below user code");
+
+// Register state of a thread that entered the kernel through SYSCALL
+struct syscall_frame {
+    uint64_t r15;
+    uint64_t r14;
+    uint64_t r13;
+    uint64_t r12;
+    uint64_t r11;
+    uint64_t r10;
+    uint64_t r9;
+    uint64_t r8;
+    uint64_t rbp;
+    uint64_t rdi;
+    uint64_t rsi;
+    uint64_t rdx;
+    uint64_t rcx;
+    uint64_t rbx;
+    uint64_t rax; // Syscall number on entry, return value on exit
+
+    // Same layout as the tail of an interrupt frame
+    uint64_t rip;
+    uint64_t cs;
+    uint64_t rflags;
+    uint64_t rsp;
+    uint64_t ss;
+};
+
+static_assert(sizeof(syscall_frame) % 16 == 0, "syscall_frame must keep the stack aligned");
+
+/**
+ * @brief Enables SYSCALL/SYSRET on the calling CPU.
+ *
+ * Programs IA32_STAR with the kernel and user selectors, IA32_LSTAR with the
+ * entry point and IA32_FMASK so the entry runs with interrupts disabled until
+ * it has switched to the kernel stack.
+ */
+void enable_syscall_interface();
+
+/**
+ * @brief Leaves the calling kernel thread for ring 3. Never returns.
+ *
+ * @param rip User mode entry point.
+ * @param rsp User mode stack pointer.
+ * @param arg Value passed in rdi, every other register starts out zero.
+ */
+[[noreturn]] void enter_user_mode(uint64_t rip, uint64_t rsp, uint64_t arg);
+
+/**
+ * @brief Leaves the calling kernel thread for ring 3 with a complete register state.
+ *
+ * Used to start a forked thread where its parent's SYSCALL returned, so the
+ * frame is copied from the parent with rax changed. Never returns.
+ *
+ * @param frame Register state to resume, may live on the calling thread's stack.
+ */
+[[noreturn]] void return_to_user_mode(const syscall_frame* frame);
+} // namespace arch::x86
+
+#endif // X86_SYSCALL_H
+#endif // ARCH_X86_64
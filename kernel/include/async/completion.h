@@ -0,0 +1,84 @@
+#ifndef ASYNC_COMPLETION_H
+#define ASYNC_COMPLETION_H
+
+#include <arch/x86/percpu/percpu.h>
+#include <async/executor.h>
+#include <core/types.h>
+
+#include <coroutine>
+
+namespace async {
+
+/**
+ * @brief Auto-reset event a single coroutine waits on with `co_await`, signalled by a device.
+ *
+ * signal() is callable from interrupt handlers. A signal that arrives while
+ * nobody waits is remembered, so the next `co_await` completes immediately;
+ * that lets a driver check its device, then wait, without losing a wakeup
+ * that lands in between. Awaiting consumes the signal. The waiter resumes on
+ * the executor of the CPU it suspended on. A zero-initialized completion is
+ * not signalled.
+ */
+class completion {
+public:
+    constexpr completion() = default;
+
+    completion(const completion&) = delete;
+    completion& operator=(const completion&) = delete;
+
+    void signal() {
+        uint32_t state = __atomic_load_n(&m_state, __ATOMIC_ACQUIRE);
+
+        while (true) {
+            if (state == SIGNALLED) {
+                return;
+            }
+
+            uint32_t next = state == WAITING ? IDLE : SIGNALLED;
+            if (__atomic_compare_exchange_n(&m_state, &state, next, false, __ATOMIC_ACQ_REL,
+                                            __ATOMIC_ACQUIRE)) {
+                break;
+            }
+        }
+
+        if (state == WAITING) {
+            schedule(&m_waiter, m_cpu);
+        }
+    }
+
+    bool await_ready() noexcept {
+        uint32_t expected = SIGNALLED;
+        return __atomic_compare_exchange_n(&m_state, &expected, IDLE, false, __ATOMIC_ACQ_REL,
+                                           __ATOMIC_RELAXED);
+    }
+
+    bool await_suspend(std::coroutine_handle<> waiter) noexcept {
+        m_waiter.handle = waiter;
+        m_cpu = arch::x86::current_cpu();
+
+        uint32_t expected = IDLE;
+        if (__atomic_compare_exchange_n(&m_state, &expected, WAITING, false, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE)) {
+            return true;
+        }
+
+        // Signalled since await_ready, consume it and keep running
+        __atomic_store_n(&m_state, IDLE, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    void await_resume() noexcept {}
+
+private:
+    static constexpr uint32_t IDLE = 0;
+    static constexpr uint32_t SIGNALLED = 1;
+    static constexpr uint32_t WAITING = 2;
+
+    uint32_t m_state = IDLE;
+    int m_cpu = 0;
+    ready_node m_waiter = {};
+};
+
+} // namespace async
+
+#endif
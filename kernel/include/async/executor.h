@@ -0,0 +1,47 @@
+#ifndef ASYNC_EXECUTOR_H
+#define ASYNC_EXECUTOR_H
+
+#include <core/types.h>
+
+#include <coroutine>
+
+/*
+    Every CPU has an executor: a queue of suspended coroutines that are ready
+    to continue. Interrupt handlers make a coroutine ready by signalling the
+    completion it waits on, and the CPU's idle loop resumes everything ready
+    after each wakeup. Coroutines therefore wait for devices without a thread
+    or a stack of their own, only their frame stays allocated.
+*/
+
+namespace async {
+
+// Queue link of a suspended coroutine, lives in whatever it is suspended on
+struct ready_node {
+    ready_node* next;
+    std::coroutine_handle<> handle;
+};
+
+/**
+ * @brief Queues a coroutine on the executor of a CPU, callable from any context.
+ *
+ * A CPU other than the caller's is woken from its idle wait with
+ * sched::wake_idle_cpu().
+ */
+void schedule(ready_node* node, int cpu);
+
+/**
+ * @brief Resumes the calling CPU's ready coroutines until none is left.
+ *
+ * Called from idle loops with interrupts enabled. Coroutines run on the
+ * calling context's stack until they suspend again or finish.
+ */
+void run_ready();
+
+/**
+ * @brief Returns whether the calling CPU has coroutines waiting to be resumed.
+ */
+bool has_ready();
+
+} // namespace async
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef ASYNC_FRAME_POOL_H
+#define ASYNC_FRAME_POOL_H
+
+#include <core/types.h>
+
+namespace async {
+
+// Largest coroutine frame the pool hands out, covers debug builds where every temporary is spilled
+inline constexpr size_t FRAME_BLOCK_SIZE = 1024;
+
+// Coroutines alive at the same time
+inline constexpr size_t FRAME_POOL_BLOCKS = 128;
+
+/**
+ * @brief Allocates a coroutine frame from the fixed-size block pool.
+ *
+ * The kernel has no general heap, every coroutine frame comes from here.
+ * Callable from any context.
+ *
+ * @return void* The frame, or nullptr if it is larger than FRAME_BLOCK_SIZE or the pool is empty.
+ */
+void* allocate_frame(size_t size);
+
+/**
+ * @brief Returns a frame obtained from allocate_frame() to the pool.
+ */
+void free_frame(void* frame);
+
+/**
+ * @brief Returns the number of frames currently allocated.
+ */
+size_t frames_in_use();
+
+} // namespace async
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef ASYNC_TASK_H
+#define ASYNC_TASK_H
+
+#include <arch/x86/percpu/percpu.h>
+#include <async/executor.h>
+#include <async/frame_pool.h>
+#include <core/types.h>
+
+#include <coroutine>
+
+namespace async {
+
+template <typename T>
+class task;
+
+namespace detail {
+
+// Frame allocation and completion handling shared by every task promise
+struct promise_base {
+    std::coroutine_handle<> continuation; // Coroutine awaiting this one, resumed when it finishes
+    ready_node spawn_node = {};           // Executor link of a spawned task
+    bool detached = false;                // Spawned, the frame frees itself on completion
+
+    // Frames come from the coroutine frame pool, a failed allocation makes an invalid task
+    static void* operator new(size_t size) noexcept {
+        return allocate_frame(size);
+    }
+
+    static void operator delete(void* frame) noexcept {
+        free_frame(frame);
+    }
+
+    // Lazy start, a task runs once it is awaited or spawned
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    struct final_awaiter {
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> self) noexcept {
+            promise_base& promise = self.promise();
+
+            if (promise.continuation) {
+                return promise.continuation;
+            }
+            if (promise.detached) {
+                self.destroy();
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    final_awaiter final_suspend() noexcept {
+        return {};
+    }
+
+    // Built with -fno-exceptions, nothing can be thrown
+    void unhandled_exception() noexcept {}
+};
+
+template <typename T>
+struct task_promise : promise_base {
+    T value{};
+
+    void return_value(T result) noexcept {
+        value = result;
+    }
+
+    T result() noexcept {
+        return value;
+    }
+};
+
+template <>
+struct task_promise<void> : promise_base {
+    void return_void() noexcept {}
+
+    void result() noexcept {}
+};
+
+} // namespace detail
+
+/**
+ * @brief Lazily started coroutine returning a T, awaited with `co_await` or handed to spawn().
+ *
+ * Its frame comes from the coroutine frame pool. If the pool is exhausted the
+ * task is invalid (valid() returns false): awaiting it completes immediately
+ * with a default-constructed T and spawning it fails.
+ */
+template <typename T = void>
+class [[nodiscard]] task {
+public:
+    struct promise_type : detail::task_promise<T> {
+        task get_return_object() noexcept {
+            return task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        static task get_return_object_on_allocation_failure() noexcept {
+            return task(nullptr);
+        }
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    // Awaiting starts the task and resumes the awaiting coroutine once it finished
+    struct awaiter {
+        handle_type handle;
+
+        bool await_ready() noexcept {
+            return !handle || handle.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+            handle.promise().continuation = caller;
+            return handle;
+        }
+
+        T await_resume() noexcept {
+            if (!handle) {
+                return T();
+            }
+            return handle.promise().result();
+        }
+    };
+
+    task(task&& other) noexcept : m_handle(other.m_handle) {
+        other.m_handle = nullptr;
+    }
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+    task& operator=(task&&) = delete;
+
+    ~task() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    bool valid() const {
+        return static_cast<bool>(m_handle);
+    }
+
+    awaiter operator co_await() && noexcept {
+        return awaiter{m_handle};
+    }
+
+    /**
+     * @brief Gives up ownership of the coroutine frame, used by spawn().
+     */
+    handle_type release() {
+        handle_type handle = m_handle;
+        m_handle = nullptr;
+        return handle;
+    }
+
+private:
+    explicit task(handle_type handle) : m_handle(handle) {}
+
+    handle_type m_handle;
+};
+
+/**
+ * @brief Starts a task on the calling CPU's executor without waiting for it.
+ *
+ * The task runs on the next run_ready() and frees its frame when it finishes.
+ *
+ * @return false if the task is invalid (its frame could not be allocated).
+ */
+inline bool spawn(task<void> work) {
+    if (!work.valid()) {
+        return false;
+    }
+
+    auto handle = work.release();
+    auto& promise = handle.promise();
+
+    promise.detached = true;
+    promise.spawn_node.handle = handle;
+    schedule(&promise.spawn_node, arch::x86::current_cpu());
+    return true;
+}
+
+} // namespace async
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <arch/x86/cpu/cpu.h>
+#include <core/types.h>
+
+namespace bench {
+
+// Benchmark identifiers, the numeric values are part of the IRIS protocol
+enum class benchmark_id : uint16_t {
+    INITRAMFS_OPEN = 0,
+    INITRAMFS_READ = 1,
+    PORT_IO_INB_LOOP = 2,
+    PORT_IO_INSB = 3,
+    PORT_IO_INW_LOOP = 4,
+    PORT_IO_INSW = 5,
+    PORT_IO_OUTB_LOOP = 6,
+    PORT_IO_OUTSB = 7,
+    SPINLOCK_1CPU = 8,
+    SPINLOCK_2CPU = 9,
+    SPINLOCK_3CPU = 10,
+    SPINLOCK_4CPU = 11,
+    MCS_LOCK_1CPU = 12,
+    MCS_LOCK_2CPU = 13,
+    MCS_LOCK_3CPU = 14,
+    MCS_LOCK_4CPU = 15,
+    SCHED_SPAWN_THROUGHPUT = 16,
+    SCHED_PING_PONG = 17,
+    SCHED_PING_PONG_FPU = 18,
+    SYSCALL_NULL_ROUND_TRIP = 19,
+    PROC_FORK_EXIT_64MIB = 20,
+    TLB_SWITCH_PCID = 21,
+    TLB_SWITCH_FLUSH = 22,
+    TLB_SHOOTDOWN_1CPU = 23,
+    TLB_SHOOTDOWN_2CPU = 24,
+    TLB_SHOOTDOWN_3CPU = 25,
+    TLB_SHOOTDOWN_4CPU = 26,
+    TLB_SHOOTDOWN_BATCHED = 27,
+    TLB_SHOOTDOWN_UNBATCHED = 28,
+    IPI_ROUND_TRIP_1CPU = 29,
+    IPI_ROUND_TRIP_2CPU = 30,
+    IPI_ROUND_TRIP_3CPU = 31,
+    RCU_READ_1CPU = 32,
+    RCU_READ_2CPU = 33,
+    RCU_READ_3CPU = 34,
+    RCU_READ_4CPU = 35,
+    SPINLOCK_READ_1CPU = 36,
+    SPINLOCK_READ_2CPU = 37,
+    SPINLOCK_READ_3CPU = 38,
+    SPINLOCK_READ_4CPU = 39,
+    RCU_SYNCHRONIZE = 40,
+    CONTAINER_INTRUSIVE_LIST = 41,
+    CONTAINER_SPSC_RING = 42,
+    CONTAINER_MPSC_QUEUE = 43,
+    CONTAINER_MPMC_QUEUE = 44,
+    CONTAINER_HASH_MAP_INSERT_ERASE = 45,
+    CONTAINER_HASH_MAP_LOOKUP = 46,
+    CONTAINER_RADIX_TREE_INSERT_ERASE = 47,
+    CONTAINER_RADIX_TREE_LOOKUP = 48,
+    IRIS_EMIT_BLOCKING = 49,
+    IRIS_EMIT_ASYNC = 50,
+    SERIAL_LOOPBACK_BLOCKING = 51,
+    SERIAL_LOOPBACK_ASYNC = 52,
+    SCHED_IDLE_WAKEUP = 53,
+    IRQ_DISPATCH_LOCAL = 54,
+    IRQ_DISPATCH_REMOTE = 55,
+    BLOCK_RANDOM_READ_QD1 = 56,
+    BLOCK_RANDOM_READ_QD2 = 57,
+    BLOCK_RANDOM_READ_QD4 = 58,
+    BLOCK_RANDOM_READ_QD8 = 59,
+    BLOCK_RANDOM_READ_QD16 = 60,
+    BLOCK_RANDOM_READ_QD32 = 61,
+    BLOCK_RANDOM_READ_QD64 = 62,
+    BLOCK_RANDOM_READ_QD128 = 63,
+    BLOCK_SEQUENTIAL_READ_QD1 = 64,
+    BLOCK_SEQUENTIAL_READ_QD2 = 65,
+    BLOCK_SEQUENTIAL_READ_QD4 = 66,
+    BLOCK_SEQUENTIAL_READ_QD8 = 67,
+    BLOCK_SEQUENTIAL_READ_QD16 = 68,
+    BLOCK_SEQUENTIAL_READ_QD32 = 69,
+    BLOCK_SEQUENTIAL_READ_QD64 = 70,
+    BLOCK_SEQUENTIAL_READ_QD128 = 71,
+    BUFFER_CACHE_SEQUENTIAL_READ = 72,
+    BUFFER_CACHE_RANDOM_READ = 73,
+    BUFFER_CACHE_HOT_READ = 74,
+    BUFFER_CACHE_WRITE_BACK = 75,
+    NET_ROUND_TRIP_SMALL = 76,
+    NET_ROUND_TRIP_LARGE = 77,
+    NET_STREAM_SMALL = 78,
+    NET_STREAM_LARGE = 79,
+};
+
+// Accumulated measurements of one benchmark
+struct result {
+    uint64_t iterations;
+    uint64_t total_cycles;
+    uint64_t min_cycles;
+    uint64_t max_cycles;
+    uint64_t bytes; // Bytes processed over all iterations, 0 for latency-only benchmarks
+};
+
+// Payload of EVENT_BENCHMARK_RESULT
+struct result_payload {
+    uint64_t iterations;
+    uint64_t total_cycles;
+    uint64_t min_cycles;
+    uint64_t max_cycles;
+    uint64_t bytes;
+    uint64_t tsc_frequency; // TSC ticks per second, 0 if not calibrated
+    uint16_t id;            // benchmark_id
+    uint16_t reserved1;
+    uint32_t reserved2;
+} __attribute__((packed));
+
+static_assert(sizeof(result_payload) == 56, "Benchmark result payload must be 56 bytes");
+
+/**
+ * @brief Reads the TSC for timing a benchmark iteration.
+ *
+ * The preceding lfence keeps earlier instructions from leaking into the measured interval.
+ */
+inline uint64_t timestamp() {
+    asm volatile("lfence" ::: "memory");
+    return arch::x86::rdtsc();
+}
+
+/**
+ * @brief Adds one iteration to a result.
+ */
+inline void record(result* res, uint64_t cycles, uint64_t bytes = 0) {
+    if (res->iterations == 0 || cycles < res->min_cycles) {
+        res->min_cycles = cycles;
+    }
+    if (cycles > res->max_cycles) {
+        res->max_cycles = cycles;
+    }
+
+    ++res->iterations;
+    res->total_cycles += cycles;
+    res->bytes += bytes;
+}
+
+/**
+ * @brief Emits a result as an EVENT_BENCHMARK_RESULT event.
+ */
+void report(benchmark_id id, const result& res);
+
+// Work of run_on_cpus() and run_with_helpers(), `index` is 0 on the BSP and the CPU ID on an AP
+using cpu_body = void (*)(void* context, uint32_t index);
+
+/**
+ * @brief Runs `body` on the BSP and on APs 1 to `cpus - 1` at the same time.
+ *
+ * APs pick up work on their next wakeup, so every one of them waits for a
+ * common start signal. Bodies usually need all CPUs to take part, so if an
+ * AP cannot be posted to, the ones that were are released without running
+ * `body`.
+ *
+ * @param cycles Set to the cycles from the start signal until the last CPU finished.
+ * @return false If an AP could not be posted to, `body` then ran nowhere.
+ */
+bool run_on_cpus(cpu_body body, void* context, uint32_t cpus, uint64_t* cycles);
+
+/**
+ * @brief Runs `body` on the BSP while APs 1 to `helpers` spin with interrupts enabled.
+ *
+ * For work the BSP measures against other CPUs, such as IPIs and TLB shootdowns.
+ * Each helper runs `enter` before the BSP starts and `leave` once it is done,
+ * either may be null. `body` only runs once every helper has entered.
+ *
+ * @return false If an AP could not be posted to, `body` then did not run.
+ */
+bool run_with_helpers(cpu_body body, void* context, uint32_t helpers, cpu_body enter,
+                      cpu_body leave);
+
+/**
+ * @brief Runs every benchmark suite and reports the results over IRIS.
+ *
+ * Called from init() before the idle loop when BUILD_BENCHMARKS is defined.
+ */
+void run_all();
+
+// Individual suites, one per subsystem
+void run_initramfs_benchmarks();
+void run_port_io_benchmarks();
+void run_lock_benchmarks();
+void run_sched_benchmarks();
+void run_syscall_benchmarks();
+void run_proc_benchmarks();
+void run_tlb_benchmarks();
+void run_ipi_benchmarks();
+void run_rcu_benchmarks();
+void run_container_benchmarks();
+void run_async_benchmarks();
+void run_irq_benchmarks();
+void run_block_benchmarks();
+void run_buffer_cache_benchmarks();
+void run_net_benchmarks();
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef BLOCK_BLOCK_H
+#define BLOCK_BLOCK_H
+
+#include <core/types.h>
+
+namespace block {
+
+// Unit of request addresses, independent of the device's logical block size
+inline constexpr uint32_t SECTOR_SIZE = 512;
+
+// Largest number of registered block devices
+inline constexpr size_t MAX_DEVICES = 8;
+
+inline constexpr size_t NAME_LENGTH = 8;
+
+enum class operation : uint8_t {
+    READ = 0,
+    WRITE = 1,
+    FLUSH = 2, // Makes completed writes durable, sector fields are ignored
+};
+
+// Request completion status
+inline constexpr int STATUS_OK = 0;
+inline constexpr int STATUS_IO_ERROR = -1;
+inline constexpr int STATUS_UNSUPPORTED = -2;
+inline constexpr int STATUS_INVALID = -3; // Outside the device or not block-aligned
+
+/**
+ * @brief One transfer between a device and a physically contiguous buffer.
+ *
+ * Owned by the submitter, the driver uses `next` while the request is in
+ * flight. Requests for adjacent sectors submitted together may be merged into
+ * a single device command, each still completes on its own.
+ */
+struct request {
+    operation op;
+    uint64_t sector;       // First SECTOR_SIZE unit
+    uint32_t sector_count;
+    uint64_t buffer;       // Physical address of sector_count * SECTOR_SIZE bytes
+
+    // Called once the status is set, from the queue's interrupt or from poll()
+    void (*done)(request* req);
+    void* context;
+
+    int status;
+    uint32_t completed; // Set to 1 with release ordering after status, see is_complete()
+    request* next;
+};
+
+struct device;
+
+struct device_operations {
+    /**
+     * @brief Queues requests on one hardware queue and notifies the device once.
+     *
+     * @return size_t Requests accepted from the front of the array, the rest
+     * did not fit in the queue and must be submitted again later.
+     */
+    size_t (*submit)(device* dev, uint16_t queue, request* const* requests, size_t count);
+
+    // Completes finished requests of a queue without waiting for its interrupt
+    void (*poll)(device* dev, uint16_t queue);
+};
+
+struct device {
+    char name[NAME_LENGTH];
+    uint64_t sector_count;
+    uint32_t block_size;  // Logical block size in bytes, requests must be aligned to it
+    uint16_t queue_count; // Hardware queues, CPU n submits to queue n % queue_count
+    bool read_only;
+    bool polled;          // No completion interrupts, waiters must call poll()
+    const device_operations* ops;
+    void* driver_data;
+};
+
+/**
+ * @brief Makes a device visible to get_device() and find_device().
+ *
+ * @return false If MAX_DEVICES devices are already registered.
+ */
+bool register_device(device* dev);
+
+size_t device_count();
+
+/**
+ * @brief Returns the device at an index of the registry, or nullptr if out of range.
+ */
+device* get_device(size_t index);
+
+/**
+ * @brief Returns the device with a name such as "vda", or nullptr.
+ */
+device* find_device(const char* name);
+
+/**
+ * @brief Submits requests to the calling CPU's queue of a device.
+ *
+ * Invalid requests are completed with STATUS_INVALID instead of being queued.
+ *
+ * @return size_t Requests consumed from the front of the array.
+ */
+size_t submit(device* dev, request* const* requests, size_t count);
+
+/**
+ * @brief Completes finished requests on the calling CPU's queue without its interrupt.
+ */
+void poll(device* dev);
+
+/**
+ * @brief Completes finished requests on every queue of a polled device, does nothing otherwise.
+ *
+ * For waiters whose request may have gone to another CPU's queue.
+ */
+void poll_all(device* dev);
+
+inline bool is_complete(const request* req) {
+    return __atomic_load_n(&req->completed, __ATOMIC_ACQUIRE) != 0;
+}
+
+/**
+ * @brief Marks a request complete and runs its callback, used by drivers.
+ */
+void complete(request* req, int status);
+
+/**
+ * @brief Submits one request and spins until it completes, polling if the device has no interrupts.
+ *
+ * For boot-time and benchmark callers; other code should use the callback.
+ *
+ * @return int The request's status.
+ */
+int submit_and_wait(device* dev, request* req);
+
+} // namespace block
+
+#endif
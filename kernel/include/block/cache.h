@@ -0,0 +1,165 @@
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+#include <block/block.h>
+#include <core/types.h>
+#include <sync/rcu.h>
+
+/*
+    Page-granular buffer cache over the block devices.
+
+    Every buffer holds one BLOCK_SIZE block of a device in its own page frame.
+    The index is a hash table of RCU-published chains: a lookup takes no lock,
+    it walks its chain inside a read-side critical section and pins the buffer
+    it finds with a reference count. Buffers are reclaimed with the CLOCK
+    algorithm and go back to the free list only after a grace period, so no
+    reader can walk into a buffer that was reused for another block.
+
+    A reader asking for the block after the one it read last is treated as a
+    sequential stream, the blocks ahead of it are read in one batch that the
+    driver merges into large commands, and the window doubles with every
+    refill. Dirty buffers are written back by a flusher coroutine, woken once
+    DIRTY_THRESHOLD buffers are dirty or the oldest dirty data waited
+    WRITEBACK_DELAY_MS; it submits them sorted by device and block so that
+    adjacent blocks merge as well.
+*/
+
+namespace block::cache {
+
+// Bytes per cached block, one page frame
+inline constexpr uint32_t BLOCK_SIZE = 4096;
+inline constexpr uint32_t SECTORS_PER_BLOCK = BLOCK_SIZE / SECTOR_SIZE;
+
+// Buffers, and page frames, owned by the cache
+inline constexpr size_t BUFFER_COUNT = 1024;
+
+// Chains of the hash index, a power of two
+inline constexpr size_t HASH_BUCKETS = 2048;
+
+// Buffers reclaimed at once when the free list runs low, they share one grace period
+inline constexpr size_t RECLAIM_BATCH = 64;
+
+// Read-ahead window of a sequential stream in blocks, doubled on every refill
+inline constexpr uint32_t READ_AHEAD_MIN = 4;
+inline constexpr uint32_t READ_AHEAD_MAX = 64;
+
+// Dirty buffers written back per flusher round
+inline constexpr size_t WRITEBACK_BATCH = 128;
+
+// Dirty buffers that wake the flusher right away
+inline constexpr size_t DIRTY_THRESHOLD = BUFFER_COUNT / 4;
+
+// Age of the oldest dirty data that wakes the flusher from flush_writeback()
+inline constexpr uint64_t WRITEBACK_DELAY_MS = 100;
+
+// Interval between two EVENT_BUFFER_CACHE_STATS reports from flush_stats()
+inline constexpr uint64_t STATS_REPORT_INTERVAL_MS = 1000;
+
+// Buffer flags
+inline constexpr uint32_t BUFFER_VALID = 1U << 0;      // Data holds the block's contents
+inline constexpr uint32_t BUFFER_DIRTY = 1U << 1;      // Data is newer than the device
+inline constexpr uint32_t BUFFER_IO = 1U << 2;         // A read or write is in flight
+inline constexpr uint32_t BUFFER_REFERENCED = 1U << 3; // Used since the CLOCK hand last passed
+inline constexpr uint32_t BUFFER_READ_AHEAD = 1U << 4; // Read ahead, not asked for yet
+inline constexpr uint32_t BUFFER_ERROR = 1U << 5;      // The last transfer failed
+
+/**
+ * @brief One cached block, pinned between get() and release().
+ *
+ * Holders may read and modify `data`, a modification must be followed by
+ * mark_dirty(). The other fields are maintained by the cache.
+ */
+struct buffer {
+    device* dev;
+    uint64_t block; // BLOCK_SIZE unit on the device
+    void* data;     // BLOCK_SIZE bytes
+    uint64_t phys;
+
+    buffer* hash_next; // RCU-published chain link
+    buffer* free_next;
+    uint32_t flags;
+    uint32_t refcount; // Holders, or a marker while the buffer is free or being reclaimed
+    request io;
+    sync::rcu_head rcu;
+};
+
+// Payload of EVENT_BUFFER_CACHE_STATS, counters since boot
+struct stats_payload {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t read_ahead;      // Blocks read ahead of a sequential reader
+    uint64_t read_ahead_hits; // Read-ahead blocks a reader asked for later
+    uint64_t evictions;
+    uint64_t writebacks;       // Blocks written back
+    uint64_t writeback_rounds; // Batches the flusher and sync_device() submitted
+    uint32_t buffers;
+    uint32_t dirty; // Buffers dirty at the time of the report
+} __attribute__((packed));
+
+static_assert(sizeof(stats_payload) == 64, "Buffer cache stats payload must be 64 bytes");
+
+/**
+ * @brief Allocates the buffers and starts the flusher on the calling CPU's executor.
+ *
+ * Called once after the block drivers were bound.
+ *
+ * @return false If there is no block device or no frame could be allocated.
+ */
+bool init();
+
+/**
+ * @brief Returns a pinned buffer with the contents of a block, reading it on a miss.
+ *
+ * Detects sequential streams and reads ahead of them. Spins until the block
+ * was read; may yield while reclaimed buffers wait for their grace period, so
+ * it must not be called with interrupts disabled or inside a read-side
+ * critical section.
+ *
+ * @return buffer* The buffer, or nullptr if the block is outside the device,
+ * the device's block size does not divide BLOCK_SIZE, the read failed or every
+ * buffer is pinned or dirty.
+ */
+buffer* get(device* dev, uint64_t block);
+
+/**
+ * @brief Unpins a buffer returned by get().
+ */
+void release(buffer* buf);
+
+/**
+ * @brief Marks a pinned buffer as modified, it is written back by the flusher.
+ */
+void mark_dirty(buffer* buf);
+
+/**
+ * @brief Writes every dirty buffer of a device back and flushes the device's write cache.
+ *
+ * Spins until the writes completed, for the same callers as get().
+ *
+ * @return int STATUS_OK, or STATUS_IO_ERROR if a write failed; the buffer
+ * stays dirty and is retried by the flusher.
+ */
+int sync_device(device* dev);
+
+/**
+ * @brief Wakes the flusher once the oldest dirty data waited WRITEBACK_DELAY_MS.
+ *
+ * Called from the BSP's idle loop.
+ */
+void flush_writeback();
+
+/**
+ * @brief Emits EVENT_BUFFER_CACHE_STATS.
+ */
+void emit_stats();
+
+/**
+ * @brief Emits EVENT_BUFFER_CACHE_STATS once per report interval if the cache was used since.
+ *
+ * Must only be called from one CPU at a time, the BSP's idle loop.
+ */
+void flush_stats();
+
+} // namespace block::cache
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef BOOT_INFO_H
+#define BOOT_INFO_H
+
+#include <boot/multiboot2.h>
+
+namespace boot {
+
+// Maximum number of multiboot modules the kernel keeps track of
+inline constexpr size_t MAX_BOOT_MODULES = 16;
+
+// A module loaded by the bootloader, accessed in place through the higher-half mapping
+struct boot_module {
+    uint64_t phys_start;  // Physical address of the first byte
+    uint64_t size;        // Size in bytes
+    const uint8_t* data;  // Higher-half virtual address of the first byte
+    const char* cmdline;  // NUL-terminated command line given to module2 in grub.cfg
+};
+
+/**
+ * @brief Records the multiboot2 information structure and indexes its module tags.
+ *
+ * Modules are never copied. Modules that lie outside the boot-time kernel
+ * mapping are skipped.
+ *
+ * @param mbi Higher-half virtual address of the multiboot2 information structure.
+ */
+void parse_boot_info(void* mbi);
+
+/**
+ * @brief Returns the first tag of the given type, or nullptr if the bootloader did not provide one.
+ */
+const multiboot::tag* find_boot_tag(multiboot::tag_type type);
+
+/**
+ * @brief Returns the physical range occupied by the multiboot2 information structure.
+ *
+ * @param phys Receives the physical address of the first byte.
+ * @param size Receives the size in bytes.
+ */
+void get_boot_info_range(uint64_t* phys, uint64_t* size);
+
+/**
+ * @brief Returns the number of modules found by parse_boot_info.
+ */
+size_t boot_module_count();
+
+/**
+ * @brief Returns the module at the given index, or nullptr if out of range.
+ */
+const boot_module* get_boot_module(size_t index);
+
+/**
+ * @brief Returns the first module whose command line equals the given string, or nullptr.
+ */
+const boot_module* find_boot_module(const char* cmdline);
+
+/**
+ * @brief Returns whether a physical range is free RAM according to the bootloader.
+ *
+ * The range must lie inside a single AVAILABLE memory map entry and must not
+ * overlap the multiboot2 information structure or any module.
+ */
+bool is_free_memory(uint64_t phys, uint64_t size);
+
+} // namespace boot
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef BOOT_TIMING_H
+#define BOOT_TIMING_H
+
+#include <core/types.h>
+
+namespace boot {
+
+// Boot milestones in the order they are reached, the numeric values are part of the IRIS protocol
+enum class boot_phase : uint16_t {
+    // Sampled by boot.S into g_bootstrap_tsc
+    BOOTSTRAP_ENTRY = 0,   // First instruction of the kernel
+    PAGE_TABLES_START = 1, // Bootstrap page table fill started
+    PAGE_TABLES_DONE = 2,  // Bootstrap page table fill finished
+    LONG_MODE_ENTRY = 3,   // Long mode reached, about to call init()
+
+    // Sampled by the kernel proper
+    SERIAL_READY = 4,  // COM1 initialized
+    IRIS_READY = 5,    // IRIS initialized on COM2
+    GDT_READY = 6,     // GDT and TSS loaded
+    PER_CPU_READY = 7, // BSP per-CPU area online
+    IDT_READY = 8,     // IDT loaded and legacy PIC masked
+    LAPIC_READY = 9,   // Local APIC enabled and timers calibrated
+    ARCH_READY = 10,   // arch_first_stage_init done, interrupts enabled
+    IDLE_REACHED = 11, // Idle loop entered
+};
+
+inline constexpr size_t BOOT_PHASE_COUNT = 12;
+
+// Number of phases recorded by boot.S before any C++ code runs
+inline constexpr size_t BOOTSTRAP_PHASE_COUNT = 4;
+
+// Payload of EVENT_BOOT_PHASE
+struct boot_phase_payload {
+    uint64_t tsc;    // TSC value when the phase was reached
+    uint64_t cycles; // TSC cycles since the previously recorded phase
+    uint16_t phase;  // boot_phase
+    uint16_t reserved1;
+    uint32_t reserved2;
+} __attribute__((packed));
+
+static_assert(sizeof(boot_phase_payload) == 24, "Boot phase payload must be 24 bytes");
+
+// Payload of EVENT_BOOT_COMPLETE
+struct boot_summary_payload {
+    uint64_t entry_tsc;       // TSC at the first kernel instruction (firmware and loader cost)
+    uint64_t idle_tsc;        // TSC when the idle loop was reached
+    uint64_t tsc_frequency;   // Calibrated TSC ticks per second, 0 if unknown
+    uint64_t boot_to_idle_ns; // Kernel entry to idle loop, 0 if the TSC is not calibrated
+} __attribute__((packed));
+
+static_assert(sizeof(boot_summary_payload) == 32, "Boot summary payload must be 32 bytes");
+
+/**
+ * @brief Records the TSC value for a boot phase reached by the kernel proper.
+ *
+ * Only the first call for each phase is kept.
+ *
+ * @param phase The milestone that was just reached.
+ */
+void mark_phase(boot_phase phase);
+
+/**
+ * @brief Marks the idle loop as reached and reports the boot timeline over IRIS.
+ *
+ * Emits one EVENT_BOOT_PHASE event per recorded phase followed by a single
+ * EVENT_BOOT_COMPLETE summary. The events are sent after the fact so the
+ * serial transmission time does not distort the measured phases.
+ */
+void report_boot_complete();
+
+} // namespace boot
+
+#endif
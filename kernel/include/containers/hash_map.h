@@ -0,0 +1,172 @@
+#ifndef CONTAINERS_HASH_MAP_H
+#define CONTAINERS_HASH_MAP_H
+
+#include <core/types.h>
+
+namespace containers {
+
+/**
+ * @brief Fibonacci hash for integer keys, the map uses the high bits of the product.
+ */
+template <typename K>
+struct hash {
+    uint64_t operator()(K key) const {
+        return static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ULL;
+    }
+};
+
+template <typename K>
+struct hash<K*> {
+    uint64_t operator()(K* key) const {
+        return reinterpret_cast<uintptr_t>(key) * 0x9E3779B97F4A7C15ULL;
+    }
+};
+
+/**
+ * @brief Fixed-capacity open-addressing hash map with linear probing.
+ *
+ * Entries live in one flat array, so a lookup usually touches a single
+ * cache line. Erasing shifts the following entries of the probe sequence
+ * back instead of leaving tombstones, which keeps lookups fast however many
+ * entries come and go. Not synchronized; shared maps are locked by their
+ * owner or replaced as a whole under RCU. A zero-initialized map is empty.
+ *
+ * @tparam K Key, compared with ==.
+ * @tparam V Trivially copyable value.
+ * @tparam N Capacity, a power of two; keep the map well below full, probes grow with the load.
+ */
+template <typename K, typename V, size_t N, typename Hash = hash<K>>
+class hash_map {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "Hash map capacity must be a power of two");
+
+public:
+    constexpr hash_map() = default;
+
+    hash_map(const hash_map&) = delete;
+    hash_map& operator=(const hash_map&) = delete;
+
+    /**
+     * @brief Inserts a key or replaces its value.
+     *
+     * @return false if the key is new and the map is full.
+     */
+    bool insert(const K& key, const V& value) {
+        for (size_t i = home(key), probes = 0; probes < N; i = (i + 1) & (N - 1), ++probes) {
+            slot* s = &m_slots[i];
+
+            if (!s->used) {
+                if (m_size == N) {
+                    return false;
+                }
+
+                s->key = key;
+                s->value = value;
+                s->used = true;
+                ++m_size;
+                return true;
+            }
+
+            if (s->key == key) {
+                s->value = value;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Returns the value of a key, or nullptr if it is not in the map.
+     */
+    V* find(const K& key) {
+        for (size_t i = home(key), probes = 0; probes < N; i = (i + 1) & (N - 1), ++probes) {
+            slot* s = &m_slots[i];
+
+            if (!s->used) {
+                return nullptr;
+            }
+            if (s->key == key) {
+                return &s->value;
+            }
+        }
+
+        return nullptr;
+    }
+
+    const V* find(const K& key) const {
+        return const_cast<hash_map*>(this)->find(key);
+    }
+
+    /**
+     * @brief Removes a key, returns false if it was not in the map.
+     */
+    bool erase(const K& key) {
+        size_t hole = home(key);
+        size_t probes = 0;
+
+        while (m_slots[hole].used && !(m_slots[hole].key == key)) {
+            hole = (hole + 1) & (N - 1);
+            if (++probes == N) {
+                return false;
+            }
+        }
+
+        if (!m_slots[hole].used) {
+            return false;
+        }
+
+        // Move back every later entry of the run that the hole would cut off from its home slot
+        size_t next = (hole + 1) & (N - 1);
+        for (size_t steps = 1; steps < N && m_slots[next].used; ++steps) {
+            size_t wanted = home(m_slots[next].key);
+            bool reachable = hole <= next ? (wanted > hole && wanted <= next)
+                                          : (wanted > hole || wanted <= next);
+
+            if (!reachable) {
+                m_slots[hole] = m_slots[next];
+                hole = next;
+            }
+
+            next = (next + 1) & (N - 1);
+        }
+
+        m_slots[hole].used = false;
+        --m_size;
+        return true;
+    }
+
+    void clear() {
+        for (slot& s : m_slots) {
+            s.used = false;
+        }
+        m_size = 0;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    static constexpr size_t capacity() {
+        return N;
+    }
+
+private:
+    struct slot {
+        K key;
+        V value;
+        bool used;
+    };
+
+    static constexpr unsigned INDEX_SHIFT = 64 - __builtin_ctzll(N);
+
+    static size_t home(const K& key) {
+        return static_cast<size_t>(Hash()(key) >> INDEX_SHIFT);
+    }
+
+    slot m_slots[N] = {};
+    size_t m_size = 0;
+};
+
+} // namespace containers
+
+#endif
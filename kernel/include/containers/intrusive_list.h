@@ -0,0 +1,178 @@
+#ifndef CONTAINERS_INTRUSIVE_LIST_H
+#define CONTAINERS_INTRUSIVE_LIST_H
+
+#include <core/types.h>
+
+namespace containers {
+
+/**
+ * @brief Links embedded in an object that can be on an intrusive_list.
+ */
+template <typename T>
+struct list_node {
+    T* prev;
+    T* next;
+};
+
+/**
+ * @brief Doubly linked list threaded through a list_node member of its elements.
+ *
+ * Never allocates, an element can be on as many lists as it has nodes and is
+ * removed in O(1) without a search. Not synchronized, the owner locks it.
+ * A zero-initialized list is empty, so lists can be globals without constructors.
+ */
+template <typename T, list_node<T> T::*Node>
+class intrusive_list {
+public:
+    class iterator {
+    public:
+        explicit iterator(T* item) : m_item(item) {}
+
+        T* operator*() const {
+            return m_item;
+        }
+
+        iterator& operator++() {
+            m_item = (m_item->*Node).next;
+            return *this;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return m_item != other.m_item;
+        }
+
+    private:
+        T* m_item;
+    };
+
+    constexpr intrusive_list() = default;
+
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    bool empty() const {
+        return m_front == nullptr;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    T* front() const {
+        return m_front;
+    }
+
+    T* back() const {
+        return m_back;
+    }
+
+    void push_front(T* item) {
+        (item->*Node).prev = nullptr;
+        (item->*Node).next = m_front;
+
+        if (m_front) {
+            (m_front->*Node).prev = item;
+        } else {
+            m_back = item;
+        }
+
+        m_front = item;
+        ++m_size;
+    }
+
+    void push_back(T* item) {
+        (item->*Node).prev = m_back;
+        (item->*Node).next = nullptr;
+
+        if (m_back) {
+            (m_back->*Node).next = item;
+        } else {
+            m_front = item;
+        }
+
+        m_back = item;
+        ++m_size;
+    }
+
+    /**
+     * @brief Inserts `item` right after `position`, which must be on this list.
+     */
+    void insert_after(T* position, T* item) {
+        T* next = (position->*Node).next;
+
+        (item->*Node).prev = position;
+        (item->*Node).next = next;
+        (position->*Node).next = item;
+
+        if (next) {
+            (next->*Node).prev = item;
+        } else {
+            m_back = item;
+        }
+
+        ++m_size;
+    }
+
+    /**
+     * @brief Unlinks an element, which must be on this list.
+     */
+    void remove(T* item) {
+        list_node<T>& node = item->*Node;
+
+        if (node.prev) {
+            (node.prev->*Node).next = node.next;
+        } else {
+            m_front = node.next;
+        }
+
+        if (node.next) {
+            (node.next->*Node).prev = node.prev;
+        } else {
+            m_back = node.prev;
+        }
+
+        node.prev = nullptr;
+        node.next = nullptr;
+        --m_size;
+    }
+
+    /**
+     * @brief Unlinks and returns the first element, or nullptr if the list is empty.
+     */
+    T* pop_front() {
+        T* item = m_front;
+        if (item) {
+            remove(item);
+        }
+        return item;
+    }
+
+    /**
+     * @brief Unlinks and returns the last element, or nullptr if the list is empty.
+     */
+    T* pop_back() {
+        T* item = m_back;
+        if (item) {
+            remove(item);
+        }
+        return item;
+    }
+
+    // The list must not change while it is iterated
+    iterator begin() const {
+        return iterator(m_front);
+    }
+
+    iterator end() const {
+        return iterator(nullptr);
+    }
+
+private:
+    T* m_front = nullptr;
+    T* m_back = nullptr;
+    size_t m_size = 0;
+};
+
+} // namespace containers
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef CONTAINERS_MPMC_QUEUE_H
+#define CONTAINERS_MPMC_QUEUE_H
+
+#include <core/types.h>
+
+namespace containers {
+
+/**
+ * @brief Bounded multi-producer / multi-consumer queue of copyable values (Vyukov).
+ *
+ * Every slot carries a sequence number that tells producers and consumers
+ * whose turn it is, so either side claims a slot with one compare-and-swap on
+ * its own index and never waits for the other side's index. An operation
+ * only fails when the queue is full or empty, never because of contention.
+ *
+ * Slots store their sequence relative to their index, so a zero-initialized
+ * queue is empty and needs no constructor.
+ *
+ * @tparam T Trivially copyable element.
+ * @tparam N Capacity, a power of two.
+ */
+template <typename T, size_t N>
+class mpmc_queue {
+    static_assert(N != 0 && (N & (N - 1)) == 0, "MPMC queue capacity must be a power of two");
+
+public:
+    constexpr mpmc_queue() = default;
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    /**
+     * @brief Appends a copy of `value`, returns false if the queue is full.
+     */
+    bool try_push(const T& value) {
+        size_t position = __atomic_load_n(&m_enqueue, __ATOMIC_RELAXED);
+
+        while (true) {
+            slot* s = &m_slots[position & (N - 1)];
+            auto difference = static_cast<int64_t>(sequence(s, position) - position);
+
+            if (difference == 0) {
+                if (__atomic_compare_exchange_n(&m_enqueue, &position, position + 1, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    s->value = value;
+                    set_sequence(s, position, position + 1);
+                    return true;
+                }
+            } else if (difference < 0) {
+                // The slot still holds the entry from one lap ago
+                return false;
+            } else {
+                position = __atomic_load_n(&m_enqueue, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes the oldest entry into `value`, returns false if the queue is empty.
+     */
+    bool try_pop(T* value) {
+        size_t position = __atomic_load_n(&m_dequeue, __ATOMIC_RELAXED);
+
+        while (true) {
+            slot* s = &m_slots[position & (N - 1)];
+            auto difference = static_cast<int64_t>(sequence(s, position) - (position + 1));
+
+            if (difference == 0) {
+                if (__atomic_compare_exchange_n(&m_dequeue, &position, position + 1, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    *value = s->value;
+                    set_sequence(s, position, position + N);
+                    return true;
+                }
+            } else if (difference < 0) {
+                // Nothing was pushed into the slot yet
+                return false;
+            } else {
+                position = __atomic_load_n(&m_dequeue, __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    static constexpr size_t capacity() {
+        return N;
+    }
+
+private:
+    struct slot {
+        size_t turn; // Sequence number minus the slot index
+        T value;
+    };
+
+    static size_t sequence(slot* s, size_t position) {
+        return __atomic_load_n(&s->turn, __ATOMIC_ACQUIRE) + (position & (N - 1));
+    }
+
+    // Hands the slot to the other side after the value was written or read
+    static void set_sequence(slot* s, size_t position, size_t value) {
+        __atomic_store_n(&s->turn, value - (position & (N - 1)), __ATOMIC_RELEASE);
+    }
+
+    alignas(64) size_t m_enqueue = 0;
+    alignas(64) size_t m_dequeue = 0;
+    alignas(64) slot m_slots[N] = {};
+};
+
+} // namespace containers
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef CONTAINERS_MPSC_QUEUE_H
+#define CONTAINERS_MPSC_QUEUE_H
+
+#include <core/types.h>
+
+namespace containers {
+
+/**
+ * @brief Unbounded multi-producer / single-consumer queue threaded through a `next` member.
+ *
+ * Producers push with one compare-and-swap, the consumer takes every queued
+ * element at once with one exchange, so elements are batched rather than
+ * dequeued one by one. Being intrusive it needs no capacity: the producer
+ * owns the element's storage until the consumer is done with it. A
+ * zero-initialized queue is empty.
+ */
+template <typename T, T* T::*Next>
+class mpsc_queue {
+public:
+    constexpr mpsc_queue() = default;
+
+    mpsc_queue(const mpsc_queue&) = delete;
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+    /**
+     * @brief Adds an element, callable from any context.
+     *
+     * @return true if the queue was empty, the producer then has to notify the consumer.
+     */
+    bool push(T* item) {
+        T* head = __atomic_load_n(&m_head, __ATOMIC_RELAXED);
+
+        do {
+            item->*Next = head;
+        } while (!__atomic_compare_exchange_n(&m_head, &head, item, true, __ATOMIC_RELEASE,
+                                              __ATOMIC_RELAXED));
+
+        return head == nullptr;
+    }
+
+    /**
+     * @brief Empties the queue, consumer only.
+     *
+     * @return The elements in the order they were pushed, linked through `Next`, or nullptr.
+     */
+    T* take_all() {
+        T* item = __atomic_exchange_n(&m_head, nullptr, __ATOMIC_ACQUIRE);
+
+        // Pushed as a stack, reverse it
+        T* ordered = nullptr;
+        while (item) {
+            T* next = item->*Next;
+            item->*Next = ordered;
+            ordered = item;
+            item = next;
+        }
+
+        return ordered;
+    }
+
+    bool empty() const {
+        return __atomic_load_n(&m_head, __ATOMIC_RELAXED) == nullptr;
+    }
+
+private:
+    T* m_head = nullptr;
+};
+
+} // namespace containers
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef CONTAINERS_RADIX_TREE_H
+#define CONTAINERS_RADIX_TREE_H
+
+#include <core/types.h>
+
+namespace containers {
+
+/**
+ * @brief Radix tree mapping integer keys to pointers, with nodes from a fixed pool.
+ *
+ * Each level resolves 6 bits of the key through a 64-slot node, like the
+ * page tables do with 9 bits, so lookups cost a fixed number of dependent
+ * loads however many keys are stored and dense key ranges share nodes.
+ * Nodes come from an embedded pool and return to it once empty. Not
+ * synchronized. A zero-initialized tree is empty.
+ *
+ * @tparam T Type of the stored objects, the tree only keeps pointers.
+ * @tparam NODES Node pool size, bounds how many sparse keys fit.
+ * @tparam KEY_BITS Keys must be below 2^KEY_BITS.
+ */
+template <typename T, size_t NODES, unsigned KEY_BITS = 32>
+class radix_tree {
+    static_assert(KEY_BITS > 0 && KEY_BITS <= 64, "Radix tree keys are at most 64 bits");
+
+public:
+    static constexpr unsigned BITS_PER_LEVEL = 6;
+    static constexpr size_t SLOTS = size_t{1} << BITS_PER_LEVEL;
+    static constexpr unsigned LEVELS = (KEY_BITS + BITS_PER_LEVEL - 1) / BITS_PER_LEVEL;
+
+    constexpr radix_tree() = default;
+
+    radix_tree(const radix_tree&) = delete;
+    radix_tree& operator=(const radix_tree&) = delete;
+
+    /**
+     * @brief Stores `value` under `key`, replacing an existing value.
+     *
+     * @return false if the key is out of range, value is null or the node pool
+     * cannot hold the nodes the key needs; the tree is then left unchanged.
+     */
+    bool insert(uint64_t key, T* value) {
+        if (!in_range(key) || !value) {
+            return false;
+        }
+
+        // The whole missing path is allocated or none of it, so a failed insert leaves no
+        // empty nodes linked into the tree
+        if (NODES - m_nodes_used < missing_nodes(key)) {
+            return false;
+        }
+
+        if (!m_root && !(m_root = allocate_node())) {
+            return false;
+        }
+
+        node* current = m_root;
+        for (unsigned level = LEVELS - 1; level > 0; --level) {
+            void** slot = &current->slots[index(key, level)];
+
+            if (!*slot) {
+                node* child = allocate_node();
+                if (!child) {
+                    return false;
+                }
+                *slot = child;
+                ++current->count;
+            }
+            current = static_cast<node*>(*slot);
+        }
+
+        void** slot = &current->slots[index(key, 0)];
+        if (!*slot) {
+            ++current->count;
+            ++m_size;
+        }
+        *slot = value;
+        return true;
+    }
+
+    /**
+     * @brief Returns the value stored under `key`, or nullptr.
+     */
+    T* find(uint64_t key) const {
+        if (!in_range(key)) {
+            return nullptr;
+        }
+
+        const node* current = m_root;
+        for (unsigned level = LEVELS - 1; current && level > 0; --level) {
+            current = static_cast<const node*>(current->slots[index(key, level)]);
+        }
+
+        return current ? static_cast<T*>(current->slots[index(key, 0)]) : nullptr;
+    }
+
+    /**
+     * @brief Removes `key` and frees the nodes it leaves empty.
+     *
+     * @return The removed value, or nullptr if the key was not stored.
+     */
+    T* erase(uint64_t key) {
+        if (!in_range(key) || !m_root) {
+            return nullptr;
+        }
+
+        // Nodes from the root down to the leaf, for freeing the empty ones on the way back
+        node* path[LEVELS];
+        path[LEVELS - 1] = m_root;
+
+        for (unsigned level = LEVELS - 1; level > 0; --level) {
+            auto* child = static_cast<node*>(path[level]->slots[index(key, level)]);
+            if (!child) {
+                return nullptr;
+            }
+            path[level - 1] = child;
+        }
+
+        T* value = static_cast<T*>(path[0]->slots[index(key, 0)]);
+        if (!value) {
+            return nullptr;
+        }
+
+        path[0]->slots[index(key, 0)] = nullptr;
+        --path[0]->count;
+        --m_size;
+
+        for (unsigned level = 0; level < LEVELS && path[level]->count == 0; ++level) {
+            free_node(path[level]);
+
+            if (level + 1 < LEVELS) {
+                path[level + 1]->slots[index(key, level + 1)] = nullptr;
+                --path[level + 1]->count;
+            } else {
+                m_root = nullptr;
+            }
+        }
+
+        return value;
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    /**
+     * @brief Returns the number of pool nodes in use.
+     */
+    size_t nodes_used() const {
+        return m_nodes_used;
+    }
+
+private:
+    struct node {
+        void* slots[SLOTS];
+        uint32_t count; // Non-null slots
+        node* next_free;
+    };
+
+    static bool in_range(uint64_t key) {
+        return KEY_BITS == 64 || (key >> (KEY_BITS % 64)) == 0;
+    }
+
+    static size_t index(uint64_t key, unsigned level) {
+        return (key >> (level * BITS_PER_LEVEL)) & (SLOTS - 1);
+    }
+
+    // Nodes insert() has to allocate for `key`, one per level below the deepest existing one
+    size_t missing_nodes(uint64_t key) const {
+        if (!m_root) {
+            return LEVELS;
+        }
+
+        const node* current = m_root;
+        for (unsigned level = LEVELS - 1; level > 0; --level) {
+            current = static_cast<const node*>(current->slots[index(key, level)]);
+            if (!current) {
+                return level;
+            }
+        }
+        return 0;
+    }
+
+    node* allocate_node() {
+        node* n = m_free_nodes;
+
+        if (n) {
+            m_free_nodes = n->next_free;
+        } else if (m_never_used < NODES) {
+            // Handed out in order first, so a zero-initialized pool needs no free list setup
+            n = &m_nodes[m_never_used++];
+        } else {
+            return nullptr;
+        }
+
+        for (void*& slot : n->slots) {
+            slot = nullptr;
+        }
+        n->count = 0;
+        ++m_nodes_used;
+        return n;
+    }
+
+    void free_node(node* n) {
+        n->next_free = m_free_nodes;
+        m_free_nodes = n;
+        --m_nodes_used;
+    }
+
+    node* m_root = nullptr;
+    node* m_free_nodes = nullptr;
+    size_t m_never_used = 0;
+    size_t m_nodes_used = 0;
+    size_t m_size = 0;
+    node m_nodes[NODES] = {};
+};
+
+} // namespace containers
+
+#endif
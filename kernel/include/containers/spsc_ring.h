@@ -0,0 +1,85 @@
+#ifndef CONTAINERS_SPSC_RING_H
+#define CONTAINERS_SPSC_RING_H
+
+#include <core/types.h>
+
+namespace containers {
+
+/**
+ * @brief Fixed-capacity single-producer / single-consumer ring of copyable values.
+ *
+ * One context pushes and one pops, each without locks or atomic
+ * read-modify-write instructions. Producer and consumer indices sit on their
+ * own cache lines so the two sides only share a line when they touch the same
+ * entry. A zero-initialized ring is empty.
+ *
+ * @tparam T Trivially copyable element.
+ * @tparam N Capacity, a power of two.
+ */
+template <typename T, size_t N>
+class spsc_ring {
+    static_assert(N != 0 && (N & (N - 1)) == 0, "SPSC ring capacity must be a power of two");
+
+public:
+    constexpr spsc_ring() = default;
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    /**
+     * @brief Appends a copy of `value`, returns false if the ring is full. Producer only.
+     */
+    bool try_push(const T& value) {
+        size_t head = m_head;
+        if (head - __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE) >= N) {
+            return false;
+        }
+
+        m_entries[head & (N - 1)] = value;
+
+        // Publish the entry only after it is fully written
+        __atomic_store_n(&m_head, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * @brief Moves the oldest entry into `value`, returns false if empty. Consumer only.
+     */
+    bool try_pop(T* value) {
+        size_t tail = m_tail;
+        if (tail == __atomic_load_n(&m_head, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+
+        *value = m_entries[tail & (N - 1)];
+
+        // Release the slot only after it was copied out
+        __atomic_store_n(&m_tail, tail + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * @brief Returns the number of entries, exact only when called by one of the two sides.
+     */
+    size_t size() const {
+        return __atomic_load_n(&m_head, __ATOMIC_ACQUIRE) -
+               __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    static constexpr size_t capacity() {
+        return N;
+    }
+
+private:
+    alignas(64) size_t m_head = 0; // Written by the producer only
+    alignas(64) size_t m_tail = 0; // Written by the consumer only
+    alignas(64) T m_entries[N] = {};
+};
+
+} // namespace containers
+
+#endif
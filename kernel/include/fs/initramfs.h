@@ -0,0 +1,100 @@
+#ifndef FS_INITRAMFS_H
+#define FS_INITRAMFS_H
+
+#include <core/types.h>
+
+namespace fs::initramfs {
+
+// Command line of the multiboot module holding the archive (module2 ... initramfs)
+inline constexpr const char* MODULE_CMDLINE = "initramfs";
+
+// Maximum number of regular files indexed from the archive
+inline constexpr size_t MAX_FILES = 256;
+
+// A regular file inside the archive, neither its path nor its contents are copied out of the module
+struct file {
+    const char* prefix;   // ustar prefix field (leading directories of long paths), may be empty
+    size_t prefix_length; // Length of prefix, the path is prefix + "/" + name when non-zero
+    const char* name;     // ustar name field, not NUL-terminated
+    size_t name_length;   // Length of name
+    uint32_t path_hash;   // FNV-1a hash of the full path, compared before the path bytes
+    uint32_t mode;        // Permission bits from the archive header
+    const uint8_t* data;  // Contents, directly inside the module
+    uint64_t size;        // Size of the contents in bytes
+};
+
+// Open file with a read position
+struct file_handle {
+    const file* node;
+    uint64_t offset;
+};
+
+// Payload of EVENT_INITRAMFS_MOUNTED
+struct mount_payload {
+    uint64_t phys_start;  // Physical address of the archive
+    uint64_t size;        // Size of the archive in bytes
+    uint64_t total_bytes; // Sum of the sizes of all indexed files
+    uint32_t file_count;  // Number of indexed regular files
+    uint32_t reserved;
+} __attribute__((packed));
+
+static_assert(sizeof(mount_payload) == 32, "Initramfs mount payload must be 32 bytes");
+
+/**
+ * @brief Indexes a ustar archive in place.
+ *
+ * Only regular files are indexed; directories are implied by the paths.
+ * Entries beyond MAX_FILES are ignored.
+ *
+ * @param archive Start of the archive.
+ * @param size Size of the archive in bytes.
+ * @return true If the archive was well-formed up to its end-of-archive marker or its size.
+ * @return false If a header failed its checksum or lacked the ustar magic.
+ */
+bool mount(const void* archive, uint64_t size);
+
+/**
+ * @brief Mounts the multiboot module whose command line is MODULE_CMDLINE.
+ *
+ * Emits EVENT_INITRAMFS_MOUNTED on success.
+ *
+ * @return true If the module was found and mounted.
+ */
+bool mount_boot_module();
+
+/**
+ * @brief Looks up a file by path.
+ *
+ * @param path NUL-terminated path, with or without a leading "/".
+ * @param handle Receives the file with its read position at 0.
+ * @return true If the file exists.
+ */
+bool open(const char* path, file_handle* handle);
+
+/**
+ * @brief Copies up to length bytes from the current position and advances it.
+ *
+ * @return size_t Number of bytes copied, 0 at end of file.
+ */
+size_t read(file_handle* handle, void* buffer, size_t length);
+
+/**
+ * @brief Returns a pointer to the file contents for zero-copy access.
+ */
+inline const uint8_t* contents(const file_handle* handle) {
+    return handle->node->data;
+}
+
+/**
+ * @brief Returns the number of indexed files.
+ */
+size_t file_count();
+
+/**
+ * @brief Returns the file at the given index, or nullptr if out of range.
+ */
+const file* file_at(size_t index);
+
+} // namespace fs::initramfs
+
+#endif
@@ -9,21 +9,55 @@ namespace iris {
 // Organized by category for future expansion
 
 // System Events (0x0000 - 0x00FF)
-inline constexpr uint16_t EVENT_IRIS_INIT = 0x0001; // IRIS system initialized
+inline constexpr uint16_t EVENT_IRIS_INIT = 0x0001;        // IRIS system initialized
+inline constexpr uint16_t EVENT_PROFILE_SAMPLE = 0x0002;   // Sampling profiler stack sample
+inline constexpr uint16_t EVENT_TRACE_SCOPE = 0x0003;      // Duration of a traced scope
+inline constexpr uint16_t EVENT_TRACEPOINT_STATS = 0x0004; // Per-CPU tracepoint counters
+inline constexpr uint16_t EVENT_BENCHMARK_RESULT = 0x0005; // In-kernel benchmark result
 
 // Boot Events (0x0100 - 0x01FF)
 inline constexpr uint16_t EVENT_BOOT_START = 0x0100; // Kernel boot started
 inline constexpr uint16_t EVENT_GDT_LOADED = 0x0101; // Global Descriptor Table loaded
 inline constexpr uint16_t EVENT_TSS_LOADED = 0x0102; // Task State Segment loaded
+// 0x0103 - 0x0105 reserved for memory map parsing
+inline constexpr uint16_t EVENT_PMM_INIT_DONE = 0x0106; // Physical frame allocator ready
+inline constexpr uint16_t EVENT_BOOT_PHASE = 0x0107;    // Boot milestone with TSC timestamp
+inline constexpr uint16_t EVENT_BOOT_COMPLETE = 0x0108; // Boot-to-idle summary
+inline constexpr uint16_t EVENT_CPU_FEATURES = 0x0109;  // CPUID feature words of one CPU
 
-// Future categories reserved:
 // Process/Thread Events (0x0200 - 0x02FF)
-// Memory Events (0x0300 - 0x03FF)
+inline constexpr uint16_t EVENT_CONTEXT_SWITCH = 0x0200;  // Scheduler switched tasks on a CPU
+inline constexpr uint16_t EVENT_TASK_MIGRATED = 0x0201;   // Task stolen by another CPU's run queue
+inline constexpr uint16_t EVENT_SCHED_CPU_STATS = 0x0202; // Per-CPU scheduler counters
+inline constexpr uint16_t EVENT_PROCESS_START = 0x0203;   // User process entered ring 3
+inline constexpr uint16_t EVENT_PROCESS_EXIT = 0x0204;    // User process exited, with fault counts
+inline constexpr uint16_t EVENT_CPU_UTILIZATION = 0x0205; // Per-CPU idle and busy cycles
+
 // Interrupt Events (0x0400 - 0x04FF)
+inline constexpr uint16_t EVENT_CPU_EXCEPTION = 0x0400;   // Unhandled CPU exception
+inline constexpr uint16_t EVENT_IPI_SEND = 0x0401;        // Cross-CPU call queued, IPIs sent
+inline constexpr uint16_t EVENT_IPI_RECEIVE = 0x0402;     // Cross-CPU calls served by one IPI
+inline constexpr uint16_t EVENT_INTERRUPT_STATS = 0x0403; // Interrupts of one vector on one CPU
+
 // Synchronization Events (0x0500 - 0x05FF)
+inline constexpr uint16_t EVENT_LOCK_STATS = 0x0500; // Lock contention counters
+
 // I/O Events (0x0600 - 0x06FF)
+inline constexpr uint16_t EVENT_PCI_DEVICE = 0x0600;         // PCI function found by enumeration
+inline constexpr uint16_t EVENT_PCI_ENUMERATION = 0x0601;    // PCI enumeration summary and time
+inline constexpr uint16_t EVENT_BLOCK_DEVICE = 0x0602;       // Block device attached
+inline constexpr uint16_t EVENT_BLOCK_QUEUE_STATS = 0x0603;  // Per-queue block request counters
+inline constexpr uint16_t EVENT_BUFFER_CACHE_STATS = 0x0604; // Buffer cache hit and write counters
+
 // Filesystem Events (0x0700 - 0x07FF)
+inline constexpr uint16_t EVENT_INITRAMFS_MOUNTED = 0x0700; // Initramfs module indexed
+
 // Network Events (0x0800 - 0x08FF)
+inline constexpr uint16_t EVENT_NET_DEVICE = 0x0800;      // Network device attached
+inline constexpr uint16_t EVENT_NET_QUEUE_STATS = 0x0801; // Per-queue-pair packet counters
+
+// Future categories reserved:
+// Memory Events (0x0300 - 0x03FF)
 
 } // namespace iris
 
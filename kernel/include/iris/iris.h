@@ -12,6 +12,9 @@ inline constexpr uint32_t PACKET_MAGIC = 0x53495249;
 // COM2 port for IRIS debug output
 inline constexpr uint16_t IRIS_SERIAL_PORT = static_cast<uint16_t>(serial::port_base::COM2);
 
+// Bytes of packets queued for the transmitter coroutine while async transmission is on
+inline constexpr size_t PACKET_QUEUE_SIZE = 4096;
+
 // Packet structure - 24 bytes total, 8-byte aligned
 struct packet {
     // Frame header (8 bytes)
@@ -66,6 +69,37 @@ void emit_with_payload(uint16_t event_type, uint64_t timestamp_ns, uint8_t cpu_i
  */
 void init();
 
+/**
+ * @brief Returns whether the IRIS serial port has been set up.
+ *
+ * Code that can run before iris::init (e.g. tracepoints) uses this to avoid
+ * writing to an unconfigured port.
+ */
+bool is_initialized();
+
+/**
+ * @brief Switches packet transmission between blocking writes and a transmitter coroutine.
+ *
+ * When on, emit() only copies the packet into a PACKET_QUEUE_SIZE byte
+ * queue; a coroutine on the calling CPU's executor moves it to COM2 one FIFO
+ * burst per transmit interrupt. Must be enabled on the CPU that receives the
+ * COM2 interrupt. A packet that does not fit the queue is written blocking
+ * after everything queued, so packets never reorder. Turning it off writes
+ * out what is still queued.
+ *
+ * @param enabled Whether emit() queues packets instead of writing them.
+ * @return false if the transmitter coroutine could not be started.
+ */
+bool set_async_transmission(bool enabled);
+
+/**
+ * @brief Writes every queued packet out with blocking writes.
+ *
+ * Used before halting, e.g. on an unhandled exception, when the executor
+ * will not run again.
+ */
+void flush();
+
 } // namespace iris
 
 #endif
@@ -0,0 +1,72 @@
+#ifndef IRIS_PROFILER_H
+#define IRIS_PROFILER_H
+
+#include <core/types.h>
+
+namespace iris::profiler {
+
+// Maximum number of instruction pointers captured per sample (interrupted RIP included)
+inline constexpr size_t MAX_STACK_DEPTH = 8;
+
+// Number of samples each CPU can buffer between flushes (must be a power of two)
+inline constexpr uint32_t SAMPLE_BUFFER_SIZE = 64;
+
+static_assert((SAMPLE_BUFFER_SIZE & (SAMPLE_BUFFER_SIZE - 1)) == 0,
+              "Sample buffer size must be a power of two");
+
+// Payload of EVENT_PROFILE_SAMPLE, only the first `depth` entries of ips are transmitted
+struct sample {
+    uint64_t tsc;                  // TSC value when the sample was taken
+    uint32_t depth;                // Number of valid entries in ips
+    uint32_t dropped;              // Samples lost on this CPU since the previous streamed sample
+    uint64_t ips[MAX_STACK_DEPTH]; // Interrupted RIP followed by return addresses, innermost first
+};
+
+inline constexpr size_t SAMPLE_HEADER_SIZE = sizeof(sample) - sizeof(sample::ips);
+
+static_assert(SAMPLE_HEADER_SIZE == 16, "Profiler sample header must not contain padding");
+
+/**
+ * @brief Enables sample collection on all CPUs.
+ *
+ * Samples are taken from the periodic local APIC timer interrupt, so the
+ * sampling rate equals the kernel tick frequency.
+ */
+void start();
+
+/**
+ * @brief Disables sample collection. Already buffered samples can still be flushed.
+ */
+void stop();
+
+/**
+ * @brief Returns whether sample collection is enabled.
+ */
+bool is_running();
+
+/**
+ * @brief Records a sample for the calling CPU.
+ *
+ * Intended to be called from the timer interrupt. The call stack is recovered
+ * by walking the frame-pointer chain starting at the interrupted RBP, stopping
+ * at the first frame that lies outside the kernel image. The sample is pushed
+ * into a lock-free single-producer/single-consumer ring owned by the calling
+ * CPU; if the ring is full, the sample is counted as dropped.
+ *
+ * @param rip Instruction pointer of the interrupted context.
+ * @param rbp Frame pointer of the interrupted context.
+ */
+void record_sample(uint64_t rip, uint64_t rbp);
+
+/**
+ * @brief Streams the samples buffered on every online CPU as EVENT_PROFILE_SAMPLE events.
+ *
+ * Each ring has a single consumer, so only one CPU may flush (the BSP's idle
+ * loop). Must be called with interrupts enabled from non-interrupt context so
+ * serial transmission never happens inside the timer interrupt.
+ */
+void flush();
+
+} // namespace iris::profiler
+
+#endif
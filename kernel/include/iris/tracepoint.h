@@ -0,0 +1,133 @@
+#ifndef IRIS_TRACEPOINT_H
+#define IRIS_TRACEPOINT_H
+
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/percpu/percpu.h>
+#include <iris/event_types.h>
+
+namespace iris {
+
+// Instrumented code paths, the numeric values are part of the IRIS protocol
+enum class tracepoint : uint16_t {
+    ARCH_INIT_GDT = 0,
+    SERIAL_INIT_PORT = 1,
+    IRIS_INIT = 2,
+    MEMORY_MEMCMP = 3,
+    MEMORY_MEMCPY = 4,
+    MEMORY_MEMMOVE = 5,
+    MEMORY_MEMSET = 6,
+    MEMORY_MEMZERO = 7,
+};
+
+inline constexpr size_t TRACEPOINT_COUNT = 8;
+
+// What a scope_trace does when its scope ends
+enum class trace_mode : uint8_t {
+    EMIT,         // Update the counters and emit an EVENT_TRACE_SCOPE duration event
+    COUNTERS_ONLY // Update the counters only, for hot paths that cannot afford an event per call
+};
+
+// Accumulated cost of a tracepoint on one CPU
+struct tracepoint_stats {
+    uint64_t calls;
+    uint64_t total_cycles;
+    uint64_t max_cycles;
+};
+
+// Payload of EVENT_TRACE_SCOPE
+struct trace_scope_payload {
+    uint64_t start_tsc; // TSC value when the scope was entered
+    uint64_t cycles;    // TSC cycles spent inside the scope
+    uint16_t id;        // tracepoint
+    uint16_t reserved1;
+    uint32_t reserved2;
+} __attribute__((packed));
+
+static_assert(sizeof(trace_scope_payload) == 24, "Trace scope payload must be 24 bytes");
+
+// Payload of EVENT_TRACEPOINT_STATS
+struct tracepoint_stats_payload {
+    uint64_t calls;
+    uint64_t total_cycles;
+    uint64_t max_cycles;
+    uint16_t id; // tracepoint
+    uint16_t reserved1;
+    uint32_t reserved2;
+} __attribute__((packed));
+
+static_assert(sizeof(tracepoint_stats_payload) == 32, "Tracepoint stats payload must be 32 bytes");
+
+DECLARE_PER_CPU(tracepoint_stats, g_tracepoint_stats[TRACEPOINT_COUNT]);
+
+/**
+ * @brief Accounts a scope that finished before the per-CPU areas were online.
+ *
+ * Such scopes can only run on the bootstrapping processor, so they are kept in
+ * a single static table that is reported together with CPU 0's counters.
+ */
+void account_early_scope(tracepoint id, uint64_t cycles);
+
+/**
+ * @brief Emits an EVENT_TRACE_SCOPE event for a finished scope.
+ *
+ * Nothing is sent until IRIS has been initialized.
+ */
+void emit_scope(tracepoint id, uint64_t start_tsc, uint64_t cycles);
+
+/**
+ * @brief Emits one EVENT_TRACEPOINT_STATS event per tracepoint hit, for every online CPU.
+ *
+ * Each event carries the CPU its counters belong to, whichever CPU emits it.
+ */
+void emit_tracepoint_stats();
+
+/**
+ * @brief Measures the TSC cycles spent between construction and destruction.
+ *
+ * Counters are kept per CPU and updated with single GS-relative instructions,
+ * so an interrupt can at worst race the max_cycles update of the same
+ * tracepoint. Compiles to nothing unless ENABLE_TRACEPOINTS is defined.
+ *
+ * Usage:
+ *   iris::scope_trace<iris::tracepoint::SERIAL_INIT_PORT> trace;
+ */
+template <tracepoint Id, trace_mode Mode = trace_mode::EMIT>
+class scope_trace {
+public:
+#ifdef ENABLE_TRACEPOINTS
+    scope_trace() : m_start(arch::x86::rdtsc()) {}
+
+    ~scope_trace() {
+        uint64_t cycles = arch::x86::rdtsc() - m_start;
+
+        if (arch::x86::per_cpu_online()) [[likely]] {
+            tracepoint_stats* stats = &g_tracepoint_stats[static_cast<size_t>(Id)];
+
+            arch::x86::this_cpu_add(&stats->calls, uint64_t{1});
+            arch::x86::this_cpu_add(&stats->total_cycles, cycles);
+
+            if (cycles > arch::x86::this_cpu_read(&stats->max_cycles)) {
+                arch::x86::this_cpu_write(&stats->max_cycles, cycles);
+            }
+        } else {
+            account_early_scope(Id, cycles);
+        }
+
+        if constexpr (Mode == trace_mode::EMIT) {
+            emit_scope(Id, m_start, cycles);
+        }
+    }
+
+private:
+    uint64_t m_start;
+#else
+    // User-provided so disabled tracepoints do not trigger unused variable warnings
+    scope_trace() {}
+#endif
+
+    static_assert(static_cast<size_t>(Id) < TRACEPOINT_COUNT, "Unknown tracepoint");
+};
+
+} // namespace iris
+
+#endif
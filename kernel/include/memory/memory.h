@@ -71,6 +71,16 @@ void* memset(void* dest, int value, size_t count);
  */
 void* memzero(void* dest, size_t count);
 
+/**
+ * @brief Selects the copy and fill implementations for the CPU's features.
+ *
+ * Switches memcpy, memset and memzero to REP MOVSB/STOSB for longer regions
+ * on CPUs with enhanced REP string operations, and memcpy for every length
+ * with fast short REP MOVSB. Called once on the BSP after its features were
+ * probed, until then the portable loops are used.
+ */
+void init_string_operations();
+
 } // namespace memory
 
 #endif
@@ -0,0 +1,74 @@
+#ifndef MEMORY_PMM_H
+#define MEMORY_PMM_H
+
+#include <arch/x86/paging/paging.h>
+#include <core/types.h>
+
+namespace memory::pmm {
+
+// Only frames inside the boot-time kernel mapping are managed, so every frame handed out is
+// reachable through phys_to_virt without mapping it first
+inline constexpr uint64_t MANAGED_MEMORY_SIZE = arch::x86::BOOT_MAPPED_MEMORY_SIZE;
+inline constexpr size_t MAX_FRAMES = MANAGED_MEMORY_SIZE / arch::x86::PAGE_SIZE;
+
+// Payload of EVENT_PMM_INIT_DONE
+struct init_payload {
+    uint64_t available_frames; // Frames the bootloader reported AVAILABLE below MANAGED_MEMORY_SIZE
+    uint64_t free_frames;      // Frames left after the kernel image, boot info and modules
+    uint64_t init_cycles;      // TSC cycles spent building the bitmap
+    uint64_t reserved;
+} __attribute__((packed));
+
+static_assert(sizeof(init_payload) == 32, "PMM init payload must be 32 bytes");
+
+/**
+ * @brief Builds the free frame bitmap from the multiboot2 memory map.
+ *
+ * Everything below the end of the kernel image (including the first megabyte
+ * used by the AP trampoline), the multiboot2 information structure and every
+ * boot module stay reserved. Reports the result with EVENT_PMM_INIT_DONE.
+ *
+ * @return true If the memory map was found.
+ * @return false If the bootloader did not provide a memory map, no frame is free then.
+ */
+bool init();
+
+/**
+ * @brief Allocates one 4KB physical frame with a reference count of 1.
+ *
+ * The frame is not cleared. Safe to call from interrupt context.
+ *
+ * @return uint64_t Physical address of the frame, or 0 if physical memory is exhausted.
+ */
+uint64_t allocate_frame();
+
+/**
+ * @brief Adds a reference to an allocated frame, used when a page is shared copy-on-write.
+ *
+ * @param phys Physical address of the frame.
+ */
+void share_frame(uint64_t phys);
+
+/**
+ * @brief Drops one reference to a frame and returns it to the free pool with the last one.
+ *
+ * @param phys Physical address of the frame.
+ */
+void free_frame(uint64_t phys);
+
+/**
+ * @brief Returns the number of references to an allocated frame.
+ *
+ * A count of 1 means the caller's mapping is the only one, a copy-on-write
+ * page can then be made writable in place.
+ */
+uint16_t frame_reference_count(uint64_t phys);
+
+/**
+ * @brief Returns the number of frames currently free.
+ */
+size_t free_frame_count();
+
+} // namespace memory::pmm
+
+#endif
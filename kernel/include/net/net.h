@@ -0,0 +1,171 @@
+#ifndef NET_NET_H
+#define NET_NET_H
+
+#include <core/types.h>
+
+namespace net {
+
+// Bytes of one packet buffer, two share a page frame
+inline constexpr uint32_t PACKET_BUFFER_SIZE = 2048;
+
+// Bytes in front of a packet's frame, drivers place their per-packet header there
+inline constexpr uint32_t PACKET_HEADROOM = 64;
+
+// Largest frame a packet holds
+inline constexpr uint32_t MAX_FRAME_SIZE = PACKET_BUFFER_SIZE - PACKET_HEADROOM;
+
+// Packets in the pool, a power of two
+inline constexpr size_t PACKET_POOL_SIZE = 2048;
+
+// Largest number of registered network devices
+inline constexpr size_t MAX_DEVICES = 4;
+
+inline constexpr size_t NAME_LENGTH = 8;
+inline constexpr size_t MAC_LENGTH = 6;
+
+// packet::flags
+inline constexpr uint8_t PACKET_CHECKSUM_PARTIAL = 1U << 0; // Transmit: checksum still to be computed
+inline constexpr uint8_t PACKET_CHECKSUM_VALID = 1U << 1;   // Receive: the device verified it
+
+/**
+ * @brief An Ethernet frame in a buffer from the packet pool.
+ *
+ * Whoever holds the pointer owns the buffer: transmit() returns it to the pool
+ * once the device sent it, a receive handler gets it from the driver and must
+ * free or transmit it. Receive buffers are posted to the device as they are,
+ * so a frame reaches its handler without a copy.
+ */
+struct packet {
+    uint8_t* data;   // Frame start, PACKET_HEADROOM bytes into the buffer
+    uint64_t phys;   // Physical address of data
+    uint32_t length; // Frame bytes
+    uint16_t queue;  // Queue pair the frame arrived on
+    uint8_t flags;
+
+    // With PACKET_CHECKSUM_PARTIAL, the ones' complement sum of the bytes from
+    // checksum_start to the end is stored at checksum_start + checksum_offset
+    uint16_t checksum_start;
+    uint16_t checksum_offset;
+
+    packet* next; // Free for the owner
+};
+
+struct device;
+
+// Called with every batch of received frames, from the queue's interrupt or from poll()
+using receive_handler = void (*)(device* dev, packet* const* packets, size_t count);
+
+struct device_operations {
+    /**
+     * @brief Queues frames on one transmit queue and notifies the device once.
+     *
+     * @return size_t Packets accepted from the front of the array, the rest
+     * did not fit in the queue and still belong to the caller.
+     */
+    size_t (*transmit)(device* dev, uint16_t queue, packet* const* packets, size_t count);
+
+    // Delivers received frames and frees sent ones without waiting for an interrupt
+    void (*poll)(device* dev, uint16_t queue);
+};
+
+struct device {
+    char name[NAME_LENGTH];
+    uint8_t mac[MAC_LENGTH];
+    uint16_t mtu;
+    uint16_t queue_count;  // Queue pairs, CPU n transmits on pair n % queue_count
+    bool polled;           // No receive interrupts, frames only arrive through poll()
+    bool checksum_offload; // The device computes PACKET_CHECKSUM_PARTIAL checksums
+    receive_handler receive;
+    const device_operations* ops;
+    void* driver_data;
+};
+
+/**
+ * @brief Allocates the packet pool, called by drivers before they post receive buffers.
+ *
+ * Only the first call allocates.
+ *
+ * @return false If no frame could be allocated for it.
+ */
+bool init_pool();
+
+/**
+ * @brief Takes up to `count` packets from the pool, callable from any context.
+ *
+ * Packets come back with length, flags and headroom reset.
+ *
+ * @return size_t Packets stored to `packets`, fewer if the pool ran low.
+ */
+size_t allocate_packets(packet** packets, size_t count);
+
+/**
+ * @brief Takes one packet from the pool, or returns nullptr if it is empty.
+ */
+packet* allocate_packet();
+
+/**
+ * @brief Returns packets to the pool, callable from any context.
+ */
+void free_packets(packet* const* packets, size_t count);
+
+void free_packet(packet* pkt);
+
+/**
+ * @brief Returns the number of packets currently in the pool.
+ */
+size_t free_packet_count();
+
+/**
+ * @brief Makes a device visible to get_device() and find_device().
+ *
+ * @return false If MAX_DEVICES devices are already registered.
+ */
+bool register_device(device* dev);
+
+size_t device_count();
+
+/**
+ * @brief Returns the device at an index of the registry, or nullptr if out of range.
+ */
+device* get_device(size_t index);
+
+/**
+ * @brief Returns the device with a name such as "eth0", or nullptr.
+ */
+device* find_device(const char* name);
+
+/**
+ * @brief Replaces the handler of a device's received frames, nullptr drops them.
+ */
+void set_receive_handler(device* dev, receive_handler handler);
+
+/**
+ * @brief Passes received frames to the device's handler, used by drivers.
+ */
+void deliver(device* dev, packet* const* packets, size_t count);
+
+/**
+ * @brief Transmits frames on the calling CPU's queue pair of a device.
+ *
+ * Frames that are empty or longer than MAX_FRAME_SIZE are freed instead of
+ * being queued. Checksums the device cannot offload are computed first.
+ *
+ * @return size_t Packets consumed from the front of the array.
+ */
+size_t transmit(device* dev, packet* const* packets, size_t count);
+
+/**
+ * @brief Receives and frees sent frames on the calling CPU's queue pair without its interrupt.
+ */
+void poll(device* dev);
+
+/**
+ * @brief Polls every queue pair of a polled device, does nothing otherwise.
+ *
+ * For receivers that may not be on the CPU whose queue their frames arrive on.
+ */
+void poll_all(device* dev);
+
+} // namespace net
+
+#endif
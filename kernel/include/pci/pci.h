@@ -0,0 +1,225 @@
+#ifndef PCI_PCI_H
+#define PCI_PCI_H
+
+#include <arch/x86/irq/irq.h>
+#include <core/types.h>
+
+namespace pci {
+
+// Largest number of functions kept in the device table, further ones are ignored
+inline constexpr size_t MAX_DEVICES = 64;
+
+// Largest number of registered drivers
+inline constexpr size_t MAX_DRIVERS = 16;
+
+// Largest number of ECAM regions kept from the MCFG table
+inline constexpr size_t MAX_ECAM_REGIONS = 4;
+
+inline constexpr size_t BAR_COUNT = 6;
+
+// Vendor ID read from a function that does not exist
+inline constexpr uint16_t VENDOR_NONE = 0xFFFF;
+
+// Configuration space registers of the common header
+inline constexpr uint16_t REG_VENDOR_ID = 0x00;
+inline constexpr uint16_t REG_DEVICE_ID = 0x02;
+inline constexpr uint16_t REG_COMMAND = 0x04;
+inline constexpr uint16_t REG_STATUS = 0x06;
+inline constexpr uint16_t REG_REVISION = 0x08;
+inline constexpr uint16_t REG_HEADER_TYPE = 0x0E;
+inline constexpr uint16_t REG_BAR0 = 0x10;
+inline constexpr uint16_t REG_SECONDARY_BUS = 0x19; // PCI-to-PCI bridges only
+inline constexpr uint16_t REG_SUBSYSTEM_VENDOR_ID = 0x2C;
+inline constexpr uint16_t REG_SUBSYSTEM_ID = 0x2E;
+inline constexpr uint16_t REG_CAPABILITIES = 0x34;
+inline constexpr uint16_t REG_INTERRUPT_LINE = 0x3C;
+inline constexpr uint16_t REG_INTERRUPT_PIN = 0x3D;
+
+// Command register bits
+inline constexpr uint16_t COMMAND_IO_SPACE = 1U << 0;
+inline constexpr uint16_t COMMAND_MEMORY_SPACE = 1U << 1;
+inline constexpr uint16_t COMMAND_BUS_MASTER = 1U << 2;
+inline constexpr uint16_t COMMAND_INTX_DISABLE = 1U << 10;
+
+// Capability IDs
+inline constexpr uint8_t CAPABILITY_MSI = 0x05;
+inline constexpr uint8_t CAPABILITY_VENDOR = 0x09;
+inline constexpr uint8_t CAPABILITY_PCIE = 0x10;
+inline constexpr uint8_t CAPABILITY_MSIX = 0x11;
+
+// Bytes of configuration space cached per function, the whole common header
+inline constexpr size_t CACHED_HEADER_SIZE = 64;
+
+// Location of a function in the configuration space
+struct address {
+    uint16_t segment;
+    uint8_t bus;
+    uint8_t slot;
+    uint8_t function;
+};
+
+enum class bar_type : uint8_t {
+    NONE = 0,
+    IO = 1,
+    MEMORY32 = 2,
+    MEMORY64 = 3, // Occupies this BAR and the next one
+};
+
+struct bar {
+    uint64_t address; // Physical address or I/O port base
+    uint64_t size;
+    bar_type type;
+    bool prefetchable;
+};
+
+struct driver;
+
+// A function found by enumeration, its header as read at that time
+struct device {
+    address location;
+    uint16_t vendor_id;
+    uint16_t device_id;
+    uint16_t subsystem_vendor_id;
+    uint16_t subsystem_id;
+    uint8_t class_code;
+    uint8_t subclass;
+    uint8_t prog_if;
+    uint8_t revision;
+    uint8_t header_type;    // Without the multi-function bit
+    uint8_t interrupt_pin;  // 1-4 for INTA-INTD, 0 if none
+    uint8_t interrupt_line; // Legacy IRQ the firmware assigned, 0xFF if none
+    uint8_t msi_offset;     // Offset of the MSI capability, 0 if absent
+    uint8_t msix_offset;    // Offset of the MSI-X capability, 0 if absent
+    uint8_t pcie_offset;    // Offset of the PCI Express capability, 0 if absent
+    bar bars[BAR_COUNT];
+    uint32_t header[CACHED_HEADER_SIZE / sizeof(uint32_t)];
+    const driver* bound;
+    void* driver_data;
+};
+
+// Vendor and device ID pair a driver handles
+struct device_id {
+    uint16_t vendor_id;
+    uint16_t device_id;
+};
+
+struct driver {
+    const char* name;
+    const device_id* ids;
+    size_t id_count;
+
+    // Called for every unbound function with a matching ID, returns true to bind to it
+    bool (*probe)(device* dev);
+};
+
+// Payload of EVENT_PCI_DEVICE
+struct device_payload {
+    uint16_t segment;
+    uint8_t bus;
+    uint8_t slot;
+    uint8_t function;
+    uint8_t class_code;
+    uint8_t subclass;
+    uint8_t prog_if;
+    uint16_t vendor_id;
+    uint16_t device_id;
+    uint16_t subsystem_vendor_id;
+    uint16_t subsystem_id;
+    uint8_t revision;
+    uint8_t header_type;
+    uint8_t interrupt_pin;
+    uint8_t capabilities; // Bit 0 MSI, bit 1 MSI-X, bit 2 PCI Express
+    uint32_t reserved;
+    char driver[16]; // Name of the bound driver, NUL-padded, empty if none
+} __attribute__((packed));
+
+// Payload of EVENT_PCI_ENUMERATION
+struct enumeration_payload {
+    uint64_t cycles;         // TSC cycles spent enumerating and binding
+    uint64_t nanoseconds;    // The same, 0 if the TSC is not calibrated
+    uint32_t device_count;   // Functions in the device table
+    uint32_t bound_count;    // Functions a driver bound to
+    uint16_t buses_scanned;
+    uint8_t ecam_regions;    // 0 if the legacy port mechanism was used
+    uint8_t truncated;       // 1 if functions were left out because the table was full
+    uint32_t reserved;
+} __attribute__((packed));
+
+static_assert(sizeof(device_payload) == 40, "PCI device payload must be 40 bytes");
+static_assert(sizeof(enumeration_payload) == 32, "PCI enumeration payload must be 32 bytes");
+
+/**
+ * @brief Enumerates every PCI function and binds the registered drivers.
+ *
+ * Configuration space is accessed through the ECAM regions of the ACPI MCFG
+ * table, or through ports 0xCF8/0xCFC if there is none. Buses are found by
+ * following PCI-to-PCI bridges from the host bridges, not by probing all
+ * 256. Emits EVENT_PCI_DEVICE per function and EVENT_PCI_ENUMERATION.
+ * Called once after arch::arch_first_stage_init().
+ */
+void init();
+
+/**
+ * @brief Adds a driver and binds it to matching functions that are still unbound.
+ *
+ * Drivers registered before init() are bound during enumeration.
+ *
+ * @return false If MAX_DRIVERS drivers are already registered.
+ */
+bool register_driver(const driver* drv);
+
+size_t device_count();
+
+/**
+ * @brief Returns the function at an index of the device table, or nullptr if out of range.
+ */
+device* get_device(size_t index);
+
+uint8_t read8(const device* dev, uint16_t offset);
+uint16_t read16(const device* dev, uint16_t offset);
+uint32_t read32(const device* dev, uint16_t offset);
+void write8(const device* dev, uint16_t offset, uint8_t value);
+void write16(const device* dev, uint16_t offset, uint16_t value);
+void write32(const device* dev, uint16_t offset, uint32_t value);
+
+/**
+ * @brief Sets bits of the command register, e.g. COMMAND_MEMORY_SPACE | COMMAND_BUS_MASTER.
+ */
+void enable(const device* dev, uint16_t command_bits);
+
+/**
+ * @brief Returns the offset of a capability, or 0 if the function does not have it.
+ *
+ * @param after Offset of a previous match to continue after, 0 to start from the first.
+ */
+uint8_t find_capability(const device* dev, uint8_t id, uint8_t after = 0);
+
+/**
+ * @brief Identity maps a memory BAR as uncacheable.
+ *
+ * @return void* Virtual address of the BAR, or nullptr if it is not a memory BAR.
+ */
+void* map_bar(const device* dev, size_t index);
+
+/**
+ * @brief Points the function's MSI capability at a vector and enables it.
+ *
+ * Disables INTx delivery of the function. Only a single message is enabled.
+ *
+ * @return false If the function has no MSI capability or the vector's CPU is not addressable.
+ */
+bool enable_msi(const device* dev, arch::x86::irq_vector vector);
+
+/**
+ * @brief Points an MSI-X table entry at a vector, unmasks it and enables MSI-X.
+ *
+ * Disables INTx delivery of the function. Entries not set up stay masked.
+ *
+ * @return false If the function has no MSI-X capability, the entry is out of range,
+ * the table BAR cannot be mapped or the vector's CPU is not addressable.
+ */
+bool enable_msix(const device* dev, uint16_t entry, arch::x86::irq_vector vector);
+
+} // namespace pci
+
+#endif
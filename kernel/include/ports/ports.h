@@ -2,6 +2,9 @@
 #define PORTS_H
 #include <types.h>
 
+// Port accessors are a single instruction, a call around them would cost more than the body
+#define PORT_IO_INLINE inline __attribute__((always_inline))
+
 /**
  * @brief Writes an 8-bit value to the specified I/O port.
  * 
@@ -12,7 +15,9 @@
  * @param port The I/O port address to write to.
  * @param value The 8-bit value to be written to the port.
  */
-void outb(uint16_t port, uint8_t value);
+PORT_IO_INLINE void outb(uint16_t port, uint8_t value) {
+    asm volatile("outb %1, %0" : : "dN"(port), "a"(value));
+}
 
 /**
  * @brief Reads an 8-bit value from the specified I/O port.
@@ -23,7 +28,11 @@ void outb(uint16_t port, uint8_t value);
  * @param port The I/O port address to read from.
  * @return uint8_t The 8-bit value read from the port.
  */
-uint8_t inb(uint16_t port);
+PORT_IO_INLINE uint8_t inb(uint16_t port) {
+    uint8_t ret;
+    asm volatile("inb %1, %0" : "=a"(ret) : "dN"(port));
+    return ret;
+}
 
 /**
  * @brief Writes a 16-bit value to the specified I/O port.
@@ -35,7 +44,9 @@ uint8_t inb(uint16_t port);
  * @param port The I/O port address to write to.
  * @param val The 16-bit value to be written to the port.
  */
-void outw(uint16_t port, uint16_t val);
+PORT_IO_INLINE void outw(uint16_t port, uint16_t val) {
+    asm volatile("outw %w0, %w1" : : "a"(val), "Nd"(port));
+}
 
 /**
  * @brief Reads a 16-bit value from the specified I/O port.
@@ -47,7 +58,11 @@ void outw(uint16_t port, uint16_t val);
  * @param port The I/O port address to read from.
  * @return uint16_t The 16-bit value read from the port.
  */
-uint16_t inw(uint16_t port);
+PORT_IO_INLINE uint16_t inw(uint16_t port) {
+    uint16_t ret;
+    asm volatile("inw %w1, %w0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
 
 /**
  * @brief Writes a 32-bit value to the specified I/O port.
@@ -59,7 +74,9 @@ uint16_t inw(uint16_t port);
  * @param port The I/O port address to write to.
  * @param val The 32-bit value to be written to the port.
  */
-void outl(uint16_t port, uint32_t val);
+PORT_IO_INLINE void outl(uint16_t port, uint32_t val) {
+    asm volatile("outl %0, %1" : : "a"(val), "Nd"(port));
+}
 
 /**
  * @brief Reads a 32-bit value from the specified I/O port.
@@ -71,6 +88,91 @@ void outl(uint16_t port, uint32_t val);
  * @param port The I/O port address to read from.
  * @return uint32_t The 32-bit value read from the port.
  */
-uint32_t inl(uint16_t port);
+PORT_IO_INLINE uint32_t inl(uint16_t port) {
+    uint32_t ret;
+    asm volatile("inl %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+/**
+ * @brief Reads `count` 8-bit values from the specified I/O port into a buffer.
+ *
+ * Uses `rep insb`, so the whole transfer is a single instruction instead of
+ * one `inb` per value. Intended for bulk transfers such as PIO data registers.
+ *
+ * @param port The I/O port address to read from.
+ * @param buffer Destination for the bytes read, at least `count` * 1 bytes.
+ * @param count Number of 8-bit values to read.
+ */
+PORT_IO_INLINE void insb(uint16_t port, void* buffer, size_t count) {
+    asm volatile("rep insb" : "+D"(buffer), "+c"(count) : "d"(port) : "memory");
+}
+
+/**
+ * @brief Writes `count` 8-bit values from a buffer to the specified I/O port.
+ *
+ * Uses `rep outsb`, the string counterpart of `outb`.
+ *
+ * @param port The I/O port address to write to.
+ * @param buffer Source of the bytes to write, at least `count` * 1 bytes.
+ * @param count Number of 8-bit values to write.
+ */
+PORT_IO_INLINE void outsb(uint16_t port, const void* buffer, size_t count) {
+    asm volatile("rep outsb" : "+S"(buffer), "+c"(count) : "d"(port) : "memory");
+}
+
+/**
+ * @brief Reads `count` 16-bit values from the specified I/O port into a buffer.
+ *
+ * Uses `rep insw`, so the whole transfer is a single instruction instead of
+ * one `inw` per value. Intended for bulk transfers such as PIO data registers.
+ *
+ * @param port The I/O port address to read from.
+ * @param buffer Destination for the words read, at least `count` * 2 bytes.
+ * @param count Number of 16-bit values to read.
+ */
+PORT_IO_INLINE void insw(uint16_t port, void* buffer, size_t count) {
+    asm volatile("rep insw" : "+D"(buffer), "+c"(count) : "d"(port) : "memory");
+}
+
+/**
+ * @brief Writes `count` 16-bit values from a buffer to the specified I/O port.
+ *
+ * Uses `rep outsw`, the string counterpart of `outw`.
+ *
+ * @param port The I/O port address to write to.
+ * @param buffer Source of the words to write, at least `count` * 2 bytes.
+ * @param count Number of 16-bit values to write.
+ */
+PORT_IO_INLINE void outsw(uint16_t port, const void* buffer, size_t count) {
+    asm volatile("rep outsw" : "+S"(buffer), "+c"(count) : "d"(port) : "memory");
+}
+
+/**
+ * @brief Reads `count` 32-bit values from the specified I/O port into a buffer.
+ *
+ * Uses `rep insl`, so the whole transfer is a single instruction instead of
+ * one `inl` per value. Intended for bulk transfers such as PIO data registers.
+ *
+ * @param port The I/O port address to read from.
+ * @param buffer Destination for the double words read, at least `count` * 4 bytes.
+ * @param count Number of 32-bit values to read.
+ */
+PORT_IO_INLINE void insl(uint16_t port, void* buffer, size_t count) {
+    asm volatile("rep insl" : "+D"(buffer), "+c"(count) : "d"(port) : "memory");
+}
+
+/**
+ * @brief Writes `count` 32-bit values from a buffer to the specified I/O port.
+ *
+ * Uses `rep outsl`, the string counterpart of `outl`.
+ *
+ * @param port The I/O port address to write to.
+ * @param buffer Source of the double words to write, at least `count` * 4 bytes.
+ * @param count Number of 32-bit values to write.
+ */
+PORT_IO_INLINE void outsl(uint16_t port, const void* buffer, size_t count) {
+    asm volatile("rep outsl" : "+S"(buffer), "+c"(count) : "d"(port) : "memory");
+}
 
 #endif
@@ -0,0 +1,64 @@
+#ifndef PROC_ELF_H
+#define PROC_ELF_H
+
+#include <core/types.h>
+
+namespace proc::elf {
+
+// e_ident layout
+inline constexpr size_t IDENT_SIZE = 16;
+inline constexpr size_t IDENT_CLASS = 4;
+inline constexpr size_t IDENT_DATA = 5;
+inline constexpr size_t IDENT_VERSION = 6;
+
+inline constexpr uint8_t MAGIC[4] = {0x7F, 'E', 'L', 'F'};
+inline constexpr uint8_t CLASS_64 = 2;
+inline constexpr uint8_t DATA_LITTLE_ENDIAN = 1;
+inline constexpr uint8_t VERSION_CURRENT = 1;
+
+inline constexpr uint16_t TYPE_EXECUTABLE = 2;
+inline constexpr uint16_t MACHINE_X86_64 = 62;
+
+// Program header types, every other type is ignored by the loader
+inline constexpr uint32_t SEGMENT_LOAD = 1;
+
+// Program header flags
+inline constexpr uint32_t SEGMENT_EXECUTE = 1 << 0;
+inline constexpr uint32_t SEGMENT_WRITE = 1 << 1;
+inline constexpr uint32_t SEGMENT_READ = 1 << 2;
+
+struct header {
+    uint8_t ident[IDENT_SIZE];
+    uint16_t type;
+    uint16_t machine;
+    uint32_t version;
+    uint64_t entry;
+    uint64_t program_header_offset;
+    uint64_t section_header_offset;
+    uint32_t flags;
+    uint16_t header_size;
+    uint16_t program_header_size;
+    uint16_t program_header_count;
+    uint16_t section_header_size;
+    uint16_t section_header_count;
+    uint16_t section_names_index;
+} __attribute__((packed));
+
+static_assert(sizeof(header) == 64, "ELF64 header must be 64 bytes");
+
+struct program_header {
+    uint32_t type;
+    uint32_t flags;
+    uint64_t offset;        // File offset of the first byte
+    uint64_t vaddr;         // Virtual address of the first byte
+    uint64_t paddr;         // Unused
+    uint64_t file_size;     // Bytes present in the file
+    uint64_t memory_size;   // Bytes in memory, the rest after file_size is zero-filled
+    uint64_t align;
+} __attribute__((packed));
+
+static_assert(sizeof(program_header) == 56, "ELF64 program header must be 56 bytes");
+
+} // namespace proc::elf
+
+#endif
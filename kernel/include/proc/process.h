@@ -0,0 +1,191 @@
+#ifndef PROC_PROCESS_H
+#define PROC_PROCESS_H
+
+#include <arch/x86/fpu/fpu.h>
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/syscall/syscall.h>
+#include <core/types.h>
+
+namespace sched {
+struct task;
+}
+
+namespace proc {
+
+// Number of processes that can exist at the same time
+inline constexpr size_t MAX_PROCESSES = 64;
+
+// PT_LOAD segments plus the stack
+inline constexpr size_t MAX_REGIONS = 16;
+
+// Demand-zero user stack right below the top of user space, one unmapped guard page above it
+inline constexpr uint64_t USER_STACK_TOP = arch::x86::USER_SPACE_END - arch::x86::PAGE_SIZE;
+inline constexpr uint64_t USER_STACK_SIZE = 0x100000;
+
+// Exit code of a process killed by a page fault it was not allowed to take (-EFAULT)
+inline constexpr int32_t EXIT_PAGE_FAULT = -14;
+
+// Page fault error code bits pushed by the CPU
+inline constexpr uint64_t PAGE_FAULT_PRESENT = 1 << 0;
+inline constexpr uint64_t PAGE_FAULT_WRITE = 1 << 1;
+inline constexpr uint64_t PAGE_FAULT_USER = 1 << 2;
+inline constexpr uint64_t PAGE_FAULT_INSTRUCTION = 1 << 4;
+
+/*
+    A page-aligned range of the user address space. Nothing is mapped up front,
+    each page is filled on its first access: bytes inside the file-backed range
+    are copied from the executable, which stays in place inside the initramfs
+    module, everything else (.bss, the stack) is zero-filled.
+*/
+struct region {
+    uint64_t start;           // First byte, page aligned
+    uint64_t end;             // One past the last byte, page aligned
+    uint64_t pte_flags;       // Flags of every page mapped in the region
+    const uint8_t* file_data; // Contents of [file_start, file_start + file_size)
+    uint64_t file_start;      // Virtual address of the first file-backed byte
+    uint64_t file_size;       // 0 for anonymous regions
+};
+
+enum class process_state : uint8_t {
+    RUNNING,
+    EXITED, // exit_code is valid, the slot lives on until the parent waited for it
+};
+
+struct process {
+    uint32_t pid;
+    uint64_t cr3; // Address space handle, the PML4 tagged with its ID
+    uint64_t entry;
+    uint64_t arg; // Passed to the entry point in rdi
+    region regions[MAX_REGIONS];
+    size_t region_count;
+    sched::task* task;
+    process* next_free;
+
+    process* parent;     // Waits for this process, null for processes started by the kernel
+    uint32_t references; // One for the thread until it is switched out dead, one for the parent
+    process_state state;
+    int32_t exit_code;
+
+    uint64_t spawn_tsc; // TSC when spawn or fork was called
+    uint64_t start_tsc; // TSC right before the first switch to user mode
+
+    // Only updated by the CPU running the process
+    uint64_t file_faults;  // Pages filled from the executable
+    uint64_t zero_faults;  // Pages zero-filled
+    uint64_t cow_faults;   // Shared pages made writable, copied or not
+    uint64_t fault_cycles; // TSC cycles spent resolving faults
+
+    // Where a forked child starts, copied from the parent at fork time
+    arch::x86::syscall_frame fork_frame;
+    arch::x86::fpu_state fork_fpu;
+};
+
+// Payload of EVENT_PROCESS_START
+struct process_start_payload {
+    uint64_t spawn_tsc;
+    uint64_t startup_cycles; // spawn() to the first user mode instruction
+    uint64_t entry;
+    uint32_t pid;
+    uint16_t region_count;
+    uint16_t reserved;
+} __attribute__((packed));
+
+static_assert(sizeof(process_start_payload) == 32, "Process start payload must be 32 bytes");
+
+// Payload of EVENT_PROCESS_EXIT
+struct process_exit_payload {
+    uint64_t runtime_cycles; // First user mode instruction to exit
+    uint64_t file_faults;
+    uint64_t zero_faults;
+    uint64_t cow_faults;
+    uint64_t fault_cycles;
+    uint32_t pid;
+    int32_t exit_code;
+} __attribute__((packed));
+
+static_assert(sizeof(process_exit_payload) == 48, "Process exit payload must be 48 bytes");
+
+/**
+ * @brief Loads an ELF64 executable from the initramfs and starts it in a new thread.
+ *
+ * Only the headers are read here. The PT_LOAD segments become demand-paged
+ * regions of a fresh address space, so startup cost does not depend on the
+ * size of the image. EVENT_PROCESS_START is emitted right before the thread
+ * enters user mode.
+ *
+ * @param path Path of the executable inside the initramfs.
+ * @param arg Value passed to the entry point in rdi.
+ * @return process* The new process, or nullptr if the file is missing or not a valid
+ * static x86-64 executable, or if the process, task or frame pools are exhausted.
+ */
+process* spawn(const char* path, uint64_t arg = 0);
+
+/**
+ * @brief Duplicates the current process, sharing its memory copy-on-write.
+ *
+ * The child gets a clone of the address space, the regions and the FPU state
+ * and starts where the parent's system call returns, with rax set to 0.
+ *
+ * @param frame The parent's system call frame.
+ * @return process* The child, or nullptr if the caller is not a process or a pool is exhausted.
+ */
+process* fork(const arch::x86::syscall_frame* frame);
+
+/**
+ * @brief Waits until a child of the current process exited and frees its slot.
+ *
+ * There are no wait queues yet, the caller yields until the child is done.
+ *
+ * @param pid Process ID returned by fork.
+ * @param exit_code Receives the child's exit code.
+ * @return true If the child was found and reaped.
+ * @return false If pid is not a child of the current process.
+ */
+bool wait(uint32_t pid, int32_t* exit_code);
+
+/**
+ * @brief Enables or disables EVENT_PROCESS_START and EVENT_PROCESS_EXIT.
+ *
+ * Serial transmission takes milliseconds, benchmarks turn the events off.
+ */
+void set_event_tracing(bool enabled);
+
+/**
+ * @brief Returns the process the calling task belongs to, or nullptr for kernel threads.
+ */
+process* current_process();
+
+/**
+ * @brief Resolves a page fault on an address of the current process.
+ *
+ * Called from the page fault handler with interrupts disabled. Missing pages
+ * are demand-filled, writes to copy-on-write pages get a private copy.
+ *
+ * @param address Faulting virtual address (CR2).
+ * @param error_code Error code pushed by the CPU.
+ * @return true If the access can be retried.
+ * @return false If the address is outside every region, the access violates the page's
+ * permissions or no frame is left.
+ */
+bool handle_page_fault(uint64_t address, uint64_t error_code);
+
+/**
+ * @brief Terminates the current process and reports EVENT_PROCESS_EXIT.
+ *
+ * The address space is freed once the thread is switched out for good.
+ *
+ * @param code Exit code reported over IRIS.
+ */
+[[noreturn]] void exit(int32_t code);
+
+/**
+ * @brief Frees the address space of a process whose thread is dead.
+ *
+ * Called by the scheduler after the thread's last switch, its address space is no
+ * longer loaded anywhere. The pool slot is freed once the parent waited too.
+ */
+void release(process* p);
+
+} // namespace proc
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <sched/task.h>
+
+namespace sched {
+
+// Timer ticks a task may run before it is preempted in favour of a waiting task
+inline constexpr uint32_t TIME_SLICE_TICKS = 1;
+
+// Number of scheduler events buffered per CPU between two flush_events() calls
+inline constexpr size_t SCHED_EVENT_BUFFER_SIZE = 256;
+
+// Payload of EVENT_CONTEXT_SWITCH
+struct context_switch_payload {
+    uint64_t tsc;
+    uint32_t prev_tid;
+    uint32_t next_tid;
+} __attribute__((packed));
+
+static_assert(sizeof(context_switch_payload) == 16, "Context switch payload must be 16 bytes");
+
+// Payload of EVENT_TASK_MIGRATED
+struct task_migrated_payload {
+    uint64_t tsc;
+    uint32_t tid;
+    uint16_t from_cpu;
+    uint16_t to_cpu;
+} __attribute__((packed));
+
+static_assert(sizeof(task_migrated_payload) == 16, "Task migrated payload must be 16 bytes");
+
+// Payload of EVENT_SCHED_CPU_STATS
+struct cpu_stats_payload {
+    uint64_t context_switches;
+    uint64_t migrations;      // Tasks this CPU stole from other run queues
+    uint64_t tasks_completed; // Tasks that exited on this CPU
+    uint64_t dropped_events;  // Scheduler events lost to a full event buffer
+} __attribute__((packed));
+
+static_assert(sizeof(cpu_stats_payload) == 32, "Scheduler CPU stats payload must be 32 bytes");
+
+// Interval between two EVENT_CPU_UTILIZATION reports
+inline constexpr uint64_t UTILIZATION_REPORT_INTERVAL_MS = 1000;
+
+// How an idle CPU waits for work, reported in cpu_utilization_payload
+enum class idle_method : uint8_t {
+    HALT = 0,  // STI; HLT, only an interrupt ends the wait
+    MWAIT = 1, // MONITOR/MWAIT on the CPU's wakeup word, a plain store ends the wait
+};
+
+// Payload of EVENT_CPU_UTILIZATION
+struct cpu_utilization_payload {
+    uint64_t window_cycles; // TSC cycles since the previous report of this CPU
+    uint64_t idle_cycles;   // Part of the window the CPU spent waiting for work
+    uint64_t wakeups;       // Times the CPU woke from its idle wait within the window
+    uint8_t method;         // idle_method
+    uint8_t reserved1;
+    uint16_t reserved2;
+    uint32_t reserved3;
+} __attribute__((packed));
+
+static_assert(sizeof(cpu_utilization_payload) == 32, "CPU utilization payload must be 32 bytes");
+
+/**
+ * @brief Turns the calling CPU's current context into its idle task and brings its run queue online.
+ *
+ * Called once per CPU, by init() on the BSP and by ap_main() on every AP.
+ */
+void init_cpu(int cpu);
+
+/**
+ * @brief Creates a kernel thread and queues it for execution.
+ *
+ * The task is queued on the calling CPU if the affinity allows it, otherwise on
+ * the first allowed CPU. Idle CPUs balance the load by stealing from the
+ * busiest run queue.
+ *
+ * @param fn Function run by the thread, the thread exits when it returns.
+ * @param arg Argument passed to `fn`.
+ * @param priority 0 (highest) to PRIORITY_COUNT - 1.
+ * @param affinity Mask of CPUs the thread may run on.
+ * @return task* The new task, or nullptr if MAX_TASKS tasks already exist.
+ */
+task* spawn(task_fn fn, void* arg, uint8_t priority = DEFAULT_PRIORITY, uint64_t affinity = ALL_CPUS);
+
+/**
+ * @brief Returns the task running on the calling CPU.
+ */
+task* current_task();
+
+/**
+ * @brief Gives up the CPU to the next runnable task, if there is one.
+ */
+void yield();
+
+/**
+ * @brief Ends the calling task. Never returns.
+ *
+ * If the task belongs to a process, the process is released once the task
+ * has been switched out for the last time.
+ */
+[[noreturn]] void exit();
+
+/**
+ * @brief Makes the calling task run in another address space from now on.
+ *
+ * The new CR3 is loaded immediately and on every later switch to the task.
+ *
+ * @param cr3 Address space handle returned by arch::x86::create_address_space.
+ */
+void switch_address_space(uint64_t cr3);
+
+/**
+ * @brief Accounts a timer tick and preempts the current task once its time slice is used up.
+ *
+ * Called from the timer interrupt handler after the interrupt was acknowledged.
+ */
+void tick();
+
+/**
+ * @brief Gives the current task the FPU after it trapped with CR0.TS set (#NM).
+ *
+ * Called from the device-not-available exception handler.
+ */
+void handle_fpu_trap();
+
+/**
+ * @brief Copies the current task's FPU state, whether it is live in the registers or saved.
+ *
+ * Used by fork so the child continues with the parent's FPU registers.
+ */
+void copy_fpu_state(arch::x86::fpu_state* state);
+
+/**
+ * @brief Replaces the current task's FPU state, loaded on its next FPU instruction.
+ */
+void load_fpu_state(const arch::x86::fpu_state* state);
+
+/**
+ * @brief One iteration of a CPU's idle loop.
+ *
+ * Runs queued or stealable tasks until none are left, then waits for work:
+ * with MONITOR/MWAIT on the CPU's wakeup word where CPUID reports it, so
+ * wake_idle_cpu() ends the wait without an IPI, otherwise with HLT until the
+ * next interrupt. The time spent waiting is accounted as idle. Must be called
+ * from the CPU's idle task.
+ */
+void idle();
+
+/**
+ * @brief Ends the idle wait of a CPU that was handed work, callable from any context.
+ *
+ * Called after queueing a task or a coroutine for another CPU. A CPU waiting
+ * in MWAIT resumes right away; one that halts picks the work up on its next
+ * interrupt, at the latest on its next timer tick.
+ */
+void wake_idle_cpu(int cpu);
+
+/**
+ * @brief Returns how idle CPUs wait for work.
+ */
+idle_method current_idle_method();
+
+/**
+ * @brief Enables or disables buffering of context switch and migration events.
+ */
+void set_event_tracing(bool enabled);
+
+/**
+ * @brief Emits the scheduler events buffered by every CPU.
+ *
+ * Must only be called from one CPU at a time, the BSP's idle loop.
+ */
+void flush_events();
+
+/**
+ * @brief Emits one EVENT_SCHED_CPU_STATS event per online CPU.
+ */
+void emit_cpu_stats();
+
+/**
+ * @brief Emits one EVENT_CPU_UTILIZATION event per online CPU once per report interval.
+ *
+ * Does nothing until UTILIZATION_REPORT_INTERVAL_MS passed since the last
+ * report. Must only be called from one CPU at a time, the BSP's idle loop.
+ */
+void flush_utilization();
+
+} // namespace sched
+
+#endif
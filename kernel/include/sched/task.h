@@ -0,0 +1,58 @@
+#ifndef SCHED_TASK_H
+#define SCHED_TASK_H
+
+#include <arch/x86/fpu/fpu.h>
+#include <core/types.h>
+
+namespace proc {
+struct process;
+}
+
+namespace sched {
+
+// Number of priority levels, 0 is the most important
+inline constexpr uint8_t PRIORITY_COUNT = 32;
+inline constexpr uint8_t DEFAULT_PRIORITY = 16;
+
+// Affinity mask allowing every CPU
+inline constexpr uint64_t ALL_CPUS = ~0ULL;
+
+// Kernel stack of every task
+inline constexpr size_t TASK_STACK_SIZE = 0x4000;
+
+// Number of tasks that can exist at the same time, idle tasks not included
+inline constexpr size_t MAX_TASKS = 256;
+
+using task_fn = void (*)(void* arg);
+
+enum class task_state : uint8_t {
+    RUNNABLE, // Waiting in a run queue, or preempted and about to be requeued
+    RUNNING,  // Currently executing on task::cpu
+    DEAD,     // Finished, freed once another task runs on its CPU
+};
+
+struct task {
+    uint64_t saved_rsp; // Kernel stack pointer while switched out, must stay first (context_switch.S)
+    task* next;         // Run queue link
+    task_fn entry;
+    void* arg;
+    uint64_t affinity; // Bit n set if the task may run on CPU n
+    uint32_t tid;      // 0 for the idle tasks
+    int cpu;           // CPU the task last ran or is queued on
+    task_state state;
+    uint8_t priority;
+    bool is_idle;
+    uint8_t* stack;            // Base of the kernel stack, null for idle tasks
+    uint64_t kernel_stack_top; // Loaded into the TSS rsp0 while the task runs
+    uint64_t cr3;              // Address space handle, activated on every switch to the task
+    proc::process* process;    // Owning user process, null for kernel threads
+
+    // FPU state is loaded on first use after a switch (#NM) and saved only if the task used it
+    int fpu_cpu;   // CPU whose registers still hold the task's FPU state, -1 if none
+    bool fpu_used; // `fpu` holds a saved state, otherwise the task starts from the initial one
+    arch::x86::fpu_state fpu;
+};
+
+} // namespace sched
+
+#endif
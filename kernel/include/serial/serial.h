@@ -1,5 +1,6 @@
 #ifndef SERIAL_H
 #define SERIAL_H
+#include <async/task.h>
 #include <ports/ports.h>
 
 namespace serial {
@@ -50,9 +51,29 @@ enum class modem_control_flags : uint8_t {
 // Line Status Register (LSR) flags
 enum class line_status_flags : uint8_t {
     TRANSMIT_EMPTY = 0x20, // Transmitter Holding Register Empty
+    OVERRUN_ERROR = 0x02,  // A byte was lost because the receive FIFO was full
     DATA_READY = 0x01      // Data Ready
 };
 
+// Interrupt Enable Register (IER) flags
+enum class interrupt_enable_flags : uint8_t {
+    RECEIVED_DATA_AVAILABLE = 0x01, // Received data reached the FIFO trigger level or timed out
+    TRANSMIT_HOLDING_EMPTY = 0x02   // Transmit FIFO ran empty
+};
+
+// Bytes the 16550 transmit FIFO accepts at once once it ran empty
+inline constexpr uint32_t TRANSMIT_FIFO_SIZE = 16;
+
+// Size of the per-port receive ring, must be a power of two
+inline constexpr uint32_t RECEIVE_BUFFER_SIZE = 1024;
+
+// Receive path counters of a single port
+struct receive_stats {
+    uint64_t received; // Bytes moved from the UART into the receive ring
+    uint64_t dropped;  // Bytes discarded because the receive ring was full
+    uint64_t overruns; // Times the UART reported bytes lost in its own FIFO
+};
+
 // Baud rate divisors (assuming 1.8432 MHz clock)
 enum class baud_rate_divisor : uint8_t {
     BAUD_115200 = 0x01, // 115200 baud
@@ -153,17 +174,119 @@ void write(uint16_t port, const char* str);
 void write(uint16_t port, const char* str, uint32_t length);
 
 /**
- * @brief Reads a single character from the specified serial port.
+ * @brief Sends raw binary data through the specified serial port.
+ *
+ * Unlike the string variants, no newline translation is performed, so every
+ * byte is transmitted exactly as given. This must be used for binary protocols
+ * such as IRIS where a 0x0A byte is ordinary data.
+ *
+ * @param port The I/O port address of the serial port to use for sending the data.
+ * @param data Pointer to the bytes to transmit.
+ * @param length The number of bytes to transmit.
+ */
+void write_raw(uint16_t port, const void* data, uint32_t length);
+
+/**
+ * @brief Fills the transmit FIFO of the specified serial port if it ran empty, without waiting.
+ *
+ * @param port The I/O port address of the serial port to use for sending the data.
+ * @param data Pointer to the bytes to transmit.
+ * @param length The number of bytes available at `data`.
+ * @return uint32_t The number of bytes written, at most TRANSMIT_FIFO_SIZE, 0 if the FIFO
+ * still held data.
+ */
+uint32_t write_burst(uint16_t port, const void* data, uint32_t length);
+
+/**
+ * @brief Services an interrupt of the specified serial port.
+ *
+ * Called from the port's IRQ handler. Drains the receive FIFO into the
+ * receive ring, which also acknowledges both the trigger level and the
+ * character timeout interrupts, and wakes a coroutine in read_async() if
+ * bytes arrived. If a coroutine waits for the transmitter, a transmit FIFO
+ * that ran empty wakes it and the transmit interrupt is disarmed again.
+ *
+ * @param port The I/O port address of the serial port that raised the interrupt.
+ */
+void handle_interrupt(uint16_t port);
+
+/**
+ * @brief Reads a single character without blocking.
+ *
+ * @param port The I/O port address of the serial port to read from.
+ * @param chr Receives the character if one was available.
+ * @return true If a character was read.
+ * @return false If the receive ring was empty.
+ */
+bool try_read(uint16_t port, char* chr);
+
+/**
+ * @brief Reads up to `length` already received characters without blocking.
  *
- * This function retrieves a character from the Receive Buffer Register (RBR) of
- * the serial port. It should be called only when data is confirmed to be available
- * using `is_data_available` to avoid reading invalid or empty data.
+ * @param port The I/O port address of the serial port to read from.
+ * @param buffer Destination for the received characters.
+ * @param length Maximum number of characters to read.
+ * @return uint32_t The number of characters copied, 0 if nothing was pending.
+ */
+uint32_t read(uint16_t port, char* buffer, uint32_t length);
+
+/**
+ * @brief Reads a single character from the specified serial port, waiting for one if needed.
+ *
+ * With interrupts enabled the CPU halts until the receive interrupt (or any
+ * other interrupt) wakes it, instead of polling the Line Status Register.
+ * With interrupts disabled the port is polled.
  *
  * @param port The I/O port address of the serial port to read from.
  * @return char The character read from the serial port.
  */
 char read(uint16_t port);
 
+/**
+ * @brief Waits until the transmit FIFO of the specified serial port ran empty.
+ *
+ * Arms the port's transmit interrupt and suspends until it fires, instead of
+ * polling the Line Status Register. Completes immediately if the FIFO is
+ * already empty. One coroutine per port may wait at a time.
+ *
+ * @param port The I/O port address of the serial port to wait for.
+ */
+async::task<void> wait_transmit_empty(uint16_t port);
+
+/**
+ * @brief Reads up to `length` characters, suspending until at least one arrived.
+ *
+ * The receive interrupt resumes the reading coroutine. One coroutine per
+ * port may read at a time.
+ *
+ * @param port The I/O port address of the serial port to read from.
+ * @param buffer Destination for the received characters.
+ * @param length Maximum number of characters to read.
+ * @return uint32_t The number of characters copied, 0 only for ports without a receive ring.
+ */
+async::task<uint32_t> read_async(uint16_t port, char* buffer, uint32_t length);
+
+/**
+ * @brief Sends raw binary data, suspending while the transmit FIFO drains.
+ *
+ * Fills the transmit FIFO TRANSMIT_FIFO_SIZE bytes at a time and waits for
+ * the transmit interrupt in between. The caller must keep other writers off
+ * the port until the task finished.
+ *
+ * @param port The I/O port address of the serial port to use for sending the data.
+ * @param data Pointer to the bytes to transmit, must stay valid until the task finished.
+ * @param length The number of bytes to transmit.
+ */
+async::task<void> write_async(uint16_t port, const void* data, uint32_t length);
+
+/**
+ * @brief Returns the receive counters of the specified serial port.
+ *
+ * @param port The I/O port address of the serial port.
+ * @return receive_stats All zero for ports without a receive ring.
+ */
+receive_stats get_receive_stats(uint16_t port);
+
 } // namespace serial
 
 #endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef SYNC_LOCK_STATS_H
+#define SYNC_LOCK_STATS_H
+
+#include <arch/x86/cpu/cpu.h>
+#include <core/types.h>
+
+namespace sync {
+
+// Contention counters of one lock, only ever written by the current holder
+struct lock_stats {
+    uint64_t acquisitions;
+    uint64_t contended;       // Acquisitions that had to wait for another holder
+    uint64_t spin_cycles;     // TSC cycles spent waiting, summed over all acquisitions
+    uint64_t max_hold_cycles; // Longest time the lock was held
+    uint64_t acquired_tsc;    // TSC value when the current holder took the lock
+};
+
+// Maximum length of a lock name in EVENT_LOCK_STATS, including the terminator
+inline constexpr size_t LOCK_NAME_SIZE = 32;
+
+// Payload of EVENT_LOCK_STATS
+struct lock_stats_payload {
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t spin_cycles;
+    uint64_t max_hold_cycles;
+    char name[LOCK_NAME_SIZE]; // NUL-terminated
+} __attribute__((packed));
+
+static_assert(sizeof(lock_stats_payload) == 64, "Lock stats payload must be 64 bytes");
+
+/**
+ * @brief Accounts an acquisition, called by the new holder right after taking the lock.
+ *
+ * @param stats Counters of the lock.
+ * @param wait_cycles TSC cycles spent waiting, 0 for uncontended acquisitions.
+ */
+inline void account_acquired([[maybe_unused]] lock_stats* stats,
+                             [[maybe_unused]] uint64_t wait_cycles) {
+#ifdef ENABLE_LOCK_STATS
+    ++stats->acquisitions;
+    if (wait_cycles != 0) {
+        ++stats->contended;
+        stats->spin_cycles += wait_cycles;
+    }
+    stats->acquired_tsc = arch::x86::rdtsc();
+#endif
+}
+
+/**
+ * @brief Accounts the end of a hold, called by the holder right before releasing the lock.
+ */
+inline void account_released([[maybe_unused]] lock_stats* stats) {
+#ifdef ENABLE_LOCK_STATS
+    uint64_t held = arch::x86::rdtsc() - stats->acquired_tsc;
+    if (held > stats->max_hold_cycles) {
+        stats->max_hold_cycles = held;
+    }
+#endif
+}
+
+/**
+ * @brief Emits an EVENT_LOCK_STATS event for a lock.
+ *
+ * Does nothing when `stats` is null, which is what the locks return when
+ * ENABLE_LOCK_STATS is not defined.
+ *
+ * @param name Human readable lock name, truncated to LOCK_NAME_SIZE - 1 characters.
+ * @param stats Counters of the lock, read without synchronization.
+ */
+void emit_lock_stats(const char* name, const lock_stats* stats);
+
+} // namespace sync
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef SYNC_MCS_LOCK_H
+#define SYNC_MCS_LOCK_H
+
+#include <sync/lock_stats.h>
+
+namespace sync {
+
+/**
+ * @brief Mellor-Crummey and Scott queue lock.
+ *
+ * Every waiter spins on a flag in its own queue node instead of on the lock
+ * word, so a release invalidates a single waiter's cache line rather than the
+ * line of every waiting CPU. Preferable to the ticket spinlock for locks that
+ * are contended by many CPUs. Acquisition order is FIFO.
+ *
+ * Each acquisition needs a node that stays valid until the matching unlock,
+ * mcs_guard and irq_mcs_guard keep it on the stack.
+ */
+class mcs_lock {
+public:
+    struct node {
+        node* next;
+        uint32_t locked; // Cleared by the predecessor to hand the lock over
+    };
+
+    constexpr mcs_lock() = default;
+
+    mcs_lock(const mcs_lock&) = delete;
+    mcs_lock& operator=(const mcs_lock&) = delete;
+
+    void lock(node* self) {
+        self->next = nullptr;
+        self->locked = 1;
+
+        node* predecessor = __atomic_exchange_n(&m_tail, self, __ATOMIC_ACQ_REL);
+        if (predecessor) [[unlikely]] {
+            wait_for_handover(predecessor, self);
+            return;
+        }
+
+        account_acquired(stats_storage(), 0);
+    }
+
+    bool try_lock(node* self) {
+        self->next = nullptr;
+        self->locked = 0;
+
+        node* expected = nullptr;
+        if (!__atomic_compare_exchange_n(&m_tail, &expected, self, false, __ATOMIC_ACQUIRE,
+                                         __ATOMIC_RELAXED)) {
+            return false;
+        }
+
+        account_acquired(stats_storage(), 0);
+        return true;
+    }
+
+    void unlock(node* self) {
+        account_released(stats_storage());
+
+        node* successor = __atomic_load_n(&self->next, __ATOMIC_ACQUIRE);
+        if (!successor) {
+            // No known successor, release the lock unless one is enqueueing right now
+            node* expected = self;
+            if (__atomic_compare_exchange_n(&m_tail, &expected, nullptr, false, __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED)) {
+                return;
+            }
+
+            successor = wait_for_successor(self);
+        }
+
+        __atomic_store_n(&successor->locked, 0, __ATOMIC_RELEASE);
+    }
+
+    bool is_locked() const {
+        return __atomic_load_n(&m_tail, __ATOMIC_RELAXED) != nullptr;
+    }
+
+    /**
+     * @brief Returns the contention counters, null unless ENABLE_LOCK_STATS is defined.
+     */
+    const lock_stats* stats() const {
+#ifdef ENABLE_LOCK_STATS
+        return &m_stats;
+#else
+        return nullptr;
+#endif
+    }
+
+private:
+    void wait_for_handover(node* predecessor, node* self);
+    static node* wait_for_successor(node* self);
+
+    lock_stats* stats_storage() {
+#ifdef ENABLE_LOCK_STATS
+        return &m_stats;
+#else
+        return nullptr;
+#endif
+    }
+
+    node* m_tail = nullptr; // Last node in the queue, null when the lock is free
+#ifdef ENABLE_LOCK_STATS
+    lock_stats m_stats = {};
+#endif
+};
+
+/**
+ * @brief Holds an MCS lock for the lifetime of the guard, with the queue node on the stack.
+ */
+class mcs_guard {
+public:
+    explicit mcs_guard(mcs_lock& lock) : m_lock(lock) {
+        m_lock.lock(&m_node);
+    }
+
+    ~mcs_guard() {
+        m_lock.unlock(&m_node);
+    }
+
+    mcs_guard(const mcs_guard&) = delete;
+    mcs_guard& operator=(const mcs_guard&) = delete;
+
+private:
+    mcs_lock& m_lock;
+    mcs_lock::node m_node;
+};
+
+/**
+ * @brief Disables interrupts and holds an MCS lock for the lifetime of the guard.
+ */
+class irq_mcs_guard {
+public:
+    explicit irq_mcs_guard(mcs_lock& lock)
+        : m_lock(lock), m_rflags(arch::x86::save_and_disable_interrupts()) {
+        m_lock.lock(&m_node);
+    }
+
+    ~irq_mcs_guard() {
+        m_lock.unlock(&m_node);
+        arch::x86::restore_interrupts(m_rflags);
+    }
+
+    irq_mcs_guard(const irq_mcs_guard&) = delete;
+    irq_mcs_guard& operator=(const irq_mcs_guard&) = delete;
+
+private:
+    mcs_lock& m_lock;
+    mcs_lock::node m_node;
+    uint64_t m_rflags;
+};
+
+} // namespace sync
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef SYNC_RCU_H
+#define SYNC_RCU_H
+
+#include <arch/x86/percpu/percpu.h>
+#include <core/types.h>
+
+/*
+    Quiescent-state-based read-copy-update for read-mostly data.
+
+    Readers never lock or write shared memory. A writer publishes a new copy
+    with rcu_assign_pointer() and frees the old one once every CPU has passed
+    a quiescent state, a point where it cannot be inside a read-side critical
+    section: a context switch, an iteration of an idle loop, or a timer tick
+    that interrupted code outside of one.
+
+    Kernel threads are preempted from the timer tick, so a read-side critical
+    section only needs to keep that tick from switching tasks; rcu_read_lock()
+    is a single per-CPU increment without a barrier. Code that already runs
+    with interrupts disabled (interrupt handlers, the scheduler) cannot pass
+    a quiescent state and needs no rcu_read_lock() at all.
+*/
+
+namespace sync {
+
+// Read-side critical sections the current CPU is in, keeps the timer tick from preempting
+DECLARE_PER_CPU(uint64_t, g_rcu_read_nesting);
+
+// Embedded in an object freed through call_rcu()
+struct rcu_head {
+    rcu_head* next;
+    void (*callback)(rcu_head* head);
+};
+
+using rcu_callback = void (*)(rcu_head* head);
+
+/**
+ * @brief Enters a read-side critical section, may nest.
+ *
+ * Must not sleep, yield or block until the matching rcu_read_unlock().
+ */
+inline void rcu_read_lock() {
+    arch::x86::this_cpu_add(&g_rcu_read_nesting, uint64_t{1});
+}
+
+/**
+ * @brief Leaves a read-side critical section.
+ */
+inline void rcu_read_unlock() {
+    arch::x86::this_cpu_add(&g_rcu_read_nesting, ~uint64_t{0});
+}
+
+/**
+ * @brief Returns whether the calling CPU is inside a read-side critical section.
+ */
+inline bool rcu_read_lock_held() {
+    return arch::x86::this_cpu_read(&g_rcu_read_nesting) != 0;
+}
+
+/**
+ * @brief Loads an RCU-protected pointer inside a read-side critical section.
+ */
+template <typename T>
+inline T* rcu_dereference(T* const& pointer) {
+    return __atomic_load_n(&pointer, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Publishes a new version of an RCU-protected object after it is fully initialized.
+ */
+template <typename T>
+inline void rcu_assign_pointer(T*& pointer, T* value) {
+    __atomic_store_n(&pointer, value, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Records a quiescent state of the calling CPU, called with interrupts disabled.
+ *
+ * Only updates a counter, used on the context switch path.
+ */
+void rcu_note_quiescent_state(int cpu);
+
+/**
+ * @brief Records a quiescent state, advances the grace period and runs finished callbacks.
+ *
+ * Called from idle loops and timer ticks outside of read-side critical sections.
+ */
+void rcu_quiescent_state();
+
+/**
+ * @brief Queues `callback(head)` to run once every current reader is done.
+ *
+ * Callbacks queued on a CPU before a grace period starts are run as one batch
+ * when it ends, on the same CPU with interrupts disabled, so they must not
+ * block. Callable from any context.
+ */
+void call_rcu(rcu_head* head, rcu_callback callback);
+
+/**
+ * @brief Waits until every read-side critical section running at the time of the call ended.
+ *
+ * Yields while waiting, so it must not be called inside a read-side critical
+ * section or with interrupts disabled.
+ */
+void synchronize_rcu();
+
+} // namespace sync
+
+#endif // SYNC_RCU_H
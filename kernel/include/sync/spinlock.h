@@ -0,0 +1,140 @@
+#ifndef SYNC_SPINLOCK_H
+#define SYNC_SPINLOCK_H
+
+#include <sync/lock_stats.h>
+
+namespace sync {
+
+/**
+ * @brief Ticket spinlock, grants the lock in FIFO order.
+ *
+ * The fast path is a single locked XADD. Waiters back off with a number of
+ * PAUSE instructions proportional to their distance from the head of the
+ * queue, which keeps the cache line holding the owner ticket from bouncing
+ * between every waiter on each release.
+ *
+ * Must not be taken from interrupt context unless every holder uses
+ * irq_spinlock_guard, otherwise an interrupt on the holding CPU deadlocks.
+ */
+class spinlock {
+public:
+    constexpr spinlock() = default;
+
+    spinlock(const spinlock&) = delete;
+    spinlock& operator=(const spinlock&) = delete;
+
+    void lock() {
+        uint16_t ticket = __atomic_fetch_add(&m_next, 1, __ATOMIC_RELAXED);
+
+        if (__atomic_load_n(&m_owner, __ATOMIC_ACQUIRE) != ticket) [[unlikely]] {
+            lock_slow(ticket);
+            return;
+        }
+
+        account_acquired(stats_storage(), 0);
+    }
+
+    bool try_lock() {
+        uint16_t owner = __atomic_load_n(&m_owner, __ATOMIC_ACQUIRE);
+        uint16_t expected = owner;
+
+        // Only succeeds if nobody holds or waits for the lock
+        if (!__atomic_compare_exchange_n(&m_next, &expected, static_cast<uint16_t>(owner + 1),
+                                         false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return false;
+        }
+
+        account_acquired(stats_storage(), 0);
+        return true;
+    }
+
+    void unlock() {
+        account_released(stats_storage());
+
+        // Only the holder writes the owner ticket, a plain increment published with release is enough
+        __atomic_store_n(&m_owner, static_cast<uint16_t>(m_owner + 1), __ATOMIC_RELEASE);
+    }
+
+    bool is_locked() const {
+        return __atomic_load_n(&m_owner, __ATOMIC_RELAXED) !=
+               __atomic_load_n(&m_next, __ATOMIC_RELAXED);
+    }
+
+    /**
+     * @brief Returns the contention counters, null unless ENABLE_LOCK_STATS is defined.
+     */
+    const lock_stats* stats() const {
+#ifdef ENABLE_LOCK_STATS
+        return &m_stats;
+#else
+        return nullptr;
+#endif
+    }
+
+private:
+    void lock_slow(uint16_t ticket);
+
+    lock_stats* stats_storage() {
+#ifdef ENABLE_LOCK_STATS
+        return &m_stats;
+#else
+        return nullptr;
+#endif
+    }
+
+    uint16_t m_owner = 0; // Ticket currently being served
+    uint16_t m_next = 0;  // Next ticket to hand out
+#ifdef ENABLE_LOCK_STATS
+    lock_stats m_stats = {};
+#endif
+};
+
+/**
+ * @brief Holds a spinlock for the lifetime of the guard.
+ */
+class spinlock_guard {
+public:
+    explicit spinlock_guard(spinlock& lock) : m_lock(lock) {
+        m_lock.lock();
+    }
+
+    ~spinlock_guard() {
+        m_lock.unlock();
+    }
+
+    spinlock_guard(const spinlock_guard&) = delete;
+    spinlock_guard& operator=(const spinlock_guard&) = delete;
+
+private:
+    spinlock& m_lock;
+};
+
+/**
+ * @brief Disables interrupts and holds a spinlock for the lifetime of the guard.
+ *
+ * Required for locks shared with interrupt handlers. The previous interrupt
+ * state is restored after the lock is released.
+ */
+class irq_spinlock_guard {
+public:
+    explicit irq_spinlock_guard(spinlock& lock)
+        : m_lock(lock), m_rflags(arch::x86::save_and_disable_interrupts()) {
+        m_lock.lock();
+    }
+
+    ~irq_spinlock_guard() {
+        m_lock.unlock();
+        arch::x86::restore_interrupts(m_rflags);
+    }
+
+    irq_spinlock_guard(const irq_spinlock_guard&) = delete;
+    irq_spinlock_guard& operator=(const irq_spinlock_guard&) = delete;
+
+private:
+    spinlock& m_lock;
+    uint64_t m_rflags;
+};
+
+} // namespace sync
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef SYSCALL_H
+#define SYSCALL_H
+
+#include <arch/x86/syscall/syscall.h>
+#include <core/types.h>
+
+namespace syscall {
+
+// System call numbers, passed in rax, the numeric values are part of the user ABI
+enum class syscall_number : uint64_t {
+    NULL_CALL = 0, // Returns 0, measures the kernel entry and exit cost
+    EXIT = 1,      // Ends the calling thread, rdi is the exit code of a process
+    YIELD = 2,     // Gives up the CPU to the next runnable thread
+    FORK = 3,      // Duplicates the calling process, returns the child's PID or 0 in the child
+    WAIT = 4,      // Waits for the child with PID rdi to exit, returns its exit code
+};
+
+inline constexpr size_t SYSCALL_COUNT = 5;
+
+// Returned in rax for numbers without a handler
+inline constexpr int64_t ERROR_NO_SYSCALL = -38;
+
+// Returned by WAIT if rdi is not a child of the caller
+inline constexpr int64_t ERROR_NO_CHILD = -10;
+
+// Returned by FORK if the caller is not a process or the process, task or frame pools are full
+inline constexpr int64_t ERROR_NO_MEMORY = -12;
+
+// Arguments arrive in rdi, rsi, rdx, r10, r8 and r9, the result goes back in rax
+using syscall_handler = int64_t (*)(uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t);
+
+} // namespace syscall
+
+/**
+ * @brief Dispatches a system call through the syscall table.
+ *
+ * Called by the SYSCALL entry with interrupts enabled, on the calling
+ * thread's kernel stack. The result is stored in frame->rax.
+ */
+EXTERN_C void handle_syscall(arch::x86::syscall_frame* frame);
+
+#endif
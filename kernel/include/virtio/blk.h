@@ -0,0 +1,64 @@
+#ifndef VIRTIO_BLK_H
+#define VIRTIO_BLK_H
+
+#include <core/types.h>
+
+namespace virtio::blk {
+
+inline constexpr uint16_t PCI_DEVICE_ID_TRANSITIONAL = 0x1001;
+inline constexpr uint16_t PCI_DEVICE_ID_MODERN = 0x1042;
+
+// Largest number of virtio-blk devices driven
+inline constexpr size_t MAX_DEVICES = 4;
+
+// Largest number of request queues per device, each is served by one CPU
+inline constexpr size_t MAX_QUEUES = 8;
+
+// Device commands in flight per queue, a command may carry several merged requests
+inline constexpr uint16_t MAX_IN_FLIGHT = 128;
+
+// Payload of EVENT_BLOCK_DEVICE
+struct device_payload {
+    uint64_t sector_count;
+    uint64_t features;    // Negotiated virtio feature bits
+    uint32_t block_size;
+    uint32_t max_segments; // Requests merged into one command at most
+    uint16_t queue_count;
+    uint16_t queue_size;
+    uint8_t interrupts;   // 1 if the queues complete through MSI-X, 0 if polled
+    uint8_t read_only;
+    uint16_t reserved;
+    char name[8];
+} __attribute__((packed));
+
+// Payload of EVENT_BLOCK_QUEUE_STATS
+struct queue_stats_payload {
+    uint64_t requests;      // block::request submissions
+    uint64_t commands;      // Device commands, fewer than requests when merging
+    uint64_t notifications; // Doorbell writes, each a VM exit under a hypervisor
+    uint64_t interrupts;
+    uint16_t queue;
+    uint16_t reserved1;
+    uint32_t reserved2;
+    char name[8];
+} __attribute__((packed));
+
+static_assert(sizeof(device_payload) == 40, "virtio-blk device payload must be 40 bytes");
+static_assert(sizeof(queue_stats_payload) == 48, "virtio-blk queue stats payload must be 48 bytes");
+
+/**
+ * @brief Registers the virtio-blk PCI driver, called before pci::init().
+ *
+ * Every bound device becomes a block::device named vda, vdb and so on, and
+ * is reported with EVENT_BLOCK_DEVICE.
+ */
+void init();
+
+/**
+ * @brief Emits EVENT_BLOCK_QUEUE_STATS for every queue of every device.
+ */
+void emit_stats();
+
+} // namespace virtio::blk
+
+#endif
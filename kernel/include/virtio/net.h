@@ -0,0 +1,69 @@
+#ifndef VIRTIO_NET_H
+#define VIRTIO_NET_H
+
+#include <core/types.h>
+
+namespace virtio::net {
+
+inline constexpr uint16_t PCI_DEVICE_ID_TRANSITIONAL = 0x1000;
+inline constexpr uint16_t PCI_DEVICE_ID_MODERN = 0x1041;
+
+// Largest number of virtio-net devices driven
+inline constexpr size_t MAX_DEVICES = 4;
+
+// Largest number of queue pairs per device, each is served by one CPU
+inline constexpr size_t MAX_QUEUE_PAIRS = 8;
+
+// Received frames handed to the receive handler at once
+inline constexpr size_t RECEIVE_BATCH = 64;
+
+// Payload of EVENT_NET_DEVICE
+struct device_payload {
+    uint64_t features; // Negotiated virtio feature bits
+    uint8_t mac[6];
+    uint16_t mtu;
+    uint16_t queue_pairs;     // In use
+    uint16_t max_queue_pairs; // Offered by the device
+    uint16_t receive_queue_size;
+    uint16_t transmit_queue_size;
+    uint8_t interrupts;       // 1 if the receive queues interrupt through MSI-X, 0 if polled
+    uint8_t checksum_offload; // Bit 0 transmit checksums, bit 1 receive checksums
+    uint16_t reserved1;
+    uint32_t reserved2;
+    char name[8];
+} __attribute__((packed));
+
+// Payload of EVENT_NET_QUEUE_STATS
+struct queue_stats_payload {
+    uint64_t receive_packets;
+    uint64_t receive_bytes;
+    uint64_t transmit_packets;
+    uint64_t transmit_bytes;
+    uint64_t transmit_reaps;    // Passes that freed sent frames, fewer than frames when batching
+    uint64_t notifications;     // Doorbell writes of both queues, each a VM exit under a hypervisor
+    uint64_t interrupts;
+    uint32_t refill_failures;   // Receive ring refills the packet pool could not complete
+    uint16_t queue;
+    uint16_t reserved;
+    char name[8];
+} __attribute__((packed));
+
+static_assert(sizeof(device_payload) == 40, "virtio-net device payload must be 40 bytes");
+static_assert(sizeof(queue_stats_payload) == 72, "virtio-net queue stats payload must be 72 bytes");
+
+/**
+ * @brief Registers the virtio-net PCI driver, called before pci::init().
+ *
+ * Every bound device becomes a net::device named eth0, eth1 and so on, and is
+ * reported with EVENT_NET_DEVICE.
+ */
+void init();
+
+/**
+ * @brief Emits EVENT_NET_QUEUE_STATS for every queue pair of every device.
+ */
+void emit_stats();
+
+} // namespace virtio::net
+
+#endif
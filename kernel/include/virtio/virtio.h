@@ -0,0 +1,193 @@
+#ifndef VIRTIO_VIRTIO_H
+#define VIRTIO_VIRTIO_H
+
+#include <arch/x86/irq/irq.h>
+#include <core/types.h>
+#include <pci/pci.h>
+#include <sync/spinlock.h>
+
+namespace virtio {
+
+inline constexpr uint16_t PCI_VENDOR_ID = 0x1AF4;
+
+// Modern (virtio 1.x) PCI device IDs are 0x1040 plus the device type
+inline constexpr uint16_t PCI_DEVICE_ID_MODERN_BASE = 0x1040;
+
+// Largest queue size the driver uses, devices offering more are clamped to it
+inline constexpr uint16_t MAX_QUEUE_SIZE = 256;
+
+// Written as an MSI-X entry to leave a queue or the configuration change without interrupt
+inline constexpr uint16_t NO_VECTOR = 0xFFFF;
+
+// Device-independent feature bits
+inline constexpr uint32_t F_RING_INDIRECT_DESC = 28;
+inline constexpr uint32_t F_RING_EVENT_IDX = 29;
+inline constexpr uint32_t F_VERSION_1 = 32;
+
+// Descriptor flags
+inline constexpr uint16_t DESC_F_NEXT = 1U << 0;
+inline constexpr uint16_t DESC_F_WRITE = 1U << 1; // Device writes the buffer
+inline constexpr uint16_t DESC_F_INDIRECT = 1U << 2;
+
+struct descriptor {
+    uint64_t address;
+    uint32_t length;
+    uint16_t flags;
+    uint16_t next;
+} __attribute__((packed));
+
+static_assert(sizeof(descriptor) == 16, "Virtqueue descriptor must be 16 bytes");
+
+// One buffer of a descriptor chain
+struct buffer {
+    uint64_t address; // Physical
+    uint32_t length;
+    bool device_writable;
+};
+
+// Split virtqueue, the rings live in frames from the physical frame allocator
+struct virtqueue {
+    uint16_t index;
+    uint16_t size;
+    descriptor* descriptors;
+    volatile uint16_t* avail; // flags, idx, ring[size], used_event
+    volatile uint8_t* used;   // flags, idx, {id, len}[size], avail_event
+    volatile uint16_t* notify;
+    uint64_t descriptor_phys;
+    uint64_t rings_phys;
+
+    uint16_t free_head;
+    uint16_t free_count;
+    uint16_t avail_index;    // Next avail ring slot, published to the device by kick()
+    uint16_t kicked_index;   // avail_index at the last notification
+    uint16_t last_used;      // Next used ring entry to consume
+    bool event_index;        // F_RING_EVENT_IDX was negotiated
+    bool callbacks_disabled;
+    void* tokens[MAX_QUEUE_SIZE]; // Per head descriptor, returned by pop_used()
+
+    // Taken by drivers around every queue operation, also from the queue's interrupt
+    sync::spinlock lock;
+};
+
+// Modern PCI transport of one device
+struct device {
+    pci::device* pci;
+    volatile uint8_t* common;        // virtio_pci_common_cfg
+    volatile uint8_t* isr;
+    volatile uint8_t* device_config; // Device-type specific layout
+    volatile uint8_t* notify_base;
+    uint32_t notify_multiplier;
+    uint64_t features; // Negotiated
+    uint16_t queue_count;
+    bool msix;         // MSI-X table present, queue interrupts can target CPUs
+};
+
+/**
+ * @brief Finds the modern capabilities of a virtio PCI function and resets the device.
+ *
+ * Maps the BARs they point into, enables memory decoding and bus mastering,
+ * then sets the ACKNOWLEDGE and DRIVER status bits.
+ *
+ * @return false If a capability is missing, i.e. the device is legacy-only.
+ */
+bool init_device(device* dev, pci::device* pci);
+
+/**
+ * @brief Accepts the offered features that are also in `wanted` and sets FEATURES_OK.
+ *
+ * F_VERSION_1 is always requested and required.
+ *
+ * @return false If the device did not accept the subset, dev->features is then 0.
+ */
+bool negotiate_features(device* dev, uint64_t wanted);
+
+inline bool has_feature(const device* dev, uint32_t bit) {
+    return (dev->features >> bit) & 1;
+}
+
+/**
+ * @brief Allocates the rings of a queue and enables it.
+ *
+ * @param max_size Upper bound of the queue size, the device's own maximum also applies.
+ * @param vector Interrupt the device raises for the queue, MSI-X entry `msix_entry` is
+ * pointed at it. Ignored if msix_entry is NO_VECTOR, the queue is then polled.
+ * @return false If the queue does not exist or no frame is left for its rings.
+ */
+bool setup_queue(device* dev, virtqueue* queue, uint16_t index, uint16_t max_size,
+                 uint16_t msix_entry, arch::x86::irq_vector vector);
+
+/**
+ * @brief Sets DRIVER_OK, the device starts processing its queues.
+ */
+void driver_ok(device* dev);
+
+/**
+ * @brief Sets FAILED after an unrecoverable setup error.
+ */
+void fail(device* dev);
+
+uint8_t read_config8(const device* dev, size_t offset);
+uint16_t read_config16(const device* dev, size_t offset);
+uint32_t read_config32(const device* dev, size_t offset);
+
+/**
+ * @brief Reads a 64-bit field, retried until the configuration generation is stable.
+ */
+uint64_t read_config64(const device* dev, size_t offset);
+
+/**
+ * @brief Adds a descriptor chain to the avail ring without notifying the device.
+ *
+ * Called with queue->lock held. The chain becomes visible to the device at
+ * the next kick(), so a batch costs a single notification.
+ *
+ * @return false If fewer than `count` descriptors are free.
+ */
+bool add_chain(virtqueue* queue, const buffer* buffers, size_t count, void* token);
+
+/**
+ * @brief Adds a single descriptor pointing at an indirect descriptor table.
+ *
+ * Needs F_RING_INDIRECT_DESC. The table must stay untouched until the token is
+ * returned by pop_used(). Called with queue->lock held.
+ */
+bool add_indirect(virtqueue* queue, uint64_t table_phys, size_t count, void* token);
+
+/**
+ * @brief Publishes the chains added since the last kick and notifies the device if needed.
+ *
+ * With F_RING_EVENT_IDX the notification, a VM exit under a hypervisor, is
+ * skipped unless the device asked for one within the published range.
+ * Called with queue->lock held.
+ *
+ * @return true If the device was notified.
+ */
+bool kick(virtqueue* queue);
+
+/**
+ * @brief Returns the token of the next chain the device finished, or nullptr if none.
+ *
+ * Frees the chain's descriptors. Called with queue->lock held.
+ *
+ * @param length Bytes the device wrote into the chain, may be nullptr.
+ */
+void* pop_used(virtqueue* queue, uint32_t* length);
+
+/**
+ * @brief Asks for an interrupt at the next used chain.
+ *
+ * Called with queue->lock held.
+ *
+ * @return false If chains were used meanwhile, the caller must pop them first
+ * because their interrupt may have been suppressed.
+ */
+bool enable_callbacks(virtqueue* queue);
+
+/**
+ * @brief Asks the device not to interrupt for used chains, e.g. while polling.
+ */
+void disable_callbacks(virtqueue* queue);
+
+} // namespace virtio
+
+#endif
@@ -0,0 +1,126 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/acpi/acpi.h>
+#include <arch/x86/paging/paging.h>
+#include <boot/boot_info.h>
+
+namespace arch::x86 {
+// Root System Description Pointer, the ACPI 2.0 fields only count from revision 2 on
+struct acpi_rsdp {
+    char signature[8];
+    uint8_t checksum;
+    char oem_id[6];
+    uint8_t revision;
+    uint32_t rsdt_address;
+    uint32_t length;
+    uint64_t xsdt_address;
+    uint8_t extended_checksum;
+    uint8_t reserved[3];
+} __attribute__((packed));
+
+static_assert(sizeof(acpi_rsdp) == 36, "ACPI 2.0 RSDP must be 36 bytes");
+
+// ACPI 1.0 RSDP, the part covered by the first checksum
+inline constexpr size_t RSDP_V1_SIZE = 20;
+
+static const acpi_table_header* g_root_table = nullptr;
+static size_t g_root_pointer_size = 0; // 8 for the XSDT, 4 for the RSDT
+
+static bool checksum_valid(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    uint8_t sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+        sum = static_cast<uint8_t>(sum + bytes[i]);
+    }
+    return sum == 0;
+}
+
+static bool signature_is(const char* signature, const char* expected, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        if (signature[i] != expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Firmware places the tables near the top of RAM, which may be past the boot-time mapping
+static const void* map_table(uint64_t phys, size_t size) {
+    if (phys + size <= BOOT_MAPPED_MEMORY_SIZE) {
+        return phys_to_virt(phys);
+    }
+    return map_mmio(phys, size);
+}
+
+// Returns the whole table if its header and checksum are valid
+static const acpi_table_header* map_checked_table(uint64_t phys) {
+    const auto* header =
+        static_cast<const acpi_table_header*>(map_table(phys, sizeof(acpi_table_header)));
+    if (!header || header->length < sizeof(acpi_table_header)) {
+        return nullptr;
+    }
+
+    header = static_cast<const acpi_table_header*>(map_table(phys, header->length));
+    if (!header || !checksum_valid(header, header->length)) {
+        return nullptr;
+    }
+    return header;
+}
+
+static const acpi_rsdp* find_rsdp() {
+    const auto* tag = reinterpret_cast<const multiboot::tag_acpi_new*>(
+        boot::find_boot_tag(multiboot::tag_type::ACPI_NEW));
+    if (!tag) {
+        tag = reinterpret_cast<const multiboot::tag_acpi_new*>(
+            boot::find_boot_tag(multiboot::tag_type::ACPI_OLD));
+    }
+    if (!tag || tag->size < sizeof(multiboot::tag) + RSDP_V1_SIZE) {
+        return nullptr;
+    }
+
+    const auto* rsdp = reinterpret_cast<const acpi_rsdp*>(tag->rsdp);
+    if (!signature_is(rsdp->signature, "RSD PTR ", sizeof(rsdp->signature)) ||
+        !checksum_valid(rsdp, RSDP_V1_SIZE)) {
+        return nullptr;
+    }
+    return rsdp;
+}
+
+bool init_acpi() {
+    const acpi_rsdp* rsdp = find_rsdp();
+    if (!rsdp) {
+        return false;
+    }
+
+    // The XSDT holds 64-bit pointers, the RSDT 32-bit ones
+    bool extended = rsdp->revision >= 2 && rsdp->xsdt_address != 0;
+    g_root_table = map_checked_table(extended ? rsdp->xsdt_address : rsdp->rsdt_address);
+    g_root_pointer_size = extended ? sizeof(uint64_t) : sizeof(uint32_t);
+
+    return g_root_table != nullptr;
+}
+
+const acpi_table_header* find_acpi_table(const char* signature) {
+    if (!g_root_table) {
+        return nullptr;
+    }
+
+    size_t count = (g_root_table->length - sizeof(acpi_table_header)) / g_root_pointer_size;
+    const auto* pointers = reinterpret_cast<const uint8_t*>(g_root_table + 1);
+
+    for (size_t i = 0; i < count; ++i) {
+        // The XSDT's pointers are not 8-byte aligned
+        uint64_t phys = 0;
+        for (size_t byte = 0; byte < g_root_pointer_size; ++byte) {
+            phys |= static_cast<uint64_t>(pointers[i * g_root_pointer_size + byte]) << (8 * byte);
+        }
+
+        const acpi_table_header* table = map_checked_table(phys);
+        if (table && signature_is(table->signature, signature, sizeof(table->signature))) {
+            return table;
+        }
+    }
+    return nullptr;
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
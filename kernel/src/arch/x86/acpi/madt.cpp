@@ -0,0 +1,136 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/acpi/acpi.h>
+#include <arch/x86/acpi/madt.h>
+
+namespace arch::x86 {
+struct madt_header {
+    acpi_table_header header;
+    uint32_t lapic_address;
+    uint32_t flags;
+} __attribute__((packed));
+
+struct madt_entry_header {
+    uint8_t type;
+    uint8_t length;
+} __attribute__((packed));
+
+struct madt_local_apic {
+    madt_entry_header header;
+    uint8_t processor_id;
+    uint8_t apic_id;
+    uint32_t flags;
+} __attribute__((packed));
+
+struct madt_io_apic {
+    madt_entry_header header;
+    uint8_t id;
+    uint8_t reserved;
+    uint32_t address;
+    uint32_t gsi_base;
+} __attribute__((packed));
+
+struct madt_source_override {
+    madt_entry_header header;
+    uint8_t bus;
+    uint8_t source;
+    uint32_t gsi;
+    uint16_t flags;
+} __attribute__((packed));
+
+struct madt_local_x2apic {
+    madt_entry_header header;
+    uint16_t reserved;
+    uint32_t x2apic_id;
+    uint32_t flags;
+    uint32_t processor_uid;
+} __attribute__((packed));
+
+inline constexpr uint8_t MADT_LOCAL_APIC = 0;
+inline constexpr uint8_t MADT_IO_APIC = 1;
+inline constexpr uint8_t MADT_SOURCE_OVERRIDE = 2;
+inline constexpr uint8_t MADT_LOCAL_X2APIC = 9;
+
+// Local APIC flags, a CPU is usable if either is set
+inline constexpr uint32_t MADT_LAPIC_ENABLED = 1U << 0;
+inline constexpr uint32_t MADT_LAPIC_ONLINE_CAPABLE = 1U << 1;
+
+static madt_info g_madt;
+
+static void record_entry(const madt_entry_header* entry) {
+    switch (entry->type) {
+    case MADT_LOCAL_APIC: {
+        const auto* lapic = reinterpret_cast<const madt_local_apic*>(entry);
+        if (lapic->flags & (MADT_LAPIC_ENABLED | MADT_LAPIC_ONLINE_CAPABLE)) {
+            ++g_madt.cpu_count;
+        }
+        break;
+    }
+    case MADT_LOCAL_X2APIC: {
+        const auto* x2apic = reinterpret_cast<const madt_local_x2apic*>(entry);
+        if (x2apic->flags & (MADT_LAPIC_ENABLED | MADT_LAPIC_ONLINE_CAPABLE)) {
+            ++g_madt.cpu_count;
+        }
+        break;
+    }
+    case MADT_IO_APIC: {
+        const auto* io_apic = reinterpret_cast<const madt_io_apic*>(entry);
+        if (g_madt.io_apic_count < MAX_IO_APICS) {
+            g_madt.io_apics[g_madt.io_apic_count++] = {.address = io_apic->address,
+                                                       .gsi_base = io_apic->gsi_base,
+                                                       .id = io_apic->id};
+        }
+        break;
+    }
+    case MADT_SOURCE_OVERRIDE: {
+        const auto* source = reinterpret_cast<const madt_source_override*>(entry);
+        // Bus 0 is ISA, no other bus is defined
+        if (source->bus == 0 && source->source < ISA_IRQ_COUNT) {
+            g_madt.isa_irqs[source->source] = {
+                .gsi = source->gsi,
+                .active_low = (source->flags & MADT_POLARITY_MASK) == MADT_POLARITY_ACTIVE_LOW,
+                .level_triggered = (source->flags & MADT_TRIGGER_MASK) == MADT_TRIGGER_LEVEL};
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+bool init_madt() {
+    // ISA interrupts are edge triggered and active high unless overridden
+    for (size_t irq = 0; irq < ISA_IRQ_COUNT; ++irq) {
+        g_madt.isa_irqs[irq] = {
+            .gsi = static_cast<uint32_t>(irq), .active_low = false, .level_triggered = false};
+    }
+
+    const acpi_table_header* header = find_acpi_table("APIC");
+    if (!header || header->length < sizeof(madt_header)) {
+        return false;
+    }
+
+    const auto* table = reinterpret_cast<const madt_header*>(header);
+
+    const auto* entries = reinterpret_cast<const uint8_t*>(table + 1);
+    size_t length = table->header.length - sizeof(madt_header);
+
+    for (size_t offset = 0; offset + sizeof(madt_entry_header) <= length;) {
+        const auto* entry = reinterpret_cast<const madt_entry_header*>(entries + offset);
+        if (entry->length < sizeof(madt_entry_header) || offset + entry->length > length) {
+            break;
+        }
+
+        record_entry(entry);
+        offset += entry->length;
+    }
+
+    g_madt.found = true;
+    return true;
+}
+
+const madt_info* madt() {
+    return &g_madt;
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
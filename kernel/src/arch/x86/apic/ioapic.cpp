@@ -0,0 +1,217 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/acpi/madt.h>
+#include <arch/x86/apic/ioapic.h>
+#include <arch/x86/paging/paging.h>
+#include <sync/spinlock.h>
+
+namespace arch::x86 {
+// Indirect register window, the index goes to IOREGSEL and the data through IOWIN
+inline constexpr uint32_t IOAPIC_REGISTER_SELECT = 0x00;
+inline constexpr uint32_t IOAPIC_REGISTER_WINDOW = 0x10;
+inline constexpr size_t IOAPIC_WINDOW_SIZE = 0x20;
+
+inline constexpr uint32_t IOAPIC_REG_VERSION = 0x01;
+inline constexpr uint32_t IOAPIC_REG_REDIRECTION = 0x10; // Two registers per input
+
+// Redirection entry fields, low half
+inline constexpr uint32_t RTE_ACTIVE_LOW = 1U << 13;
+inline constexpr uint32_t RTE_LEVEL_TRIGGERED = 1U << 15;
+inline constexpr uint32_t RTE_MASKED = 1U << 16;
+
+// Redirection entry fields, high half, physical destination mode
+inline constexpr uint32_t RTE_DESTINATION_SHIFT = 24;
+inline constexpr uint32_t RTE_MAX_DESTINATION = 0xFF;
+
+struct io_apic {
+    volatile uint32_t* registers;
+    uint32_t gsi_base;
+    uint32_t inputs;
+};
+
+struct gsi_route {
+    irq_vector vector;
+    uint32_t flags; // Polarity and trigger mode bits of the redirection entry
+    irq_handler_t handler;
+    void* context;
+    const char* name;
+    bool routed;
+};
+
+static io_apic g_io_apics[MAX_IO_APICS];
+static size_t g_io_apic_count = 0;
+
+// Serializes the register windows and the route table
+static sync::spinlock g_ioapic_lock;
+static gsi_route g_routes[MAX_GSIS];
+
+static uint32_t read_register(const io_apic* apic, uint32_t reg) {
+    apic->registers[IOAPIC_REGISTER_SELECT / sizeof(uint32_t)] = reg;
+    return apic->registers[IOAPIC_REGISTER_WINDOW / sizeof(uint32_t)];
+}
+
+static void write_register(const io_apic* apic, uint32_t reg, uint32_t value) {
+    apic->registers[IOAPIC_REGISTER_SELECT / sizeof(uint32_t)] = reg;
+    apic->registers[IOAPIC_REGISTER_WINDOW / sizeof(uint32_t)] = value;
+}
+
+// The low half holds the mask bit, so it is written last when unmasking
+static void write_entry(const io_apic* apic, uint32_t input, uint32_t low, uint32_t high) {
+    write_register(apic, IOAPIC_REG_REDIRECTION + input * 2 + 1, high);
+    write_register(apic, IOAPIC_REG_REDIRECTION + input * 2, low);
+}
+
+static void mask_entry(const io_apic* apic, uint32_t input) {
+    write_register(apic, IOAPIC_REG_REDIRECTION + input * 2, RTE_MASKED);
+}
+
+static const io_apic* find_io_apic(uint32_t gsi) {
+    for (size_t i = 0; i < g_io_apic_count; ++i) {
+        const io_apic* apic = &g_io_apics[i];
+        if (gsi >= apic->gsi_base && gsi < apic->gsi_base + apic->inputs) {
+            return apic;
+        }
+    }
+    return nullptr;
+}
+
+// Points the input at a vector, called with g_ioapic_lock held
+static bool program_entry(const io_apic* apic, uint32_t gsi, const gsi_route* route) {
+    uint32_t destination = irq_destination(route->vector.cpu);
+    if (destination > RTE_MAX_DESTINATION) {
+        return false;
+    }
+
+    uint32_t input = gsi - apic->gsi_base;
+    mask_entry(apic, input);
+    write_entry(apic, input, route->flags | route->vector.vector,
+                destination << RTE_DESTINATION_SHIFT);
+    return true;
+}
+
+bool init_ioapics() {
+    const madt_info* info = madt();
+
+    for (size_t i = 0; i < info->io_apic_count; ++i) {
+        void* window = map_mmio(info->io_apics[i].address, IOAPIC_WINDOW_SIZE);
+        auto* registers = static_cast<volatile uint32_t*>(window);
+        if (!registers) {
+            continue;
+        }
+
+        io_apic* apic = &g_io_apics[g_io_apic_count++];
+        apic->registers = registers;
+        apic->gsi_base = info->io_apics[i].gsi_base;
+        apic->inputs = ((read_register(apic, IOAPIC_REG_VERSION) >> 16) & 0xFF) + 1;
+
+        // Firmware may leave inputs unmasked, nothing is routed until a driver asks
+        for (uint32_t input = 0; input < apic->inputs; ++input) {
+            mask_entry(apic, input);
+        }
+    }
+
+    return g_io_apic_count > 0;
+}
+
+bool ioapic_available() {
+    return g_io_apic_count > 0;
+}
+
+bool route_gsi(uint32_t gsi, bool active_low, bool level_triggered, int cpu,
+               irq_handler_t handler, void* context, const char* name) {
+    if (gsi >= MAX_GSIS) {
+        return false;
+    }
+
+    sync::spinlock_guard guard(g_ioapic_lock);
+
+    const io_apic* apic = find_io_apic(gsi);
+    gsi_route* route = &g_routes[gsi];
+    if (!apic || route->routed) {
+        return false;
+    }
+
+    irq_vector vector;
+    if (!allocate_irq_vector(cpu, handler, context, name, &vector)) {
+        return false;
+    }
+
+    *route = {.vector = vector,
+              .flags = (active_low ? RTE_ACTIVE_LOW : 0) |
+                       (level_triggered ? RTE_LEVEL_TRIGGERED : 0),
+              .handler = handler,
+              .context = context,
+              .name = name,
+              .routed = true};
+
+    if (!program_entry(apic, gsi, route)) {
+        free_irq_vector(vector);
+        route->routed = false;
+        return false;
+    }
+    return true;
+}
+
+bool route_isa_irq(uint8_t irq, int cpu, irq_handler_t handler, void* context, const char* name) {
+    if (irq >= ISA_IRQ_COUNT) {
+        return false;
+    }
+
+    const isa_irq_route* isa = &madt()->isa_irqs[irq];
+    return route_gsi(isa->gsi, isa->active_low, isa->level_triggered, cpu, handler, context, name);
+}
+
+bool set_gsi_affinity(uint32_t gsi, int cpu) {
+    if (gsi >= MAX_GSIS) {
+        return false;
+    }
+
+    sync::spinlock_guard guard(g_ioapic_lock);
+
+    const io_apic* apic = find_io_apic(gsi);
+    gsi_route* route = &g_routes[gsi];
+    if (!apic || !route->routed) {
+        return false;
+    }
+    if (route->vector.cpu == cpu) {
+        return true;
+    }
+
+    irq_vector vector;
+    if (!allocate_irq_vector(cpu, route->handler, route->context, route->name, &vector)) {
+        return false;
+    }
+
+    irq_vector previous = route->vector;
+    route->vector = vector;
+    if (!program_entry(apic, gsi, route)) {
+        // Back to the old CPU, its vector is still allocated
+        route->vector = previous;
+        program_entry(apic, gsi, route);
+        free_irq_vector(vector);
+        return false;
+    }
+
+    free_irq_vector(previous);
+    return true;
+}
+
+void unroute_gsi(uint32_t gsi) {
+    if (gsi >= MAX_GSIS) {
+        return;
+    }
+
+    sync::spinlock_guard guard(g_ioapic_lock);
+
+    const io_apic* apic = find_io_apic(gsi);
+    gsi_route* route = &g_routes[gsi];
+    if (!apic || !route->routed) {
+        return;
+    }
+
+    mask_entry(apic, gsi - apic->gsi_base);
+    free_irq_vector(route->vector);
+    route->routed = false;
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
@@ -0,0 +1,184 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/cpu/features.h>
+#include <arch/x86/cpu/static_key.h>
+#include <arch/x86/idt/idt.h>
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/pit/pit.h>
+
+namespace arch::x86 {
+inline constexpr uint64_t APIC_BASE_ADDRESS_MASK = 0xFFFFFF000;
+inline constexpr uint64_t APIC_BASE_GLOBAL_ENABLE = 1ULL << 11;
+inline constexpr uint64_t APIC_BASE_X2APIC_ENABLE = 1ULL << 10;
+
+// x2APIC registers are MSRs, one per 16-byte xAPIC register slot
+inline constexpr uint32_t X2APIC_MSR_BASE = 0x800;
+inline constexpr uint32_t X2APIC_MSR_ICR = X2APIC_MSR_BASE + (LAPIC_REG_ICR_LOW >> 4);
+
+// Timer divide configuration value for a divisor of 16
+inline constexpr uint32_t LAPIC_TIMER_DIVIDE_BY_16 = 0x3;
+
+// Length of the PIT reference window used for calibration
+inline constexpr uint32_t CALIBRATION_WINDOW_US = 10000;
+
+static volatile uint32_t* g_lapic_registers = nullptr;
+
+// Set by init_lapic() before the APs start, every register access tests it
+static static_key g_x2apic;
+static uint64_t g_lapic_timer_frequency = 0;
+static uint64_t g_tsc_frequency = 0;
+
+uint32_t lapic_read(uint32_t reg) {
+    if (static_branch_likely(g_x2apic)) {
+        return static_cast<uint32_t>(read_msr(X2APIC_MSR_BASE + (reg >> 4)));
+    }
+    return g_lapic_registers[reg / sizeof(uint32_t)];
+}
+
+void lapic_write(uint32_t reg, uint32_t value) {
+    if (static_branch_likely(g_x2apic)) {
+        write_msr(X2APIC_MSR_BASE + (reg >> 4), value);
+        return;
+    }
+    g_lapic_registers[reg / sizeof(uint32_t)] = value;
+}
+
+uint32_t lapic_id() {
+    // The x2APIC ID register holds the whole 32-bit ID
+    if (static_branch_likely(g_x2apic)) {
+        return lapic_read(LAPIC_REG_ID);
+    }
+    return lapic_read(LAPIC_REG_ID) >> 24;
+}
+
+bool x2apic_enabled() {
+    return g_x2apic.enabled;
+}
+
+void lapic_send_eoi() {
+    lapic_write(LAPIC_REG_EOI, 0);
+}
+
+void lapic_send_ipi(uint32_t destination, uint32_t command) {
+    // One 64-bit write sends it, there is no delivery status to wait for
+    if (static_branch_likely(g_x2apic)) {
+        write_msr(X2APIC_MSR_ICR, (static_cast<uint64_t>(destination) << 32) | command);
+        return;
+    }
+
+    lapic_write(LAPIC_REG_ICR_HIGH, destination << 24);
+    lapic_write(LAPIC_REG_ICR_LOW, command);
+
+    while (lapic_read(LAPIC_REG_ICR_LOW) & LAPIC_ICR_DELIVERY_PENDING) {
+        cpu_relax();
+    }
+}
+
+static void lapic_error_handler(interrupt_frame* /* frame */) {
+    // The error status register must be written before it can be read back
+    lapic_write(LAPIC_REG_ERROR_STATUS, 0);
+    lapic_send_eoi();
+}
+
+static void enable_lapic() {
+    uint64_t base = read_msr(IA32_APIC_BASE_MSR) | APIC_BASE_GLOBAL_ENABLE;
+    write_msr(IA32_APIC_BASE_MSR, base);
+
+    // From xAPIC to x2APIC mode needs the global enable set first
+    if (g_x2apic.enabled) {
+        write_msr(IA32_APIC_BASE_MSR, base | APIC_BASE_X2APIC_ENABLE);
+    }
+
+    // Accept all interrupt priorities
+    lapic_write(LAPIC_REG_TASK_PRIORITY, 0);
+
+    // Local interrupt pins are not used, device interrupts arrive via messages
+    lapic_write(LAPIC_REG_LVT_LINT0, LAPIC_LVT_MASKED);
+    lapic_write(LAPIC_REG_LVT_LINT1, LAPIC_LVT_MASKED);
+    lapic_write(LAPIC_REG_LVT_ERROR, LAPIC_ERROR_VECTOR);
+    lapic_write(LAPIC_REG_LVT_TIMER, LAPIC_LVT_MASKED);
+
+    lapic_write(LAPIC_REG_SPURIOUS, LAPIC_SOFTWARE_ENABLE | LAPIC_SPURIOUS_VECTOR);
+}
+
+static void calibrate_lapic_timer() {
+    lapic_write(LAPIC_REG_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_BY_16);
+    lapic_write(LAPIC_REG_LVT_TIMER, LAPIC_LVT_MASKED);
+
+    pit_start_oneshot(CALIBRATION_WINDOW_US);
+    lapic_write(LAPIC_REG_TIMER_INITIAL_COUNT, 0xFFFFFFFF);
+    uint64_t tsc_start = rdtsc();
+
+    while (!pit_oneshot_expired()) {
+        cpu_relax();
+    }
+
+    uint32_t elapsed = 0xFFFFFFFF - lapic_read(LAPIC_REG_TIMER_CURRENT_COUNT);
+    uint64_t tsc_elapsed = rdtsc() - tsc_start;
+    lapic_write(LAPIC_REG_TIMER_INITIAL_COUNT, 0);
+
+    // The TSC is calibrated in the same window to avoid a second PIT wait during boot
+    g_lapic_timer_frequency = static_cast<uint64_t>(elapsed) * (1000000 / CALIBRATION_WINDOW_US);
+    g_tsc_frequency = tsc_elapsed * (1000000 / CALIBRATION_WINDOW_US);
+}
+
+bool init_lapic() {
+    // Register accesses become MSR accesses, no register page is mapped
+    if (has_feature(cpu_feature::X2APIC)) {
+        set_static_key(&g_x2apic, true);
+    } else {
+        uint64_t base = read_msr(IA32_APIC_BASE_MSR) & APIC_BASE_ADDRESS_MASK;
+
+        g_lapic_registers = static_cast<volatile uint32_t*>(map_mmio(base, PAGE_SIZE));
+        if (!g_lapic_registers) {
+            return false;
+        }
+    }
+
+    register_interrupt_handler(LAPIC_ERROR_VECTOR, lapic_error_handler);
+
+    enable_lapic();
+    calibrate_lapic_timer();
+
+    return true;
+}
+
+void init_ap_lapic() {
+    enable_lapic();
+}
+
+void lapic_route_legacy_pic() {
+    lapic_write(LAPIC_REG_LVT_LINT0, LAPIC_LVT_DELIVERY_EXTINT);
+}
+
+void start_lapic_timer(uint32_t frequency_hz) {
+    if (frequency_hz == 0) {
+        return;
+    }
+
+    uint64_t initial_count = g_lapic_timer_frequency / frequency_hz;
+    if (initial_count == 0) {
+        initial_count = 1;
+    }
+
+    lapic_write(LAPIC_REG_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_BY_16);
+    lapic_write(LAPIC_REG_LVT_TIMER, LAPIC_TIMER_VECTOR | LAPIC_LVT_TIMER_PERIODIC);
+    lapic_write(LAPIC_REG_TIMER_INITIAL_COUNT, static_cast<uint32_t>(initial_count));
+}
+
+void stop_lapic_timer() {
+    lapic_write(LAPIC_REG_LVT_TIMER, LAPIC_LVT_MASKED);
+    lapic_write(LAPIC_REG_TIMER_INITIAL_COUNT, 0);
+}
+
+uint64_t lapic_timer_frequency() {
+    return g_lapic_timer_frequency;
+}
+
+uint64_t tsc_frequency() {
+    return g_tsc_frequency;
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
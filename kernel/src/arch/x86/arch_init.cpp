@@ -1,9 +1,89 @@
 #include <arch/arch_init.h>
+#include <arch/x86/acpi/acpi.h>
+#include <arch/x86/acpi/madt.h>
+#include <arch/x86/apic/ioapic.h>
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/cpu/features.h>
+#include <arch/x86/fpu/fpu.h>
 #include <arch/x86/gdt/gdt.h>
+#include <arch/x86/idt/idt.h>
+#include <arch/x86/irq/irq.h>
+#include <arch/x86/paging/tlb.h>
+#include <arch/x86/percpu/percpu.h>
+#include <arch/x86/pic/pic.h>
+#include <arch/x86/smp/ipi.h>
+#include <arch/x86/smp/smp.h>
+#include <arch/x86/syscall/syscall.h>
+#include <boot/boot_timing.h>
+#include <iris/profiler.h>
+#include <memory/memory.h>
+#include <proc/process.h>
+#include <sched/sched.h>
+#include <serial/serial.h>
 
 uint8_t g_default_bsp_system_stack[0x1000 * 4];
 
 namespace arch {
+static void timer_interrupt_handler(x86::interrupt_frame* frame) {
+    iris::profiler::record_sample(frame->rip, frame->rbp);
+
+    x86::lapic_send_eoi();
+
+    // May switch away, the interrupted task resumes here when it is scheduled again
+    sched::tick();
+}
+
+static void fpu_trap_handler(x86::interrupt_frame*) {
+    sched::handle_fpu_trap();
+}
+
+static void page_fault_handler(x86::interrupt_frame* frame) {
+    if (proc::handle_page_fault(x86::read_cr2(), frame->error_code)) {
+        return;
+    }
+
+    // A user access outside the process's regions only ends the process
+    if (frame->cs & 3) {
+        proc::exit(proc::EXIT_PAGE_FAULT);
+    }
+
+    x86::handle_unhandled_exception(frame);
+}
+
+static void com1_interrupt_handler(x86::interrupt_frame*) {
+    serial::handle_interrupt(static_cast<uint16_t>(serial::port_base::COM1));
+    x86::send_legacy_pic_eoi(x86::LEGACY_IRQ_COM1);
+}
+
+static void com2_interrupt_handler(x86::interrupt_frame*) {
+    serial::handle_interrupt(static_cast<uint16_t>(serial::port_base::COM2));
+    x86::send_legacy_pic_eoi(x86::LEGACY_IRQ_COM2);
+}
+
+// Routed through the I/O APIC, the context is the port base
+static void serial_irq_handler(void* context) {
+    serial::handle_interrupt(static_cast<uint16_t>(reinterpret_cast<uintptr_t>(context)));
+}
+
+static void* serial_irq_context(serial::port_base port) {
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(port));
+}
+
+// Serial interrupts go to the BSP, the IRIS transmitter runs there
+static void route_serial_interrupt(serial::port_base port, uint8_t irq,
+                                   x86::interrupt_handler_t legacy_handler, const char* name) {
+    if (x86::ioapic_available() &&
+        x86::route_isa_irq(irq, 0, serial_irq_handler, serial_irq_context(port), name)) {
+        return;
+    }
+
+    // No I/O APIC, the legacy PIC passes the line through LINT0 of the BSP
+    x86::register_interrupt_handler(x86::PIC1_VECTOR_OFFSET + irq, legacy_handler);
+    x86::lapic_route_legacy_pic();
+    x86::enable_legacy_irq(irq);
+}
+
 void arch_first_stage_init() {
     // Setup kernel stack
     uint64_t bsp_system_stack_top = reinterpret_cast<uint64_t>(g_default_bsp_system_stack) +
@@ -11,6 +91,68 @@ void arch_first_stage_init() {
 
     // Setup the GDT with userspace support
     x86::init_gdt(0, bsp_system_stack_top);
+    boot::mark_phase(boot::boot_phase::GDT_READY);
+
+    // Tracepoints switch from the early table to per-CPU counters from here on
+    if (!x86::init_bsp_per_cpu_area()) {
+        while (true) {
+            x86::halt();
+        }
+    }
+    boot::mark_phase(boot::boot_phase::PER_CPU_READY);
+
+    // Everything after this asks the cached CPUID words, hot paths are patched to match them
+    x86::init_cpu_features(0);
+    memory::init_string_operations();
+
+    // The boot context becomes the BSP's idle task
+    sched::init_cpu(0);
+
+    // Setup the IDT and route all interrupts through the local APIC
+    x86::init_idt();
+    x86::disable_legacy_pic();
+    x86::init_irq();
+    boot::mark_phase(boot::boot_phase::IDT_READY);
+
+    // I/O APICs and ISA interrupt overrides, the legacy PIC stays masked if there is one
+    if (x86::init_acpi()) {
+        x86::init_madt();
+    }
+
+    // FPU state is switched lazily, a thread's first FPU instruction after a switch raises #NM
+    x86::register_interrupt_handler(x86::EXCEPTION_DEVICE_NOT_AVAILABLE, fpu_trap_handler);
+    x86::init_fpu();
+
+    // User pages are mapped on first access
+    x86::register_interrupt_handler(x86::EXCEPTION_PAGE_FAULT, page_fault_handler);
+
+    // Cross-CPU function calls, TLB shootdowns are sent through them
+    x86::init_ipi();
+
+    // PCID-tagged address spaces
+    x86::init_tlb(0);
+
+    x86::enable_syscall_interface();
+
+    bool lapic_ready = x86::init_lapic();
+    if (lapic_ready) {
+        x86::register_interrupt_handler(x86::LAPIC_TIMER_VECTOR, timer_interrupt_handler);
+        x86::start_lapic_timer(x86::LAPIC_TIMER_FREQUENCY_HZ);
+        boot::mark_phase(boot::boot_phase::LAPIC_READY);
+
+        x86::init_ioapics();
+        route_serial_interrupt(serial::port_base::COM1, x86::LEGACY_IRQ_COM1,
+                               com1_interrupt_handler, "com1");
+        route_serial_interrupt(serial::port_base::COM2, x86::LEGACY_IRQ_COM2,
+                               com2_interrupt_handler, "com2");
+    }
+
+    x86::enable_interrupts();
+
+    // Application processors reuse the BSP's IDT and APIC timer calibration
+    if (lapic_ready) {
+        x86::start_application_processors();
+    }
 }
 
 void arch_second_stage_init() {
@@ -0,0 +1,129 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/cpu/features.h>
+#include <arch/x86/percpu/percpu.h>
+#include <iris/iris.h>
+#include <memory/memory.h>
+
+namespace arch::x86 {
+inline constexpr uint32_t CPUID_EXTENDED_BASE = 0x80000000;
+
+cpu_features g_boot_cpu_features;
+
+// APs only, the BSP's entry is g_boot_cpu_features
+static cpu_features g_ap_features[MAX_CPUS];
+
+static cpu_features* features_slot(int cpu) {
+    return cpu == 0 ? &g_boot_cpu_features : &g_ap_features[cpu];
+}
+
+static void probe(cpu_features* features) {
+    uint32_t eax;
+    uint32_t ebx;
+    uint32_t ecx;
+    uint32_t edx;
+    uint32_t* words = features->words;
+
+    cpuid(0, 0, &eax, &ebx, &ecx, &edx);
+    features->max_leaf = eax;
+    memory::memcpy(&features->vendor[0], &ebx, sizeof(ebx));
+    memory::memcpy(&features->vendor[4], &edx, sizeof(edx));
+    memory::memcpy(&features->vendor[8], &ecx, sizeof(ecx));
+
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+    words[static_cast<size_t>(cpuid_word::LEAF_1_ECX)] = ecx;
+    words[static_cast<size_t>(cpuid_word::LEAF_1_EDX)] = edx;
+
+    // The extended family and model only count for the families that define them
+    uint32_t family = (eax >> 8) & 0xF;
+    uint32_t model = (eax >> 4) & 0xF;
+    if (family == 0xF) {
+        family += (eax >> 20) & 0xFF;
+    }
+    if (family == 0x6 || family >= 0xF) {
+        model |= ((eax >> 16) & 0xF) << 4;
+    }
+    features->family = static_cast<uint8_t>(family);
+    features->model = static_cast<uint8_t>(model);
+    features->stepping = static_cast<uint8_t>(eax & 0xF);
+
+    if (features->max_leaf >= 5) {
+        cpuid(5, 0, &eax, &ebx, &ecx, &edx);
+        words[static_cast<size_t>(cpuid_word::LEAF_5_ECX)] = ecx;
+    }
+
+    if (features->max_leaf >= 7) {
+        cpuid(7, 0, &eax, &ebx, &ecx, &edx);
+        words[static_cast<size_t>(cpuid_word::LEAF_7_EBX)] = ebx;
+        words[static_cast<size_t>(cpuid_word::LEAF_7_ECX)] = ecx;
+        words[static_cast<size_t>(cpuid_word::LEAF_7_EDX)] = edx;
+    }
+
+    cpuid(CPUID_EXTENDED_BASE, 0, &eax, &ebx, &ecx, &edx);
+    features->max_extended_leaf = eax;
+
+    if (features->max_extended_leaf >= CPUID_EXTENDED_BASE + 1) {
+        cpuid(CPUID_EXTENDED_BASE + 1, 0, &eax, &ebx, &ecx, &edx);
+        words[static_cast<size_t>(cpuid_word::EXT_LEAF_1_ECX)] = ecx;
+        words[static_cast<size_t>(cpuid_word::EXT_LEAF_1_EDX)] = edx;
+    }
+
+    if (features->max_extended_leaf >= CPUID_EXTENDED_BASE + 7) {
+        cpuid(CPUID_EXTENDED_BASE + 7, 0, &eax, &ebx, &ecx, &edx);
+        words[static_cast<size_t>(cpuid_word::EXT_LEAF_7_EDX)] = edx;
+    }
+}
+
+// Whether a CPU lacks a feature the BSP has, code selected at boot may not run on it
+static bool lacks_boot_features(const cpu_features* features) {
+    for (size_t i = 0; i < CPUID_WORD_COUNT; ++i) {
+        if (g_boot_cpu_features.words[i] & ~features->words[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void init_cpu_features(int cpu) {
+    if (cpu < 0 || cpu >= MAX_CPUS) {
+        return;
+    }
+
+    cpu_features* features = features_slot(cpu);
+    probe(features);
+    __atomic_store_n(&features->probed, true, __ATOMIC_RELEASE);
+}
+
+const cpu_features* cpu_features_of(int cpu) {
+    if (cpu < 0 || cpu >= MAX_CPUS) {
+        return nullptr;
+    }
+
+    const cpu_features* features = features_slot(cpu);
+    return __atomic_load_n(&features->probed, __ATOMIC_ACQUIRE) ? features : nullptr;
+}
+
+void emit_cpu_features() {
+    for (int cpu = 0; cpu < MAX_CPUS; ++cpu) {
+        const cpu_features* features = cpu_features_of(cpu);
+        if (!features) {
+            continue;
+        }
+
+        cpu_features_payload payload = {};
+        memory::memcpy(payload.words, features->words, sizeof(payload.words));
+        memory::memcpy(payload.vendor, features->vendor, sizeof(payload.vendor));
+        payload.max_leaf = features->max_leaf;
+        payload.max_extended_leaf = features->max_extended_leaf;
+        payload.family = features->family;
+        payload.model = features->model;
+        payload.stepping = features->stepping;
+        payload.mismatch = lacks_boot_features(features) ? 1 : 0;
+
+        iris::emit_with_payload(iris::EVENT_CPU_FEATURES, 0, static_cast<uint8_t>(cpu), &payload,
+                                sizeof(payload));
+    }
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
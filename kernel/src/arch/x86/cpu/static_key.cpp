@@ -0,0 +1,65 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/cpu/static_key.h>
+
+// Bounds of the .static_keys section (nyros.ld)
+EXTERN_C arch::x86::static_key_entry __static_keys_start[];
+EXTERN_C arch::x86::static_key_entry __static_keys_end[];
+
+namespace arch::x86 {
+inline constexpr uint64_t STATIC_KEY_LIKELY = 1;
+
+inline constexpr uint8_t NOP5[STATIC_KEY_SITE_SIZE] = {0x0F, 0x1F, 0x44, 0x00, 0x00};
+inline constexpr uint8_t JMP_REL32 = 0xE9;
+
+// Byte by byte rather than memcpy, memcpy itself has sites that may be the ones rewritten
+static void patch_site(const static_key_entry* entry, bool jump) {
+    auto* site = reinterpret_cast<volatile uint8_t*>(entry->site);
+    uint8_t code[STATIC_KEY_SITE_SIZE];
+
+    if (jump) {
+        // Relative to the end of the JMP, kernel text lies within +-2 GiB of itself
+        auto displacement = static_cast<uint32_t>(entry->target - (entry->site + sizeof(code)));
+
+        code[0] = JMP_REL32;
+        for (size_t i = 0; i < sizeof(displacement); ++i) {
+            code[1 + i] = static_cast<uint8_t>(displacement >> (8 * i));
+        }
+    } else {
+        for (size_t i = 0; i < sizeof(code); ++i) {
+            code[i] = NOP5[i];
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(code); ++i) {
+        site[i] = code[i];
+    }
+}
+
+void set_static_key(static_key* key, bool enabled) {
+    key->enabled = enabled;
+
+    for (static_key_entry* entry = __static_keys_start; entry < __static_keys_end; ++entry) {
+        if ((entry->key & ~STATIC_KEY_LIKELY) != reinterpret_cast<uint64_t>(key)) {
+            continue;
+        }
+
+        // A likely site jumps while disabled, an unlikely one while enabled
+        bool likely = (entry->key & STATIC_KEY_LIKELY) != 0;
+        patch_site(entry, enabled != likely);
+    }
+
+    // CPUID serializes, no stale bytes of a rewritten site are executed after this
+    uint32_t eax;
+    uint32_t ebx;
+    uint32_t ecx;
+    uint32_t edx;
+    cpuid(0, 0, &eax, &ebx, &ecx, &edx);
+}
+
+size_t static_key_site_count() {
+    return static_cast<size_t>(__static_keys_end - __static_keys_start);
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
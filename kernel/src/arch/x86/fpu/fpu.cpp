@@ -0,0 +1,35 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/fpu/fpu.h>
+#include <memory/memory.h>
+
+namespace arch::x86 {
+static fpu_state g_initial_fpu_state;
+static bool g_initial_fpu_state_ready = false;
+
+void init_fpu() {
+    // Native x87 error reporting and #NM on WAIT/FWAIT while TS is set
+    uint64_t cr0 = read_cr0();
+    cr0 &= ~CR0_EMULATION;
+    cr0 |= CR0_MONITOR_COPROCESSOR | CR0_NUMERIC_ERROR;
+    write_cr0(cr0 & ~CR0_TASK_SWITCHED);
+
+    // FXSAVE/FXRSTOR and unmasked SIMD exceptions as #XM
+    write_cr4(read_cr4() | CR4_OSFXSR | CR4_OSXMMEXCPT);
+
+    asm volatile("fninit" ::: "memory");
+
+    if (!g_initial_fpu_state_ready) {
+        save_fpu_state(&g_initial_fpu_state);
+        g_initial_fpu_state_ready = true;
+    }
+
+    set_task_switched();
+}
+
+void reset_fpu_state(fpu_state* state) {
+    memory::memcpy(state, &g_initial_fpu_state, sizeof(fpu_state));
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
@@ -1,6 +1,8 @@
 #ifdef ARCH_X86_64
 #include <arch/x86/gdt/gdt.h>
+#include <arch/x86/syscall/syscall.h>
 #include <iris/iris.h>
+#include <iris/tracepoint.h>
 #include <memory/memory.h>
 
 namespace arch::x86 {
@@ -104,6 +106,8 @@ void init_gdt_segment_descriptors(gdt_and_tss_data* data) {
 }
 
 void init_gdt(int cpu, uint64_t system_stack) {
+    iris::scope_trace<iris::tracepoint::ARCH_INIT_GDT> trace;
+
     gdt_and_tss_data* data = &g_gdt_per_cpu_array[cpu];
 
     // Zero out all descriptors initially
@@ -172,6 +176,17 @@ void init_gdt(int cpu, uint64_t system_stack) {
 void reload_task_register() {
     __asm__("ltr %%ax" : : "a"(TSS_PT1_SELECTOR));
 }
+
+void set_kernel_stack(int cpu, uint64_t rsp0) {
+    g_gdt_per_cpu_array[cpu].tss_instance.rsp0 = rsp0;
+
+    // SYSCALL does not consult the TSS, its entry reads the same stack from the per-CPU area
+    this_cpu_write(&g_syscall_kernel_stack, rsp0);
+}
+
+uint64_t kernel_stack(int cpu) {
+    return g_gdt_per_cpu_array[cpu].tss_instance.rsp0;
+}
 } // namespace arch::x86
 
 #endif // ARCH_X86_64
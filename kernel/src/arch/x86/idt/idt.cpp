@@ -0,0 +1,88 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/gdt/gdt.h>
+#include <arch/x86/idt/idt.h>
+#include <arch/x86/irq/irq.h>
+#include <arch/x86/percpu/percpu.h>
+#include <iris/iris.h>
+
+EXTERN_C uint64_t asm_isr_stub_table[];
+
+namespace arch::x86 {
+alignas(16) static idt_gate_descriptor g_idt[IDT_ENTRIES];
+static idt_desc g_idt_descriptor;
+static interrupt_handler_t g_interrupt_handlers[IDT_ENTRIES];
+
+static void set_gate(uint8_t vector, uint64_t handler, uint8_t type_attr) {
+    idt_gate_descriptor* gate = &g_idt[vector];
+
+    gate->offset_low = static_cast<uint16_t>(handler & 0xFFFF);
+    gate->selector = KERNEL_CS;
+    gate->ist = 0;
+    gate->type_attr = type_attr;
+    gate->offset_mid = static_cast<uint16_t>((handler >> 16) & 0xFFFF);
+    gate->offset_high = static_cast<uint32_t>((handler >> 32) & 0xFFFFFFFF);
+    gate->reserved = 0;
+}
+
+void handle_unhandled_exception(interrupt_frame* frame) {
+    // Report the full register state before halting, IRIS is the only
+    // channel guaranteed to work this early.
+    iris::emit_with_payload(iris::EVENT_CPU_EXCEPTION, 0, static_cast<uint8_t>(current_cpu()),
+                            frame, sizeof(interrupt_frame));
+    iris::flush();
+
+    while (true) {
+        disable_interrupts();
+        halt();
+    }
+}
+
+void init_idt() {
+    for (size_t vector = 0; vector < IDT_ENTRIES; ++vector) {
+        set_gate(static_cast<uint8_t>(vector), asm_isr_stub_table[vector], IDT_INTERRUPT_GATE);
+        g_interrupt_handlers[vector] = nullptr;
+    }
+
+    g_idt_descriptor = {.limit = sizeof(g_idt) - 1, .base = reinterpret_cast<uint64_t>(g_idt)};
+
+    load_idt();
+}
+
+void load_idt() {
+    asm volatile("lidt %0" : : "m"(g_idt_descriptor));
+}
+
+void register_interrupt_handler(uint8_t vector, interrupt_handler_t handler) {
+    g_interrupt_handlers[vector] = handler;
+}
+
+void set_interrupt_stack(uint8_t vector, uint8_t ist) {
+    g_idt[vector].ist = ist & 0x7;
+}
+} // namespace arch::x86
+
+// Called from the common interrupt entry stub (isr.S)
+EXTERN_C
+void handle_interrupt(arch::x86::interrupt_frame* frame) {
+    using namespace arch::x86;
+
+    // External interrupts only arrive once the per-CPU area is online
+    if (frame->vector >= IRQ_BASE_VECTOR) {
+        count_interrupt(static_cast<uint8_t>(frame->vector));
+    }
+
+    interrupt_handler_t handler = g_interrupt_handlers[frame->vector & 0xFF];
+    if (handler) {
+        handler(frame);
+        return;
+    }
+
+    if (frame->vector < IRQ_BASE_VECTOR) {
+        handle_unhandled_exception(frame);
+    }
+
+    // Stray external interrupts without a handler are ignored
+}
+
+#endif // ARCH_X86_64
@@ -0,0 +1,193 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/idt/idt.h>
+#include <arch/x86/irq/irq.h>
+#include <arch/x86/percpu/percpu.h>
+#include <arch/x86/pic/pic.h>
+#include <arch/x86/smp/ipi.h>
+#include <arch/x86/smp/smp.h>
+#include <iris/iris.h>
+#include <sync/spinlock.h>
+
+namespace arch::x86 {
+// MSI address of the local APICs, destination APIC ID in bits 12-19
+inline constexpr uint64_t MSI_ADDRESS_BASE = 0xFEE00000;
+inline constexpr uint32_t MSI_ADDRESS_DESTINATION_SHIFT = 12;
+inline constexpr uint32_t MSI_MAX_DESTINATION = 0xFF;
+
+struct vector_slot {
+    irq_handler_t handler; // nullptr while the vector is free
+    void* context;
+    const char* name;
+};
+
+// Read by the owning CPU in interrupt context, written under g_vector_lock
+struct alignas(64) vector_table {
+    vector_slot slots[DEVICE_VECTOR_COUNT];
+};
+
+// Written only by the owning CPU, read by flush_interrupt_stats()
+struct alignas(64) interrupt_counts {
+    uint64_t counts[IDT_ENTRIES];
+};
+
+static vector_table g_vector_tables[MAX_CPUS];
+static sync::spinlock g_vector_lock;
+
+static interrupt_counts g_interrupt_counts[MAX_CPUS];
+static interrupt_counts g_reported_counts[MAX_CPUS];
+static uint64_t g_last_stats_report = 0;
+
+static void device_interrupt(interrupt_frame* frame) {
+    auto vector = static_cast<uint8_t>(frame->vector);
+    const vector_slot* slot =
+        &g_vector_tables[current_cpu()].slots[vector - DEVICE_VECTOR_FIRST];
+
+    // A vector freed while its interrupt was in flight is only acknowledged
+    irq_handler_t handler = __atomic_load_n(&slot->handler, __ATOMIC_ACQUIRE);
+    if (handler) {
+        handler(slot->context);
+    }
+
+    lapic_send_eoi();
+}
+
+void init_irq() {
+    for (size_t vector = DEVICE_VECTOR_FIRST; vector <= DEVICE_VECTOR_LAST; ++vector) {
+        register_interrupt_handler(static_cast<uint8_t>(vector), device_interrupt);
+    }
+}
+
+bool allocate_irq_vector(int cpu, irq_handler_t handler, void* context, const char* name,
+                         irq_vector* out) {
+    if (cpu < 0 || cpu >= MAX_CPUS || !handler) {
+        return false;
+    }
+
+    sync::spinlock_guard guard(g_vector_lock);
+
+    vector_table* table = &g_vector_tables[cpu];
+    for (size_t i = 0; i < DEVICE_VECTOR_COUNT; ++i) {
+        vector_slot* slot = &table->slots[i];
+        if (slot->handler) {
+            continue;
+        }
+
+        slot->context = context;
+        slot->name = name;
+        __atomic_store_n(&slot->handler, handler, __ATOMIC_RELEASE);
+
+        *out = {.cpu = cpu, .vector = static_cast<uint8_t>(DEVICE_VECTOR_FIRST + i)};
+        return true;
+    }
+
+    return false;
+}
+
+void free_irq_vector(irq_vector vector) {
+    if (vector.cpu < 0 || vector.cpu >= MAX_CPUS || vector.vector < DEVICE_VECTOR_FIRST ||
+        vector.vector > DEVICE_VECTOR_LAST) {
+        return;
+    }
+
+    sync::spinlock_guard guard(g_vector_lock);
+    vector_slot* slot = &g_vector_tables[vector.cpu].slots[vector.vector - DEVICE_VECTOR_FIRST];
+    __atomic_store_n(&slot->handler, nullptr, __ATOMIC_RELEASE);
+}
+
+uint32_t irq_destination(int cpu) {
+    // The BSP's entry is only filled in when the APs are started
+    return cpu == current_cpu() ? lapic_id() : cpu_apic_id(cpu);
+}
+
+bool compose_msi_message(irq_vector vector, msi_message* out) {
+    uint32_t destination = irq_destination(vector.cpu);
+    if (destination > MSI_MAX_DESTINATION) {
+        return false;
+    }
+
+    // Fixed delivery, edge triggered, physical destination mode
+    *out = {.address = MSI_ADDRESS_BASE | (destination << MSI_ADDRESS_DESTINATION_SHIFT),
+            .data = vector.vector};
+    return true;
+}
+
+void count_interrupt(uint8_t vector) {
+    uint64_t* count = &g_interrupt_counts[current_cpu()].counts[vector];
+    __atomic_store_n(count, *count + 1, __ATOMIC_RELAXED);
+}
+
+static const char* vector_name(int cpu, uint8_t vector) {
+    if (vector >= DEVICE_VECTOR_FIRST && vector <= DEVICE_VECTOR_LAST) {
+        const char* name = g_vector_tables[cpu].slots[vector - DEVICE_VECTOR_FIRST].name;
+        return name ? name : "";
+    }
+
+    switch (vector) {
+    case LAPIC_TIMER_VECTOR:
+        return "lapic-timer";
+    case CALL_FUNCTION_VECTOR:
+        return "call-function";
+    case LAPIC_ERROR_VECTOR:
+        return "lapic-error";
+    case LAPIC_SPURIOUS_VECTOR:
+        return "spurious";
+    default:
+        break;
+    }
+
+    if (vector >= PIC1_VECTOR_OFFSET && vector < PIC2_VECTOR_OFFSET + 8) {
+        return "legacy-pic";
+    }
+    return "";
+}
+
+void flush_interrupt_stats() {
+    uint64_t frequency = tsc_frequency();
+    if (frequency == 0) {
+        return;
+    }
+
+    uint64_t now = rdtsc();
+    uint64_t window = now - g_last_stats_report;
+    if (window < frequency / 1000 * INTERRUPT_STATS_INTERVAL_MS) {
+        return;
+    }
+
+    // The first call only takes the baseline
+    bool report = g_last_stats_report != 0;
+    g_last_stats_report = now;
+
+    for (int cpu = 0; cpu < online_cpu_count(); ++cpu) {
+        for (size_t vector = IRQ_BASE_VECTOR; vector < IDT_ENTRIES; ++vector) {
+            uint64_t count =
+                __atomic_load_n(&g_interrupt_counts[cpu].counts[vector], __ATOMIC_RELAXED);
+            uint64_t* reported = &g_reported_counts[cpu].counts[vector];
+            if (count == *reported) {
+                continue;
+            }
+
+            if (report) {
+                interrupt_stats_payload payload = {};
+                payload.count = count;
+                payload.window_count = count - *reported;
+                payload.window_cycles = window;
+                payload.vector = static_cast<uint8_t>(vector);
+
+                const char* name = vector_name(cpu, static_cast<uint8_t>(vector));
+                for (size_t i = 0; i < IRQ_NAME_LENGTH && name[i]; ++i) {
+                    payload.name[i] = name[i];
+                }
+
+                iris::emit_with_payload(iris::EVENT_INTERRUPT_STATS, 0, static_cast<uint8_t>(cpu),
+                                        &payload, sizeof(payload));
+            }
+
+            *reported = count;
+        }
+    }
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
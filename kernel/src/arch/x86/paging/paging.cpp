@@ -0,0 +1,403 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/paging/tlb.h>
+#include <memory/memory.h>
+#include <memory/pmm.h>
+
+// Kernel PML4 filled by boot.S, linked at its physical address
+EXTERN_C uint64_t pml4_table[];
+
+namespace arch::x86 {
+// Number of page table pages reserved for mappings created before a physical allocator exists
+inline constexpr size_t EARLY_PAGE_TABLE_POOL_SIZE = 16;
+
+alignas(PAGE_SIZE) static uint8_t g_early_page_table_pool[EARLY_PAGE_TABLE_POOL_SIZE][PAGE_SIZE];
+static size_t g_early_page_tables_used = 0;
+
+static uint64_t* allocate_early_page_table() {
+    if (g_early_page_tables_used >= EARLY_PAGE_TABLE_POOL_SIZE) {
+        return nullptr;
+    }
+
+    auto* table = reinterpret_cast<uint64_t*>(g_early_page_table_pool[g_early_page_tables_used++]);
+    memory::memzero(table, PAGE_SIZE);
+    return table;
+}
+
+// Replaces the 2MB page in pd[index] with a page table mapping the same range in 4KB pages
+static uint64_t* split_large_page(uint64_t* pd, size_t index) {
+    uint64_t entry = pd[index];
+
+    uint64_t* pt = allocate_early_page_table();
+    if (!pt) {
+        return nullptr;
+    }
+
+    // Bit 7 means PAT in a 4KB entry, every other attribute carries over unchanged
+    uint64_t base = entry & PTE_LARGE_ADDRESS_MASK;
+    uint64_t flags = entry & ~(PTE_LARGE_ADDRESS_MASK | PTE_HUGE);
+
+    for (size_t i = 0; i < PAGE_TABLE_ENTRIES; ++i) {
+        pt[i] = (base + i * PAGE_SIZE) | flags;
+    }
+
+    // The PD may be shared between several mappings (see boot.S), invalidate them all
+    pd[index] = virt_to_phys(pt) | PTE_PRESENT | PTE_WRITABLE | (entry & PTE_USER);
+    write_cr3(read_cr3());
+
+    return pt;
+}
+
+// Returns the next level table referenced by table[index], creating it if needed
+static uint64_t* get_or_create_next_table(uint64_t* table, size_t index, bool is_pd,
+                                          uint64_t user) {
+    uint64_t entry = table[index];
+
+    if (entry & PTE_PRESENT) {
+        if (entry & PTE_HUGE) {
+            // 2MB pages are split, 1GB pages are never created by the kernel
+            return is_pd ? split_large_page(table, index) : nullptr;
+        }
+
+        // Access is the intersection of every level, the final entry still decides
+        table[index] = entry | user;
+
+        return static_cast<uint64_t*>(phys_to_virt(entry & PTE_ADDRESS_MASK));
+    }
+
+    uint64_t* next = allocate_early_page_table();
+    if (!next) {
+        return nullptr;
+    }
+
+    table[index] = virt_to_phys(next) | PTE_PRESENT | PTE_WRITABLE | user;
+    return next;
+}
+
+bool map_page(uint64_t virt, uint64_t phys, uint64_t flags) {
+    auto* pml4 = static_cast<uint64_t*>(phys_to_virt(read_cr3() & PTE_ADDRESS_MASK));
+    uint64_t user = flags & PTE_USER;
+
+    uint64_t* pdpt = get_or_create_next_table(pml4, (virt >> 39) & 0x1FF, false, user);
+    if (!pdpt) {
+        return false;
+    }
+
+    uint64_t* pd = get_or_create_next_table(pdpt, (virt >> 30) & 0x1FF, false, user);
+    if (!pd) {
+        return false;
+    }
+
+    uint64_t* pt = get_or_create_next_table(pd, (virt >> 21) & 0x1FF, true, user);
+    if (!pt) {
+        return false;
+    }
+
+    pt[(virt >> 12) & 0x1FF] = (phys & PTE_ADDRESS_MASK) | flags;
+    invlpg(virt);
+
+    return true;
+}
+
+void* map_mmio(uint64_t phys, size_t size) {
+    uint64_t start = phys & ~(PAGE_SIZE - 1);
+    uint64_t end = (phys + size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+
+    for (uint64_t page = start; page < end; page += PAGE_SIZE) {
+        if (!map_page(page, page, PTE_MMIO_FLAGS)) {
+            return nullptr;
+        }
+    }
+
+    return reinterpret_cast<void*>(phys);
+}
+
+// Maps one 2MB page, falls back to 4KB pages if the range already has a page table
+static bool map_large_mmio_page(uint64_t phys) {
+    auto* pml4 = static_cast<uint64_t*>(phys_to_virt(read_cr3() & PTE_ADDRESS_MASK));
+
+    uint64_t* pdpt = get_or_create_next_table(pml4, (phys >> 39) & 0x1FF, false, 0);
+    if (!pdpt) {
+        return false;
+    }
+
+    uint64_t* pd = get_or_create_next_table(pdpt, (phys >> 30) & 0x1FF, false, 0);
+    if (!pd) {
+        return false;
+    }
+
+    uint64_t* entry = &pd[(phys >> 21) & 0x1FF];
+    if ((*entry & PTE_PRESENT) && !(*entry & PTE_HUGE)) {
+        return map_mmio(phys, LARGE_PAGE_SIZE) != nullptr;
+    }
+
+    *entry = (phys & PTE_LARGE_ADDRESS_MASK) | PTE_MMIO_FLAGS | PTE_HUGE;
+    invlpg(phys);
+    return true;
+}
+
+void* map_mmio_large(uint64_t phys, size_t size) {
+    uint64_t start = phys & ~(PAGE_SIZE - 1);
+    uint64_t end = (phys + size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+
+    for (uint64_t address = start; address < end;) {
+        uint64_t next = (address + LARGE_PAGE_SIZE) & ~(LARGE_PAGE_SIZE - 1);
+
+        if ((address & (LARGE_PAGE_SIZE - 1)) == 0 && next <= end) {
+            if (!map_large_mmio_page(address)) {
+                return nullptr;
+            }
+        } else {
+            uint64_t chunk_end = next < end ? next : end;
+            if (!map_mmio(address, chunk_end - address)) {
+                return nullptr;
+            }
+        }
+
+        address = next < end ? next : end;
+    }
+
+    return reinterpret_cast<void*>(phys);
+}
+
+// First and one-past-last PML4 entries covering USER_SPACE_START to USER_SPACE_END
+inline constexpr size_t USER_PML4_FIRST = (USER_SPACE_START >> 39) & 0x1FF;
+inline constexpr size_t USER_PML4_END = USER_SPACE_END >> 39;
+
+uint64_t kernel_address_space() {
+    return reinterpret_cast<uint64_t>(pml4_table);
+}
+
+static uint64_t* table_at(uint64_t phys) {
+    return static_cast<uint64_t*>(phys_to_virt(phys & PTE_ADDRESS_MASK));
+}
+
+uint64_t create_address_space() {
+    uint64_t id = allocate_address_space_id();
+    if (!id) {
+        return 0;
+    }
+
+    uint64_t phys = memory::pmm::allocate_frame();
+    if (!phys) {
+        release_address_space_id(id);
+        return 0;
+    }
+
+    uint64_t* pml4 = table_at(phys);
+    const uint64_t* kernel_pml4 = table_at(kernel_address_space());
+
+    for (size_t i = 0; i < PAGE_TABLE_ENTRIES; ++i) {
+        pml4[i] = (i >= USER_PML4_FIRST && i < USER_PML4_END) ? 0 : kernel_pml4[i];
+    }
+
+    return phys | id;
+}
+
+// Returns the table referenced by table[index], allocating a cleared one if needed
+static uint64_t* get_or_create_user_table(uint64_t* table, size_t index) {
+    uint64_t entry = table[index];
+    if (entry & PTE_PRESENT) {
+        return table_at(entry);
+    }
+
+    uint64_t phys = memory::pmm::allocate_frame();
+    if (!phys) {
+        return nullptr;
+    }
+
+    uint64_t* next = table_at(phys);
+    memory::memzero(next, PAGE_SIZE);
+
+    // The final entry decides the access rights
+    table[index] = phys | PTE_PRESENT | PTE_WRITABLE | PTE_USER;
+    return next;
+}
+
+bool map_user_page(uint64_t pml4, uint64_t virt, uint64_t phys, uint64_t flags) {
+    uint64_t* pdpt = get_or_create_user_table(table_at(pml4), (virt >> 39) & 0x1FF);
+    if (!pdpt) {
+        return false;
+    }
+
+    uint64_t* pd = get_or_create_user_table(pdpt, (virt >> 30) & 0x1FF);
+    if (!pd) {
+        return false;
+    }
+
+    uint64_t* pt = get_or_create_user_table(pd, (virt >> 21) & 0x1FF);
+    if (!pt) {
+        return false;
+    }
+
+    pt[(virt >> 12) & 0x1FF] = (phys & PTE_ADDRESS_MASK) | flags;
+
+    if ((read_cr3() & PTE_ADDRESS_MASK) == (pml4 & PTE_ADDRESS_MASK)) {
+        invlpg(virt);
+    }
+
+    return true;
+}
+
+// Returns the entry mapping virt, or null if a page table on the way is missing
+static uint64_t* find_user_entry(uint64_t pml4, uint64_t virt) {
+    uint64_t* table = table_at(pml4);
+
+    for (int shift = 39; shift > 12; shift -= 9) {
+        uint64_t entry = table[(virt >> shift) & 0x1FF];
+        if (!(entry & PTE_PRESENT)) {
+            return nullptr;
+        }
+        table = table_at(entry);
+    }
+
+    return &table[(virt >> 12) & 0x1FF];
+}
+
+// Shares every page of a parent page table with a new child page table
+static void clone_page_table(uint64_t* parent, uint64_t* child) {
+    for (size_t i = 0; i < PAGE_TABLE_ENTRIES; ++i) {
+        uint64_t entry = parent[i];
+        if (!(entry & PTE_PRESENT)) {
+            continue;
+        }
+
+        if (entry & PTE_WRITABLE) {
+            entry = (entry & ~PTE_WRITABLE) | PTE_COPY_ON_WRITE;
+            parent[i] = entry;
+        }
+
+        memory::pmm::share_frame(entry & PTE_ADDRESS_MASK);
+        child[i] = entry;
+    }
+}
+
+uint64_t clone_address_space(uint64_t pml4) {
+    uint64_t clone = create_address_space();
+    if (!clone) {
+        return 0;
+    }
+
+    uint64_t* parent_pml4 = table_at(pml4);
+    uint64_t* child_pml4 = table_at(clone);
+    bool complete = true;
+
+    for (size_t i = USER_PML4_FIRST; i < USER_PML4_END && complete; ++i) {
+        if (!(parent_pml4[i] & PTE_PRESENT)) {
+            continue;
+        }
+
+        uint64_t* parent_pdpt = table_at(parent_pml4[i]);
+        uint64_t* child_pdpt = get_or_create_user_table(child_pml4, i);
+        complete = child_pdpt != nullptr;
+
+        for (size_t j = 0; j < PAGE_TABLE_ENTRIES && complete; ++j) {
+            if (!(parent_pdpt[j] & PTE_PRESENT)) {
+                continue;
+            }
+
+            uint64_t* parent_pd = table_at(parent_pdpt[j]);
+            uint64_t* child_pd = get_or_create_user_table(child_pdpt, j);
+            complete = child_pd != nullptr;
+
+            for (size_t k = 0; k < PAGE_TABLE_ENTRIES && complete; ++k) {
+                if (!(parent_pd[k] & PTE_PRESENT)) {
+                    continue;
+                }
+
+                uint64_t* child_pt = get_or_create_user_table(child_pd, k);
+                complete = child_pt != nullptr;
+
+                if (complete) {
+                    clone_page_table(table_at(parent_pd[k]), child_pt);
+                }
+            }
+        }
+    }
+
+    // Entries may have lost PTE_WRITABLE even if the clone failed halfway, one shootdown
+    // covers them all
+    flush_tlb_all(pml4);
+
+    if (!complete) {
+        destroy_address_space(clone);
+        return 0;
+    }
+
+    return clone;
+}
+
+bool resolve_copy_on_write(uint64_t pml4, uint64_t virt) {
+    uint64_t* entry = find_user_entry(pml4, virt);
+    if (!entry || !(*entry & PTE_PRESENT) || !(*entry & PTE_COPY_ON_WRITE)) {
+        return false;
+    }
+
+    uint64_t frame = *entry & PTE_ADDRESS_MASK;
+    uint64_t flags = (*entry & ~(PTE_ADDRESS_MASK | PTE_COPY_ON_WRITE)) | PTE_WRITABLE;
+
+    // Every other sharer already copied or exited, nobody can add a reference meanwhile
+    if (memory::pmm::frame_reference_count(frame) == 1) {
+        *entry = frame | flags;
+        flush_tlb_page(pml4, virt);
+        return true;
+    }
+
+    uint64_t copy = memory::pmm::allocate_frame();
+    if (!copy) {
+        return false;
+    }
+
+    memory::memcpy(phys_to_virt(copy), phys_to_virt(frame), PAGE_SIZE);
+    *entry = copy | flags;
+    flush_tlb_page(pml4, virt);
+
+    memory::pmm::free_frame(frame);
+    return true;
+}
+
+void destroy_address_space(uint64_t pml4) {
+    // CPUs in lazy TLB mode may still have it loaded
+    release_address_space_id(pml4);
+
+    uint64_t* pml4_entries = table_at(pml4);
+
+    for (size_t i = USER_PML4_FIRST; i < USER_PML4_END; ++i) {
+        if (!(pml4_entries[i] & PTE_PRESENT)) {
+            continue;
+        }
+
+        uint64_t* pdpt = table_at(pml4_entries[i]);
+        for (size_t j = 0; j < PAGE_TABLE_ENTRIES; ++j) {
+            if (!(pdpt[j] & PTE_PRESENT)) {
+                continue;
+            }
+
+            uint64_t* pd = table_at(pdpt[j]);
+            for (size_t k = 0; k < PAGE_TABLE_ENTRIES; ++k) {
+                if (!(pd[k] & PTE_PRESENT)) {
+                    continue;
+                }
+
+                uint64_t* pt = table_at(pd[k]);
+                for (size_t l = 0; l < PAGE_TABLE_ENTRIES; ++l) {
+                    if (pt[l] & PTE_PRESENT) {
+                        memory::pmm::free_frame(pt[l] & PTE_ADDRESS_MASK);
+                    }
+                }
+
+                memory::pmm::free_frame(pd[k] & PTE_ADDRESS_MASK);
+            }
+
+            memory::pmm::free_frame(pdpt[j] & PTE_ADDRESS_MASK);
+        }
+
+        memory::pmm::free_frame(pml4_entries[i] & PTE_ADDRESS_MASK);
+    }
+
+    memory::pmm::free_frame(pml4 & PTE_ADDRESS_MASK);
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
@@ -0,0 +1,284 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/cpu/features.h>
+#include <arch/x86/cpu/static_key.h>
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/paging/tlb.h>
+#include <arch/x86/percpu/percpu.h>
+#include <arch/x86/smp/ipi.h>
+#include <sync/spinlock.h>
+
+namespace arch::x86 {
+inline constexpr uint64_t INVPCID_SINGLE_CONTEXT = 1;
+
+/*
+    Every change to an address space that needs a flush bumps its generation.
+    A CPU records the generation its TLB entries of each address space are
+    current with, so CPUs that are not running an address space get no IPI
+    and simply flush it the next time they load it.
+*/
+struct address_space_slot {
+    uint64_t active_cpus; // Bit n set while CPU n has the address space in CR3, lazily or not
+    uint64_t generation;  // Never reset, a reused ID must not match a CPU's old generation
+    bool used;
+};
+
+// Invalidation sent to every CPU running an address space
+struct tlb_request {
+    uint64_t id;
+    uint64_t generation; // Generation the address space reached with this change
+    const uint64_t* pages;
+    size_t count;
+    bool flush_all;
+    bool leave; // Switch to the kernel address space if this one is loaded
+};
+
+static address_space_slot g_address_spaces[MAX_ADDRESS_SPACES];
+static sync::spinlock g_address_space_lock;
+
+// Generation of each address space the TLB of each CPU is current with
+static uint64_t g_seen_generations[MAX_CPUS][MAX_ADDRESS_SPACES];
+
+// Decided once by init_tlb(0), every context switch and flush tests them
+static static_key g_pcid_enabled;
+static static_key g_invpcid_supported;
+static bool g_tlb_retention = true;
+
+DEFINE_PER_CPU(uint64_t, g_loaded_address_space);
+DEFINE_PER_CPU(bool, g_tlb_lazy);
+
+static uint64_t address_space_id(uint64_t cr3) {
+    return cr3 & ADDRESS_SPACE_ID_MASK;
+}
+
+// Without PCIDs bits 3 and 4 of CR3 are cache attributes, not ID bits
+static uint64_t hardware_cr3(uint64_t cr3) {
+    return static_branch_likely(g_pcid_enabled) ? cr3 : cr3 & PTE_ADDRESS_MASK;
+}
+
+static void invpcid(uint64_t type, uint64_t pcid, uint64_t address) {
+    struct {
+        uint64_t pcid;
+        uint64_t address;
+    } descriptor = {pcid, address};
+
+    asm volatile("invpcid %0, %1" : : "m"(descriptor), "r"(type) : "memory");
+}
+
+// Drops every TLB entry of the address space loaded on this CPU
+static void flush_loaded_address_space() {
+    uint64_t cr3 = this_cpu_read(&g_loaded_address_space);
+
+    if (static_branch_likely(g_invpcid_supported)) {
+        invpcid(INVPCID_SINGLE_CONTEXT, address_space_id(cr3), 0);
+    } else {
+        // Without CR3_NO_FLUSH only the entries of the loaded PCID are dropped
+        write_cr3(hardware_cr3(cr3));
+    }
+}
+
+// Called with interrupts disabled, on the sender itself or through smp_call_function
+static void apply_request(int cpu, const tlb_request* request) {
+    uint64_t loaded = this_cpu_read(&g_loaded_address_space);
+    if (address_space_id(loaded) != request->id) {
+        // Not loaded, the generation alone makes the next load flush
+        return;
+    }
+
+    if (request->leave) {
+        uint64_t kernel = kernel_address_space();
+        write_cr3(hardware_cr3(kernel) |
+                  (static_branch_likely(g_pcid_enabled) ? CR3_NO_FLUSH : 0));
+
+        this_cpu_write(&g_loaded_address_space, kernel);
+        this_cpu_write(&g_tlb_lazy, false);
+        __atomic_and_fetch(&g_address_spaces[request->id].active_cpus, ~(1ULL << cpu),
+                           __ATOMIC_SEQ_CST);
+        return;
+    }
+
+    uint64_t* seen = &g_seen_generations[cpu][request->id];
+    if (*seen >= request->generation) {
+        // A later full flush already covered this change
+        return;
+    }
+
+    // Single pages only if this is the one change the TLB is missing
+    if (!request->flush_all && *seen + 1 == request->generation) {
+        for (size_t i = 0; i < request->count; ++i) {
+            invlpg(request->pages[i]);
+        }
+        *seen = request->generation;
+        return;
+    }
+
+    uint64_t generation =
+        __atomic_load_n(&g_address_spaces[request->id].generation, __ATOMIC_ACQUIRE);
+    flush_loaded_address_space();
+    *seen = generation;
+}
+
+static void tlb_shootdown_call(void* arg) {
+    apply_request(current_cpu(), static_cast<const tlb_request*>(arg));
+}
+
+static void shootdown(uint64_t cr3, const uint64_t* pages, size_t count, bool flush_all,
+                      bool leave) {
+    uint64_t id = address_space_id(cr3);
+    if (id == 0) {
+        return;
+    }
+
+    uint64_t rflags = save_and_disable_interrupts();
+    int cpu = current_cpu();
+    address_space_slot* slot = &g_address_spaces[id];
+
+    tlb_request request = {.id = id,
+                           .generation = 0,
+                           .pages = pages,
+                           .count = count,
+                           .flush_all = flush_all || count > TLB_BATCH_MAX_PAGES,
+                           .leave = leave};
+
+    // Orders the page table writes before the generation and the target list
+    request.generation = __atomic_add_fetch(&slot->generation, 1, __ATOMIC_SEQ_CST);
+
+    apply_request(cpu, &request);
+
+    uint64_t targets = __atomic_load_n(&slot->active_cpus, __ATOMIC_SEQ_CST) & ~(1ULL << cpu);
+
+    // Lazy CPUs see the new generation before they run user code in it again
+    for (uint64_t rest = targets; rest != 0 && !leave; rest &= rest - 1) {
+        int target = __builtin_ctzll(rest);
+        if (__atomic_load_n(per_cpu_ptr(&g_tlb_lazy, target), __ATOMIC_SEQ_CST)) {
+            targets &= ~(1ULL << target);
+        }
+    }
+
+    // Requests queued on a CPU before it takes the interrupt share one IPI
+    if (targets != 0) {
+        smp_call_function(targets, tlb_shootdown_call, &request);
+    }
+
+    restore_interrupts(rflags);
+}
+
+void init_tlb(int cpu) {
+    // Before the APs start, no other CPU runs the sites being patched
+    if (cpu == 0) {
+        bool pcid = has_feature(cpu_feature::PCID);
+        set_static_key(&g_pcid_enabled, pcid);
+        set_static_key(&g_invpcid_supported, pcid && has_feature(cpu_feature::INVPCID));
+    }
+
+    // CR4.PCIDE can only be set while CR3 holds PCID 0, the kernel address space does
+    if (g_pcid_enabled.enabled) {
+        write_cr4(read_cr4() | CR4_PCIDE);
+    }
+
+    this_cpu_write(&g_loaded_address_space, kernel_address_space());
+    this_cpu_write(&g_tlb_lazy, false);
+}
+
+bool pcid_enabled() {
+    return g_pcid_enabled.enabled;
+}
+
+bool invpcid_supported() {
+    return g_invpcid_supported.enabled;
+}
+
+uint64_t allocate_address_space_id() {
+    sync::irq_spinlock_guard guard(g_address_space_lock);
+
+    for (uint64_t id = 1; id < MAX_ADDRESS_SPACES; ++id) {
+        if (!g_address_spaces[id].used) {
+            g_address_spaces[id].used = true;
+
+            // Entries a CPU still holds from the previous owner are flushed on the first load
+            __atomic_add_fetch(&g_address_spaces[id].generation, 1, __ATOMIC_SEQ_CST);
+            return id;
+        }
+    }
+
+    return 0;
+}
+
+void release_address_space_id(uint64_t cr3) {
+    shootdown(cr3, nullptr, 0, true, true);
+
+    sync::irq_spinlock_guard guard(g_address_space_lock);
+    g_address_spaces[address_space_id(cr3)].used = false;
+}
+
+void activate_address_space(uint64_t cr3) {
+    int cpu = current_cpu();
+    uint64_t loaded = this_cpu_read(&g_loaded_address_space);
+
+    if (cr3 == kernel_address_space()) {
+        // Lazy TLB mode, kernel mappings are the same in the address space still loaded
+        if (loaded != cr3) {
+            this_cpu_write(&g_tlb_lazy, true);
+        }
+        return;
+    }
+
+    // Pairs with the generation bump in shootdown(), one of the two sides sees the other
+    __atomic_store_n(this_cpu_ptr(&g_tlb_lazy), false, __ATOMIC_SEQ_CST);
+
+    uint64_t id = address_space_id(cr3);
+    address_space_slot* slot = &g_address_spaces[id];
+    uint64_t* seen = &g_seen_generations[cpu][id];
+
+    if (loaded == cr3) {
+        // Back from lazy mode, shootdowns meanwhile only moved the generation
+        uint64_t generation = __atomic_load_n(&slot->generation, __ATOMIC_SEQ_CST);
+        if (*seen != generation) {
+            flush_loaded_address_space();
+            *seen = generation;
+        }
+        return;
+    }
+
+    if (loaded != kernel_address_space()) {
+        __atomic_and_fetch(&g_address_spaces[address_space_id(loaded)].active_cpus,
+                           ~(1ULL << cpu), __ATOMIC_SEQ_CST);
+    }
+
+    __atomic_or_fetch(&slot->active_cpus, 1ULL << cpu, __ATOMIC_SEQ_CST);
+    uint64_t generation = __atomic_load_n(&slot->generation, __ATOMIC_SEQ_CST);
+
+    uint64_t value = hardware_cr3(cr3);
+    if (static_branch_likely(g_pcid_enabled) &&
+        __atomic_load_n(&g_tlb_retention, __ATOMIC_RELAXED) && *seen == generation) {
+        value |= CR3_NO_FLUSH;
+    }
+
+    write_cr3(value);
+    *seen = generation;
+    this_cpu_write(&g_loaded_address_space, cr3);
+}
+
+void flush_tlb_page(uint64_t cr3, uint64_t virt) {
+    shootdown(cr3, &virt, 1, false, false);
+}
+
+void flush_tlb_all(uint64_t cr3) {
+    shootdown(cr3, nullptr, 0, true, false);
+}
+
+void flush_tlb_batch(tlb_batch* batch) {
+    if (batch->count != 0 || batch->flush_all) {
+        shootdown(batch->cr3, batch->pages, batch->count, batch->flush_all, false);
+    }
+
+    batch->count = 0;
+    batch->flush_all = false;
+}
+
+void set_tlb_retention(bool enabled) {
+    __atomic_store_n(&g_tlb_retention, enabled, __ATOMIC_RELAXED);
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
@@ -0,0 +1,51 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/percpu/percpu.h>
+#include <memory/memory.h>
+
+namespace arch::x86 {
+DEFINE_PER_CPU(uint64_t, g_this_cpu_base);
+DEFINE_PER_CPU(int, g_this_cpu_id);
+
+bool g_per_cpu_online = false;
+
+alignas(64) static uint8_t g_per_cpu_areas[MAX_CPUS][PER_CPU_AREA_SIZE];
+
+uint64_t per_cpu_area_base(int cpu) {
+    return reinterpret_cast<uint64_t>(g_per_cpu_areas[cpu]);
+}
+
+bool init_per_cpu_area(int cpu) {
+    auto template_size = static_cast<size_t>(__per_cpu_end - __per_cpu_start);
+
+    if (cpu < 0 || cpu >= MAX_CPUS || template_size > PER_CPU_AREA_SIZE) {
+        return false;
+    }
+
+    uint8_t* area = g_per_cpu_areas[cpu];
+
+    // Every CPU starts out with the initial values from the .percpu template
+    memory::memzero(area, PER_CPU_AREA_SIZE);
+    memory::memcpy(area, __per_cpu_start, template_size);
+
+    // The self pointer and CPU ID are accessed through the area itself
+    *reinterpret_cast<uint64_t*>(area + per_cpu_offset(&g_this_cpu_base)) =
+        reinterpret_cast<uint64_t>(area);
+    *reinterpret_cast<int*>(area + per_cpu_offset(&g_this_cpu_id)) = cpu;
+
+    write_msr(IA32_GS_BASE_MSR, reinterpret_cast<uint64_t>(area));
+
+    return true;
+}
+
+bool init_bsp_per_cpu_area() {
+    if (!init_per_cpu_area(0)) {
+        return false;
+    }
+
+    __atomic_store_n(&g_per_cpu_online, true, __ATOMIC_RELEASE);
+    return true;
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
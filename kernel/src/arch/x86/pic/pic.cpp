@@ -0,0 +1,69 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/pic/pic.h>
+#include <ports/ports.h>
+
+namespace arch::x86 {
+// Initialization Command Words
+inline constexpr uint8_t ICW1_INIT = 0x10;
+inline constexpr uint8_t ICW1_ICW4 = 0x01;
+inline constexpr uint8_t ICW4_8086 = 0x01;
+
+// Operation Command Words
+inline constexpr uint8_t OCW2_EOI = 0x20;
+
+// Master line the slave controller is cascaded on
+inline constexpr uint8_t CASCADE_IRQ = 2;
+
+// Writing to an unused port gives the PIC time to settle between commands
+static void io_wait() {
+    outb(0x80, 0);
+}
+
+void disable_legacy_pic() {
+    // Start the initialization sequence in cascade mode
+    outb(PIC1_COMMAND_PORT, ICW1_INIT | ICW1_ICW4);
+    io_wait();
+    outb(PIC2_COMMAND_PORT, ICW1_INIT | ICW1_ICW4);
+    io_wait();
+
+    // Vector offsets
+    outb(PIC1_DATA_PORT, PIC1_VECTOR_OFFSET);
+    io_wait();
+    outb(PIC2_DATA_PORT, PIC2_VECTOR_OFFSET);
+    io_wait();
+
+    // Master has the slave on IRQ2, slave has cascade identity 2
+    outb(PIC1_DATA_PORT, 0x04);
+    io_wait();
+    outb(PIC2_DATA_PORT, 0x02);
+    io_wait();
+
+    outb(PIC1_DATA_PORT, ICW4_8086);
+    io_wait();
+    outb(PIC2_DATA_PORT, ICW4_8086);
+    io_wait();
+
+    // Mask every line on both controllers
+    outb(PIC1_DATA_PORT, 0xFF);
+    outb(PIC2_DATA_PORT, 0xFF);
+}
+
+void enable_legacy_irq(uint8_t irq) {
+    if (irq >= 8) {
+        outb(PIC2_DATA_PORT, inb(PIC2_DATA_PORT) & ~(1 << (irq - 8)));
+        irq = CASCADE_IRQ;
+    }
+
+    outb(PIC1_DATA_PORT, inb(PIC1_DATA_PORT) & ~(1 << irq));
+}
+
+void send_legacy_pic_eoi(uint8_t irq) {
+    if (irq >= 8) {
+        outb(PIC2_COMMAND_PORT, OCW2_EOI);
+    }
+
+    outb(PIC1_COMMAND_PORT, OCW2_EOI);
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
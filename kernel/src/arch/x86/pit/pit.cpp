@@ -0,0 +1,40 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/pit/pit.h>
+#include <ports/ports.h>
+
+namespace arch::x86 {
+inline constexpr uint16_t PIT_CHANNEL2_DATA_PORT = 0x42;
+inline constexpr uint16_t PIT_COMMAND_PORT = 0x43;
+inline constexpr uint16_t PIT_GATE_PORT = 0x61;
+
+inline constexpr uint8_t PIT_GATE_CHANNEL2 = 0x01;
+inline constexpr uint8_t PIT_SPEAKER_ENABLE = 0x02;
+inline constexpr uint8_t PIT_CHANNEL2_OUTPUT = 0x20;
+
+// Channel 2, lobyte/hibyte access, mode 0 (interrupt on terminal count), binary
+inline constexpr uint8_t PIT_CHANNEL2_ONESHOT = 0xB0;
+
+void pit_start_oneshot(uint32_t microseconds) {
+    uint64_t count = (static_cast<uint64_t>(PIT_FREQUENCY_HZ) * microseconds) / 1000000;
+    if (count > 0xFFFF) {
+        count = 0xFFFF;
+    }
+
+    // Stop the countdown and keep the speaker disconnected
+    uint8_t gate = inb(PIT_GATE_PORT) & ~(PIT_GATE_CHANNEL2 | PIT_SPEAKER_ENABLE);
+    outb(PIT_GATE_PORT, gate);
+
+    outb(PIT_COMMAND_PORT, PIT_CHANNEL2_ONESHOT);
+    outb(PIT_CHANNEL2_DATA_PORT, static_cast<uint8_t>(count & 0xFF));
+    outb(PIT_CHANNEL2_DATA_PORT, static_cast<uint8_t>((count >> 8) & 0xFF));
+
+    // A rising edge on the gate starts the countdown
+    outb(PIT_GATE_PORT, gate | PIT_GATE_CHANNEL2);
+}
+
+bool pit_oneshot_expired() {
+    return (inb(PIT_GATE_PORT) & PIT_CHANNEL2_OUTPUT) != 0;
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
@@ -0,0 +1,167 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/idt/idt.h>
+#include <arch/x86/percpu/percpu.h>
+#include <arch/x86/smp/ipi.h>
+#include <arch/x86/smp/smp.h>
+#include <containers/mpsc_queue.h>
+#include <containers/spsc_ring.h>
+#include <iris/iris.h>
+#include <memory/memory.h>
+
+namespace arch::x86 {
+// One smp_call_function() invocation, shared by its targets
+struct call_data {
+    ipi_function fn;
+    void* arg;
+    uint32_t pending; // Targets that have not returned yet
+};
+
+// Queue node of one target, lives on the caller's stack until the target acknowledged
+struct call_entry {
+    call_entry* next;
+    call_data* data;
+    uint64_t queued_tsc;
+};
+
+// Any CPU pushes, only the owning CPU takes the whole list at once
+struct alignas(64) call_queue {
+    containers::mpsc_queue<call_entry, &call_entry::next> calls;
+};
+
+// IPI event waiting to be emitted, both payloads have the same size
+struct ipi_event {
+    uint16_t type;
+    uint8_t payload[sizeof(ipi_send_payload)];
+};
+
+// Produced by the owning CPU with interrupts off, consumed by flush_ipi_events
+struct ipi_event_ring {
+    containers::spsc_ring<ipi_event, IPI_EVENT_BUFFER_SIZE> events;
+    uint64_t dropped;
+};
+
+static call_queue g_call_queues[MAX_CPUS];
+static ipi_event_ring g_ipi_events[MAX_CPUS];
+static bool g_ipi_event_tracing = true;
+
+static void record_event(int cpu, uint16_t type, const void* payload) {
+    if (!__atomic_load_n(&g_ipi_event_tracing, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    ipi_event_ring* ring = &g_ipi_events[cpu];
+
+    ipi_event event;
+    event.type = type;
+    memory::memcpy(event.payload, payload, sizeof(event.payload));
+
+    if (!ring->events.try_push(event)) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+    }
+}
+
+// Runs every call queued for this CPU, called with interrupts disabled
+static void run_queued_calls(int cpu) {
+    // Served in the order they were posted
+    call_entry* ordered = g_call_queues[cpu].calls.take_all();
+    if (!ordered) {
+        return;
+    }
+
+    uint64_t oldest_tsc = ordered->queued_tsc;
+    uint32_t calls = 0;
+
+    while (ordered) {
+        // Read before the acknowledgement, the caller may return and reuse its stack
+        call_entry* next = ordered->next;
+        call_data* data = ordered->data;
+
+        data->fn(data->arg);
+        __atomic_sub_fetch(&data->pending, 1, __ATOMIC_RELEASE);
+
+        ordered = next;
+        ++calls;
+    }
+
+    uint64_t now = rdtsc();
+    ipi_receive_payload payload = {
+        .tsc = now, .latency_cycles = now - oldest_tsc, .calls = calls, .reserved = 0};
+    record_event(cpu, iris::EVENT_IPI_RECEIVE, &payload);
+}
+
+static void call_function_handler(interrupt_frame* /* frame */) {
+    run_queued_calls(current_cpu());
+    lapic_send_eoi();
+}
+
+void init_ipi() {
+    register_interrupt_handler(CALL_FUNCTION_VECTOR, call_function_handler);
+}
+
+void smp_call_function(uint64_t cpu_mask, ipi_function fn, void* arg) {
+    uint64_t rflags = save_and_disable_interrupts();
+    int cpu = current_cpu();
+
+    int online = online_cpu_count();
+    uint64_t online_mask = online >= MAX_CPUS ? ~0ULL : (1ULL << online) - 1;
+    uint64_t targets = cpu_mask & online_mask & ~(1ULL << cpu);
+
+    call_data data = {.fn = fn, .arg = arg, .pending = 0};
+    call_entry entries[MAX_CPUS];
+
+    for (uint64_t rest = targets; rest != 0; rest &= rest - 1) {
+        ++data.pending;
+    }
+
+    uint64_t tsc = rdtsc();
+    uint32_t ipis_sent = 0;
+
+    for (uint64_t rest = targets; rest != 0; rest &= rest - 1) {
+        int target = __builtin_ctzll(rest);
+
+        entries[target] = {.next = nullptr, .data = &data, .queued_tsc = tsc};
+        // Only the first call queued on an idle queue needs an interrupt
+        if (g_call_queues[target].calls.push(&entries[target])) {
+            lapic_send_ipi(cpu_apic_id(target), CALL_FUNCTION_VECTOR | LAPIC_ICR_LEVEL_ASSERT);
+            ++ipis_sent;
+        }
+    }
+
+    if (targets != 0) {
+        ipi_send_payload payload = {
+            .tsc = tsc, .target_mask = targets, .ipis_sent = ipis_sent, .reserved = 0};
+        record_event(cpu, iris::EVENT_IPI_SEND, &payload);
+    }
+
+    if (cpu_mask & (1ULL << cpu)) {
+        fn(arg);
+    }
+
+    while (__atomic_load_n(&data.pending, __ATOMIC_ACQUIRE) != 0) {
+        // A target may be waiting for this CPU with interrupts disabled as well
+        run_queued_calls(cpu);
+        cpu_relax();
+    }
+
+    restore_interrupts(rflags);
+}
+
+void set_ipi_event_tracing(bool enabled) {
+    __atomic_store_n(&g_ipi_event_tracing, enabled, __ATOMIC_RELAXED);
+}
+
+void flush_ipi_events() {
+    for (int cpu = 0; cpu < online_cpu_count(); ++cpu) {
+        // Popped copies free their slot before the slow serial transmission
+        ipi_event entry;
+        while (g_ipi_events[cpu].events.try_pop(&entry)) {
+            iris::emit_with_payload(entry.type, 0, static_cast<uint8_t>(cpu), entry.payload,
+                                    sizeof(entry.payload));
+        }
+    }
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
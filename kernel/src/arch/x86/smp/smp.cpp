@@ -0,0 +1,246 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/cpu/features.h>
+#include <arch/x86/fpu/fpu.h>
+#include <arch/x86/gdt/gdt.h>
+#include <arch/x86/idt/idt.h>
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/paging/tlb.h>
+#include <arch/x86/percpu/percpu.h>
+#include <arch/x86/smp/smp.h>
+#include <arch/x86/syscall/syscall.h>
+#include <async/executor.h>
+#include <boot/boot_info.h>
+#include <memory/memory.h>
+#include <sched/sched.h>
+#include <sync/rcu.h>
+
+// Bounds of the real-mode entry code and its CR3 slot (ap_trampoline.S)
+EXTERN_C uint8_t ap_trampoline_start[];
+EXTERN_C uint8_t ap_trampoline_end[];
+EXTERN_C uint8_t ap_trampoline_cr3[];
+
+// Read by ap_trampoline.S, the next logical CPU ID to hand out and the stack of each CPU
+EXTERN_C uint32_t g_ap_next_cpu;
+EXTERN_C uint64_t g_ap_stack_tops[];
+
+uint32_t g_ap_next_cpu = 1;
+uint64_t g_ap_stack_tops[arch::x86::MAX_CPUS];
+
+namespace arch::x86 {
+// Time the APs get to claim a CPU ID after the last startup IPI
+inline constexpr uint64_t AP_CLAIM_WINDOW_US = 10000;
+
+// Time a claimed AP gets to finish its initialization
+inline constexpr uint64_t AP_ONLINE_TIMEOUT_US = 100000;
+
+// Bring-up state of an AP. Only the AP moves from BOOTING to READY, everything else is the BSP's
+enum class ap_state : uint32_t {
+    BOOTING = 0,
+    READY,    // Initialized, waiting to be admitted
+    ONLINE,   // Admitted, its ID is below online_cpu_count()
+    REJECTED, // Too late or behind a CPU that was, parked for good
+};
+
+// Work slot of one CPU, written by the poster and cleared by the AP
+struct alignas(64) cpu_work {
+    cpu_work_fn fn;
+    void* arg;
+    uint32_t busy;
+};
+
+alignas(16) static uint8_t g_ap_stacks[MAX_CPUS][AP_STACK_SIZE];
+static cpu_work g_cpu_work[MAX_CPUS];
+static uint32_t g_cpu_apic_ids[MAX_CPUS];
+static ap_state g_ap_states[MAX_CPUS];
+static int g_online_cpus = 1;
+
+static void delay_us(uint64_t microseconds) {
+    uint64_t start = rdtsc();
+    uint64_t cycles = tsc_frequency() / 1000000 * microseconds;
+
+    while (rdtsc() - start < cycles) {
+        cpu_relax();
+    }
+}
+
+[[noreturn]] static void park_cpu() {
+    while (true) {
+        disable_interrupts();
+        halt();
+    }
+}
+
+// Reports this AP ready and waits for the BSP's verdict, an AP that was too late never returns
+static void wait_for_admission(int cpu) {
+    ap_state booting = ap_state::BOOTING;
+    if (__atomic_compare_exchange_n(&g_ap_states[cpu], &booting, ap_state::READY, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&g_ap_states[cpu], __ATOMIC_ACQUIRE) == ap_state::READY) {
+            cpu_relax();
+        }
+    }
+
+    if (__atomic_load_n(&g_ap_states[cpu], __ATOMIC_ACQUIRE) != ap_state::ONLINE) {
+        park_cpu();
+    }
+}
+
+[[noreturn]] static void ap_idle_loop(int cpu) {
+    cpu_work* work = &g_cpu_work[cpu];
+
+    while (true) {
+        // Coroutines run with interrupts on, like the work functions below
+        async::run_ready();
+
+        // Checked with interrupts off so a wakeup between the check and HLT is not lost
+        disable_interrupts();
+
+        cpu_work_fn fn = __atomic_load_n(&work->fn, __ATOMIC_ACQUIRE);
+        if (!fn) {
+            sync::rcu_quiescent_state();
+
+            // Runs queued and stolen tasks, waits for work once there are none
+            sched::idle();
+            continue;
+        }
+
+        enable_interrupts();
+        fn(work->arg);
+
+        __atomic_store_n(&work->fn, nullptr, __ATOMIC_RELAXED);
+        __atomic_store_n(&work->busy, 0, __ATOMIC_RELEASE);
+    }
+}
+
+// Called from ap_trampoline.S on the AP's own stack
+EXTERN_C [[noreturn]] void ap_main(int cpu) {
+    // Tracepoints use GS-relative counters as soon as the BSP's area is online, so point GS at
+    // this CPU's area before running any instrumented code
+    write_msr(IA32_GS_BASE_MSR, per_cpu_area_base(cpu));
+    init_per_cpu_area(cpu);
+    init_cpu_features(cpu);
+
+    init_gdt(cpu, g_ap_stack_tops[cpu]);
+    load_idt();
+    init_fpu();
+    init_tlb(cpu);
+    enable_syscall_interface();
+
+    init_ap_lapic();
+    g_cpu_apic_ids[cpu] = lapic_id();
+
+    // Nothing else knows about this CPU until it is admitted, a parked one takes no work
+    wait_for_admission(cpu);
+
+    start_lapic_timer(LAPIC_TIMER_FREQUENCY_HZ);
+    sched::init_cpu(cpu);
+
+    ap_idle_loop(cpu);
+}
+
+// CPU IDs are handed out on arrival, so APs come online in ID order up to the first one that is
+// not ready. It and every AP after it are parked, which keeps the online IDs dense
+static int admit_application_processors(int expected) {
+    int online = 1;
+    for (int cpu = 1; cpu < MAX_CPUS; ++cpu) {
+        ap_state ready = ap_state::READY;
+        if (online == cpu && cpu < expected &&
+            __atomic_compare_exchange_n(&g_ap_states[cpu], &ready, ap_state::ONLINE, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            ++online;
+        } else {
+            // Also covers APs still booting and IDs claimed after the claim window
+            __atomic_store_n(&g_ap_states[cpu], ap_state::REJECTED, __ATOMIC_RELEASE);
+        }
+    }
+
+    __atomic_store_n(&g_online_cpus, online, __ATOMIC_RELEASE);
+    return online;
+}
+
+int start_application_processors() {
+    auto trampoline_size = static_cast<size_t>(ap_trampoline_end - ap_trampoline_start);
+    g_cpu_apic_ids[0] = lapic_id();
+
+    if (trampoline_size > PAGE_SIZE || !boot::is_free_memory(AP_TRAMPOLINE_BASE, PAGE_SIZE)) {
+        return online_cpu_count();
+    }
+
+    auto* trampoline = static_cast<uint8_t*>(phys_to_virt(AP_TRAMPOLINE_BASE));
+    memory::memcpy(trampoline, ap_trampoline_start, trampoline_size);
+
+    // The boot page tables live below 4GB, so CR3 fits the 32-bit slot
+    auto* cr3_slot = reinterpret_cast<uint32_t*>(trampoline + (ap_trampoline_cr3 - ap_trampoline_start));
+    *cr3_slot = static_cast<uint32_t>(read_cr3());
+
+    for (int cpu = 1; cpu < MAX_CPUS; ++cpu) {
+        g_ap_stack_tops[cpu] = reinterpret_cast<uint64_t>(g_ap_stacks[cpu]) + AP_STACK_SIZE;
+    }
+
+    // INIT-SIPI-SIPI to every other CPU, as in the MP specification
+    lapic_send_ipi(0, LAPIC_ICR_DELIVERY_INIT | LAPIC_ICR_LEVEL_ASSERT |
+                          LAPIC_ICR_DEST_ALL_EXCLUDING_SELF);
+    delay_us(10000);
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        lapic_send_ipi(0, LAPIC_ICR_DELIVERY_STARTUP | LAPIC_ICR_DEST_ALL_EXCLUDING_SELF |
+                              static_cast<uint32_t>(AP_TRAMPOLINE_BASE >> 12));
+        delay_us(200);
+    }
+
+    delay_us(AP_CLAIM_WINDOW_US);
+
+    // IDs past MAX_CPUS are parked by the trampoline and never come online
+    uint32_t claimed = __atomic_load_n(&g_ap_next_cpu, __ATOMIC_ACQUIRE);
+    int expected = claimed < MAX_CPUS ? static_cast<int>(claimed) : MAX_CPUS;
+
+    uint64_t waited = 0;
+    for (int cpu = 1; cpu < expected; ++cpu) {
+        while (__atomic_load_n(&g_ap_states[cpu], __ATOMIC_ACQUIRE) != ap_state::READY &&
+               waited < AP_ONLINE_TIMEOUT_US) {
+            delay_us(100);
+            waited += 100;
+        }
+    }
+
+    return admit_application_processors(expected);
+}
+
+int online_cpu_count() {
+    return __atomic_load_n(&g_online_cpus, __ATOMIC_ACQUIRE);
+}
+
+uint32_t cpu_apic_id(int cpu) {
+    return g_cpu_apic_ids[cpu];
+}
+
+bool run_on_cpu(int cpu, cpu_work_fn fn, void* arg) {
+    if (cpu <= 0 || cpu >= online_cpu_count()) {
+        return false;
+    }
+
+    cpu_work* work = &g_cpu_work[cpu];
+
+    uint32_t expected = 0;
+    if (!__atomic_compare_exchange_n(&work->busy, &expected, 1, false, __ATOMIC_ACQUIRE,
+                                     __ATOMIC_RELAXED)) {
+        return false;
+    }
+
+    work->arg = arg;
+    __atomic_store_n(&work->fn, fn, __ATOMIC_RELEASE);
+    sched::wake_idle_cpu(cpu);
+
+    return true;
+}
+
+void wait_for_cpu(int cpu) {
+    while (__atomic_load_n(&g_cpu_work[cpu].busy, __ATOMIC_ACQUIRE)) {
+        cpu_relax();
+    }
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
@@ -0,0 +1,34 @@
+#ifdef ARCH_X86_64
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/syscall/syscall.h>
+
+// Entry points (syscall.S)
+EXTERN_C void asm_syscall_entry();
+EXTERN_C [[noreturn]] void asm_enter_user_mode(uint64_t rip, uint64_t rsp, uint64_t arg);
+EXTERN_C [[noreturn]] void asm_return_to_user_mode(const arch::x86::syscall_frame* frame);
+
+namespace arch::x86 {
+void enable_syscall_interface() {
+    uint64_t star = (static_cast<uint64_t>(SYSRET_SELECTOR_BASE) << 48) |
+                    (static_cast<uint64_t>(KERNEL_CS) << 32);
+
+    write_msr(IA32_STAR_MSR, star);
+    write_msr(IA32_LSTAR_MSR, reinterpret_cast<uint64_t>(asm_syscall_entry));
+
+    // Cleared on entry, the entry enables interrupts again once it is on the kernel stack
+    write_msr(IA32_FMASK_MSR, RFLAGS_INTERRUPT_ENABLE | RFLAGS_TRAP | RFLAGS_DIRECTION |
+                                  RFLAGS_ALIGNMENT_CHECK);
+
+    write_msr(IA32_EFER_MSR, read_msr(IA32_EFER_MSR) | EFER_SYSCALL_ENABLE);
+}
+
+void enter_user_mode(uint64_t rip, uint64_t rsp, uint64_t arg) {
+    asm_enter_user_mode(rip, rsp, arg);
+}
+
+void return_to_user_mode(const syscall_frame* frame) {
+    asm_return_to_user_mode(frame);
+}
+} // namespace arch::x86
+
+#endif // ARCH_X86_64
@@ -0,0 +1,41 @@
+#include <arch/x86/percpu/percpu.h>
+#include <async/executor.h>
+#include <containers/mpsc_queue.h>
+#include <sched/sched.h>
+
+namespace async {
+
+// Interrupt handlers and other CPUs push, only the owning CPU takes the whole list at once
+struct alignas(64) ready_queue {
+    containers::mpsc_queue<ready_node, &ready_node::next> nodes;
+};
+
+static ready_queue g_ready_queues[arch::x86::MAX_CPUS];
+
+void schedule(ready_node* node, int cpu) {
+    g_ready_queues[cpu].nodes.push(node);
+
+    if (cpu != arch::x86::current_cpu()) {
+        sched::wake_idle_cpu(cpu);
+    }
+}
+
+void run_ready() {
+    ready_queue* queue = &g_ready_queues[arch::x86::current_cpu()];
+
+    // Resumed coroutines may make others ready, keep going until the queue stays empty
+    while (ready_node* node = queue->nodes.take_all()) {
+        while (node) {
+            // Read before resuming, the node lives in the coroutine frame or what it waits on
+            ready_node* next = node->next;
+            node->handle.resume();
+            node = next;
+        }
+    }
+}
+
+bool has_ready() {
+    return !g_ready_queues[arch::x86::current_cpu()].nodes.empty();
+}
+
+} // namespace async
@@ -0,0 +1,52 @@
+#include <async/frame_pool.h>
+#include <sync/spinlock.h>
+
+namespace async {
+
+union frame_block {
+    frame_block* next_free;
+    alignas(16) uint8_t bytes[FRAME_BLOCK_SIZE];
+};
+
+static frame_block g_frame_blocks[FRAME_POOL_BLOCKS];
+static frame_block* g_free_blocks;
+static size_t g_never_used = 0;
+static size_t g_frames_in_use = 0;
+static sync::spinlock g_frame_pool_lock;
+
+void* allocate_frame(size_t size) {
+    if (size > FRAME_BLOCK_SIZE) {
+        return nullptr;
+    }
+
+    sync::irq_spinlock_guard guard(g_frame_pool_lock);
+
+    frame_block* block = g_free_blocks;
+    if (block) {
+        g_free_blocks = block->next_free;
+    } else if (g_never_used < FRAME_POOL_BLOCKS) {
+        // Handed out in order first, so the pool needs no setup before the first coroutine
+        block = &g_frame_blocks[g_never_used++];
+    } else {
+        return nullptr;
+    }
+
+    ++g_frames_in_use;
+    return block;
+}
+
+void free_frame(void* frame) {
+    auto* block = static_cast<frame_block*>(frame);
+
+    sync::irq_spinlock_guard guard(g_frame_pool_lock);
+
+    block->next_free = g_free_blocks;
+    g_free_blocks = block;
+    --g_frames_in_use;
+}
+
+size_t frames_in_use() {
+    return __atomic_load_n(&g_frames_in_use, __ATOMIC_RELAXED);
+}
+
+} // namespace async
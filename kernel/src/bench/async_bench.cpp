@@ -0,0 +1,142 @@
+#include <arch/x86/cpu/cpu.h>
+#include <async/executor.h>
+#include <async/task.h>
+#include <bench/bench.h>
+#include <iris/iris.h>
+#include <iris/tracepoint.h>
+#include <serial/serial.h>
+
+namespace bench {
+
+// Packets per emit benchmark, together they fit the async packet queue
+inline constexpr size_t EMIT_BENCH_PACKETS = 32;
+
+// Round trips through the looped-back UART per benchmark
+inline constexpr size_t LOOPBACK_ROUNDS = 32;
+
+// Bytes per round trip, one transmit FIFO burst so the receive FIFO cannot overrun
+inline constexpr uint32_t LOOPBACK_BYTES = serial::TRANSMIT_FIFO_SIZE;
+
+inline constexpr auto LOOPBACK_PORT = static_cast<uint16_t>(serial::port_base::COM1);
+
+// MCR loopback bit, routes the transmitter into the receiver and disconnects the IRQ line
+inline constexpr uint8_t MODEM_CONTROL_LOOPBACK = 0x10;
+
+static char g_loopback_out[LOOPBACK_BYTES];
+static char g_loopback_in[LOOPBACK_BYTES];
+
+// Cycles the caller spends per packet, the payload is a traced scope as emitted on hot paths
+static void run_emit_benchmark(benchmark_id id) {
+    result res = {};
+
+    for (size_t i = 0; i < EMIT_BENCH_PACKETS; ++i) {
+        auto tracepoint = static_cast<uint16_t>(iris::tracepoint::IRIS_INIT);
+        iris::trace_scope_payload payload = {.start_tsc = timestamp(),
+                                             .cycles = 0,
+                                             .id = tracepoint,
+                                             .reserved1 = 0,
+                                             .reserved2 = 0};
+
+        uint64_t start = timestamp();
+        iris::emit_with_payload(iris::EVENT_TRACE_SCOPE, 0, 0, &payload, sizeof(payload));
+        record(&res, timestamp() - start, sizeof(iris::packet) + sizeof(payload));
+    }
+
+    report(id, res);
+}
+
+// Moves every byte the UART received into the receive ring, the IRQ is disconnected in loopback
+static void poll_loopback_port() {
+    serial::handle_interrupt(LOOPBACK_PORT);
+}
+
+// Byte-wise blocking writes, then polls until the burst came back
+static void loopback_blocking_round() {
+    serial::write_raw(LOOPBACK_PORT, g_loopback_out, LOOPBACK_BYTES);
+
+    uint32_t received = 0;
+    while (received < LOOPBACK_BYTES) {
+        poll_loopback_port();
+        received +=
+            serial::read(LOOPBACK_PORT, g_loopback_in + received, LOOPBACK_BYTES - received);
+    }
+}
+
+static async::task<void> loopback_async_round(bool* done) {
+    co_await serial::write_async(LOOPBACK_PORT, g_loopback_out, LOOPBACK_BYTES);
+
+    uint32_t received = 0;
+    while (received < LOOPBACK_BYTES) {
+        received += co_await serial::read_async(LOOPBACK_PORT, g_loopback_in + received,
+                                                LOOPBACK_BYTES - received);
+    }
+
+    __atomic_store_n(done, true, __ATOMIC_RELEASE);
+}
+
+// Stands in for the port's interrupt handler and the idle loop until the round finished
+static bool loopback_async_round_polled() {
+    bool done = false;
+    if (!async::spawn(loopback_async_round(&done))) {
+        return false;
+    }
+
+    while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+        poll_loopback_port();
+        async::run_ready();
+    }
+    return true;
+}
+
+static void run_loopback_benchmarks() {
+    result blocking = {};
+    result async_result = {};
+
+    for (uint32_t i = 0; i < LOOPBACK_BYTES; ++i) {
+        g_loopback_out[i] = static_cast<char>('A' + i);
+    }
+
+    bool interrupts_enabled = arch::x86::read_rflags() & arch::x86::RFLAGS_INTERRUPT_ENABLE;
+    arch::x86::disable_interrupts();
+
+    outb(serial::modem_command_port_offset(LOOPBACK_PORT),
+         static_cast<uint8_t>(serial::modem_control_flags::RTS_DSR) | MODEM_CONTROL_LOOPBACK);
+    poll_loopback_port();
+
+    for (size_t round = 0; round < LOOPBACK_ROUNDS; ++round) {
+        uint64_t start = timestamp();
+        loopback_blocking_round();
+        record(&blocking, timestamp() - start, LOOPBACK_BYTES);
+
+        start = timestamp();
+        if (!loopback_async_round_polled()) {
+            break;
+        }
+        record(&async_result, timestamp() - start, LOOPBACK_BYTES);
+    }
+
+    outb(serial::modem_command_port_offset(LOOPBACK_PORT),
+         static_cast<uint8_t>(serial::modem_control_flags::RTS_DSR) |
+             static_cast<uint8_t>(serial::modem_control_flags::OUT2));
+
+    if (interrupts_enabled) {
+        arch::x86::enable_interrupts();
+    }
+
+    report(benchmark_id::SERIAL_LOOPBACK_BLOCKING, blocking);
+    report(benchmark_id::SERIAL_LOOPBACK_ASYNC, async_result);
+}
+
+void run_async_benchmarks() {
+    run_emit_benchmark(benchmark_id::IRIS_EMIT_BLOCKING);
+
+    // Queued packets go out once the idle loop runs the transmitter, or on the switch back
+    if (iris::set_async_transmission(true)) {
+        run_emit_benchmark(benchmark_id::IRIS_EMIT_ASYNC);
+        iris::set_async_transmission(false);
+    }
+
+    run_loopback_benchmarks();
+}
+
+} // namespace bench
@@ -0,0 +1,155 @@
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/percpu/percpu.h>
+#include <arch/x86/smp/smp.h>
+#include <bench/bench.h>
+#include <iris/iris.h>
+
+namespace bench {
+
+void report(benchmark_id id, const result& res) {
+    result_payload payload = {.iterations = res.iterations,
+                              .total_cycles = res.total_cycles,
+                              .min_cycles = res.min_cycles,
+                              .max_cycles = res.max_cycles,
+                              .bytes = res.bytes,
+                              .tsc_frequency = arch::x86::tsc_frequency(),
+                              .id = static_cast<uint16_t>(id),
+                              .reserved1 = 0,
+                              .reserved2 = 0};
+
+    iris::emit_with_payload(iris::EVENT_BENCHMARK_RESULT, 0, 0, &payload, sizeof(payload));
+}
+
+// Posts `fn` to APs 1 to `helpers` and waits until each AP that got it counted itself in `ready`.
+// Returns how many were posted, only those ever run `fn` and need wait_for_helpers()
+static uint32_t post_helpers(void (*fn)(void*), void* arg, uint32_t helpers,
+                             const uint32_t* ready) {
+    uint32_t posted = 0;
+    while (posted < helpers && arch::x86::run_on_cpu(static_cast<int>(posted + 1), fn, arg)) {
+        ++posted;
+    }
+
+    while (__atomic_load_n(ready, __ATOMIC_ACQUIRE) < posted) {
+        arch::x86::cpu_relax();
+    }
+
+    return posted;
+}
+
+static void wait_for_helpers(uint32_t posted) {
+    for (uint32_t cpu = 1; cpu <= posted; ++cpu) {
+        arch::x86::wait_for_cpu(static_cast<int>(cpu));
+    }
+}
+
+// One run_on_cpus() call, shared by every participating CPU
+struct cpu_run {
+    cpu_body body;
+    void* context;
+    uint32_t ready;     // APs waiting for the start signal
+    uint32_t go;        // Start signal
+    uint32_t cancelled; // Set before the start signal if an AP could not be posted to
+    uint32_t done;      // APs that finished
+};
+
+static void cpu_run_participant(void* arg) {
+    auto* run = static_cast<cpu_run*>(arg);
+
+    __atomic_add_fetch(&run->ready, 1, __ATOMIC_ACQ_REL);
+    while (!__atomic_load_n(&run->go, __ATOMIC_ACQUIRE)) {
+        arch::x86::cpu_relax();
+    }
+
+    if (!__atomic_load_n(&run->cancelled, __ATOMIC_RELAXED)) {
+        run->body(run->context, static_cast<uint32_t>(arch::x86::current_cpu()));
+    }
+
+    __atomic_add_fetch(&run->done, 1, __ATOMIC_RELEASE);
+}
+
+bool run_on_cpus(cpu_body body, void* context, uint32_t cpus, uint64_t* cycles) {
+    cpu_run run = {
+        .body = body, .context = context, .ready = 0, .go = 0, .cancelled = 0, .done = 0};
+
+    uint32_t posted = post_helpers(cpu_run_participant, &run, cpus - 1, &run.ready);
+    bool complete = posted + 1 >= cpus;
+
+    __atomic_store_n(&run.cancelled, complete ? 0U : 1U, __ATOMIC_RELAXED);
+    uint64_t start = timestamp();
+    __atomic_store_n(&run.go, 1, __ATOMIC_RELEASE);
+
+    if (complete) {
+        body(context, 0);
+    }
+
+    while (__atomic_load_n(&run.done, __ATOMIC_ACQUIRE) < posted) {
+        arch::x86::cpu_relax();
+    }
+    *cycles = timestamp() - start;
+
+    wait_for_helpers(posted);
+    return complete;
+}
+
+// One run_with_helpers() call, shared by the BSP and its helpers
+struct helper_run {
+    cpu_body enter;
+    cpu_body leave;
+    void* context;
+    uint32_t ready; // Helpers done with `enter`
+    uint32_t stop;  // Set once the BSP is done
+};
+
+static void helper_participant(void* arg) {
+    auto* run = static_cast<helper_run*>(arg);
+    auto cpu = static_cast<uint32_t>(arch::x86::current_cpu());
+
+    if (run->enter) {
+        run->enter(run->context, cpu);
+    }
+
+    __atomic_add_fetch(&run->ready, 1, __ATOMIC_ACQ_REL);
+    while (!__atomic_load_n(&run->stop, __ATOMIC_ACQUIRE)) {
+        arch::x86::cpu_relax();
+    }
+
+    if (run->leave) {
+        run->leave(run->context, cpu);
+    }
+}
+
+bool run_with_helpers(cpu_body body, void* context, uint32_t helpers, cpu_body enter,
+                      cpu_body leave) {
+    helper_run run = {.enter = enter, .leave = leave, .context = context, .ready = 0, .stop = 0};
+
+    uint32_t posted = post_helpers(helper_participant, &run, helpers, &run.ready);
+    bool complete = posted == helpers;
+
+    if (complete) {
+        body(context, 0);
+    }
+
+    __atomic_store_n(&run.stop, 1, __ATOMIC_RELEASE);
+    wait_for_helpers(posted);
+    return complete;
+}
+
+void run_all() {
+    run_initramfs_benchmarks();
+    run_port_io_benchmarks();
+    run_lock_benchmarks();
+    run_sched_benchmarks();
+    run_syscall_benchmarks();
+    run_proc_benchmarks();
+    run_tlb_benchmarks();
+    run_ipi_benchmarks();
+    run_rcu_benchmarks();
+    run_container_benchmarks();
+    run_async_benchmarks();
+    run_irq_benchmarks();
+    run_block_benchmarks();
+    run_buffer_cache_benchmarks();
+    run_net_benchmarks();
+}
+
+} // namespace bench
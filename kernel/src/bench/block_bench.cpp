@@ -0,0 +1,158 @@
+#include <arch/x86/cpu/cpu.h>
+#include <bench/bench.h>
+#include <block/block.h>
+#include <memory/pmm.h>
+#include <virtio/blk.h>
+
+namespace bench {
+
+// Completions measured per queue depth, after the queue was filled once
+inline constexpr size_t BLOCK_BENCH_REQUESTS = 4096;
+
+inline constexpr uint32_t BLOCK_BENCH_TRANSFER = 4096;
+inline constexpr uint32_t BLOCK_BENCH_SECTORS = BLOCK_BENCH_TRANSFER / block::SECTOR_SIZE;
+
+// Queue depths 1, 2, 4 ... 128
+inline constexpr size_t BLOCK_BENCH_DEPTHS = 8;
+inline constexpr size_t BLOCK_BENCH_MAX_DEPTH = 1 << (BLOCK_BENCH_DEPTHS - 1);
+
+static block::request g_block_requests[BLOCK_BENCH_MAX_DEPTH];
+static uint64_t g_block_buffers[BLOCK_BENCH_MAX_DEPTH];
+
+struct block_target {
+    uint64_t transfers; // BLOCK_BENCH_TRANSFER units on the device
+    uint64_t next;      // Next sequential transfer
+    uint64_t random;    // xorshift state
+    bool sequential;
+};
+
+static uint64_t next_sector(block_target* target) {
+    uint64_t index;
+    if (target->sequential) {
+        index = target->next;
+        target->next = (target->next + 1) % target->transfers;
+    } else {
+        target->random ^= target->random << 13;
+        target->random ^= target->random >> 7;
+        target->random ^= target->random << 17;
+        index = target->random % target->transfers;
+    }
+    return index * BLOCK_BENCH_SECTORS;
+}
+
+// Submits until the device took every request, a full queue drains through completions
+static void submit_all(block::device* dev, block::request** batch, size_t count) {
+    size_t done = 0;
+    while (done < count) {
+        done += block::submit(dev, batch + done, count - done);
+        if (done < count) {
+            block::poll(dev);
+            arch::x86::cpu_relax();
+        }
+    }
+}
+
+// Keeps `depth` reads in flight, every completion is recorded with the cycles since the
+// previous one, so total cycles are wall time and bytes over them is throughput
+static result run_block_depth(block::device* dev, size_t depth, bool sequential) {
+    result res = {};
+    block_target target = {.transfers = dev->sector_count / BLOCK_BENCH_SECTORS,
+                           .next = 0,
+                           .random = 0x9E3779B97F4A7C15ULL,
+                           .sequential = sequential};
+    bool in_flight[BLOCK_BENCH_MAX_DEPTH] = {};
+    block::request* batch[BLOCK_BENCH_MAX_DEPTH];
+
+    for (size_t i = 0; i < depth; ++i) {
+        g_block_requests[i] = {.op = block::operation::READ,
+                               .sector = next_sector(&target),
+                               .sector_count = BLOCK_BENCH_SECTORS,
+                               .buffer = g_block_buffers[i],
+                               .done = nullptr,
+                               .context = nullptr,
+                               .status = 0,
+                               .completed = 0,
+                               .next = nullptr};
+        batch[i] = &g_block_requests[i];
+        in_flight[i] = true;
+    }
+
+    size_t issued = depth;
+    size_t completed = 0;
+    bool failed = false;
+    uint64_t last = timestamp();
+    submit_all(dev, batch, depth);
+
+    while (completed < issued) {
+        if (dev->polled) {
+            block::poll(dev);
+        }
+
+        size_t ready = 0;
+        for (size_t i = 0; i < depth; ++i) {
+            block::request* req = &g_block_requests[i];
+            if (!in_flight[i] || !block::is_complete(req)) {
+                continue;
+            }
+
+            uint64_t now = timestamp();
+            record(&res, now - last, BLOCK_BENCH_TRANSFER);
+            last = now;
+            ++completed;
+
+            // After an error the requests in flight are drained but none are issued
+            failed = failed || req->status != block::STATUS_OK;
+            if (!failed && issued < BLOCK_BENCH_REQUESTS) {
+                req->sector = next_sector(&target);
+                batch[ready++] = req;
+                ++issued;
+            } else {
+                in_flight[i] = false;
+            }
+        }
+
+        if (ready > 0) {
+            submit_all(dev, batch, ready);
+        } else {
+            arch::x86::cpu_relax();
+        }
+    }
+    return failed ? result{} : res;
+}
+
+void run_block_benchmarks() {
+    block::device* dev = block::get_device(0);
+    if (!dev || dev->block_size > BLOCK_BENCH_TRANSFER ||
+        dev->sector_count < BLOCK_BENCH_MAX_DEPTH * BLOCK_BENCH_SECTORS) {
+        return;
+    }
+
+    size_t buffers = 0;
+    for (; buffers < BLOCK_BENCH_MAX_DEPTH; ++buffers) {
+        g_block_buffers[buffers] = memory::pmm::allocate_frame();
+        if (!g_block_buffers[buffers]) {
+            break;
+        }
+    }
+
+    if (buffers == BLOCK_BENCH_MAX_DEPTH) {
+        for (size_t i = 0; i < BLOCK_BENCH_DEPTHS; ++i) {
+            auto id = static_cast<uint16_t>(benchmark_id::BLOCK_RANDOM_READ_QD1) + i;
+            report(static_cast<benchmark_id>(id), run_block_depth(dev, 1U << i, false));
+        }
+
+        // Adjacent reads submitted together are merged into one device command
+        for (size_t i = 0; i < BLOCK_BENCH_DEPTHS; ++i) {
+            auto id = static_cast<uint16_t>(benchmark_id::BLOCK_SEQUENTIAL_READ_QD1) + i;
+            report(static_cast<benchmark_id>(id), run_block_depth(dev, 1U << i, true));
+        }
+
+        virtio::blk::emit_stats();
+    }
+
+    for (size_t i = 0; i < buffers; ++i) {
+        memory::pmm::free_frame(g_block_buffers[i]);
+    }
+}
+
+} // namespace bench
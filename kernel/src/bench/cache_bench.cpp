@@ -0,0 +1,111 @@
+#include <bench/bench.h>
+#include <block/cache.h>
+#include <memory/memory.h>
+
+namespace bench {
+
+// Blocks read in order from block 0, four times the cache so read-ahead runs against eviction
+inline constexpr uint64_t CACHE_BENCH_SEQUENTIAL_BLOCKS = 4 * block::cache::BUFFER_COUNT;
+
+// Random reads over the sequential range, about one in four hits
+inline constexpr size_t CACHE_BENCH_RANDOM_READS = 4096;
+
+// Random reads over a working set that stays cached
+inline constexpr uint64_t CACHE_BENCH_HOT_BLOCKS = block::cache::BUFFER_COUNT / 4;
+inline constexpr size_t CACHE_BENCH_HOT_READS = 16384;
+
+// Blocks dirtied and written back, placed after the read range
+inline constexpr uint64_t CACHE_BENCH_WRITE_FIRST = CACHE_BENCH_SEQUENTIAL_BLOCKS;
+inline constexpr uint64_t CACHE_BENCH_WRITE_BLOCKS = block::cache::BUFFER_COUNT / 2;
+
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+// Records one get() and release(), false if the read failed
+static bool read_block(result* res, block::device* dev, uint64_t index) {
+    uint64_t start = timestamp();
+    block::cache::buffer* buf = block::cache::get(dev, index);
+    if (!buf) {
+        return false;
+    }
+    block::cache::release(buf);
+    record(res, timestamp() - start, block::cache::BLOCK_SIZE);
+    return true;
+}
+
+static result run_sequential_read(block::device* dev) {
+    result res = {};
+    for (uint64_t i = 0; i < CACHE_BENCH_SEQUENTIAL_BLOCKS; ++i) {
+        if (!read_block(&res, dev, i)) {
+            return {};
+        }
+    }
+    return res;
+}
+
+static result run_random_read(block::device* dev, uint64_t blocks, size_t reads) {
+    result res = {};
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    for (size_t i = 0; i < reads; ++i) {
+        if (!read_block(&res, dev, next_random(&state) % blocks)) {
+            return {};
+        }
+    }
+    return res;
+}
+
+// Every block is dirtied, then written back with one sync_device(); the total is wall time
+static result run_write_back(block::device* dev) {
+    result res = {};
+
+    for (uint64_t i = 0; i < CACHE_BENCH_WRITE_BLOCKS; ++i) {
+        uint64_t start = timestamp();
+        block::cache::buffer* buf = block::cache::get(dev, CACHE_BENCH_WRITE_FIRST + i);
+        if (!buf) {
+            return {};
+        }
+        memory::memset(buf->data, static_cast<int>(i), block::cache::BLOCK_SIZE);
+        block::cache::mark_dirty(buf);
+        block::cache::release(buf);
+        record(&res, timestamp() - start, block::cache::BLOCK_SIZE);
+    }
+
+    uint64_t start = timestamp();
+    if (block::cache::sync_device(dev) != block::STATUS_OK) {
+        return {};
+    }
+    record(&res, timestamp() - start);
+    return res;
+}
+
+void run_buffer_cache_benchmarks() {
+    block::device* dev = block::get_device(0);
+    if (!dev || dev->sector_count / block::cache::SECTORS_PER_BLOCK <
+                    CACHE_BENCH_WRITE_FIRST + CACHE_BENCH_WRITE_BLOCKS) {
+        return;
+    }
+
+    // Cold, each refill of the read-ahead window is merged into a few device commands
+    report(benchmark_id::BUFFER_CACHE_SEQUENTIAL_READ, run_sequential_read(dev));
+
+    report(benchmark_id::BUFFER_CACHE_RANDOM_READ,
+           run_random_read(dev, CACHE_BENCH_SEQUENTIAL_BLOCKS, CACHE_BENCH_RANDOM_READS));
+
+    // Lookups without a lock once the first pass loaded the working set
+    run_random_read(dev, CACHE_BENCH_HOT_BLOCKS, CACHE_BENCH_HOT_READS);
+    report(benchmark_id::BUFFER_CACHE_HOT_READ,
+           run_random_read(dev, CACHE_BENCH_HOT_BLOCKS, CACHE_BENCH_HOT_READS));
+
+    if (!dev->read_only) {
+        report(benchmark_id::BUFFER_CACHE_WRITE_BACK, run_write_back(dev));
+    }
+
+    block::cache::emit_stats();
+}
+
+} // namespace bench
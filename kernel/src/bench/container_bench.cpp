@@ -0,0 +1,240 @@
+#include <arch/x86/smp/smp.h>
+#include <bench/bench.h>
+#include <containers/hash_map.h>
+#include <containers/intrusive_list.h>
+#include <containers/mpmc_queue.h>
+#include <containers/mpsc_queue.h>
+#include <containers/radix_tree.h>
+#include <containers/spsc_ring.h>
+
+namespace bench {
+
+// Largest number of CPUs sharing one of the concurrent queues
+inline constexpr uint32_t CONTAINER_BENCH_MAX_CPUS = 4;
+
+// Elements passed through a concurrent queue in one round
+inline constexpr uint32_t QUEUE_BENCH_ITEMS = 8192;
+
+// Rounds of the single-CPU and the concurrent benchmarks, each one recorded as a single iteration
+inline constexpr size_t CONTAINER_BENCH_ROUNDS = 8;
+
+inline constexpr size_t QUEUE_BENCH_CAPACITY = 256;
+
+// Entries of the map and tree benchmarks, the map is filled to half its capacity
+inline constexpr size_t MAP_BENCH_ENTRIES = 1024;
+
+// Enough for three levels over the keys from map_key()
+inline constexpr size_t RADIX_BENCH_NODES = 128;
+inline constexpr unsigned RADIX_BENCH_KEY_BITS = 16;
+
+struct bench_item {
+    containers::list_node<bench_item> link;
+    bench_item* next;
+    uint64_t value;
+};
+
+// Context of one concurrent run, shared by every participating CPU
+struct queue_run {
+    uint32_t cpus;
+    uint32_t consumed;
+};
+
+static containers::spsc_ring<uint64_t, QUEUE_BENCH_CAPACITY> g_spsc_ring;
+static containers::mpsc_queue<bench_item, &bench_item::next> g_mpsc_queue;
+static containers::mpmc_queue<uint64_t, QUEUE_BENCH_CAPACITY> g_mpmc_queue;
+
+static bench_item g_items[CONTAINER_BENCH_MAX_CPUS][QUEUE_BENCH_ITEMS];
+static containers::intrusive_list<bench_item, &bench_item::link> g_item_list;
+
+static containers::hash_map<uint64_t, uint64_t, MAP_BENCH_ENTRIES * 2> g_hash_map;
+static containers::radix_tree<bench_item, RADIX_BENCH_NODES, RADIX_BENCH_KEY_BITS> g_radix_tree;
+
+// Index 0 (the BSP) produces, index 1 consumes
+static void spsc_body(void* /* context */, uint32_t index) {
+    for (uint64_t i = 0; i < QUEUE_BENCH_ITEMS; ++i) {
+        if (index == 0) {
+            while (!g_spsc_ring.try_push(i)) {
+                arch::x86::cpu_relax();
+            }
+        } else {
+            uint64_t value;
+            while (!g_spsc_ring.try_pop(&value)) {
+                arch::x86::cpu_relax();
+            }
+        }
+    }
+}
+
+// Index 0 consumes in batches, every other index produces its own share of the items
+static void mpsc_body(void* context, uint32_t index) {
+    auto* run = static_cast<queue_run*>(context);
+    uint32_t producers = run->cpus - 1;
+    uint32_t share = QUEUE_BENCH_ITEMS / producers;
+
+    if (index != 0) {
+        for (uint32_t i = 0; i < share; ++i) {
+            g_mpsc_queue.push(&g_items[index][i]);
+        }
+        return;
+    }
+
+    for (uint32_t received = 0; received < share * producers;) {
+        for (bench_item* item = g_mpsc_queue.take_all(); item; item = item->next) {
+            ++received;
+        }
+    }
+}
+
+// The lower half of the indices produce, the upper half consume
+static void mpmc_body(void* context, uint32_t index) {
+    auto* run = static_cast<queue_run*>(context);
+    uint32_t producers = run->cpus / 2;
+    uint32_t share = QUEUE_BENCH_ITEMS / producers;
+    uint32_t total = share * producers;
+
+    if (index < producers) {
+        for (uint64_t i = 0; i < share; ++i) {
+            while (!g_mpmc_queue.try_push(i)) {
+                arch::x86::cpu_relax();
+            }
+        }
+        return;
+    }
+
+    while (__atomic_load_n(&run->consumed, __ATOMIC_RELAXED) < total) {
+        uint64_t value;
+        if (g_mpmc_queue.try_pop(&value)) {
+            __atomic_add_fetch(&run->consumed, 1, __ATOMIC_RELAXED);
+        } else {
+            arch::x86::cpu_relax();
+        }
+    }
+}
+
+// Records the average cycles per element passed through the queue in each round
+static void run_queue_benchmark(cpu_body body, uint32_t cpus, benchmark_id id) {
+    if (static_cast<uint32_t>(arch::x86::online_cpu_count()) < cpus) {
+        return;
+    }
+
+    result res = {};
+    for (size_t round = 0; round < CONTAINER_BENCH_ROUNDS; ++round) {
+        queue_run run = {.cpus = cpus, .consumed = 0};
+        uint64_t cycles;
+        if (!run_on_cpus(body, &run, cpus, &cycles)) {
+            return;
+        }
+        record(&res, cycles / QUEUE_BENCH_ITEMS);
+    }
+
+    report(id, res);
+}
+
+// One push_back and one pop_front per element
+static void run_list_benchmark() {
+    result res = {};
+
+    for (size_t round = 0; round < CONTAINER_BENCH_ROUNDS; ++round) {
+        uint64_t start = timestamp();
+        for (bench_item& item : g_items[0]) {
+            g_item_list.push_back(&item);
+        }
+        while (g_item_list.pop_front()) {
+        }
+        record(&res, (timestamp() - start) / QUEUE_BENCH_ITEMS);
+    }
+
+    report(benchmark_id::CONTAINER_INTRUSIVE_LIST, res);
+}
+
+// Keys spread like kernel object IDs, consecutive with gaps
+static uint64_t map_key(size_t i) {
+    return i * 7 + 3;
+}
+
+static void run_hash_map_benchmarks() {
+    result update = {};
+    result lookup = {};
+
+    for (size_t round = 0; round < CONTAINER_BENCH_ROUNDS; ++round) {
+        uint64_t start = timestamp();
+        for (size_t i = 0; i < MAP_BENCH_ENTRIES; ++i) {
+            g_hash_map.insert(map_key(i), i);
+        }
+        for (size_t i = 0; i < MAP_BENCH_ENTRIES; ++i) {
+            g_hash_map.erase(map_key(i));
+        }
+        record(&update, (timestamp() - start) / MAP_BENCH_ENTRIES);
+    }
+
+    for (size_t i = 0; i < MAP_BENCH_ENTRIES; ++i) {
+        g_hash_map.insert(map_key(i), i);
+    }
+
+    for (size_t round = 0; round < CONTAINER_BENCH_ROUNDS; ++round) {
+        uint64_t sum = 0;
+        uint64_t start = timestamp();
+        for (size_t i = 0; i < MAP_BENCH_ENTRIES; ++i) {
+            sum += *g_hash_map.find(map_key(i));
+        }
+        record(&lookup, (timestamp() - start) / MAP_BENCH_ENTRIES);
+
+        volatile uint64_t sink = sum;
+        (void)sink;
+    }
+
+    g_hash_map.clear();
+
+    report(benchmark_id::CONTAINER_HASH_MAP_INSERT_ERASE, update);
+    report(benchmark_id::CONTAINER_HASH_MAP_LOOKUP, lookup);
+}
+
+static void run_radix_tree_benchmarks() {
+    result update = {};
+    result lookup = {};
+
+    for (size_t round = 0; round < CONTAINER_BENCH_ROUNDS; ++round) {
+        uint64_t start = timestamp();
+        for (size_t i = 0; i < MAP_BENCH_ENTRIES; ++i) {
+            g_radix_tree.insert(map_key(i), &g_items[0][i]);
+        }
+        for (size_t i = 0; i < MAP_BENCH_ENTRIES; ++i) {
+            g_radix_tree.erase(map_key(i));
+        }
+        record(&update, (timestamp() - start) / MAP_BENCH_ENTRIES);
+    }
+
+    for (size_t i = 0; i < MAP_BENCH_ENTRIES; ++i) {
+        g_radix_tree.insert(map_key(i), &g_items[0][i]);
+    }
+
+    for (size_t round = 0; round < CONTAINER_BENCH_ROUNDS; ++round) {
+        uint64_t sum = 0;
+        uint64_t start = timestamp();
+        for (size_t i = 0; i < MAP_BENCH_ENTRIES; ++i) {
+            sum += g_radix_tree.find(map_key(i))->value;
+        }
+        record(&lookup, (timestamp() - start) / MAP_BENCH_ENTRIES);
+
+        volatile uint64_t sink = sum;
+        (void)sink;
+    }
+
+    for (size_t i = 0; i < MAP_BENCH_ENTRIES; ++i) {
+        g_radix_tree.erase(map_key(i));
+    }
+
+    report(benchmark_id::CONTAINER_RADIX_TREE_INSERT_ERASE, update);
+    report(benchmark_id::CONTAINER_RADIX_TREE_LOOKUP, lookup);
+}
+
+void run_container_benchmarks() {
+    run_list_benchmark();
+    run_queue_benchmark(spsc_body, 2, benchmark_id::CONTAINER_SPSC_RING);
+    run_queue_benchmark(mpsc_body, CONTAINER_BENCH_MAX_CPUS, benchmark_id::CONTAINER_MPSC_QUEUE);
+    run_queue_benchmark(mpmc_body, CONTAINER_BENCH_MAX_CPUS, benchmark_id::CONTAINER_MPMC_QUEUE);
+    run_hash_map_benchmarks();
+    run_radix_tree_benchmarks();
+}
+
+} // namespace bench
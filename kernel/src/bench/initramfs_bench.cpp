@@ -0,0 +1,71 @@
+#include <bench/bench.h>
+#include <fs/initramfs.h>
+
+namespace bench {
+
+// Number of passes over every file in the archive
+inline constexpr size_t INITRAMFS_ROUNDS = 64;
+
+// Size of each read call, a typical page-sized buffer
+inline constexpr size_t INITRAMFS_READ_CHUNK = 4096;
+
+// Path buffer large enough for a ustar prefix, separator, name and terminator
+inline constexpr size_t INITRAMFS_PATH_MAX = 155 + 1 + 100 + 1;
+
+static uint8_t g_read_buffer[INITRAMFS_READ_CHUNK];
+
+// Rebuilds the full path of an indexed file so lookups go through the public open()
+static void build_path(const fs::initramfs::file* node, char* path) {
+    size_t length = 0;
+
+    for (size_t i = 0; i < node->prefix_length; ++i) {
+        path[length++] = node->prefix[i];
+    }
+    if (node->prefix_length > 0) {
+        path[length++] = '/';
+    }
+    for (size_t i = 0; i < node->name_length; ++i) {
+        path[length++] = node->name[i];
+    }
+
+    path[length] = '\0';
+}
+
+void run_initramfs_benchmarks() {
+    size_t count = fs::initramfs::file_count();
+    if (count == 0) {
+        return;
+    }
+
+    result open_result = {};
+    result read_result = {};
+    char path[INITRAMFS_PATH_MAX];
+
+    for (size_t round = 0; round < INITRAMFS_ROUNDS; ++round) {
+        for (size_t i = 0; i < count; ++i) {
+            build_path(fs::initramfs::file_at(i), path);
+
+            fs::initramfs::file_handle handle;
+
+            uint64_t start = timestamp();
+            bool found = fs::initramfs::open(path, &handle);
+            record(&open_result, timestamp() - start);
+
+            if (!found) {
+                continue;
+            }
+
+            uint64_t bytes = 0;
+            start = timestamp();
+            while (size_t n = fs::initramfs::read(&handle, g_read_buffer, sizeof(g_read_buffer))) {
+                bytes += n;
+            }
+            record(&read_result, timestamp() - start, bytes);
+        }
+    }
+
+    report(benchmark_id::INITRAMFS_OPEN, open_result);
+    report(benchmark_id::INITRAMFS_READ, read_result);
+}
+
+} // namespace bench
@@ -0,0 +1,59 @@
+#include <arch/x86/smp/ipi.h>
+#include <arch/x86/smp/smp.h>
+#include <bench/bench.h>
+
+namespace bench {
+
+inline constexpr size_t IPI_ROUND_TRIP_ITERATIONS = 5000;
+
+// Largest number of APs called at once
+inline constexpr uint32_t IPI_BENCH_MAX_TARGETS = 3;
+
+struct ipi_run {
+    uint32_t targets;
+    result res;
+};
+
+static void empty_call(void* /* arg */) {}
+
+static void round_trip_body(void* context, uint32_t /* index */) {
+    auto* run = static_cast<ipi_run*>(context);
+    uint64_t mask = ((1ULL << run->targets) - 1) << 1;
+
+    for (size_t i = 0; i < IPI_ROUND_TRIP_ITERATIONS; ++i) {
+        uint64_t start = timestamp();
+        arch::x86::smp_call_function(mask, empty_call, nullptr);
+        record(&run->res, timestamp() - start);
+    }
+}
+
+// Calls an empty function on APs 1 to `targets` and waits for every one of them. The targets
+// spin with interrupts enabled so no wakeup from halt is measured, an empty result if one of
+// them could not be posted to
+static result run_round_trip(uint32_t targets) {
+    ipi_run run = {.targets = targets, .res = {}};
+    if (!run_with_helpers(round_trip_body, &run, targets, nullptr, nullptr)) {
+        return {};
+    }
+
+    return run.res;
+}
+
+void run_ipi_benchmarks() {
+    auto online = static_cast<uint32_t>(arch::x86::online_cpu_count());
+    uint32_t max_targets = online - 1 < IPI_BENCH_MAX_TARGETS ? online - 1 : IPI_BENCH_MAX_TARGETS;
+
+    // Thousands of events per run would flood the serial link
+    arch::x86::set_ipi_event_tracing(false);
+
+    for (uint32_t targets = 1; targets <= max_targets; ++targets) {
+        result res = run_round_trip(targets);
+        report(static_cast<benchmark_id>(
+                   static_cast<uint16_t>(benchmark_id::IPI_ROUND_TRIP_1CPU) + targets - 1),
+               res);
+    }
+
+    arch::x86::set_ipi_event_tracing(true);
+}
+
+} // namespace bench
@@ -0,0 +1,84 @@
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/irq/irq.h>
+#include <arch/x86/percpu/percpu.h>
+#include <arch/x86/smp/smp.h>
+#include <bench/bench.h>
+
+namespace bench {
+
+inline constexpr size_t IRQ_DISPATCH_ITERATIONS = 5000;
+
+// Completion flag set by the vector's handler
+struct irq_run {
+    uint32_t ready;
+    uint32_t stop;
+    uint32_t handled;
+};
+
+static void bench_irq_handler(void* context) {
+    auto* run = static_cast<irq_run*>(context);
+    __atomic_store_n(&run->handled, 1, __ATOMIC_RELEASE);
+}
+
+// Keeps the target spinning with interrupts enabled so no wakeup from idle is measured
+static void irq_participant(void* arg) {
+    auto* run = static_cast<irq_run*>(arg);
+
+    __atomic_store_n(&run->ready, 1, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&run->stop, __ATOMIC_ACQUIRE)) {
+        arch::x86::cpu_relax();
+    }
+}
+
+// Raises a device vector on `cpu` through the local APIC and waits until its handler ran
+static result run_dispatch(int cpu, irq_run* run) {
+    result res = {};
+
+    arch::x86::irq_vector vector;
+    if (!arch::x86::allocate_irq_vector(cpu, bench_irq_handler, run, "bench", &vector)) {
+        return res;
+    }
+
+    uint32_t destination = arch::x86::irq_destination(cpu);
+    for (size_t i = 0; i < IRQ_DISPATCH_ITERATIONS; ++i) {
+        __atomic_store_n(&run->handled, 0, __ATOMIC_RELAXED);
+
+        uint64_t start = timestamp();
+        arch::x86::lapic_send_ipi(destination, vector.vector);
+        while (!__atomic_load_n(&run->handled, __ATOMIC_ACQUIRE)) {
+            arch::x86::cpu_relax();
+        }
+        record(&res, timestamp() - start);
+    }
+
+    arch::x86::free_irq_vector(vector);
+    return res;
+}
+
+void run_irq_benchmarks() {
+    irq_run local = {.ready = 0, .stop = 0, .handled = 0};
+    report(benchmark_id::IRQ_DISPATCH_LOCAL, run_dispatch(arch::x86::current_cpu(), &local));
+
+    if (arch::x86::online_cpu_count() < 2) {
+        return;
+    }
+
+    irq_run remote = {.ready = 0, .stop = 0, .handled = 0};
+    if (!arch::x86::run_on_cpu(1, irq_participant, &remote)) {
+        return;
+    }
+
+    while (!__atomic_load_n(&remote.ready, __ATOMIC_ACQUIRE)) {
+        arch::x86::cpu_relax();
+    }
+
+    result res = run_dispatch(1, &remote);
+
+    __atomic_store_n(&remote.stop, 1, __ATOMIC_RELEASE);
+    arch::x86::wait_for_cpu(1);
+
+    report(benchmark_id::IRQ_DISPATCH_REMOTE, res);
+}
+
+} // namespace bench
@@ -0,0 +1,64 @@
+#include <arch/x86/smp/smp.h>
+#include <bench/bench.h>
+#include <sync/mcs_lock.h>
+#include <sync/spinlock.h>
+
+namespace bench {
+
+// Largest number of CPUs contending for the lock
+inline constexpr uint32_t LOCK_BENCH_MAX_CPUS = 4;
+
+// Lock acquisitions per CPU in one round
+inline constexpr uint32_t LOCK_BENCH_ACQUISITIONS = 20000;
+
+// Rounds per CPU count, each one recorded as a single iteration
+inline constexpr size_t LOCK_BENCH_ROUNDS = 8;
+
+static sync::spinlock g_bench_spinlock;
+static sync::mcs_lock g_bench_mcs_lock;
+
+// Data protected by the benchmark locks, on its own cache line like a real critical section
+alignas(64) static uint64_t g_bench_counter;
+
+static void spinlock_body(void* /* context */, uint32_t /* index */) {
+    for (uint32_t i = 0; i < LOCK_BENCH_ACQUISITIONS; ++i) {
+        sync::irq_spinlock_guard guard(g_bench_spinlock);
+        ++g_bench_counter;
+    }
+}
+
+static void mcs_lock_body(void* /* context */, uint32_t /* index */) {
+    for (uint32_t i = 0; i < LOCK_BENCH_ACQUISITIONS; ++i) {
+        sync::irq_mcs_guard guard(g_bench_mcs_lock);
+        ++g_bench_counter;
+    }
+}
+
+// Records the average cycles per acquisition of each round
+static void run_lock_benchmark(cpu_body body, benchmark_id first_id) {
+    auto online = static_cast<uint32_t>(arch::x86::online_cpu_count());
+
+    for (uint32_t cpus = 1; cpus <= LOCK_BENCH_MAX_CPUS && cpus <= online; ++cpus) {
+        result res = {};
+
+        for (size_t round = 0; round < LOCK_BENCH_ROUNDS; ++round) {
+            uint64_t cycles;
+            if (!run_on_cpus(body, nullptr, cpus, &cycles)) {
+                return;
+            }
+            record(&res, cycles / (static_cast<uint64_t>(cpus) * LOCK_BENCH_ACQUISITIONS));
+        }
+
+        report(static_cast<benchmark_id>(static_cast<uint16_t>(first_id) + cpus - 1), res);
+    }
+}
+
+void run_lock_benchmarks() {
+    run_lock_benchmark(spinlock_body, benchmark_id::SPINLOCK_1CPU);
+    run_lock_benchmark(mcs_lock_body, benchmark_id::MCS_LOCK_1CPU);
+
+    sync::emit_lock_stats("bench_spinlock", g_bench_spinlock.stats());
+    sync::emit_lock_stats("bench_mcs_lock", g_bench_mcs_lock.stats());
+}
+
+} // namespace bench
@@ -0,0 +1,196 @@
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/cpu/cpu.h>
+#include <bench/bench.h>
+#include <memory/memory.h>
+#include <net/net.h>
+#include <virtio/net.h>
+
+namespace bench {
+
+// IEEE 802 local experimental EtherType, nothing else on the link answers it
+inline constexpr uint16_t NET_BENCH_ETHERTYPE = 0x88B5;
+
+// Minimum and full-MTU Ethernet frames without the FCS
+inline constexpr uint32_t NET_BENCH_SMALL_FRAME = 60;
+inline constexpr uint32_t NET_BENCH_LARGE_FRAME = 1514;
+
+inline constexpr size_t NET_BENCH_ROUND_TRIPS = 1024;
+
+// Frames streamed one way, queued in bursts that share a notification
+inline constexpr size_t NET_BENCH_STREAM_FRAMES = 16384;
+inline constexpr size_t NET_BENCH_BURST = 32;
+
+// A frame missing for this long is lost, the run ends there
+inline constexpr uint64_t NET_BENCH_TIMEOUT_MS = 100;
+
+static uint64_t g_net_replies;
+
+// Owned by stream_handler while a stream runs
+static result g_net_stream;
+static uint64_t g_net_last_arrival;
+static uint64_t g_net_received;
+
+static void fill_frame(net::packet* pkt, const net::device* from, const net::device* to,
+                       uint32_t length) {
+    memory::memcpy(pkt->data, to->mac, net::MAC_LENGTH);
+    memory::memcpy(pkt->data + net::MAC_LENGTH, from->mac, net::MAC_LENGTH);
+    pkt->data[12] = static_cast<uint8_t>(NET_BENCH_ETHERTYPE >> 8);
+    pkt->data[13] = static_cast<uint8_t>(NET_BENCH_ETHERTYPE);
+    memory::memzero(pkt->data + 14, length - 14);
+    pkt->length = length;
+}
+
+// Sends every frame back out of the device it arrived on, in the same buffer
+static void echo_handler(net::device* dev, net::packet* const* packets, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t* frame = packets[i]->data;
+        memory::memcpy(frame, frame + net::MAC_LENGTH, net::MAC_LENGTH);
+        memory::memcpy(frame + net::MAC_LENGTH, dev->mac, net::MAC_LENGTH);
+    }
+
+    size_t sent = net::transmit(dev, packets, count);
+    net::free_packets(packets + sent, count - sent);
+}
+
+static void reply_handler(net::device*, net::packet* const* packets, size_t count) {
+    net::free_packets(packets, count);
+    __atomic_add_fetch(&g_net_replies, count, __ATOMIC_RELEASE);
+}
+
+// Each frame is recorded with the time since the one before, so the total is the stream's span
+static void stream_handler(net::device*, net::packet* const* packets, size_t count) {
+    uint64_t now = timestamp();
+    for (size_t i = 0; i < count; ++i) {
+        record(&g_net_stream, now - g_net_last_arrival, packets[i]->length);
+        g_net_last_arrival = now;
+    }
+
+    net::free_packets(packets, count);
+    __atomic_add_fetch(&g_net_received, count, __ATOMIC_RELEASE);
+}
+
+// Polled devices get no interrupts, so waits drive both ends themselves
+static void poll_devices(net::device* first, net::device* second) {
+    net::poll_all(first);
+    net::poll_all(second);
+    arch::x86::cpu_relax();
+}
+
+static uint64_t timeout_cycles() {
+    return arch::x86::tsc_frequency() / 1000 * NET_BENCH_TIMEOUT_MS;
+}
+
+// One frame at a time from `sender` to `echo` and back, measured until the reply is delivered
+static result run_round_trips(net::device* sender, net::device* echo, uint32_t length) {
+    result res = {};
+    uint64_t timeout = timeout_cycles();
+
+    __atomic_store_n(&g_net_replies, 0, __ATOMIC_RELAXED);
+    net::set_receive_handler(echo, echo_handler);
+    net::set_receive_handler(sender, reply_handler);
+
+    for (size_t i = 0; i < NET_BENCH_ROUND_TRIPS; ++i) {
+        net::packet* pkt = net::allocate_packet();
+        if (!pkt) {
+            res = {};
+            break;
+        }
+        fill_frame(pkt, sender, echo, length);
+
+        uint64_t start = timestamp();
+        if (net::transmit(sender, &pkt, 1) == 0) {
+            net::free_packet(pkt);
+            res = {};
+            break;
+        }
+
+        while (__atomic_load_n(&g_net_replies, __ATOMIC_ACQUIRE) == i &&
+               timestamp() - start < timeout) {
+            poll_devices(echo, sender);
+        }
+        if (__atomic_load_n(&g_net_replies, __ATOMIC_ACQUIRE) == i) {
+            res = {};
+            break;
+        }
+        record(&res, timestamp() - start, length);
+    }
+
+    net::set_receive_handler(sender, nullptr);
+    net::set_receive_handler(echo, nullptr);
+    return res;
+}
+
+// Frames from `sender` to `receiver` as fast as the transmit queue takes them
+static result run_stream(net::device* sender, net::device* receiver, uint32_t length) {
+    uint64_t timeout = timeout_cycles();
+    net::packet* burst[NET_BENCH_BURST];
+
+    g_net_stream = {};
+    __atomic_store_n(&g_net_received, 0, __ATOMIC_RELAXED);
+    g_net_last_arrival = timestamp();
+    net::set_receive_handler(receiver, stream_handler);
+
+    size_t sent = 0;
+    uint64_t progress = timestamp();
+    while (sent < NET_BENCH_STREAM_FRAMES && timestamp() - progress < timeout) {
+        size_t wanted = NET_BENCH_STREAM_FRAMES - sent;
+        wanted = wanted < NET_BENCH_BURST ? wanted : NET_BENCH_BURST;
+
+        // An empty pool or a full ring fills up again as the receiver frees frames
+        size_t count = net::allocate_packets(burst, wanted);
+        for (size_t i = 0; i < count; ++i) {
+            fill_frame(burst[i], sender, receiver, length);
+        }
+
+        size_t queued = 0;
+        while (queued < count && timestamp() - progress < timeout) {
+            size_t accepted = net::transmit(sender, burst + queued, count - queued);
+            queued += accepted;
+            if (accepted > 0) {
+                progress = timestamp();
+            } else {
+                poll_devices(receiver, sender);
+            }
+        }
+        net::free_packets(burst + queued, count - queued);
+        sent += queued;
+
+        poll_devices(receiver, sender);
+    }
+
+    // Frames still in flight arrive until the receiver stays quiet for a timeout
+    uint64_t seen = __atomic_load_n(&g_net_received, __ATOMIC_ACQUIRE);
+    progress = timestamp();
+    while (seen < sent && timestamp() - progress < timeout) {
+        poll_devices(receiver, sender);
+        uint64_t received = __atomic_load_n(&g_net_received, __ATOMIC_ACQUIRE);
+        if (received != seen) {
+            seen = received;
+            progress = timestamp();
+        }
+    }
+
+    net::set_receive_handler(receiver, nullptr);
+    return g_net_stream;
+}
+
+// Needs two devices on one link, see the loopback mode of scripts/run.sh
+void run_net_benchmarks() {
+    net::device* first = net::get_device(0);
+    net::device* second = net::get_device(1);
+    if (!first || !second) {
+        return;
+    }
+
+    report(benchmark_id::NET_ROUND_TRIP_SMALL,
+           run_round_trips(first, second, NET_BENCH_SMALL_FRAME));
+    report(benchmark_id::NET_ROUND_TRIP_LARGE,
+           run_round_trips(first, second, NET_BENCH_LARGE_FRAME));
+
+    report(benchmark_id::NET_STREAM_SMALL, run_stream(first, second, NET_BENCH_SMALL_FRAME));
+    report(benchmark_id::NET_STREAM_LARGE, run_stream(first, second, NET_BENCH_LARGE_FRAME));
+
+    virtio::net::emit_stats();
+}
+
+} // namespace bench
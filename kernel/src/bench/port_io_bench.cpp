@@ -0,0 +1,71 @@
+#include <bench/bench.h>
+#include <ports/ports.h>
+
+namespace bench {
+
+// Number of simulated sector transfers per benchmark
+inline constexpr size_t PORT_IO_ROUNDS = 256;
+
+// One ATA sector, the unit of a PIO data transfer
+inline constexpr size_t SECTOR_SIZE = 512;
+
+// Primary ATA data register, reads without a pending command return the bus value and have no
+// side effects, which is all that is needed to measure the cost of the access itself
+inline constexpr uint16_t ATA_PRIMARY_DATA_PORT = 0x1F0;
+
+// POST diagnostic port, writes are always safe
+inline constexpr uint16_t POST_DIAGNOSTIC_PORT = 0x80;
+
+static uint8_t g_sector_buffer[SECTOR_SIZE] __attribute__((aligned(16)));
+
+void run_port_io_benchmarks() {
+    result inb_loop = {};
+    result insb_result = {};
+    result inw_loop = {};
+    result insw_result = {};
+    result outb_loop = {};
+    result outsb_result = {};
+
+    auto* words = reinterpret_cast<uint16_t*>(g_sector_buffer);
+
+    for (size_t round = 0; round < PORT_IO_ROUNDS; ++round) {
+        uint64_t start = timestamp();
+        for (size_t i = 0; i < SECTOR_SIZE; ++i) {
+            g_sector_buffer[i] = inb(ATA_PRIMARY_DATA_PORT);
+        }
+        record(&inb_loop, timestamp() - start, SECTOR_SIZE);
+
+        start = timestamp();
+        insb(ATA_PRIMARY_DATA_PORT, g_sector_buffer, SECTOR_SIZE);
+        record(&insb_result, timestamp() - start, SECTOR_SIZE);
+
+        start = timestamp();
+        for (size_t i = 0; i < SECTOR_SIZE / sizeof(uint16_t); ++i) {
+            words[i] = inw(ATA_PRIMARY_DATA_PORT);
+        }
+        record(&inw_loop, timestamp() - start, SECTOR_SIZE);
+
+        start = timestamp();
+        insw(ATA_PRIMARY_DATA_PORT, g_sector_buffer, SECTOR_SIZE / sizeof(uint16_t));
+        record(&insw_result, timestamp() - start, SECTOR_SIZE);
+
+        start = timestamp();
+        for (size_t i = 0; i < SECTOR_SIZE; ++i) {
+            outb(POST_DIAGNOSTIC_PORT, g_sector_buffer[i]);
+        }
+        record(&outb_loop, timestamp() - start, SECTOR_SIZE);
+
+        start = timestamp();
+        outsb(POST_DIAGNOSTIC_PORT, g_sector_buffer, SECTOR_SIZE);
+        record(&outsb_result, timestamp() - start, SECTOR_SIZE);
+    }
+
+    report(benchmark_id::PORT_IO_INB_LOOP, inb_loop);
+    report(benchmark_id::PORT_IO_INSB, insb_result);
+    report(benchmark_id::PORT_IO_INW_LOOP, inw_loop);
+    report(benchmark_id::PORT_IO_INSW, insw_result);
+    report(benchmark_id::PORT_IO_OUTB_LOOP, outb_loop);
+    report(benchmark_id::PORT_IO_OUTSB, outsb_result);
+}
+
+} // namespace bench
@@ -0,0 +1,63 @@
+#include <arch/x86/paging/paging.h>
+#include <bench/bench.h>
+#include <proc/process.h>
+#include <sched/sched.h>
+
+namespace bench {
+
+// Page shared with the user program, above the pages of the syscall benchmark
+inline constexpr uint64_t FORK_BENCH_DATA = arch::x86::BOOT_MAPPED_MEMORY_SIZE +
+                                            3 * arch::x86::PAGE_SIZE;
+
+inline constexpr const char* FORK_BENCH_PATH = "bin/forkbench";
+
+inline constexpr uint64_t FORK_ITERATIONS = 64;
+inline constexpr uint64_t FORK_MAX_ITERATIONS = 256;
+
+// Same layout as fork_bench_data in user/forkbench/forkbench.cpp
+struct fork_bench_data {
+    uint64_t iterations; // Written by the kernel
+    uint64_t completed;  // Valid cycles entries, fewer than iterations if fork failed
+    uint64_t done;       // Set once completed is final
+    uint64_t cycles[FORK_MAX_ITERATIONS];
+};
+
+static_assert(sizeof(fork_bench_data) <= arch::x86::PAGE_SIZE,
+              "Fork benchmark data must fit in one page");
+
+alignas(arch::x86::PAGE_SIZE) static uint8_t g_fork_data_page[arch::x86::PAGE_SIZE];
+
+void run_proc_benchmarks() {
+    using namespace arch::x86;
+
+    // Inside the PML4 slot every address space shares with the kernel
+    if (!map_page(FORK_BENCH_DATA, virt_to_phys(g_fork_data_page),
+                  PTE_PRESENT | PTE_WRITABLE | PTE_USER | PTE_NO_EXECUTE)) {
+        return;
+    }
+
+    auto* data = reinterpret_cast<fork_bench_data*>(g_fork_data_page);
+    data->iterations = FORK_ITERATIONS;
+    data->completed = 0;
+    __atomic_store_n(&data->done, 0, __ATOMIC_RELEASE);
+
+    // Two events per fork would measure the serial port instead
+    proc::set_event_tracing(false);
+
+    if (proc::spawn(FORK_BENCH_PATH, FORK_BENCH_DATA)) {
+        while (__atomic_load_n(&data->done, __ATOMIC_ACQUIRE) == 0) {
+            sched::yield();
+        }
+    }
+
+    proc::set_event_tracing(true);
+
+    result res = {};
+    for (uint64_t i = 0; i < data->completed; ++i) {
+        record(&res, data->cycles[i]);
+    }
+
+    report(benchmark_id::PROC_FORK_EXIT_64MIB, res);
+}
+
+} // namespace bench
@@ -0,0 +1,103 @@
+#include <arch/x86/smp/smp.h>
+#include <bench/bench.h>
+#include <sync/rcu.h>
+#include <sync/spinlock.h>
+
+namespace bench {
+
+// Largest number of CPUs reading the table at once
+inline constexpr uint32_t RCU_BENCH_MAX_CPUS = 4;
+
+// Table lookups per CPU in one round
+inline constexpr uint32_t RCU_BENCH_LOOKUPS = 50000;
+
+// Rounds per CPU count, each one recorded as a single iteration
+inline constexpr size_t RCU_BENCH_ROUNDS = 8;
+
+// Each one waits for a timer tick on every CPU
+inline constexpr size_t RCU_SYNCHRONIZE_ITERATIONS = 16;
+
+inline constexpr size_t RCU_BENCH_TABLE_ENTRIES = 64;
+
+// Read-mostly table, replaced as a whole by writers
+struct lookup_table {
+    uint64_t values[RCU_BENCH_TABLE_ENTRIES];
+};
+
+static lookup_table g_tables[2];
+static lookup_table* g_rcu_table = &g_tables[0];
+
+static sync::spinlock g_table_lock;
+static lookup_table* g_locked_table = &g_tables[0];
+
+// Sums are stored to a volatile so the lookups cannot be optimized away
+static void rcu_read_body(void* /* context */, uint32_t /* index */) {
+    uint64_t sum = 0;
+
+    for (uint32_t i = 0; i < RCU_BENCH_LOOKUPS; ++i) {
+        sync::rcu_read_lock();
+        sum += sync::rcu_dereference(g_rcu_table)->values[i & (RCU_BENCH_TABLE_ENTRIES - 1)];
+        sync::rcu_read_unlock();
+    }
+
+    volatile uint64_t result = sum;
+    (void)result;
+}
+
+static void locked_read_body(void* /* context */, uint32_t /* index */) {
+    uint64_t sum = 0;
+
+    for (uint32_t i = 0; i < RCU_BENCH_LOOKUPS; ++i) {
+        sync::spinlock_guard guard(g_table_lock);
+        sum += g_locked_table->values[i & (RCU_BENCH_TABLE_ENTRIES - 1)];
+    }
+
+    volatile uint64_t result = sum;
+    (void)result;
+}
+
+// Records the average cycles per lookup of each round
+static void run_read_benchmark(cpu_body body, benchmark_id first_id) {
+    auto online = static_cast<uint32_t>(arch::x86::online_cpu_count());
+
+    for (uint32_t cpus = 1; cpus <= RCU_BENCH_MAX_CPUS && cpus <= online; ++cpus) {
+        result res = {};
+
+        for (size_t round = 0; round < RCU_BENCH_ROUNDS; ++round) {
+            uint64_t cycles;
+            if (!run_on_cpus(body, nullptr, cpus, &cycles)) {
+                return;
+            }
+            record(&res, cycles / (static_cast<uint64_t>(cpus) * RCU_BENCH_LOOKUPS));
+        }
+
+        report(static_cast<benchmark_id>(static_cast<uint16_t>(first_id) + cpus - 1), res);
+    }
+}
+
+// Publishes the other table and waits until no reader can still see the old one
+static void run_synchronize_benchmark() {
+    result res = {};
+
+    for (size_t i = 0; i < RCU_SYNCHRONIZE_ITERATIONS; ++i) {
+        uint64_t start = timestamp();
+        sync::rcu_assign_pointer(g_rcu_table, &g_tables[(i + 1) & 1]);
+        sync::synchronize_rcu();
+        record(&res, timestamp() - start);
+    }
+
+    report(benchmark_id::RCU_SYNCHRONIZE, res);
+}
+
+void run_rcu_benchmarks() {
+    for (size_t i = 0; i < RCU_BENCH_TABLE_ENTRIES; ++i) {
+        g_tables[0].values[i] = i;
+        g_tables[1].values[i] = i;
+    }
+
+    run_read_benchmark(rcu_read_body, benchmark_id::RCU_READ_1CPU);
+    run_read_benchmark(locked_read_body, benchmark_id::SPINLOCK_READ_1CPU);
+    run_synchronize_benchmark();
+}
+
+} // namespace bench
@@ -0,0 +1,177 @@
+#include <arch/x86/percpu/percpu.h>
+#include <arch/x86/smp/smp.h>
+#include <bench/bench.h>
+#include <sched/sched.h>
+
+namespace bench {
+
+// Short-lived threads spawned per round
+inline constexpr uint32_t SCHED_BENCH_THREADS = 4096;
+
+// Rounds, each one recorded as a single iteration
+inline constexpr size_t SCHED_BENCH_ROUNDS = 4;
+
+// Busy work of every thread, long enough for idle CPUs to wake up and steal
+inline constexpr uint64_t SCHED_BENCH_THREAD_CYCLES = 20000;
+
+// Yields per thread in one ping-pong round
+inline constexpr uint32_t PING_PONG_YIELDS = 10000;
+
+// Ping-pong rounds, each one recorded as a single iteration
+inline constexpr size_t PING_PONG_ROUNDS = 8;
+
+// Wakeups of an idle AP, each one recorded as a single iteration
+inline constexpr size_t IDLE_WAKEUP_ROUNDS = 64;
+
+// Pause before each wakeup, long enough for the AP to be back in its idle wait
+inline constexpr uint64_t IDLE_WAKEUP_SETTLE_CYCLES = 200000;
+
+// Two threads bouncing the CPU between each other
+struct ping_pong_run {
+    bool use_fpu;
+    uint32_t started;
+    uint32_t finished;
+    uint64_t start_tsc;
+    uint64_t end_tsc;
+};
+
+static uint32_t g_sched_bench_finished;
+
+static void short_thread(void*) {
+    uint64_t start = arch::x86::rdtsc();
+    while (arch::x86::rdtsc() - start < SCHED_BENCH_THREAD_CYCLES) {
+        arch::x86::cpu_relax();
+    }
+
+    __atomic_add_fetch(&g_sched_bench_finished, 1, __ATOMIC_RELEASE);
+}
+
+// Returns the cycles from the first spawn until the last thread finished
+static uint64_t run_spawn_round() {
+    __atomic_store_n(&g_sched_bench_finished, 0, __ATOMIC_RELAXED);
+
+    uint64_t start = timestamp();
+
+    for (uint32_t spawned = 0; spawned < SCHED_BENCH_THREADS;) {
+        if (sched::spawn(short_thread, nullptr)) {
+            ++spawned;
+        } else {
+            // Task pool exhausted, run some of the queued threads to free their slots
+            sched::yield();
+        }
+    }
+
+    while (__atomic_load_n(&g_sched_bench_finished, __ATOMIC_ACQUIRE) < SCHED_BENCH_THREADS) {
+        sched::yield();
+    }
+
+    return timestamp() - start;
+}
+
+static void ping_pong_thread(void* arg) {
+    auto* run = static_cast<ping_pong_run*>(arg);
+
+    // The first thread to run starts the clock
+    if (__atomic_fetch_add(&run->started, 1, __ATOMIC_ACQ_REL) == 0) {
+        run->start_tsc = timestamp();
+    }
+
+    for (uint32_t i = 0; i < PING_PONG_YIELDS; ++i) {
+        if (run->use_fpu) {
+            // Touches the x87 register file, so every switch back in takes the #NM path
+            asm volatile("fld1; fstp %%st(0)" ::: "memory");
+        }
+
+        sched::yield();
+    }
+
+    // The last thread to finish stops it
+    if (__atomic_add_fetch(&run->finished, 1, __ATOMIC_ACQ_REL) == 2) {
+        run->end_tsc = timestamp();
+    }
+}
+
+// Records the average cycles per switch between two threads pinned to the calling CPU
+static void run_ping_pong_benchmark(benchmark_id id, bool use_fpu) {
+    uint64_t affinity = 1ULL << arch::x86::current_cpu();
+    result res = {};
+
+    for (size_t round = 0; round < PING_PONG_ROUNDS; ++round) {
+        ping_pong_run run = {
+            .use_fpu = use_fpu, .started = 0, .finished = 0, .start_tsc = 0, .end_tsc = 0};
+
+        uint32_t spawned = 0;
+        for (; spawned < 2; ++spawned) {
+            if (!sched::spawn(ping_pong_thread, &run, sched::DEFAULT_PRIORITY, affinity)) {
+                break;
+            }
+        }
+
+        // Both threads run until they finish, this context only resumes once the queue drains
+        while (__atomic_load_n(&run.finished, __ATOMIC_ACQUIRE) < spawned) {
+            sched::yield();
+        }
+
+        if (spawned < 2) {
+            return;
+        }
+
+        record(&res, (run.end_tsc - run.start_tsc) / (2 * PING_PONG_YIELDS));
+    }
+
+    report(id, res);
+}
+
+static void stamp_wakeup(void* arg) {
+    __atomic_store_n(static_cast<uint64_t*>(arg), arch::x86::rdtsc(), __ATOMIC_RELEASE);
+}
+
+// Cycles from posting work to an idle AP until it runs, a plain store with MWAIT, a tick with HLT
+static void run_idle_wakeup_benchmark() {
+    if (arch::x86::online_cpu_count() < 2) {
+        return;
+    }
+
+    result res = {};
+    uint64_t woke = 0;
+
+    for (size_t round = 0; round < IDLE_WAKEUP_ROUNDS; ++round) {
+        uint64_t settle = arch::x86::rdtsc();
+        while (arch::x86::rdtsc() - settle < IDLE_WAKEUP_SETTLE_CYCLES) {
+            arch::x86::cpu_relax();
+        }
+
+        uint64_t start = timestamp();
+        if (!arch::x86::run_on_cpu(1, stamp_wakeup, &woke)) {
+            break;
+        }
+        arch::x86::wait_for_cpu(1);
+
+        record(&res, __atomic_load_n(&woke, __ATOMIC_ACQUIRE) - start);
+    }
+
+    report(benchmark_id::SCHED_IDLE_WAKEUP, res);
+}
+
+void run_sched_benchmarks() {
+    // One event per switch would overflow the event buffers and measure the serial link
+    sched::set_event_tracing(false);
+
+    result res = {};
+    for (size_t round = 0; round < SCHED_BENCH_ROUNDS; ++round) {
+        record(&res, run_spawn_round() / SCHED_BENCH_THREADS);
+    }
+
+    report(benchmark_id::SCHED_SPAWN_THROUGHPUT, res);
+
+    run_ping_pong_benchmark(benchmark_id::SCHED_PING_PONG, false);
+    run_ping_pong_benchmark(benchmark_id::SCHED_PING_PONG_FPU, true);
+    run_idle_wakeup_benchmark();
+
+    sched::set_event_tracing(true);
+
+    // Completed tasks and steals per CPU show how evenly the load was spread
+    sched::emit_cpu_stats();
+}
+
+} // namespace bench
@@ -0,0 +1,83 @@
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/syscall/syscall.h>
+#include <bench/bench.h>
+#include <memory/memory.h>
+#include <sched/sched.h>
+
+// Ring-3 benchmark program (user_null_syscall.S)
+EXTERN_C uint8_t user_null_syscall_start[];
+EXTERN_C uint8_t user_null_syscall_end[];
+
+namespace bench {
+
+// User addresses of the benchmark program, right above the boot identity map
+inline constexpr uint64_t USER_BENCH_CODE = arch::x86::BOOT_MAPPED_MEMORY_SIZE;
+inline constexpr uint64_t USER_BENCH_DATA = USER_BENCH_CODE + arch::x86::PAGE_SIZE;
+inline constexpr uint64_t USER_BENCH_STACK = USER_BENCH_DATA + arch::x86::PAGE_SIZE;
+
+// Null syscalls per round
+inline constexpr uint64_t NULL_SYSCALL_ITERATIONS = 100000;
+
+// Rounds, each one recorded as a single iteration
+inline constexpr size_t NULL_SYSCALL_ROUNDS = 8;
+
+// Shared with the user program through its data page
+struct user_bench_data {
+    uint64_t iterations; // Written by the kernel
+    uint64_t cycles;     // Written by the program when it is done
+};
+
+alignas(arch::x86::PAGE_SIZE) static uint8_t g_user_code_page[arch::x86::PAGE_SIZE];
+alignas(arch::x86::PAGE_SIZE) static uint8_t g_user_data_page[arch::x86::PAGE_SIZE];
+alignas(arch::x86::PAGE_SIZE) static uint8_t g_user_stack_page[arch::x86::PAGE_SIZE];
+
+static bool map_user_program() {
+    using namespace arch::x86;
+
+    auto program_size = static_cast<size_t>(user_null_syscall_end - user_null_syscall_start);
+    if (program_size > PAGE_SIZE) {
+        return false;
+    }
+
+    memory::memcpy(g_user_code_page, user_null_syscall_start, program_size);
+
+    return map_page(USER_BENCH_CODE, virt_to_phys(g_user_code_page), PTE_PRESENT | PTE_USER) &&
+           map_page(USER_BENCH_DATA, virt_to_phys(g_user_data_page),
+                    PTE_PRESENT | PTE_WRITABLE | PTE_USER | PTE_NO_EXECUTE) &&
+           map_page(USER_BENCH_STACK, virt_to_phys(g_user_stack_page),
+                    PTE_PRESENT | PTE_WRITABLE | PTE_USER | PTE_NO_EXECUTE);
+}
+
+static void user_program_thread(void*) {
+    arch::x86::enter_user_mode(USER_BENCH_CODE, USER_BENCH_STACK + arch::x86::PAGE_SIZE,
+                               USER_BENCH_DATA);
+}
+
+void run_syscall_benchmarks() {
+    if (!map_user_program()) {
+        return;
+    }
+
+    // The kernel sees the data page through its higher-half alias
+    auto* data = reinterpret_cast<user_bench_data*>(g_user_data_page);
+    result res = {};
+
+    for (size_t round = 0; round < NULL_SYSCALL_ROUNDS; ++round) {
+        data->iterations = NULL_SYSCALL_ITERATIONS;
+        __atomic_store_n(&data->cycles, 0, __ATOMIC_RELEASE);
+
+        if (!sched::spawn(user_program_thread, nullptr)) {
+            return;
+        }
+
+        while (__atomic_load_n(&data->cycles, __ATOMIC_ACQUIRE) == 0) {
+            sched::yield();
+        }
+
+        record(&res, data->cycles / NULL_SYSCALL_ITERATIONS);
+    }
+
+    report(benchmark_id::SYSCALL_NULL_ROUND_TRIP, res);
+}
+
+} // namespace bench
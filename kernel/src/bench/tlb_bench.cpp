@@ -0,0 +1,174 @@
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/paging/tlb.h>
+#include <arch/x86/smp/smp.h>
+#include <bench/bench.h>
+#include <memory/pmm.h>
+
+namespace bench {
+
+// Pages mapped in each benchmark address space and read after every switch
+inline constexpr uint64_t TLB_BENCH_BASE = arch::x86::USER_SPACE_START;
+inline constexpr size_t TLB_BENCH_PAGES = 32;
+
+inline constexpr size_t TLB_SWITCH_ITERATIONS = 2000;
+
+// Largest number of CPUs running the address space that is shot down
+inline constexpr uint32_t TLB_BENCH_MAX_CPUS = 4;
+
+inline constexpr size_t TLB_SHOOTDOWN_ITERATIONS = 2000;
+
+// Pages unmapped at once by the batch benchmarks, more than a batch holds individually
+inline constexpr size_t TLB_BATCH_BENCH_PAGES = 64;
+inline constexpr size_t TLB_BATCH_ITERATIONS = 200;
+
+using shootdown_body = void (*)(uint64_t cr3, result* res);
+
+// One shootdown measurement, every participating CPU has `cr3` loaded while `body` runs
+struct shootdown_run {
+    uint64_t cr3;
+    shootdown_body body;
+    result res;
+};
+
+// Maps TLB_BENCH_PAGES fresh frames, the kernel reads them through the user mapping
+static bool populate(uint64_t cr3) {
+    using namespace arch::x86;
+
+    for (size_t i = 0; i < TLB_BENCH_PAGES; ++i) {
+        uint64_t frame = memory::pmm::allocate_frame();
+        if (!frame) {
+            return false;
+        }
+
+        if (!map_user_page(cr3, TLB_BENCH_BASE + i * PAGE_SIZE, frame,
+                           PTE_PRESENT | PTE_WRITABLE | PTE_USER | PTE_NO_EXECUTE)) {
+            memory::pmm::free_frame(frame);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void touch_pages() {
+    for (size_t i = 0; i < TLB_BENCH_PAGES; ++i) {
+        (void)*reinterpret_cast<volatile uint64_t*>(TLB_BENCH_BASE + i * arch::x86::PAGE_SIZE);
+    }
+}
+
+// Alternates between two address spaces and reads every mapped page after each switch
+static void run_switch_benchmark(const uint64_t spaces[2], bool retention, benchmark_id id) {
+    arch::x86::set_tlb_retention(retention);
+    uint64_t rflags = arch::x86::save_and_disable_interrupts();
+
+    result res = {};
+    for (size_t i = 0; i < TLB_SWITCH_ITERATIONS; ++i) {
+        uint64_t start = timestamp();
+        arch::x86::activate_address_space(spaces[i & 1]);
+        touch_pages();
+        record(&res, timestamp() - start);
+    }
+
+    arch::x86::activate_address_space(arch::x86::kernel_address_space());
+    arch::x86::restore_interrupts(rflags);
+    arch::x86::set_tlb_retention(true);
+
+    report(id, res);
+}
+
+// Interrupts stay enabled around the switch, the shootdown IPIs are what is measured
+static void load_address_space(uint64_t cr3) {
+    uint64_t rflags = arch::x86::save_and_disable_interrupts();
+    arch::x86::activate_address_space(cr3);
+    arch::x86::restore_interrupts(rflags);
+}
+
+static void shootdown_enter(void* context, uint32_t /* index */) {
+    load_address_space(static_cast<shootdown_run*>(context)->cr3);
+}
+
+static void shootdown_leave(void* /* context */, uint32_t /* index */) {
+    load_address_space(arch::x86::kernel_address_space());
+}
+
+static void shootdown_measure(void* context, uint32_t index) {
+    auto* run = static_cast<shootdown_run*>(context);
+
+    shootdown_enter(context, index);
+    run->body(run->cr3, &run->res);
+    shootdown_leave(context, index);
+}
+
+// Runs `body` on the BSP while `cpus - 1` APs have the address space loaded, an empty result if
+// one of them could not be posted to
+static result run_with_participants(uint64_t cr3, uint32_t cpus, shootdown_body body) {
+    shootdown_run run = {.cr3 = cr3, .body = body, .res = {}};
+    if (!run_with_helpers(shootdown_measure, &run, cpus - 1, shootdown_enter, shootdown_leave)) {
+        return {};
+    }
+
+    return run.res;
+}
+
+static void single_page_body(uint64_t cr3, result* res) {
+    for (size_t i = 0; i < TLB_SHOOTDOWN_ITERATIONS; ++i) {
+        uint64_t start = timestamp();
+        arch::x86::flush_tlb_page(cr3, TLB_BENCH_BASE);
+        record(res, timestamp() - start);
+    }
+}
+
+static void batched_body(uint64_t cr3, result* res) {
+    arch::x86::tlb_batch batch = {.cr3 = cr3, .pages = {}, .count = 0, .flush_all = false};
+
+    for (size_t i = 0; i < TLB_BATCH_ITERATIONS; ++i) {
+        uint64_t start = timestamp();
+        for (size_t page = 0; page < TLB_BATCH_BENCH_PAGES; ++page) {
+            arch::x86::tlb_batch_add(&batch, TLB_BENCH_BASE + page * arch::x86::PAGE_SIZE);
+        }
+        arch::x86::flush_tlb_batch(&batch);
+        record(res, timestamp() - start, TLB_BATCH_BENCH_PAGES * arch::x86::PAGE_SIZE);
+    }
+}
+
+static void unbatched_body(uint64_t cr3, result* res) {
+    for (size_t i = 0; i < TLB_BATCH_ITERATIONS; ++i) {
+        uint64_t start = timestamp();
+        for (size_t page = 0; page < TLB_BATCH_BENCH_PAGES; ++page) {
+            arch::x86::flush_tlb_page(cr3, TLB_BENCH_BASE + page * arch::x86::PAGE_SIZE);
+        }
+        record(res, timestamp() - start, TLB_BATCH_BENCH_PAGES * arch::x86::PAGE_SIZE);
+    }
+}
+
+void run_tlb_benchmarks() {
+    uint64_t spaces[2] = {arch::x86::create_address_space(), arch::x86::create_address_space()};
+
+    if (spaces[0] && spaces[1] && populate(spaces[0]) && populate(spaces[1])) {
+        run_switch_benchmark(spaces, true, benchmark_id::TLB_SWITCH_PCID);
+        run_switch_benchmark(spaces, false, benchmark_id::TLB_SWITCH_FLUSH);
+
+        auto online = static_cast<uint32_t>(arch::x86::online_cpu_count());
+        uint32_t max_cpus = online < TLB_BENCH_MAX_CPUS ? online : TLB_BENCH_MAX_CPUS;
+
+        for (uint32_t cpus = 1; cpus <= max_cpus; ++cpus) {
+            result res = run_with_participants(spaces[0], cpus, single_page_body);
+            report(static_cast<benchmark_id>(
+                       static_cast<uint16_t>(benchmark_id::TLB_SHOOTDOWN_1CPU) + cpus - 1),
+                   res);
+        }
+
+        report(benchmark_id::TLB_SHOOTDOWN_BATCHED,
+               run_with_participants(spaces[0], max_cpus, batched_body));
+        report(benchmark_id::TLB_SHOOTDOWN_UNBATCHED,
+               run_with_participants(spaces[0], max_cpus, unbatched_body));
+    }
+
+    for (uint64_t cr3 : spaces) {
+        if (cr3) {
+            arch::x86::destroy_address_space(cr3);
+        }
+    }
+}
+
+} // namespace bench
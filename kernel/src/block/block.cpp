@@ -0,0 +1,132 @@
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/percpu/percpu.h>
+#include <block/block.h>
+#include <sync/spinlock.h>
+
+namespace block {
+
+static sync::spinlock g_registry_lock;
+static device* g_devices[MAX_DEVICES];
+static size_t g_device_count = 0;
+
+static bool name_equals(const char* a, const char* b) {
+    for (size_t i = 0; i < NAME_LENGTH; ++i) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+        if (a[i] == '\0') {
+            return true;
+        }
+    }
+    return true;
+}
+
+bool register_device(device* dev) {
+    sync::spinlock_guard guard(g_registry_lock);
+
+    if (g_device_count >= MAX_DEVICES) {
+        return false;
+    }
+    g_devices[g_device_count] = dev;
+
+    // Readers index the array without the lock
+    __atomic_store_n(&g_device_count, g_device_count + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+size_t device_count() {
+    return __atomic_load_n(&g_device_count, __ATOMIC_ACQUIRE);
+}
+
+device* get_device(size_t index) {
+    return index < device_count() ? g_devices[index] : nullptr;
+}
+
+device* find_device(const char* name) {
+    size_t count = device_count();
+    for (size_t i = 0; i < count; ++i) {
+        if (name_equals(g_devices[i]->name, name)) {
+            return g_devices[i];
+        }
+    }
+    return nullptr;
+}
+
+void complete(request* req, int status) {
+    req->status = status;
+    __atomic_store_n(&req->completed, 1, __ATOMIC_RELEASE);
+    if (req->done) {
+        req->done(req);
+    }
+}
+
+static bool valid(const device* dev, const request* req) {
+    if (req->op == operation::FLUSH) {
+        return true;
+    }
+    if (req->op == operation::WRITE && dev->read_only) {
+        return false;
+    }
+
+    uint32_t sectors_per_block = dev->block_size / SECTOR_SIZE;
+    return req->sector_count != 0 && req->sector < dev->sector_count &&
+           req->sector_count <= dev->sector_count - req->sector &&
+           req->sector % sectors_per_block == 0 && req->sector_count % sectors_per_block == 0;
+}
+
+static uint16_t current_queue(const device* dev) {
+    return static_cast<uint16_t>(static_cast<uint32_t>(arch::x86::current_cpu()) %
+                                 dev->queue_count);
+}
+
+size_t submit(device* dev, request* const* requests, size_t count) {
+    uint16_t queue = current_queue(dev);
+    size_t consumed = 0;
+
+    // Valid runs go to the driver as one batch, so they share a notification
+    while (consumed < count) {
+        size_t run = 0;
+        while (consumed + run < count && valid(dev, requests[consumed + run])) {
+            requests[consumed + run]->completed = 0;
+            ++run;
+        }
+
+        if (run > 0) {
+            size_t accepted = dev->ops->submit(dev, queue, requests + consumed, run);
+            consumed += accepted;
+            if (accepted < run) {
+                return consumed;
+            }
+            continue;
+        }
+
+        complete(requests[consumed++], STATUS_INVALID);
+    }
+    return consumed;
+}
+
+void poll(device* dev) {
+    dev->ops->poll(dev, current_queue(dev));
+}
+
+void poll_all(device* dev) {
+    for (uint16_t queue = 0; dev->polled && queue < dev->queue_count; ++queue) {
+        dev->ops->poll(dev, queue);
+    }
+}
+
+int submit_and_wait(device* dev, request* req) {
+    while (submit(dev, &req, 1) == 0) {
+        poll(dev);
+        arch::x86::cpu_relax();
+    }
+
+    // The caller may have moved to another CPU, so every queue is polled
+    while (!is_complete(req)) {
+        poll_all(dev);
+        arch::x86::cpu_relax();
+    }
+    return req->status;
+}
+
+} // namespace block
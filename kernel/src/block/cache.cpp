@@ -0,0 +1,704 @@
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/percpu/percpu.h>
+#include <arch/x86/smp/smp.h>
+#include <async/completion.h>
+#include <async/task.h>
+#include <block/cache.h>
+#include <iris/iris.h>
+#include <memory/pmm.h>
+#include <sched/sched.h>
+#include <sync/spinlock.h>
+
+namespace block::cache {
+
+// refcount of a buffer that is free or being reclaimed, lookups cannot pin it
+static constexpr uint32_t UNPINNABLE = 0x80000000;
+
+struct bucket {
+    buffer* head;
+    sync::spinlock lock; // Serializes insertions and removals, lookups take none
+};
+
+// Sequential access detection of one device, updated without a lock by every reader
+struct stream {
+    device* dev;
+    uint64_t next;   // Block a sequential reader asks for next
+    uint64_t ahead;  // First block not read ahead yet
+    uint32_t window; // Blocks read ahead per refill, 0 while access is random
+};
+
+static buffer g_buffers[BUFFER_COUNT];
+static size_t g_buffer_count = 0;
+
+static bucket g_buckets[HASH_BUCKETS];
+
+// Freed from RCU callbacks, which run with interrupts disabled
+static sync::spinlock g_free_lock;
+static buffer* g_free_list;
+static size_t g_free_count;
+static size_t g_reclaiming; // Reclaimed buffers waiting for their grace period
+
+static sync::spinlock g_clock_lock;
+static size_t g_clock_hand;
+
+static sync::spinlock g_stream_lock;
+static stream g_streams[MAX_DEVICES];
+
+static uint32_t g_dirty_count;
+static uint64_t g_dirty_since; // TSC when the oldest dirty data was written, 0 if none is
+static uint32_t g_writeback_in_flight;
+
+// The flusher waits for work on the first and for its writes on the second
+static async::completion g_flusher_wakeup;
+static async::completion g_writeback_done;
+static buffer* g_flusher_batch[WRITEBACK_BATCH];
+
+// Counted per CPU so that hits do not share a cache line, summed for reports
+DEFINE_PER_CPU(uint64_t, g_cache_hits);
+DEFINE_PER_CPU(uint64_t, g_cache_misses);
+DEFINE_PER_CPU(uint64_t, g_cache_read_ahead);
+DEFINE_PER_CPU(uint64_t, g_cache_read_ahead_hits);
+DEFINE_PER_CPU(uint64_t, g_cache_evictions);
+DEFINE_PER_CPU(uint64_t, g_cache_writebacks);
+DEFINE_PER_CPU(uint64_t, g_cache_writeback_rounds);
+
+static uint64_t g_last_stats_report = 0;
+static uint64_t g_reported_accesses = 0;
+
+static void increment(uint64_t* counter) {
+    arch::x86::this_cpu_add(counter, uint64_t{1});
+}
+
+static uint64_t total(uint64_t* counter) {
+    uint64_t sum = 0;
+    for (int cpu = 0; cpu < arch::x86::online_cpu_count(); ++cpu) {
+        sum += *arch::x86::per_cpu_ptr(counter, cpu);
+    }
+    return sum;
+}
+
+// Blocks of a device, 0 if its block size does not divide BLOCK_SIZE
+static uint64_t block_count(const device* dev) {
+    if (dev->block_size == 0 || dev->block_size > BLOCK_SIZE || BLOCK_SIZE % dev->block_size) {
+        return 0;
+    }
+    return dev->sector_count / SECTORS_PER_BLOCK;
+}
+
+static bucket* bucket_for(const device* dev, uint64_t block) {
+    uint64_t key = block ^ (reinterpret_cast<uint64_t>(dev) << 24);
+    return &g_buckets[((key * 0x9E3779B97F4A7C15ULL) >> 32) & (HASH_BUCKETS - 1)];
+}
+
+static bool try_pin(buffer* buf) {
+    uint32_t refcount = __atomic_load_n(&buf->refcount, __ATOMIC_RELAXED);
+    while (refcount != UNPINNABLE) {
+        if (__atomic_compare_exchange_n(&buf->refcount, &refcount, refcount + 1, true,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Pins the buffer of a block if it is cached, without taking a lock
+static buffer* lookup(device* dev, uint64_t block) {
+    bucket* b = bucket_for(dev, block);
+
+    // A buffer's key only changes after a grace period that follows its removal
+    sync::rcu_read_lock();
+    for (buffer* buf = sync::rcu_dereference(b->head); buf;
+         buf = sync::rcu_dereference(buf->hash_next)) {
+        if (buf->dev == dev && buf->block == block && try_pin(buf)) {
+            sync::rcu_read_unlock();
+            return buf;
+        }
+    }
+    sync::rcu_read_unlock();
+    return nullptr;
+}
+
+// Caller claimed the buffer, readers still walking past it keep the old links
+static void unlink(buffer* buf) {
+    bucket* b = bucket_for(buf->dev, buf->block);
+    sync::spinlock_guard guard(b->lock);
+
+    for (buffer** link = &b->head; *link; link = &(*link)->hash_next) {
+        if (*link == buf) {
+            sync::rcu_assign_pointer(*link, buf->hash_next);
+            return;
+        }
+    }
+}
+
+static void push_free(buffer* buf) {
+    sync::irq_spinlock_guard guard(g_free_lock);
+    buf->free_next = g_free_list;
+    g_free_list = buf;
+    ++g_free_count;
+}
+
+static void free_buffer(sync::rcu_head* head) {
+    auto* buf = reinterpret_cast<buffer*>(reinterpret_cast<uint8_t*>(head) -
+                                          __builtin_offsetof(buffer, rcu));
+    push_free(buf);
+    __atomic_sub_fetch(&g_reclaiming, 1, __ATOMIC_RELAXED);
+}
+
+// Advances the CLOCK hand to a clean, unpinned buffer not used since its last pass and removes it
+static buffer* evict() {
+    sync::spinlock_guard guard(g_clock_lock);
+
+    // Two rounds, the first may only clear referenced bits
+    for (size_t scanned = 0; scanned < 2 * g_buffer_count; ++scanned) {
+        buffer* buf = &g_buffers[g_clock_hand];
+        g_clock_hand = (g_clock_hand + 1) % g_buffer_count;
+
+        if (__atomic_fetch_and(&buf->flags, ~BUFFER_REFERENCED, __ATOMIC_RELAXED) &
+            BUFFER_REFERENCED) {
+            continue;
+        }
+
+        uint32_t unpinned = 0;
+        if (!__atomic_compare_exchange_n(&buf->refcount, &unpinned, UNPINNABLE, false,
+                                         __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            continue;
+        }
+
+        // Dirtying needs a pin, so a clean buffer stays clean once claimed
+        if (__atomic_load_n(&buf->flags, __ATOMIC_ACQUIRE) & (BUFFER_DIRTY | BUFFER_IO)) {
+            __atomic_store_n(&buf->refcount, 0, __ATOMIC_RELEASE);
+            continue;
+        }
+
+        unlink(buf);
+        increment(&g_cache_evictions);
+        return buf;
+    }
+    return nullptr;
+}
+
+// Queues a batch of evicted buffers for the free list, returns how many
+static size_t reclaim() {
+    size_t reclaimed = 0;
+    for (; reclaimed < RECLAIM_BATCH; ++reclaimed) {
+        buffer* buf = evict();
+        if (!buf) {
+            break;
+        }
+        __atomic_add_fetch(&g_reclaiming, 1, __ATOMIC_RELAXED);
+        sync::call_rcu(&buf->rcu, free_buffer);
+    }
+    return reclaimed;
+}
+
+static buffer* pop_free() {
+    sync::irq_spinlock_guard guard(g_free_lock);
+    buffer* buf = g_free_list;
+    if (buf) {
+        g_free_list = buf->free_next;
+        --g_free_count;
+    }
+    return buf;
+}
+
+// Takes a free buffer, refilling the free list before it runs dry so misses rarely wait
+static buffer* allocate(bool wait) {
+    while (true) {
+        buffer* buf = pop_free();
+
+        if (__atomic_load_n(&g_free_count, __ATOMIC_RELAXED) < RECLAIM_BATCH / 2 &&
+            __atomic_load_n(&g_reclaiming, __ATOMIC_RELAXED) == 0 && reclaim() == 0 && !buf) {
+            // Everything is pinned or dirty, only the flusher can make buffers reclaimable
+            g_flusher_wakeup.signal();
+            return nullptr;
+        }
+
+        if (buf || !wait) {
+            return buf;
+        }
+
+        // Passes this CPU's quiescent state so the reclaimed batch's grace period can end
+        sync::rcu_quiescent_state();
+        sched::yield();
+    }
+}
+
+// Pins the buffer of a block, adding an unread one with BUFFER_IO set if it is not cached
+static buffer* insert(device* dev, uint64_t block, bool wait, bool* created) {
+    *created = false;
+
+    buffer* fresh = allocate(wait);
+    if (!fresh) {
+        return nullptr;
+    }
+
+    bucket* b = bucket_for(dev, block);
+    {
+        sync::spinlock_guard guard(b->lock);
+
+        for (buffer* buf = b->head; buf; buf = buf->hash_next) {
+            if (buf->dev == dev && buf->block == block && try_pin(buf)) {
+                push_free(fresh);
+                return buf;
+            }
+        }
+
+        fresh->dev = dev;
+        fresh->block = block;
+        __atomic_store_n(&fresh->flags, BUFFER_IO, __ATOMIC_RELAXED);
+        __atomic_store_n(&fresh->refcount, 1, __ATOMIC_RELAXED);
+        fresh->hash_next = b->head;
+        sync::rcu_assign_pointer(b->head, fresh);
+    }
+
+    *created = true;
+    return fresh;
+}
+
+static void read_done(request* req) {
+    auto* buf = static_cast<buffer*>(req->context);
+    uint32_t result = req->status == STATUS_OK ? BUFFER_VALID : BUFFER_ERROR;
+
+    // Waiters see the result once BUFFER_IO is clear
+    __atomic_fetch_or(&buf->flags, result, __ATOMIC_RELAXED);
+    __atomic_fetch_and(&buf->flags, ~BUFFER_IO, __ATOMIC_RELEASE);
+}
+
+static void mark_dirty_flags(buffer* buf) {
+    if (__atomic_fetch_or(&buf->flags, BUFFER_DIRTY, __ATOMIC_RELAXED) & BUFFER_DIRTY) {
+        return;
+    }
+
+    uint64_t none = 0;
+    __atomic_compare_exchange_n(&g_dirty_since, &none, arch::x86::rdtsc(), false,
+                                __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+
+    if (__atomic_add_fetch(&g_dirty_count, 1, __ATOMIC_RELAXED) == DIRTY_THRESHOLD) {
+        g_flusher_wakeup.signal();
+    }
+}
+
+static void write_done(request* req) {
+    auto* buf = static_cast<buffer*>(req->context);
+
+    if (req->status == STATUS_OK) {
+        __atomic_fetch_and(&buf->flags, ~BUFFER_ERROR, __ATOMIC_RELAXED);
+        increment(&g_cache_writebacks);
+    } else {
+        __atomic_fetch_or(&buf->flags, BUFFER_ERROR, __ATOMIC_RELAXED);
+        mark_dirty_flags(buf);
+    }
+
+    __atomic_fetch_and(&buf->flags, ~BUFFER_IO, __ATOMIC_RELEASE);
+    if (__atomic_sub_fetch(&g_writeback_in_flight, 1, __ATOMIC_ACQ_REL) == 0) {
+        g_writeback_done.signal();
+    }
+}
+
+static request* prepare_io(buffer* buf, operation op) {
+    buf->io = {.op = op,
+               .sector = buf->block * SECTORS_PER_BLOCK,
+               .sector_count = SECTORS_PER_BLOCK,
+               .buffer = buf->phys,
+               .done = op == operation::READ ? read_done : write_done,
+               .context = buf,
+               .status = 0,
+               .completed = 0,
+               .next = nullptr};
+    return &buf->io;
+}
+
+// Submits until the device took every request, a full queue drains through completions
+static void submit_all(device* dev, request** batch, size_t count) {
+    size_t done = 0;
+    while (done < count) {
+        done += submit(dev, batch + done, count - done);
+        if (done < count) {
+            poll(dev);
+            arch::x86::cpu_relax();
+        }
+    }
+}
+
+static void wait_io(buffer* buf) {
+    while (__atomic_load_n(&buf->flags, __ATOMIC_ACQUIRE) & BUFFER_IO) {
+        poll_all(buf->dev);
+        arch::x86::cpu_relax();
+    }
+}
+
+// Claims a buffer nobody transfers for a new transfer, clearing `clear` with the claim
+static bool claim_io(buffer* buf, uint32_t required, uint32_t clear) {
+    uint32_t flags = __atomic_load_n(&buf->flags, __ATOMIC_RELAXED);
+    while ((flags & (required | BUFFER_IO)) == required) {
+        if (__atomic_compare_exchange_n(&buf->flags, &flags, (flags & ~clear) | BUFFER_IO, true,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Waits for the pinned buffer's read, reads it again once if an earlier read failed
+static bool wait_valid(buffer* buf) {
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        wait_io(buf);
+        if (__atomic_load_n(&buf->flags, __ATOMIC_ACQUIRE) & BUFFER_VALID) {
+            return true;
+        }
+
+        if (claim_io(buf, BUFFER_ERROR, BUFFER_ERROR)) {
+            request* req = prepare_io(buf, operation::READ);
+            submit_all(buf->dev, &req, 1);
+        }
+    }
+    return false;
+}
+
+static stream* stream_for(device* dev) {
+    for (stream& s : g_streams) {
+        device* owner = __atomic_load_n(&s.dev, __ATOMIC_ACQUIRE);
+        if (owner == dev) {
+            return &s;
+        }
+        if (!owner) {
+            break;
+        }
+    }
+
+    sync::spinlock_guard guard(g_stream_lock);
+    for (stream& s : g_streams) {
+        if (s.dev == dev) {
+            return &s;
+        }
+        if (!s.dev) {
+            __atomic_store_n(&s.dev, dev, __ATOMIC_RELEASE);
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+// Tracks the device's stream, returns the blocks to read ahead; a lost race only skips a refill
+static uint32_t plan_read_ahead(stream* s, uint64_t block, uint64_t blocks, uint64_t* from) {
+    if (__atomic_exchange_n(&s->next, block + 1, __ATOMIC_RELAXED) != block) {
+        __atomic_store_n(&s->window, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&s->ahead, block + 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    uint32_t window = __atomic_load_n(&s->window, __ATOMIC_RELAXED);
+    if (window == 0) {
+        window = READ_AHEAD_MIN;
+    }
+
+    // Refills once less than half a window is left ahead of the reader
+    uint64_t ahead = __atomic_load_n(&s->ahead, __ATOMIC_RELAXED);
+    uint64_t start = ahead > block + 1 ? ahead : block + 1;
+    if (start - (block + 1) >= window / 2 || start >= blocks) {
+        return 0;
+    }
+
+    uint64_t count = blocks - start < window ? blocks - start : window;
+    if (!__atomic_compare_exchange_n(&s->ahead, &ahead, start + count, false, __ATOMIC_RELAXED,
+                                     __ATOMIC_RELAXED)) {
+        return 0;
+    }
+
+    uint32_t next_window = window * 2 < READ_AHEAD_MAX ? window * 2 : READ_AHEAD_MAX;
+    __atomic_store_n(&s->window, next_window, __ATOMIC_RELAXED);
+    *from = start;
+    return static_cast<uint32_t>(count);
+}
+
+// Adds reads of the blocks that are not cached to a batch, read-ahead buffers stay unpinned
+static size_t queue_read_ahead(device* dev, uint64_t from, uint32_t count, request** batch) {
+    size_t queued = 0;
+    for (uint64_t block = from; block < from + count; ++block) {
+        buffer* buf = lookup(dev, block);
+        if (!buf) {
+            // Read-ahead never waits for a free buffer
+            bool created;
+            buf = insert(dev, block, false, &created);
+            if (!buf) {
+                break;
+            }
+            if (created) {
+                __atomic_fetch_or(&buf->flags, BUFFER_READ_AHEAD, __ATOMIC_RELAXED);
+                batch[queued++] = prepare_io(buf, operation::READ);
+                increment(&g_cache_read_ahead);
+            }
+        }
+
+        // BUFFER_IO keeps it from being reclaimed until the read completed
+        release(buf);
+    }
+    return queued;
+}
+
+// Claims up to `max` dirty buffers of a device, or of all devices, sorted by device and block
+static size_t collect_dirty(const device* dev, buffer** claimed, size_t max) {
+    size_t count = 0;
+
+    for (size_t i = 0; i < g_buffer_count && count < max; ++i) {
+        buffer* buf = &g_buffers[i];
+        if ((dev && buf->dev != dev) || !claim_io(buf, BUFFER_DIRTY, BUFFER_DIRTY)) {
+            continue;
+        }
+        __atomic_sub_fetch(&g_dirty_count, 1, __ATOMIC_RELAXED);
+
+        size_t slot = count++;
+        for (; slot > 0; --slot) {
+            const buffer* prev = claimed[slot - 1];
+            if (prev->dev < buf->dev || (prev->dev == buf->dev && prev->block < buf->block)) {
+                break;
+            }
+            claimed[slot] = claimed[slot - 1];
+        }
+        claimed[slot] = buf;
+    }
+    return count;
+}
+
+// Writes claimed buffers, each device's run goes to the driver as one batch
+static void submit_writeback(buffer** claimed, size_t count) {
+    request* batch[WRITEBACK_BATCH];
+
+    __atomic_add_fetch(&g_writeback_in_flight, count, __ATOMIC_ACQ_REL);
+    increment(&g_cache_writeback_rounds);
+
+    for (size_t start = 0; start < count;) {
+        device* dev = claimed[start]->dev;
+        size_t run = 0;
+        while (start + run < count && claimed[start + run]->dev == dev) {
+            batch[run] = prepare_io(claimed[start + run], operation::WRITE);
+            ++run;
+        }
+
+        submit_all(dev, batch, run);
+        start += run;
+    }
+}
+
+// Completes writes of devices without interrupts, returns false if there are none
+static bool poll_writeback() {
+    bool polled = false;
+    for (size_t i = 0; i < device_count(); ++i) {
+        device* dev = get_device(i);
+        if (dev->polled) {
+            poll_all(dev);
+            polled = true;
+        }
+    }
+    return polled;
+}
+
+static bool any_failed(buffer* const* claimed, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (__atomic_load_n(&claimed[i]->flags, __ATOMIC_ACQUIRE) & BUFFER_ERROR) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static async::task<void> flusher() {
+    while (true) {
+        co_await g_flusher_wakeup;
+
+        __atomic_store_n(&g_dirty_since, 0, __ATOMIC_RELAXED);
+
+        size_t count;
+        while ((count = collect_dirty(nullptr, g_flusher_batch, WRITEBACK_BATCH)) > 0) {
+            submit_writeback(g_flusher_batch, count);
+
+            // Also waits for writes of sync_device(), a stale signal costs one more check
+            while (__atomic_load_n(&g_writeback_in_flight, __ATOMIC_ACQUIRE) != 0) {
+                if (poll_writeback()) {
+                    arch::x86::cpu_relax();
+                    continue;
+                }
+                co_await g_writeback_done;
+            }
+
+            // Failed writes are dirty again, they are retried after WRITEBACK_DELAY_MS
+            if (any_failed(g_flusher_batch, count)) {
+                break;
+            }
+        }
+    }
+}
+
+bool init() {
+    if (device_count() == 0) {
+        return false;
+    }
+
+    for (; g_buffer_count < BUFFER_COUNT; ++g_buffer_count) {
+        uint64_t phys = memory::pmm::allocate_frame();
+        if (!phys) {
+            break;
+        }
+
+        buffer* buf = &g_buffers[g_buffer_count];
+        buf->phys = phys;
+        buf->data = arch::x86::phys_to_virt(phys);
+        buf->refcount = UNPINNABLE;
+        push_free(buf);
+    }
+
+    if (g_buffer_count == 0) {
+        return false;
+    }
+
+    // Runs from this CPU's executor whenever g_flusher_wakeup is signalled
+    return async::spawn(flusher());
+}
+
+buffer* get(device* dev, uint64_t block) {
+    uint64_t blocks = block_count(dev);
+    if (block >= blocks || g_buffer_count == 0) {
+        return nullptr;
+    }
+
+    uint64_t ahead_from = 0;
+    uint32_t ahead_count = 0;
+    if (stream* s = stream_for(dev)) {
+        ahead_count = plan_read_ahead(s, block, blocks, &ahead_from);
+    }
+
+    request* batch[1 + READ_AHEAD_MAX];
+    size_t queued = 0;
+
+    buffer* buf = lookup(dev, block);
+    if (buf) {
+        increment(&g_cache_hits);
+        if (__atomic_fetch_and(&buf->flags, ~BUFFER_READ_AHEAD, __ATOMIC_RELAXED) &
+            BUFFER_READ_AHEAD) {
+            increment(&g_cache_read_ahead_hits);
+        }
+    } else {
+        bool created;
+        buf = insert(dev, block, true, &created);
+        if (!buf) {
+            return nullptr;
+        }
+        if (created) {
+            increment(&g_cache_misses);
+            batch[queued++] = prepare_io(buf, operation::READ);
+        } else {
+            increment(&g_cache_hits);
+        }
+    }
+
+    // The miss and the blocks after it go out together, so the driver merges them
+    queued += queue_read_ahead(dev, ahead_from, ahead_count, batch + queued);
+    submit_all(dev, batch, queued);
+
+    if (!wait_valid(buf)) {
+        release(buf);
+        return nullptr;
+    }
+
+    __atomic_fetch_or(&buf->flags, BUFFER_REFERENCED, __ATOMIC_RELAXED);
+    return buf;
+}
+
+void release(buffer* buf) {
+    __atomic_sub_fetch(&buf->refcount, 1, __ATOMIC_RELEASE);
+}
+
+void mark_dirty(buffer* buf) {
+    mark_dirty_flags(buf);
+}
+
+int sync_device(device* dev) {
+    buffer* claimed[WRITEBACK_BATCH];
+    int status = STATUS_OK;
+
+    size_t count;
+    while (status == STATUS_OK && (count = collect_dirty(dev, claimed, WRITEBACK_BATCH)) > 0) {
+        submit_writeback(claimed, count);
+
+        for (size_t i = 0; i < count; ++i) {
+            wait_io(claimed[i]);
+        }
+        if (any_failed(claimed, count)) {
+            status = STATUS_IO_ERROR;
+        }
+    }
+
+    // Writes the flusher started before this call must be durable as well
+    for (size_t i = 0; i < g_buffer_count; ++i) {
+        if (g_buffers[i].dev == dev) {
+            wait_io(&g_buffers[i]);
+        }
+    }
+
+    request flush = {.op = operation::FLUSH,
+                     .sector = 0,
+                     .sector_count = 0,
+                     .buffer = 0,
+                     .done = nullptr,
+                     .context = nullptr,
+                     .status = 0,
+                     .completed = 0,
+                     .next = nullptr};
+    int flushed = submit_and_wait(dev, &flush);
+
+    // Devices without a volatile write cache do not support flushes
+    if (status == STATUS_OK && flushed != STATUS_OK && flushed != STATUS_UNSUPPORTED) {
+        status = flushed;
+    }
+    return status;
+}
+
+void flush_writeback() {
+    uint64_t frequency = arch::x86::tsc_frequency();
+    uint64_t since = __atomic_load_n(&g_dirty_since, __ATOMIC_RELAXED);
+    if (frequency == 0 || since == 0) {
+        return;
+    }
+
+    if (arch::x86::rdtsc() - since >= frequency / 1000 * WRITEBACK_DELAY_MS) {
+        g_flusher_wakeup.signal();
+    }
+}
+
+void emit_stats() {
+    stats_payload payload = {.hits = total(&g_cache_hits),
+                             .misses = total(&g_cache_misses),
+                             .read_ahead = total(&g_cache_read_ahead),
+                             .read_ahead_hits = total(&g_cache_read_ahead_hits),
+                             .evictions = total(&g_cache_evictions),
+                             .writebacks = total(&g_cache_writebacks),
+                             .writeback_rounds = total(&g_cache_writeback_rounds),
+                             .buffers = static_cast<uint32_t>(g_buffer_count),
+                             .dirty = __atomic_load_n(&g_dirty_count, __ATOMIC_RELAXED)};
+
+    iris::emit_with_payload(iris::EVENT_BUFFER_CACHE_STATS, 0, 0, &payload, sizeof(payload));
+}
+
+void flush_stats() {
+    uint64_t frequency = arch::x86::tsc_frequency();
+    if (frequency == 0 || g_buffer_count == 0) {
+        return;
+    }
+
+    uint64_t now = arch::x86::rdtsc();
+    if (now - g_last_stats_report < frequency / 1000 * STATS_REPORT_INTERVAL_MS) {
+        return;
+    }
+    g_last_stats_report = now;
+
+    uint64_t accesses = total(&g_cache_hits) + total(&g_cache_misses) + total(&g_cache_writebacks);
+    if (accesses != g_reported_accesses) {
+        g_reported_accesses = accesses;
+        emit_stats();
+    }
+}
+
+} // namespace block::cache
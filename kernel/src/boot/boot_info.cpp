@@ -0,0 +1,161 @@
+#include <arch/x86/paging/paging.h>
+#include <boot/boot_info.h>
+
+namespace boot {
+
+// Fixed part of the multiboot2 information structure preceding the first tag
+struct mbi_header {
+    uint32_t total_size;
+    uint32_t reserved;
+};
+
+static const uint8_t* g_mbi = nullptr;
+static boot_module g_boot_modules[MAX_BOOT_MODULES];
+static size_t g_boot_module_count = 0;
+
+static const multiboot::tag* first_tag() {
+    return reinterpret_cast<const multiboot::tag*>(g_mbi + sizeof(mbi_header));
+}
+
+// Returns false once the END tag or the end of the structure is reached
+static bool is_valid_tag(const multiboot::tag* current) {
+    const uint8_t* end = g_mbi + reinterpret_cast<const mbi_header*>(g_mbi)->total_size;
+
+    return reinterpret_cast<const uint8_t*>(current) + sizeof(multiboot::tag) <= end &&
+           current->size >= sizeof(multiboot::tag) &&
+           current->type != static_cast<uint32_t>(multiboot::tag_type::END);
+}
+
+static const multiboot::tag* next_tag(const multiboot::tag* current) {
+    uint64_t address = reinterpret_cast<uint64_t>(current) + current->size;
+    address = (address + multiboot::TAG_ALIGN - 1) & ~uint64_t{multiboot::TAG_ALIGN - 1};
+    return reinterpret_cast<const multiboot::tag*>(address);
+}
+
+static bool strings_equal(const char* lhs, const char* rhs) {
+    while (*lhs && *lhs == *rhs) {
+        ++lhs;
+        ++rhs;
+    }
+
+    return *lhs == *rhs;
+}
+
+static void add_module(const multiboot::tag_module* module) {
+    if (g_boot_module_count >= MAX_BOOT_MODULES || module->mod_end < module->mod_start) {
+        return;
+    }
+
+    // Modules are used in place, so they must be reachable through the boot-time mapping
+    if (module->mod_end > arch::x86::BOOT_MAPPED_MEMORY_SIZE) {
+        return;
+    }
+
+    boot_module* entry = &g_boot_modules[g_boot_module_count++];
+    entry->phys_start = module->mod_start;
+    entry->size = module->mod_end - module->mod_start;
+    entry->data = static_cast<const uint8_t*>(arch::x86::phys_to_virt(module->mod_start));
+    entry->cmdline = module->cmdline;
+}
+
+void parse_boot_info(void* mbi) {
+    g_mbi = static_cast<const uint8_t*>(mbi);
+    g_boot_module_count = 0;
+
+    for (const auto* current = first_tag(); is_valid_tag(current); current = next_tag(current)) {
+        if (current->type == static_cast<uint32_t>(multiboot::tag_type::MODULE)) {
+            add_module(reinterpret_cast<const multiboot::tag_module*>(current));
+        }
+    }
+}
+
+const multiboot::tag* find_boot_tag(multiboot::tag_type type) {
+    if (!g_mbi) {
+        return nullptr;
+    }
+
+    for (const auto* current = first_tag(); is_valid_tag(current); current = next_tag(current)) {
+        if (current->type == static_cast<uint32_t>(type)) {
+            return current;
+        }
+    }
+
+    return nullptr;
+}
+
+void get_boot_info_range(uint64_t* phys, uint64_t* size) {
+    *phys = arch::x86::virt_to_phys(g_mbi);
+    *size = reinterpret_cast<const mbi_header*>(g_mbi)->total_size;
+}
+
+size_t boot_module_count() {
+    return g_boot_module_count;
+}
+
+const boot_module* get_boot_module(size_t index) {
+    if (index >= g_boot_module_count) {
+        return nullptr;
+    }
+
+    return &g_boot_modules[index];
+}
+
+const boot_module* find_boot_module(const char* cmdline) {
+    for (size_t i = 0; i < g_boot_module_count; ++i) {
+        if (strings_equal(g_boot_modules[i].cmdline, cmdline)) {
+            return &g_boot_modules[i];
+        }
+    }
+
+    return nullptr;
+}
+
+
+bool is_free_memory(uint64_t phys, uint64_t size) {
+    const auto* mmap = reinterpret_cast<const multiboot::tag_mmap*>(
+        find_boot_tag(multiboot::tag_type::MMAP));
+    if (!mmap || mmap->entry_size < sizeof(multiboot::mmap_entry)) {
+        return false;
+    }
+
+    uint64_t end = phys + size;
+    bool available = false;
+
+    const auto* entries = reinterpret_cast<const uint8_t*>(mmap->entries);
+    size_t entries_size = mmap->size - sizeof(multiboot::tag_mmap);
+
+    for (size_t offset = 0; offset + mmap->entry_size <= entries_size;
+         offset += mmap->entry_size) {
+        const auto* entry = reinterpret_cast<const multiboot::mmap_entry*>(entries + offset);
+
+        uint64_t base = (static_cast<uint64_t>(entry->base_addr_high) << 32) | entry->base_addr_low;
+        uint64_t length = (static_cast<uint64_t>(entry->length_high) << 32) | entry->length_low;
+
+        if (entry->type == static_cast<uint32_t>(multiboot::memory_type::AVAILABLE) &&
+            phys >= base && end <= base + length) {
+            available = true;
+            break;
+        }
+    }
+
+    if (!available) {
+        return false;
+    }
+
+    uint64_t mbi_start = arch::x86::virt_to_phys(g_mbi);
+    uint64_t mbi_end = mbi_start + reinterpret_cast<const mbi_header*>(g_mbi)->total_size;
+    if (phys < mbi_end && end > mbi_start) {
+        return false;
+    }
+
+    for (size_t i = 0; i < g_boot_module_count; ++i) {
+        const boot_module& module = g_boot_modules[i];
+        if (phys < module.phys_start + module.size && end > module.phys_start) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace boot
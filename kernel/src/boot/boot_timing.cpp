@@ -0,0 +1,70 @@
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/paging/paging.h>
+#include <boot/boot_timing.h>
+#include <iris/iris.h>
+
+// Filled in by boot.S, lives in the identity-mapped bootstrap section
+EXTERN_C uint64_t g_bootstrap_tsc[];
+
+namespace boot {
+
+static uint64_t g_boot_phase_tsc[BOOT_PHASE_COUNT];
+
+void mark_phase(boot_phase phase) {
+    auto index = static_cast<size_t>(phase);
+
+    if (index < BOOT_PHASE_COUNT && g_boot_phase_tsc[index] == 0) {
+        g_boot_phase_tsc[index] = arch::x86::rdtsc();
+    }
+}
+
+void report_boot_complete() {
+    mark_phase(boot_phase::IDLE_REACHED);
+
+    // Reach the bootstrap samples through the higher half so the identity map is not required
+    const auto* bootstrap_tsc = static_cast<const uint64_t*>(
+        arch::x86::phys_to_virt(reinterpret_cast<uint64_t>(g_bootstrap_tsc)));
+
+    for (size_t i = 0; i < BOOTSTRAP_PHASE_COUNT; ++i) {
+        g_boot_phase_tsc[i] = bootstrap_tsc[i];
+    }
+
+    uint64_t previous_tsc = g_boot_phase_tsc[0];
+
+    for (size_t i = 0; i < BOOT_PHASE_COUNT; ++i) {
+        uint64_t tsc = g_boot_phase_tsc[i];
+        if (tsc == 0) {
+            continue;
+        }
+
+        boot_phase_payload payload = {.tsc = tsc,
+                                      .cycles = tsc - previous_tsc,
+                                      .phase = static_cast<uint16_t>(i),
+                                      .reserved1 = 0,
+                                      .reserved2 = 0};
+
+        iris::emit_with_payload(iris::EVENT_BOOT_PHASE, 0, 0, &payload, sizeof(payload));
+        previous_tsc = tsc;
+    }
+
+    uint64_t entry_tsc = g_boot_phase_tsc[static_cast<size_t>(boot_phase::BOOTSTRAP_ENTRY)];
+    uint64_t idle_tsc = g_boot_phase_tsc[static_cast<size_t>(boot_phase::IDLE_REACHED)];
+    uint64_t tsc_frequency = arch::x86::tsc_frequency();
+
+    boot_summary_payload summary = {.entry_tsc = entry_tsc,
+                                    .idle_tsc = idle_tsc,
+                                    .tsc_frequency = tsc_frequency,
+                                    .boot_to_idle_ns = 0};
+
+    if (tsc_frequency != 0) {
+        // Split the conversion to avoid overflowing 64 bits for long boots
+        uint64_t cycles = idle_tsc - entry_tsc;
+        summary.boot_to_idle_ns = (cycles / tsc_frequency) * 1000000000ULL +
+                                  ((cycles % tsc_frequency) * 1000000000ULL) / tsc_frequency;
+    }
+
+    iris::emit_with_payload(iris::EVENT_BOOT_COMPLETE, 0, 0, &summary, sizeof(summary));
+}
+
+} // namespace boot
@@ -1,7 +1,28 @@
 #include <arch/arch_init.h>
+#include <arch/x86/cpu/features.h>
+#include <arch/x86/irq/irq.h>
+#include <arch/x86/smp/ipi.h>
+#include <async/executor.h>
+#include <bench/bench.h>
+#include <block/cache.h>
+#include <boot/boot_info.h>
+#include <boot/boot_timing.h>
 #include <boot/multiboot2.h>
+#include <fs/initramfs.h>
 #include <iris/iris.h>
+#include <iris/profiler.h>
+#include <iris/tracepoint.h>
+#include <memory/pmm.h>
+#include <pci/pci.h>
+#include <proc/process.h>
+#include <sched/sched.h>
 #include <serial/serial.h>
+#include <sync/rcu.h>
+#include <virtio/blk.h>
+#include <virtio/net.h>
+
+// Executable started in user mode once the kernel is up, packed into the initramfs by the build
+inline constexpr const char* INIT_PROGRAM_PATH = "bin/init";
 
 EXTERN_C
 void init(unsigned int magic, void* mbi) {
@@ -11,20 +32,74 @@ void init(unsigned int magic, void* mbi) {
         }
     }
 
-    (void)mbi;
+    boot::parse_boot_info(mbi);
 
     // Initialize early stage serial output
     serial::init_port(static_cast<uint16_t>(serial::port_base::COM1));
+    boot::mark_phase(boot::boot_phase::SERIAL_READY);
 
     // Initialize IRIS debug system on COM2
     iris::init();
     iris::emit(iris::EVENT_BOOT_START, 0, 0);
+    boot::mark_phase(boot::boot_phase::IRIS_READY);
 
     // Hardware and arch-specific setup
     arch::arch_first_stage_init();
+    boot::mark_phase(boot::boot_phase::ARCH_READY);
+
+    // Every frame outside the kernel image, boot info and modules becomes allocatable
+    memory::pmm::init();
+
+    // Read-only initial filesystem, used in place from the bootloader module
+    fs::initramfs::mount_boot_module();
+
+    // Device table from the PCI configuration space, drivers registered so far are bound
+    virtio::blk::init();
+    virtio::net::init();
+    pci::init();
+
+    // Buffer cache over the block devices bound above, its flusher runs from this CPU's executor
+    block::cache::init();
+
+    // Features every CPU reported at bring-up, APs that differ from the BSP are flagged
+    arch::x86::emit_cpu_features();
+
+#ifdef BUILD_BENCHMARKS
+    bench::run_all();
+#endif
 
-    // Idle loop
+#ifdef ENABLE_PROFILER
+    iris::profiler::start();
+#endif
+
+    // First user program, runs once the boot context becomes the idle task below
+    proc::spawn(INIT_PROGRAM_PATH);
+
+    // Packets go out from the transmit interrupt from here on, COM2 interrupts this CPU
+    iris::set_async_transmission(true);
+
+    // Boot timeline up to here and the cost of every tracepoint hit so far. Boot-to-idle
+    // includes the benchmarks in builds that run them
+    boot::report_boot_complete();
+    iris::emit_tracepoint_stats();
+
+    // Idle loop, the boot context is the BSP's idle task
     while (true) {
-        asm volatile("hlt");
+        // Stream samples and scheduler events collected since the last wakeup
+        iris::profiler::flush();
+        sched::flush_events();
+        sched::flush_utilization();
+        arch::x86::flush_ipi_events();
+        arch::x86::flush_interrupt_stats();
+        block::cache::flush_writeback();
+        block::cache::flush_stats();
+
+        // Quiescent point, runs RCU callbacks whose grace period ended
+        sync::rcu_quiescent_state();
+
+        // Continues coroutines whose device completed, e.g. the IRIS transmitter
+        async::run_ready();
+
+        sched::idle();
     }
 }
@@ -0,0 +1,119 @@
+#include <containers/hash_map.h>
+#include <test.h>
+
+namespace {
+
+inline constexpr size_t MAP_SLOTS = 8;
+
+// Places key k in home slot k % MAP_SLOTS, so tests choose where probe runs start
+struct slot_hash {
+    uint64_t operator()(uint64_t key) const {
+        return (key % MAP_SLOTS) << 61;
+    }
+};
+
+using map = containers::hash_map<uint64_t, uint64_t, MAP_SLOTS, slot_hash>;
+
+bool has(map& m, uint64_t key, uint64_t value) {
+    const uint64_t* found = m.find(key);
+    return found && *found == value;
+}
+
+} // namespace
+
+TEST(insert_find_and_replace) {
+    map m;
+
+    EXPECT(m.insert(1, 10));
+    EXPECT(m.insert(9, 90));
+    EXPECT(has(m, 1, 10) && has(m, 9, 90));
+    EXPECT(m.find(17) == nullptr);
+
+    EXPECT(m.insert(1, 11));
+    EXPECT(has(m, 1, 11) && m.size() == 2);
+}
+
+TEST(full_map_rejects_new_keys_only) {
+    map m;
+    for (uint64_t key = 0; key < MAP_SLOTS; ++key) {
+        EXPECT(m.insert(key, key));
+    }
+
+    EXPECT(!m.insert(100, 0));
+    EXPECT(m.insert(3, 33) && has(m, 3, 33));
+    EXPECT(m.find(100) == nullptr);
+}
+
+// Keys 7, 15 and 23 share home slot 7, so 15 and 23 wrap to slots 0 and 1 and push key 0 to 2
+TEST(erase_shifts_back_across_table_end) {
+    map m;
+    m.insert(7, 70);
+    m.insert(15, 150);
+    m.insert(23, 230);
+    m.insert(0, 0);
+
+    EXPECT(m.erase(7));
+    EXPECT(m.find(7) == nullptr);
+    EXPECT(has(m, 15, 150) && has(m, 23, 230) && has(m, 0, 0));
+    EXPECT(m.size() == 3);
+
+    // The run moved back one slot each, so slot 2 is free for key 2 at its home again
+    EXPECT(m.insert(2, 20));
+    EXPECT(has(m, 2, 20) && has(m, 0, 0));
+}
+
+TEST(probe_chain_survives_erase_in_middle) {
+    map m;
+    m.insert(7, 70);
+    m.insert(15, 150);
+    m.insert(23, 230);
+    m.insert(31, 310);
+
+    EXPECT(m.erase(15));
+    EXPECT(has(m, 7, 70) && has(m, 23, 230) && has(m, 31, 310));
+
+    EXPECT(m.erase(31));
+    EXPECT(has(m, 7, 70) && has(m, 23, 230));
+    EXPECT(m.find(15) == nullptr && m.find(31) == nullptr);
+    EXPECT(m.size() == 2);
+}
+
+// Key 1 sits at its home slot right after the hole, it must not be moved into it
+TEST(erase_leaves_entries_at_home) {
+    map m;
+    m.insert(0, 0);
+    m.insert(8, 80);
+    m.insert(2, 20);
+    m.insert(10, 100);
+
+    EXPECT(m.erase(0));
+    EXPECT(has(m, 8, 80) && has(m, 2, 20) && has(m, 10, 100));
+
+    EXPECT(m.erase(2));
+    EXPECT(has(m, 8, 80) && has(m, 10, 100));
+}
+
+TEST(erase_missing_key) {
+    map m;
+    EXPECT(!m.erase(5));
+
+    m.insert(5, 50);
+    m.insert(13, 130);
+    EXPECT(!m.erase(21));
+    EXPECT(m.size() == 2);
+}
+
+TEST(erase_in_full_map) {
+    map m;
+    for (uint64_t key = 0; key < MAP_SLOTS; ++key) {
+        m.insert(key * MAP_SLOTS + 3, key);
+    }
+
+    for (uint64_t key = 0; key < MAP_SLOTS; key += 2) {
+        EXPECT(m.erase(key * MAP_SLOTS + 3));
+    }
+    for (uint64_t key = 1; key < MAP_SLOTS; key += 2) {
+        EXPECT(has(m, key * MAP_SLOTS + 3, key));
+    }
+    EXPECT(m.size() == MAP_SLOTS / 2);
+}
@@ -0,0 +1,71 @@
+#include <containers/intrusive_list.h>
+#include <test.h>
+
+namespace {
+
+struct item {
+    containers::list_node<item> link;
+    int value;
+};
+
+using list = containers::intrusive_list<item, &item::link>;
+
+// True if the list holds exactly `values` in order, checked in both directions
+bool holds(const list& l, const int* values, size_t count) {
+    size_t i = 0;
+    for (item* it : l) {
+        if (i >= count || it->value != values[i]) {
+            return false;
+        }
+        ++i;
+    }
+
+    for (item* it = l.back(); it; it = it->link.prev) {
+        if (i == 0 || it->value != values[--i]) {
+            return false;
+        }
+    }
+
+    return i == 0 && l.size() == count;
+}
+
+} // namespace
+
+TEST(push_and_pop_at_both_ends) {
+    list l;
+    item items[3] = {{{}, 0}, {{}, 1}, {{}, 2}};
+
+    l.push_back(&items[1]);
+    l.push_front(&items[0]);
+    l.push_back(&items[2]);
+
+    const int expected[] = {0, 1, 2};
+    EXPECT(holds(l, expected, 3));
+
+    EXPECT(l.pop_front() == &items[0]);
+    EXPECT(l.pop_back() == &items[2]);
+    EXPECT(l.pop_back() == &items[1]);
+    EXPECT(l.empty() && l.pop_front() == nullptr);
+}
+
+TEST(insert_after_and_remove_keep_links) {
+    list l;
+    item items[4] = {{{}, 0}, {{}, 1}, {{}, 2}, {{}, 3}};
+
+    l.push_back(&items[0]);
+    l.push_back(&items[2]);
+    l.insert_after(&items[0], &items[1]);
+    l.insert_after(&items[2], &items[3]);
+
+    const int all[] = {0, 1, 2, 3};
+    EXPECT(holds(l, all, 4));
+
+    l.remove(&items[1]);
+    l.remove(&items[3]);
+    const int rest[] = {0, 2};
+    EXPECT(holds(l, rest, 2));
+
+    l.remove(&items[0]);
+    l.remove(&items[2]);
+    EXPECT(l.empty() && l.front() == nullptr && l.back() == nullptr);
+}
@@ -0,0 +1,70 @@
+#include <containers/mpmc_queue.h>
+#include <test.h>
+
+using queue = containers::mpmc_queue<uint64_t, 4>;
+
+TEST(zero_initialized_queue_is_empty) {
+    static queue q;
+    uint64_t value = 7;
+
+    EXPECT(!q.try_pop(&value));
+    EXPECT(value == 7);
+}
+
+TEST(full_queue_rejects_push_until_popped) {
+    queue q;
+    for (uint64_t i = 0; i < queue::capacity(); ++i) {
+        EXPECT(q.try_push(i));
+    }
+    EXPECT(!q.try_push(99));
+
+    uint64_t value;
+    EXPECT(q.try_pop(&value) && value == 0);
+    EXPECT(q.try_push(4));
+    EXPECT(!q.try_push(99));
+
+    for (uint64_t expected = 1; expected <= 4; ++expected) {
+        EXPECT(q.try_pop(&value) && value == expected);
+    }
+    EXPECT(!q.try_pop(&value));
+}
+
+// Slot sequences are stored relative to the slot index, every lap must hand them over again
+TEST(fifo_order_across_laps) {
+    queue q;
+    uint64_t next_push = 0;
+    uint64_t next_pop = 0;
+
+    for (int lap = 0; lap < 1000; ++lap) {
+        for (int i = 0; i < 3; ++i) {
+            EXPECT(q.try_push(next_push++));
+        }
+        for (int i = 0; i < 3; ++i) {
+            uint64_t value;
+            EXPECT(q.try_pop(&value) && value == next_pop++);
+        }
+    }
+
+    uint64_t value;
+    EXPECT(!q.try_pop(&value));
+}
+
+TEST(full_and_empty_after_wrap) {
+    queue q;
+    uint64_t value;
+
+    for (uint64_t i = 0; i < 3; ++i) {
+        q.try_push(i);
+        q.try_pop(&value);
+    }
+
+    for (uint64_t i = 0; i < queue::capacity(); ++i) {
+        EXPECT(q.try_push(10 + i));
+    }
+    EXPECT(!q.try_push(99));
+
+    for (uint64_t i = 0; i < queue::capacity(); ++i) {
+        EXPECT(q.try_pop(&value) && value == 10 + i);
+    }
+    EXPECT(!q.try_pop(&value));
+}
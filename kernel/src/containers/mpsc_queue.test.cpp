@@ -0,0 +1,69 @@
+#include <containers/mpsc_queue.h>
+#include <test.h>
+
+namespace {
+
+struct item {
+    item* next;
+    int value;
+};
+
+using queue = containers::mpsc_queue<item, &item::next>;
+
+} // namespace
+
+TEST(empty_queue_takes_nothing) {
+    queue q;
+
+    EXPECT(q.empty());
+    EXPECT(q.take_all() == nullptr);
+}
+
+TEST(push_reports_whether_queue_was_empty) {
+    queue q;
+    item items[3] = {};
+
+    EXPECT(q.push(&items[0]));
+    EXPECT(!q.push(&items[1]));
+    EXPECT(!q.push(&items[2]));
+    EXPECT(!q.empty());
+
+    q.take_all();
+    EXPECT(q.empty());
+    EXPECT(q.push(&items[0]));
+}
+
+TEST(take_all_returns_push_order) {
+    queue q;
+    item items[5] = {};
+    for (int i = 0; i < 5; ++i) {
+        items[i].value = i;
+        q.push(&items[i]);
+    }
+
+    int expected = 0;
+    for (item* it = q.take_all(); it; it = it->next) {
+        EXPECT(it->value == expected);
+        ++expected;
+    }
+    EXPECT(expected == 5);
+    EXPECT(q.empty());
+}
+
+TEST(batches_keep_their_own_order) {
+    queue q;
+    item first[2] = {{nullptr, 0}, {nullptr, 1}};
+    item second[2] = {{nullptr, 2}, {nullptr, 3}};
+
+    q.push(&first[0]);
+    q.push(&first[1]);
+    item* batch = q.take_all();
+
+    q.push(&second[0]);
+    q.push(&second[1]);
+
+    EXPECT(batch == &first[0] && batch->next == &first[1] && first[1].next == nullptr);
+
+    batch = q.take_all();
+    EXPECT(batch == &second[0] && batch->next == &second[1] && second[1].next == nullptr);
+}
@@ -0,0 +1,115 @@
+#include <containers/radix_tree.h>
+#include <test.h>
+
+namespace {
+
+using tree32 = containers::radix_tree<int, 64, 32>;
+using tree64 = containers::radix_tree<int, 64, 64>;
+
+// Six levels for 32-bit keys, so the first key takes six nodes and the pool fits one more path
+using small_tree = containers::radix_tree<int, 8, 32>;
+
+} // namespace
+
+TEST(insert_and_erase_32_bit_keys) {
+    static tree32 tree;
+    int values[3] = {};
+    const uint64_t keys[3] = {0, 0xFFFFFFFFULL, 1ULL << 31};
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT(tree.insert(keys[i], &values[i]));
+    }
+    for (int i = 0; i < 3; ++i) {
+        EXPECT(tree.find(keys[i]) == &values[i]);
+    }
+    EXPECT(tree.size() == 3);
+
+    EXPECT(!tree.insert(1ULL << 32, &values[0]));
+    EXPECT(tree.find(1ULL << 32) == nullptr);
+    EXPECT(tree.find(1) == nullptr);
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT(tree.erase(keys[i]) == &values[i]);
+        EXPECT(tree.find(keys[i]) == nullptr);
+    }
+    EXPECT(tree.size() == 0 && tree.nodes_used() == 0);
+}
+
+TEST(insert_and_erase_64_bit_keys) {
+    static tree64 tree;
+    int values[3] = {};
+    const uint64_t keys[3] = {0, ~0ULL, 1ULL << 63};
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT(tree.insert(keys[i], &values[i]));
+    }
+    for (int i = 0; i < 3; ++i) {
+        EXPECT(tree.find(keys[i]) == &values[i]);
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT(tree.erase(keys[i]) == &values[i]);
+    }
+    EXPECT(tree.size() == 0 && tree.nodes_used() == 0);
+}
+
+TEST(replace_keeps_size) {
+    static tree32 tree;
+    int first = 0;
+    int second = 0;
+
+    EXPECT(tree.insert(42, &first));
+    EXPECT(tree.insert(42, &second));
+    EXPECT(tree.find(42) == &second && tree.size() == 1);
+    EXPECT(!tree.insert(43, nullptr));
+
+    EXPECT(tree.erase(42) == &second);
+    EXPECT(tree.erase(42) == nullptr);
+}
+
+// Keys 0 and 1 share every node, the path is only freed with the last of them
+TEST(erase_frees_only_empty_nodes) {
+    static tree32 tree;
+    int values[2] = {};
+
+    tree.insert(0, &values[0]);
+    tree.insert(1, &values[1]);
+    size_t path_nodes = tree.nodes_used();
+    EXPECT(path_nodes == tree32::LEVELS);
+
+    tree.erase(0);
+    EXPECT(tree.nodes_used() == path_nodes);
+    EXPECT(tree.find(1) == &values[1]);
+
+    tree.erase(1);
+    EXPECT(tree.nodes_used() == 0);
+}
+
+TEST(exhausted_pool_leaves_tree_unchanged) {
+    static small_tree tree;
+    int values[4] = {};
+
+    EXPECT(tree.insert(0, &values[0]));
+    EXPECT(tree.nodes_used() == small_tree::LEVELS);
+
+    // Differs below the root, needs five new nodes with two left
+    EXPECT(!tree.insert(1ULL << 30, &values[1]));
+    EXPECT(tree.nodes_used() == small_tree::LEVELS);
+    EXPECT(tree.find(1ULL << 30) == nullptr && tree.find(0) == &values[0]);
+
+    // Differs only in the lowest node level, needs one
+    EXPECT(tree.insert(1ULL << 6, &values[2]));
+    EXPECT(tree.nodes_used() == small_tree::LEVELS + 1);
+
+    // Needs two with one left
+    EXPECT(!tree.insert(1ULL << 12, &values[3]));
+    EXPECT(tree.nodes_used() == small_tree::LEVELS + 1);
+    EXPECT(tree.size() == 2);
+
+    // Every node goes back to the pool and can hold the path that did not fit before
+    tree.erase(0);
+    tree.erase(1ULL << 6);
+    EXPECT(tree.nodes_used() == 0);
+    EXPECT(tree.insert(1ULL << 30, &values[1]));
+    EXPECT(tree.find(1ULL << 30) == &values[1]);
+}
@@ -0,0 +1,71 @@
+#include <containers/spsc_ring.h>
+#include <test.h>
+
+using ring = containers::spsc_ring<uint32_t, 4>;
+
+TEST(empty_ring_pops_nothing) {
+    ring r;
+    uint32_t value = 7;
+
+    EXPECT(r.empty());
+    EXPECT(!r.try_pop(&value));
+    EXPECT(value == 7);
+}
+
+TEST(full_ring_rejects_push_until_popped) {
+    ring r;
+    for (uint32_t i = 0; i < ring::capacity(); ++i) {
+        EXPECT(r.try_push(i));
+    }
+
+    EXPECT(r.size() == ring::capacity());
+    EXPECT(!r.try_push(99));
+
+    uint32_t value;
+    EXPECT(r.try_pop(&value) && value == 0);
+    EXPECT(r.try_push(4));
+    EXPECT(!r.try_push(99));
+
+    for (uint32_t expected = 1; expected <= 4; ++expected) {
+        EXPECT(r.try_pop(&value) && value == expected);
+    }
+    EXPECT(r.empty());
+}
+
+// Three entries per lap keep the indices moving across the end of the array
+TEST(fifo_order_across_index_wrap) {
+    ring r;
+    uint32_t next_push = 0;
+    uint32_t next_pop = 0;
+
+    for (int lap = 0; lap < 1000; ++lap) {
+        for (int i = 0; i < 3; ++i) {
+            EXPECT(r.try_push(next_push++));
+        }
+        for (int i = 0; i < 3; ++i) {
+            uint32_t value;
+            EXPECT(r.try_pop(&value) && value == next_pop++);
+        }
+        EXPECT(r.empty());
+    }
+}
+
+TEST(full_and_empty_after_wrap) {
+    ring r;
+    uint32_t value;
+
+    for (uint32_t i = 0; i < 3; ++i) {
+        r.try_push(i);
+        r.try_pop(&value);
+    }
+
+    for (uint32_t i = 0; i < ring::capacity(); ++i) {
+        EXPECT(r.try_push(10 + i));
+    }
+    EXPECT(!r.try_push(99));
+
+    for (uint32_t i = 0; i < ring::capacity(); ++i) {
+        EXPECT(r.try_pop(&value) && value == 10 + i);
+    }
+    EXPECT(!r.try_pop(&value));
+}
@@ -0,0 +1,270 @@
+#include <boot/boot_info.h>
+#include <fs/initramfs.h>
+#include <iris/iris.h>
+#include <memory/memory.h>
+
+namespace fs::initramfs {
+
+inline constexpr size_t TAR_BLOCK_SIZE = 512;
+
+// POSIX ustar header, every numeric field is ASCII octal
+struct ustar_header {
+    char name[100];
+    char mode[8];
+    char uid[8];
+    char gid[8];
+    char size[12];
+    char mtime[12];
+    char checksum[8];
+    char typeflag;
+    char linkname[100];
+    char magic[6];
+    char version[2];
+    char uname[32];
+    char gname[32];
+    char devmajor[8];
+    char devminor[8];
+    char prefix[155];
+    char padding[12];
+} __attribute__((packed));
+
+static_assert(sizeof(ustar_header) == TAR_BLOCK_SIZE, "ustar header must fill one block");
+
+inline constexpr char TYPE_REGULAR = '0';
+inline constexpr char TYPE_REGULAR_OLD = '\0';
+
+inline constexpr uint32_t FNV_OFFSET_BASIS = 2166136261U;
+inline constexpr uint32_t FNV_PRIME = 16777619U;
+
+static file g_files[MAX_FILES];
+static size_t g_file_count = 0;
+
+static uint64_t parse_octal(const char* field, size_t length) {
+    uint64_t value = 0;
+
+    for (size_t i = 0; i < length; ++i) {
+        char digit = field[i];
+        if (digit == ' ') {
+            continue;
+        }
+        if (digit < '0' || digit > '7') {
+            break;
+        }
+        value = (value << 3) | static_cast<uint64_t>(digit - '0');
+    }
+
+    return value;
+}
+
+static size_t field_length(const char* field, size_t capacity) {
+    size_t length = 0;
+    while (length < capacity && field[length] != '\0') {
+        ++length;
+    }
+    return length;
+}
+
+static bool is_block_zero(const uint8_t* block) {
+    for (size_t i = 0; i < TAR_BLOCK_SIZE; ++i) {
+        if (block[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool verify_checksum(const ustar_header* header) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(header);
+    uint64_t sum = 0;
+
+    // The checksum field itself is summed as if it were filled with spaces
+    for (size_t i = 0; i < TAR_BLOCK_SIZE; ++i) {
+        bool in_checksum = i >= offsetof(ustar_header, checksum) &&
+                           i < offsetof(ustar_header, checksum) + sizeof(header->checksum);
+        sum += in_checksum ? static_cast<uint8_t>(' ') : bytes[i];
+    }
+
+    return sum == parse_octal(header->checksum, sizeof(header->checksum));
+}
+
+static uint32_t hash_bytes(uint32_t hash, const char* bytes, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(bytes[i])) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Drops leading "./" and "/" components so archive paths and lookups agree
+static void strip_leading_separators(const char** path, size_t* length) {
+    while (*length > 0) {
+        if ((*path)[0] == '/') {
+            ++*path;
+            --*length;
+        } else if (*length >= 2 && (*path)[0] == '.' && (*path)[1] == '/') {
+            *path += 2;
+            *length -= 2;
+        } else {
+            break;
+        }
+    }
+}
+
+static void index_file(const ustar_header* header, const uint8_t* data, uint64_t size) {
+    if (g_file_count >= MAX_FILES) {
+        return;
+    }
+
+    file* entry = &g_files[g_file_count];
+
+    entry->prefix = header->prefix;
+    entry->prefix_length = field_length(header->prefix, sizeof(header->prefix));
+    entry->name = header->name;
+    entry->name_length = field_length(header->name, sizeof(header->name));
+
+    if (entry->prefix_length > 0) {
+        strip_leading_separators(&entry->prefix, &entry->prefix_length);
+    } else {
+        strip_leading_separators(&entry->name, &entry->name_length);
+    }
+
+    if (entry->name_length == 0) {
+        return;
+    }
+
+    uint32_t hash = hash_bytes(FNV_OFFSET_BASIS, entry->prefix, entry->prefix_length);
+    if (entry->prefix_length > 0) {
+        hash = hash_bytes(hash, "/", 1);
+    }
+    entry->path_hash = hash_bytes(hash, entry->name, entry->name_length);
+
+    entry->mode = static_cast<uint32_t>(parse_octal(header->mode, sizeof(header->mode)));
+    entry->data = data;
+    entry->size = size;
+
+    ++g_file_count;
+}
+
+static bool path_matches(const file* entry, const char* path, size_t length) {
+    size_t expected = entry->prefix_length > 0 ? entry->prefix_length + 1 + entry->name_length
+                                               : entry->name_length;
+    if (length != expected) {
+        return false;
+    }
+
+    if (entry->prefix_length > 0) {
+        if (memory::memcmp(path, entry->prefix, entry->prefix_length) != 0 ||
+            path[entry->prefix_length] != '/') {
+            return false;
+        }
+
+        path += entry->prefix_length + 1;
+    }
+
+    return memory::memcmp(path, entry->name, entry->name_length) == 0;
+}
+
+bool mount(const void* archive, uint64_t size) {
+    const auto* block = static_cast<const uint8_t*>(archive);
+    const uint8_t* end = block + size;
+
+    g_file_count = 0;
+
+    while (block + TAR_BLOCK_SIZE <= end) {
+        // Two zero blocks mark the end of the archive, one is enough to stop
+        if (is_block_zero(block)) {
+            return true;
+        }
+
+        const auto* header = reinterpret_cast<const ustar_header*>(block);
+        if (memory::memcmp(header->magic, "ustar", 5) != 0 || !verify_checksum(header)) {
+            return false;
+        }
+
+        uint64_t file_size = parse_octal(header->size, sizeof(header->size));
+        const uint8_t* data = block + TAR_BLOCK_SIZE;
+
+        if (file_size > static_cast<uint64_t>(end - data)) {
+            return false;
+        }
+
+        if (header->typeflag == TYPE_REGULAR || header->typeflag == TYPE_REGULAR_OLD) {
+            index_file(header, data, file_size);
+        }
+
+        // Contents are padded to a whole number of blocks
+        block = data + ((file_size + TAR_BLOCK_SIZE - 1) & ~(TAR_BLOCK_SIZE - 1));
+    }
+
+    return true;
+}
+
+bool mount_boot_module() {
+    const boot::boot_module* module = boot::find_boot_module(MODULE_CMDLINE);
+    if (!module || !mount(module->data, module->size)) {
+        return false;
+    }
+
+    mount_payload payload = {.phys_start = module->phys_start,
+                             .size = module->size,
+                             .total_bytes = 0,
+                             .file_count = static_cast<uint32_t>(g_file_count),
+                             .reserved = 0};
+
+    for (size_t i = 0; i < g_file_count; ++i) {
+        payload.total_bytes += g_files[i].size;
+    }
+
+    iris::emit_with_payload(iris::EVENT_INITRAMFS_MOUNTED, 0, 0, &payload, sizeof(payload));
+    return true;
+}
+
+bool open(const char* path, file_handle* handle) {
+    size_t length = field_length(path, SIZE_MAX);
+    strip_leading_separators(&path, &length);
+
+    uint32_t hash = hash_bytes(FNV_OFFSET_BASIS, path, length);
+
+    for (size_t i = 0; i < g_file_count; ++i) {
+        const file* entry = &g_files[i];
+
+        if (entry->path_hash == hash && path_matches(entry, path, length)) {
+            handle->node = entry;
+            handle->offset = 0;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t read(file_handle* handle, void* buffer, size_t length) {
+    const file* node = handle->node;
+
+    if (handle->offset >= node->size) {
+        return 0;
+    }
+
+    uint64_t remaining = node->size - handle->offset;
+    if (length > remaining) {
+        length = remaining;
+    }
+
+    memory::memcpy(buffer, node->data + handle->offset, length);
+    handle->offset += length;
+
+    return length;
+}
+
+size_t file_count() {
+    return g_file_count;
+}
+
+const file* file_at(size_t index) {
+    if (index >= g_file_count) {
+        return nullptr;
+    }
+
+    return &g_files[index];
+}
+
+} // namespace fs::initramfs
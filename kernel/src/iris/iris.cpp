@@ -1,8 +1,100 @@
+#include <async/completion.h>
+#include <async/task.h>
+#include <containers/spsc_ring.h>
 #include <iris/iris.h>
+#include <iris/tracepoint.h>
 #include <serial/serial.h>
+#include <sync/spinlock.h>
 
 namespace iris {
 
+static bool g_initialized = false;
+
+// Keeps packets from different CPUs and interrupt handlers from interleaving on the wire
+static sync::spinlock g_transmit_lock;
+
+// Packet bytes waiting for the transmitter coroutine, pushed and popped under g_transmit_lock
+static containers::spsc_ring<uint8_t, PACKET_QUEUE_SIZE> g_packet_queue;
+static async::completion g_packets_queued;
+static bool g_async_transmission = false;
+static bool g_transmitter_started = false;
+
+// Writes every queued byte with the blocking path, the caller holds g_transmit_lock
+static void drain_packet_queue() {
+    uint8_t chunk[serial::TRANSMIT_FIFO_SIZE];
+
+    while (true) {
+        uint32_t count = 0;
+        while (count < sizeof(chunk) && g_packet_queue.try_pop(&chunk[count])) {
+            ++count;
+        }
+        if (count == 0) {
+            return;
+        }
+
+        serial::write_raw(IRIS_SERIAL_PORT, chunk, count);
+    }
+}
+
+// Queues or sends one packet, the caller holds g_transmit_lock
+static bool transmit(const packet& pkt, const void* payload, uint16_t payload_size) {
+    if (!payload) {
+        payload_size = 0;
+    }
+
+    size_t size = sizeof(pkt) + payload_size;
+
+    if (g_async_transmission &&
+        g_packet_queue.capacity() - g_packet_queue.size() >= size) {
+        const auto* header = reinterpret_cast<const uint8_t*>(&pkt);
+        const auto* body = static_cast<const uint8_t*>(payload);
+
+        for (size_t i = 0; i < sizeof(pkt); i++) {
+            g_packet_queue.try_push(header[i]);
+        }
+        for (size_t i = 0; i < payload_size; i++) {
+            g_packet_queue.try_push(body[i]);
+        }
+        return true;
+    }
+
+    // Queue full (or async transmission off), queued packets go first so the order is kept
+    drain_packet_queue();
+
+    // Raw write so binary fields are never subject to newline translation
+    serial::write_raw(IRIS_SERIAL_PORT, &pkt, sizeof(pkt));
+    if (payload_size > 0) {
+        serial::write_raw(IRIS_SERIAL_PORT, payload, payload_size);
+    }
+    return false;
+}
+
+// Moves queued packets to COM2 one transmit FIFO burst per transmit interrupt
+static async::task<void> transmitter() {
+    while (true) {
+        co_await g_packets_queued;
+
+        while (!g_packet_queue.empty()) {
+            co_await serial::wait_transmit_empty(IRIS_SERIAL_PORT);
+
+            sync::irq_spinlock_guard guard(g_transmit_lock);
+
+            // A blocking write may have refilled the FIFO since the wait, then wait again
+            if (!serial::is_transmit_queue_empty(IRIS_SERIAL_PORT)) {
+                continue;
+            }
+
+            uint8_t burst[serial::TRANSMIT_FIFO_SIZE];
+            uint32_t count = 0;
+            while (count < sizeof(burst) && g_packet_queue.try_pop(&burst[count])) {
+                ++count;
+            }
+
+            serial::write_burst(IRIS_SERIAL_PORT, burst, count);
+        }
+    }
+}
+
 void emit(uint16_t event_type, uint64_t timestamp_ns, uint8_t cpu_id) {
     // Build packet on stack - no heap allocation, no copying
     packet pkt = {.magic = PACKET_MAGIC,
@@ -14,9 +106,15 @@ void emit(uint16_t event_type, uint64_t timestamp_ns, uint8_t cpu_id) {
                   .reserved1 = 0,
                   .reserved2 = 0};
 
-    // Single write call - send entire packet at once for efficiency
-    // Cast to char* as serial::write expects, no data copy occurs
-    serial::write(IRIS_SERIAL_PORT, reinterpret_cast<const char*>(&pkt), sizeof(pkt));
+    bool queued;
+    {
+        sync::irq_spinlock_guard guard(g_transmit_lock);
+        queued = transmit(pkt, nullptr, 0);
+    }
+
+    if (queued) {
+        g_packets_queued.signal();
+    }
 }
 
 void emit_with_payload(uint16_t event_type, uint64_t timestamp_ns, uint8_t cpu_id,
@@ -31,23 +129,53 @@ void emit_with_payload(uint16_t event_type, uint64_t timestamp_ns, uint8_t cpu_i
                   .reserved1 = 0,
                   .reserved2 = 0};
 
-    // Send header first
-    serial::write(IRIS_SERIAL_PORT, reinterpret_cast<const char*>(&pkt), sizeof(pkt));
+    bool queued;
+    {
+        sync::irq_spinlock_guard guard(g_transmit_lock);
+        queued = transmit(pkt, payload, payload_size);
+    }
 
-    // Send payload if present
-    if (payload && payload_size > 0) {
-        serial::write(IRIS_SERIAL_PORT, reinterpret_cast<const char*>(payload), payload_size);
+    if (queued) {
+        g_packets_queued.signal();
     }
 }
 
 void init() {
+    scope_trace<tracepoint::IRIS_INIT> trace;
+
     // Initialize COM2 port for IRIS debug output
     // Using 115200 baud for maximum throughput
     serial::init_port(IRIS_SERIAL_PORT, serial::baud_rate_divisor::BAUD_115200);
+    g_initialized = true;
 
     // Emit initialization event to signal IRIS is ready
     // Timestamp is 0 as HPET likely not initialized yet
     emit(EVENT_IRIS_INIT, 0, 0);
 }
 
+bool is_initialized() {
+    return g_initialized;
+}
+
+bool set_async_transmission(bool enabled) {
+    if (enabled && !g_transmitter_started) {
+        if (!async::spawn(transmitter())) {
+            return false;
+        }
+        g_transmitter_started = true;
+    }
+
+    sync::irq_spinlock_guard guard(g_transmit_lock);
+    g_async_transmission = enabled;
+    if (!enabled) {
+        drain_packet_queue();
+    }
+    return true;
+}
+
+void flush() {
+    sync::irq_spinlock_guard guard(g_transmit_lock);
+    drain_packet_queue();
+}
+
 } // namespace iris
@@ -0,0 +1,124 @@
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/percpu/percpu.h>
+#include <arch/x86/smp/smp.h>
+#include <iris/iris.h>
+#include <iris/profiler.h>
+#include <memory/memory.h>
+
+// Bounds of the kernel image (nyros.ld), every valid kernel stack frame lies inside
+EXTERN_C uint8_t __ksymstart[];
+EXTERN_C uint8_t __ksymend[];
+
+namespace iris::profiler {
+
+// Single-producer (timer interrupt) / single-consumer (flush) ring owned by one CPU
+struct sample_ring {
+    uint32_t head; // Written by the producer only
+    uint32_t tail; // Written by the consumer only
+    uint32_t dropped;
+    sample entries[SAMPLE_BUFFER_SIZE];
+};
+
+static sample_ring g_sample_rings[arch::x86::MAX_CPUS];
+static bool g_running = false;
+
+static bool is_kernel_frame(uint64_t frame) {
+    auto start = reinterpret_cast<uint64_t>(__ksymstart);
+    auto end = reinterpret_cast<uint64_t>(__ksymend);
+
+    // A frame holds the saved RBP followed by the return address
+    return (frame & 0x7) == 0 && frame >= start && frame + 2 * sizeof(uint64_t) <= end;
+}
+
+static uint32_t walk_frame_pointers(uint64_t rbp, uint64_t* ips, uint32_t depth) {
+    uint64_t frame = rbp;
+
+    while (depth < MAX_STACK_DEPTH && is_kernel_frame(frame)) {
+        const auto* slots = reinterpret_cast<const uint64_t*>(frame);
+        uint64_t next_frame = slots[0];
+        uint64_t return_address = slots[1];
+
+        if (return_address == 0) {
+            break;
+        }
+
+        ips[depth++] = return_address;
+
+        // The stack grows down, so caller frames always live at higher addresses
+        if (next_frame <= frame) {
+            break;
+        }
+
+        frame = next_frame;
+    }
+
+    return depth;
+}
+
+void start() {
+    __atomic_store_n(&g_running, true, __ATOMIC_RELEASE);
+}
+
+void stop() {
+    __atomic_store_n(&g_running, false, __ATOMIC_RELEASE);
+}
+
+bool is_running() {
+    return __atomic_load_n(&g_running, __ATOMIC_ACQUIRE);
+}
+
+void record_sample(uint64_t rip, uint64_t rbp) {
+    if (!is_running()) {
+        return;
+    }
+
+    sample_ring* ring = &g_sample_rings[arch::x86::current_cpu()];
+
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail >= SAMPLE_BUFFER_SIZE) {
+        ++ring->dropped;
+        return;
+    }
+
+    sample* entry = &ring->entries[head & (SAMPLE_BUFFER_SIZE - 1)];
+    entry->tsc = arch::x86::rdtsc();
+    entry->ips[0] = rip;
+    entry->depth = walk_frame_pointers(rbp, entry->ips, 1);
+    entry->dropped = ring->dropped;
+    ring->dropped = 0;
+
+    // Publish the entry only after it is fully written
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+// Streams the samples buffered on one CPU, the flushing CPU is the ring's only consumer
+static void flush_ring(int cpu) {
+    sample_ring* ring = &g_sample_rings[cpu];
+
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    while (tail != head) {
+        // Copy out so the slot can be released before the slow serial transmission
+        sample entry;
+        memory::memcpy(&entry, &ring->entries[tail & (SAMPLE_BUFFER_SIZE - 1)], sizeof(sample));
+        __atomic_store_n(&ring->tail, ++tail, __ATOMIC_RELEASE);
+
+        auto payload_size =
+            static_cast<uint16_t>(SAMPLE_HEADER_SIZE + entry.depth * sizeof(uint64_t));
+        emit_with_payload(EVENT_PROFILE_SAMPLE, 0, static_cast<uint8_t>(cpu), &entry,
+                          payload_size);
+
+        head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    }
+}
+
+void flush() {
+    for (int cpu = 0; cpu < arch::x86::online_cpu_count(); ++cpu) {
+        flush_ring(cpu);
+    }
+}
+
+} // namespace iris::profiler
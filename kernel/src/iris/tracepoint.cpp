@@ -0,0 +1,84 @@
+#include <arch/x86/smp/smp.h>
+#include <iris/iris.h>
+#include <iris/tracepoint.h>
+
+namespace iris {
+
+DEFINE_PER_CPU(tracepoint_stats, g_tracepoint_stats[TRACEPOINT_COUNT]);
+
+// Scopes that completed before the per-CPU areas existed, always on the BSP
+static tracepoint_stats g_early_tracepoint_stats[TRACEPOINT_COUNT];
+
+void account_early_scope(tracepoint id, uint64_t cycles) {
+    tracepoint_stats* stats = &g_early_tracepoint_stats[static_cast<size_t>(id)];
+
+    ++stats->calls;
+    stats->total_cycles += cycles;
+
+    if (cycles > stats->max_cycles) {
+        stats->max_cycles = cycles;
+    }
+}
+
+void emit_scope(tracepoint id, uint64_t start_tsc, uint64_t cycles) {
+    if (!is_initialized()) {
+        return;
+    }
+
+    trace_scope_payload payload = {.start_tsc = start_tsc,
+                                   .cycles = cycles,
+                                   .id = static_cast<uint16_t>(id),
+                                   .reserved1 = 0,
+                                   .reserved2 = 0};
+
+    uint8_t cpu = 0;
+    if (arch::x86::per_cpu_online()) {
+        cpu = static_cast<uint8_t>(arch::x86::current_cpu());
+    }
+
+    emit_with_payload(EVENT_TRACE_SCOPE, 0, cpu, &payload, sizeof(payload));
+}
+
+// Emits the counters of one CPU, read without synchronization from the caller
+static void emit_cpu_tracepoint_stats(int cpu) {
+    const tracepoint_stats* percpu_stats = arch::x86::per_cpu_ptr(g_tracepoint_stats, cpu);
+
+    for (size_t i = 0; i < TRACEPOINT_COUNT; ++i) {
+        tracepoint_stats_payload payload = {.calls = percpu_stats[i].calls,
+                                            .total_cycles = percpu_stats[i].total_cycles,
+                                            .max_cycles = percpu_stats[i].max_cycles,
+                                            .id = static_cast<uint16_t>(i),
+                                            .reserved1 = 0,
+                                            .reserved2 = 0};
+
+        // Early boot ran on the BSP before its per-CPU area was set up
+        if (cpu == 0) {
+            const tracepoint_stats& early = g_early_tracepoint_stats[i];
+
+            payload.calls += early.calls;
+            payload.total_cycles += early.total_cycles;
+            if (early.max_cycles > payload.max_cycles) {
+                payload.max_cycles = early.max_cycles;
+            }
+        }
+
+        if (payload.calls == 0) {
+            continue;
+        }
+
+        emit_with_payload(EVENT_TRACEPOINT_STATS, 0, static_cast<uint8_t>(cpu), &payload,
+                          sizeof(payload));
+    }
+}
+
+void emit_tracepoint_stats() {
+    if (!arch::x86::per_cpu_online()) {
+        return;
+    }
+
+    for (int cpu = 0; cpu < arch::x86::online_cpu_count(); ++cpu) {
+        emit_cpu_tracepoint_stats(cpu);
+    }
+}
+
+} // namespace iris
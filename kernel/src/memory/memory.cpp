@@ -1,8 +1,41 @@
+#include <arch/x86/cpu/features.h>
+#include <arch/x86/cpu/static_key.h>
+#include <iris/tracepoint.h>
 #include <memory/memory.h>
 
 namespace memory {
 
+// Shorter copies and fills keep the loops below, REP string start-up costs more than they save
+inline constexpr size_t REP_STRING_THRESHOLD = 128;
+
+// Enhanced REP MOVSB/STOSB, the microcode moves whole cache lines regardless of alignment
+static arch::x86::static_key g_rep_string;
+
+// Fast short REP MOVSB, copies of any length are quicker as a single instruction
+static arch::x86::static_key g_fast_short_rep_movsb;
+
+static bool use_rep_movsb(size_t count) {
+    if (!arch::x86::static_branch_likely(g_rep_string)) {
+        return false;
+    }
+    return count >= REP_STRING_THRESHOLD ||
+           arch::x86::static_branch_unlikely(g_fast_short_rep_movsb);
+}
+
+static bool use_rep_stosb(size_t count) {
+    return arch::x86::static_branch_likely(g_rep_string) && count >= REP_STRING_THRESHOLD;
+}
+
+void init_string_operations() {
+    arch::x86::set_static_key(&g_rep_string, arch::x86::has_feature(arch::x86::cpu_feature::ERMS));
+    arch::x86::set_static_key(&g_fast_short_rep_movsb,
+                              arch::x86::has_feature(arch::x86::cpu_feature::ERMS) &&
+                                  arch::x86::has_feature(arch::x86::cpu_feature::FSRM));
+}
+
 int memcmp(const void* lhs, const void* rhs, size_t count) {
+    iris::scope_trace<iris::tracepoint::MEMORY_MEMCMP, iris::trace_mode::COUNTERS_ONLY> trace;
+
     if (lhs == rhs) {
         return 0;
     }
@@ -47,6 +80,8 @@ int memcmp(const void* lhs, const void* rhs, size_t count) {
 }
 
 void* memcpy(void* dest, const void* src, size_t count) {
+    iris::scope_trace<iris::tracepoint::MEMORY_MEMCPY, iris::trace_mode::COUNTERS_ONLY> trace;
+
     if (dest == src || count == 0) {
         return dest;
     }
@@ -54,6 +89,11 @@ void* memcpy(void* dest, const void* src, size_t count) {
     auto* dst_bytes = static_cast<uint8_t*>(dest);
     const auto* src_bytes = static_cast<const uint8_t*>(src);
 
+    if (use_rep_movsb(count)) {
+        asm volatile("rep movsb" : "+D"(dst_bytes), "+S"(src_bytes), "+c"(count) : : "memory");
+        return dest;
+    }
+
     // Word-aligned copy for better performance
     while (count >= sizeof(uint64_t) &&
            (reinterpret_cast<uintptr_t>(dst_bytes) & (sizeof(uint64_t) - 1)) == 0 &&
@@ -88,6 +128,8 @@ void* memcpy(void* dest, const void* src, size_t count) {
 }
 
 void* memmove(void* dest, const void* src, size_t count) {
+    iris::scope_trace<iris::tracepoint::MEMORY_MEMMOVE, iris::trace_mode::COUNTERS_ONLY> trace;
+
     if (dest == src || count == 0) {
         return dest;
     }
@@ -118,6 +160,8 @@ void* memmove(void* dest, const void* src, size_t count) {
 }
 
 void* memset(void* dest, int value, size_t count) {
+    iris::scope_trace<iris::tracepoint::MEMORY_MEMSET, iris::trace_mode::COUNTERS_ONLY> trace;
+
     if (count == 0) {
         return dest;
     }
@@ -125,6 +169,11 @@ void* memset(void* dest, int value, size_t count) {
     auto* dst_bytes = static_cast<uint8_t*>(dest);
     auto byte_value = static_cast<uint8_t>(value);
 
+    if (use_rep_stosb(count)) {
+        asm volatile("rep stosb" : "+D"(dst_bytes), "+c"(count) : "a"(byte_value) : "memory");
+        return dest;
+    }
+
     // Create word-sized pattern for optimization
     uint64_t pattern = byte_value;
     pattern |= (pattern << 8);
@@ -161,12 +210,19 @@ void* memset(void* dest, int value, size_t count) {
 }
 
 void* memzero(void* dest, size_t count) {
+    iris::scope_trace<iris::tracepoint::MEMORY_MEMZERO, iris::trace_mode::COUNTERS_ONLY> trace;
+
     if (count == 0) {
         return dest;
     }
 
     auto* dst_bytes = static_cast<uint8_t*>(dest);
 
+    if (use_rep_stosb(count)) {
+        asm volatile("rep stosb" : "+D"(dst_bytes), "+c"(count) : "a"(0) : "memory");
+        return dest;
+    }
+
     // Word-aligned zeroing for better performance
     while (count >= sizeof(uint64_t) &&
            (reinterpret_cast<uintptr_t>(dst_bytes) & (sizeof(uint64_t) - 1)) == 0) {
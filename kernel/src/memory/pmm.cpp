@@ -0,0 +1,190 @@
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/paging/paging.h>
+#include <boot/boot_info.h>
+#include <iris/iris.h>
+#include <memory/pmm.h>
+#include <sync/spinlock.h>
+
+// End of the kernel image including .bss and the per-CPU template (nyros.ld)
+EXTERN_C uint8_t __ksymend[];
+
+namespace memory::pmm {
+
+using arch::x86::PAGE_SIZE;
+
+inline constexpr size_t FRAMES_PER_WORD = 64;
+inline constexpr size_t BITMAP_WORDS = MAX_FRAMES / FRAMES_PER_WORD;
+
+// Bit n of word w is set while frame w * 64 + n is free
+static uint64_t g_free_bitmap[BITMAP_WORDS];
+static size_t g_free_frames = 0;
+
+// Reference count of every frame indexed by PFN, 2 bytes per 4KB frame (512KB for 1GB).
+// Only meaningful while the frame is allocated, updated without the lock.
+static uint16_t g_frame_references[MAX_FRAMES];
+
+// No word below this one has a free bit, allocation scans upwards from here
+static size_t g_search_hint = 0;
+
+static sync::spinlock g_lock;
+
+// Marks the frames fully inside [start, end) free, or reserves every frame touching it
+static void mark_range(uint64_t start, uint64_t end, bool free) {
+    if (end > MANAGED_MEMORY_SIZE) {
+        end = MANAGED_MEMORY_SIZE;
+    }
+
+    uint64_t first;
+    uint64_t last;
+    if (free) {
+        first = (start + PAGE_SIZE - 1) / PAGE_SIZE;
+        last = end / PAGE_SIZE;
+    } else {
+        first = start / PAGE_SIZE;
+        last = (end + PAGE_SIZE - 1) / PAGE_SIZE;
+    }
+
+    for (uint64_t frame = first; frame < last;) {
+        size_t word = frame / FRAMES_PER_WORD;
+        size_t bit = frame % FRAMES_PER_WORD;
+
+        // Whole words at once, the memory map entries are large
+        uint64_t mask = ~0ULL;
+        size_t count = FRAMES_PER_WORD - bit;
+        if (count > last - frame) {
+            count = last - frame;
+        }
+        if (count < FRAMES_PER_WORD) {
+            mask = ((1ULL << count) - 1) << bit;
+        }
+
+        if (free) {
+            g_free_bitmap[word] |= mask;
+        } else {
+            g_free_bitmap[word] &= ~mask;
+        }
+
+        frame += count;
+    }
+}
+
+// Without libgcc there is no __popcountdi2, clear one bit at a time instead
+static size_t count_free_frames() {
+    size_t count = 0;
+
+    for (size_t word = 0; word < BITMAP_WORDS; ++word) {
+        for (uint64_t bits = g_free_bitmap[word]; bits != 0; bits &= bits - 1) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+bool init() {
+    uint64_t start_tsc = arch::x86::rdtsc();
+
+    const auto* mmap = reinterpret_cast<const multiboot::tag_mmap*>(
+        boot::find_boot_tag(multiboot::tag_type::MMAP));
+    if (!mmap || mmap->entry_size < sizeof(multiboot::mmap_entry)) {
+        return false;
+    }
+
+    const auto* entries = reinterpret_cast<const uint8_t*>(mmap->entries);
+    size_t entries_size = mmap->size - sizeof(multiboot::tag_mmap);
+
+    for (size_t offset = 0; offset + mmap->entry_size <= entries_size;
+         offset += mmap->entry_size) {
+        const auto* entry = reinterpret_cast<const multiboot::mmap_entry*>(entries + offset);
+
+        uint64_t base = (static_cast<uint64_t>(entry->base_addr_high) << 32) | entry->base_addr_low;
+        uint64_t length = (static_cast<uint64_t>(entry->length_high) << 32) | entry->length_low;
+
+        if (entry->type == static_cast<uint32_t>(multiboot::memory_type::AVAILABLE) &&
+            base < MANAGED_MEMORY_SIZE) {
+            mark_range(base, base + length, true);
+        }
+    }
+
+    size_t available_frames = count_free_frames();
+
+    // Low memory, the bootstrap section and the higher-half image are one contiguous range
+    mark_range(0, arch::x86::virt_to_phys(__ksymend), false);
+
+    uint64_t mbi_phys;
+    uint64_t mbi_size;
+    boot::get_boot_info_range(&mbi_phys, &mbi_size);
+    mark_range(mbi_phys, mbi_phys + mbi_size, false);
+
+    for (size_t i = 0; i < boot::boot_module_count(); ++i) {
+        const boot::boot_module* module = boot::get_boot_module(i);
+        mark_range(module->phys_start, module->phys_start + module->size, false);
+    }
+
+    size_t free_frames = count_free_frames();
+    g_free_frames = free_frames;
+    g_search_hint = 0;
+
+    init_payload payload = {.available_frames = available_frames,
+                            .free_frames = free_frames,
+                            .init_cycles = arch::x86::rdtsc() - start_tsc,
+                            .reserved = 0};
+    iris::emit_with_payload(iris::EVENT_PMM_INIT_DONE, 0, 0, &payload, sizeof(payload));
+
+    return true;
+}
+
+uint64_t allocate_frame() {
+    sync::irq_spinlock_guard guard(g_lock);
+
+    for (size_t word = g_search_hint; word < BITMAP_WORDS; ++word) {
+        uint64_t bits = g_free_bitmap[word];
+        if (bits == 0) {
+            continue;
+        }
+
+        size_t frame = word * FRAMES_PER_WORD + __builtin_ctzll(bits);
+        g_free_bitmap[word] = bits & (bits - 1);
+        --g_free_frames;
+        g_search_hint = word;
+
+        __atomic_store_n(&g_frame_references[frame], 1, __ATOMIC_RELAXED);
+        return frame * PAGE_SIZE;
+    }
+
+    g_search_hint = BITMAP_WORDS;
+    return 0;
+}
+
+void share_frame(uint64_t phys) {
+    __atomic_add_fetch(&g_frame_references[phys / PAGE_SIZE], 1, __ATOMIC_RELAXED);
+}
+
+void free_frame(uint64_t phys) {
+    size_t frame = phys / PAGE_SIZE;
+    size_t word = frame / FRAMES_PER_WORD;
+
+    // Orders every access through the dropped mapping before the frame can be handed out again
+    if (__atomic_sub_fetch(&g_frame_references[frame], 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
+    }
+
+    sync::irq_spinlock_guard guard(g_lock);
+
+    g_free_bitmap[word] |= 1ULL << (frame % FRAMES_PER_WORD);
+    ++g_free_frames;
+
+    if (word < g_search_hint) {
+        g_search_hint = word;
+    }
+}
+
+uint16_t frame_reference_count(uint64_t phys) {
+    return __atomic_load_n(&g_frame_references[phys / PAGE_SIZE], __ATOMIC_ACQUIRE);
+}
+
+size_t free_frame_count() {
+    return __atomic_load_n(&g_free_frames, __ATOMIC_RELAXED);
+}
+
+} // namespace memory::pmm
@@ -0,0 +1,223 @@
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/percpu/percpu.h>
+#include <containers/mpmc_queue.h>
+#include <memory/pmm.h>
+#include <net/net.h>
+#include <sync/spinlock.h>
+
+namespace net {
+
+inline constexpr size_t BUFFERS_PER_FRAME = arch::x86::PAGE_SIZE / PACKET_BUFFER_SIZE;
+
+static packet g_packets[PACKET_POOL_SIZE];
+
+// Lock-free, so receive interrupts refill their rings from it while threads transmit. Twice
+// the pool, a push then never finds its slot still held by a pop that has not finished
+static containers::mpmc_queue<packet*, 2 * PACKET_POOL_SIZE> g_free_packets;
+static size_t g_free_packet_count = 0;
+static bool g_pool_ready = false;
+static sync::spinlock g_pool_lock;
+
+static sync::spinlock g_registry_lock;
+static device* g_devices[MAX_DEVICES];
+static size_t g_device_count = 0;
+
+static bool name_equals(const char* a, const char* b) {
+    for (size_t i = 0; i < NAME_LENGTH; ++i) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+        if (a[i] == '\0') {
+            return true;
+        }
+    }
+    return true;
+}
+
+bool init_pool() {
+    sync::spinlock_guard guard(g_pool_lock);
+    if (g_pool_ready) {
+        return true;
+    }
+
+    size_t count = 0;
+    while (count < PACKET_POOL_SIZE) {
+        uint64_t phys = memory::pmm::allocate_frame();
+        if (!phys) {
+            break;
+        }
+
+        auto* memory = static_cast<uint8_t*>(arch::x86::phys_to_virt(phys));
+        for (size_t i = 0; i < BUFFERS_PER_FRAME; ++i, ++count) {
+            packet* pkt = &g_packets[count];
+            pkt->data = memory + i * PACKET_BUFFER_SIZE + PACKET_HEADROOM;
+            pkt->phys = phys + i * PACKET_BUFFER_SIZE + PACKET_HEADROOM;
+            g_free_packets.try_push(pkt);
+        }
+    }
+
+    __atomic_store_n(&g_free_packet_count, count, __ATOMIC_RELEASE);
+    g_pool_ready = count > 0;
+    return g_pool_ready;
+}
+
+size_t allocate_packets(packet** packets, size_t count) {
+    size_t allocated = 0;
+    while (allocated < count && g_free_packets.try_pop(&packets[allocated])) {
+        packet* pkt = packets[allocated++];
+        pkt->length = 0;
+        pkt->queue = 0;
+        pkt->flags = 0;
+        pkt->checksum_start = 0;
+        pkt->checksum_offset = 0;
+        pkt->next = nullptr;
+    }
+
+    __atomic_sub_fetch(&g_free_packet_count, allocated, __ATOMIC_RELAXED);
+    return allocated;
+}
+
+packet* allocate_packet() {
+    packet* pkt;
+    return allocate_packets(&pkt, 1) == 1 ? pkt : nullptr;
+}
+
+void free_packets(packet* const* packets, size_t count) {
+    // Never fails, see g_free_packets
+    for (size_t i = 0; i < count; ++i) {
+        g_free_packets.try_push(packets[i]);
+    }
+    __atomic_add_fetch(&g_free_packet_count, count, __ATOMIC_RELAXED);
+}
+
+void free_packet(packet* pkt) {
+    free_packets(&pkt, 1);
+}
+
+size_t free_packet_count() {
+    return __atomic_load_n(&g_free_packet_count, __ATOMIC_RELAXED);
+}
+
+bool register_device(device* dev) {
+    sync::spinlock_guard guard(g_registry_lock);
+
+    if (g_device_count >= MAX_DEVICES) {
+        return false;
+    }
+    g_devices[g_device_count] = dev;
+
+    // Readers index the array without the lock
+    __atomic_store_n(&g_device_count, g_device_count + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+size_t device_count() {
+    return __atomic_load_n(&g_device_count, __ATOMIC_ACQUIRE);
+}
+
+device* get_device(size_t index) {
+    return index < device_count() ? g_devices[index] : nullptr;
+}
+
+device* find_device(const char* name) {
+    size_t count = device_count();
+    for (size_t i = 0; i < count; ++i) {
+        if (name_equals(g_devices[i]->name, name)) {
+            return g_devices[i];
+        }
+    }
+    return nullptr;
+}
+
+void set_receive_handler(device* dev, receive_handler handler) {
+    __atomic_store_n(&dev->receive, handler, __ATOMIC_RELEASE);
+}
+
+void deliver(device* dev, packet* const* packets, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    receive_handler handler = __atomic_load_n(&dev->receive, __ATOMIC_ACQUIRE);
+    if (handler) {
+        handler(dev, packets, count);
+    } else {
+        free_packets(packets, count);
+    }
+}
+
+// Stores the checksum a device without offload would have computed
+static void finish_checksum(packet* pkt) {
+    uint32_t start = pkt->checksum_start;
+    uint32_t field = start + pkt->checksum_offset;
+    if (start >= pkt->length || field + 2 > pkt->length) {
+        return;
+    }
+
+    // The field is part of the summed range and holds the pseudo-header sum
+    uint64_t sum = 0;
+    for (uint32_t i = start; i + 1 < pkt->length; i += 2) {
+        sum += static_cast<uint32_t>(pkt->data[i] << 8 | pkt->data[i + 1]);
+    }
+    if ((pkt->length - start) & 1) {
+        sum += static_cast<uint32_t>(pkt->data[pkt->length - 1] << 8);
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+
+    auto checksum = static_cast<uint16_t>(~sum);
+    pkt->data[field] = static_cast<uint8_t>(checksum >> 8);
+    pkt->data[field + 1] = static_cast<uint8_t>(checksum);
+    pkt->flags &= static_cast<uint8_t>(~PACKET_CHECKSUM_PARTIAL);
+}
+
+static uint16_t current_queue(const device* dev) {
+    return static_cast<uint16_t>(static_cast<uint32_t>(arch::x86::current_cpu()) %
+                                 dev->queue_count);
+}
+
+static bool valid(const packet* pkt) {
+    return pkt->length != 0 && pkt->length <= MAX_FRAME_SIZE;
+}
+
+size_t transmit(device* dev, packet* const* packets, size_t count) {
+    uint16_t queue = current_queue(dev);
+    size_t consumed = 0;
+
+    // Valid runs go to the driver as one batch, so they share a notification
+    while (consumed < count) {
+        size_t run = 0;
+        while (consumed + run < count && valid(packets[consumed + run])) {
+            packet* pkt = packets[consumed + run];
+            if ((pkt->flags & PACKET_CHECKSUM_PARTIAL) && !dev->checksum_offload) {
+                finish_checksum(pkt);
+            }
+            ++run;
+        }
+
+        if (run > 0) {
+            size_t accepted = dev->ops->transmit(dev, queue, packets + consumed, run);
+            consumed += accepted;
+            if (accepted < run) {
+                return consumed;
+            }
+            continue;
+        }
+
+        free_packet(packets[consumed++]);
+    }
+    return consumed;
+}
+
+void poll(device* dev) {
+    dev->ops->poll(dev, current_queue(dev));
+}
+
+void poll_all(device* dev) {
+    for (uint16_t queue = 0; dev->polled && queue < dev->queue_count; ++queue) {
+        dev->ops->poll(dev, queue);
+    }
+}
+
+} // namespace net
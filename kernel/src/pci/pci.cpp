@@ -0,0 +1,632 @@
+#include <arch/x86/acpi/acpi.h>
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/paging/paging.h>
+#include <iris/iris.h>
+#include <pci/pci.h>
+#include <ports/ports.h>
+#include <sync/spinlock.h>
+
+namespace pci {
+
+// Legacy configuration mechanism #1, segment 0 and the first 256 bytes only
+inline constexpr uint16_t CONFIG_ADDRESS = 0xCF8;
+inline constexpr uint16_t CONFIG_DATA = 0xCFC;
+inline constexpr uint32_t CONFIG_ENABLE = 1U << 31;
+inline constexpr uint16_t LEGACY_CONFIG_SIZE = 256;
+
+inline constexpr size_t BUS_COUNT = 256;
+inline constexpr uint8_t SLOT_COUNT = 32;
+inline constexpr uint8_t FUNCTION_COUNT = 8;
+
+inline constexpr uint8_t HEADER_TYPE_MASK = 0x7F;
+inline constexpr uint8_t HEADER_TYPE_MULTI_FUNCTION = 0x80;
+inline constexpr uint8_t HEADER_TYPE_GENERAL = 0x00;
+inline constexpr uint8_t HEADER_TYPE_BRIDGE = 0x01;
+
+inline constexpr uint16_t STATUS_CAPABILITIES = 1U << 4;
+
+// Bounds the capability walk, a malformed list could loop forever
+inline constexpr size_t MAX_CAPABILITIES = 48;
+
+// BAR low bits
+inline constexpr uint32_t BAR_IO = 1U << 0;
+inline constexpr uint32_t BAR_MEMORY_TYPE_64 = 2U << 1;
+inline constexpr uint32_t BAR_MEMORY_TYPE_MASK = 3U << 1;
+inline constexpr uint32_t BAR_PREFETCHABLE = 1U << 3;
+inline constexpr uint32_t BAR_IO_ADDRESS_MASK = ~0x3U;
+inline constexpr uint32_t BAR_MEMORY_ADDRESS_MASK = ~0xFU;
+
+// MSI capability, offsets from the capability
+inline constexpr uint16_t MSI_CONTROL = 0x02;
+inline constexpr uint16_t MSI_ADDRESS_LOW = 0x04;
+inline constexpr uint16_t MSI_ADDRESS_HIGH = 0x08; // 64-bit capable functions only
+inline constexpr uint16_t MSI_DATA_32 = 0x08;
+inline constexpr uint16_t MSI_DATA_64 = 0x0C;
+inline constexpr uint16_t MSI_CONTROL_ENABLE = 1U << 0;
+inline constexpr uint16_t MSI_CONTROL_MULTIPLE_ENABLE_MASK = 0x7U << 4;
+inline constexpr uint16_t MSI_CONTROL_64BIT = 1U << 7;
+
+// MSI-X capability, offsets from the capability
+inline constexpr uint16_t MSIX_CONTROL = 0x02;
+inline constexpr uint16_t MSIX_TABLE = 0x04;
+inline constexpr uint16_t MSIX_CONTROL_TABLE_SIZE_MASK = 0x7FF;
+inline constexpr uint16_t MSIX_CONTROL_FUNCTION_MASK = 1U << 14;
+inline constexpr uint16_t MSIX_CONTROL_ENABLE = 1U << 15;
+inline constexpr uint32_t MSIX_TABLE_BIR_MASK = 0x7;
+
+// MSI-X table entry, in dwords
+inline constexpr size_t MSIX_ENTRY_SIZE = 16;
+inline constexpr size_t MSIX_ENTRY_ADDRESS_LOW = 0;
+inline constexpr size_t MSIX_ENTRY_ADDRESS_HIGH = 1;
+inline constexpr size_t MSIX_ENTRY_DATA = 2;
+inline constexpr size_t MSIX_ENTRY_CONTROL = 3;
+inline constexpr uint32_t MSIX_ENTRY_MASKED = 1U << 0;
+
+// MCFG entry following the table header and 8 reserved bytes
+struct mcfg_entry {
+    uint64_t base;
+    uint16_t segment;
+    uint8_t start_bus;
+    uint8_t end_bus;
+    uint32_t reserved;
+} __attribute__((packed));
+
+static_assert(sizeof(mcfg_entry) == 16, "MCFG entry must be 16 bytes");
+
+inline constexpr size_t MCFG_ENTRIES_OFFSET = sizeof(arch::x86::acpi_table_header) + 8;
+
+struct ecam_region {
+    volatile uint8_t* base; // Configuration space of start_bus
+    uint16_t segment;
+    uint8_t start_bus;
+    uint8_t end_bus;
+};
+
+static ecam_region g_ecam_regions[MAX_ECAM_REGIONS];
+static size_t g_ecam_region_count = 0;
+
+// Serializes the address/data port pair of the legacy mechanism, ECAM needs no lock
+static sync::spinlock g_legacy_lock;
+
+static device g_devices[MAX_DEVICES];
+static size_t g_device_count = 0;
+static bool g_truncated = false;
+
+static sync::spinlock g_driver_lock;
+static const driver* g_drivers[MAX_DRIVERS];
+static size_t g_driver_count = 0;
+
+// Per segment, so two bridges claiming one secondary bus scan it only once
+static bool g_bus_scanned[BUS_COUNT];
+static uint16_t g_buses_scanned = 0;
+
+static volatile uint8_t* ecam_pointer(const address& location, uint16_t offset) {
+    for (size_t i = 0; i < g_ecam_region_count; ++i) {
+        const ecam_region* region = &g_ecam_regions[i];
+        if (region->segment != location.segment || location.bus < region->start_bus ||
+            location.bus > region->end_bus) {
+            continue;
+        }
+
+        uint64_t function_offset = (static_cast<uint64_t>(location.bus - region->start_bus) << 20) |
+                                   (static_cast<uint64_t>(location.slot) << 15) |
+                                   (static_cast<uint64_t>(location.function) << 12);
+        return region->base + function_offset + offset;
+    }
+    return nullptr;
+}
+
+static uint32_t legacy_address(const address& location, uint16_t offset) {
+    return CONFIG_ENABLE | (static_cast<uint32_t>(location.bus) << 16) |
+           (static_cast<uint32_t>(location.slot) << 11) |
+           (static_cast<uint32_t>(location.function) << 8) | (offset & 0xFC);
+}
+
+static bool legacy_reachable(const address& location, uint16_t offset) {
+    return location.segment == 0 && offset < LEGACY_CONFIG_SIZE;
+}
+
+// Missing functions and unreachable registers read as all ones, like a master abort
+template <typename T>
+static T config_read(const address& location, uint16_t offset) {
+    if (g_ecam_region_count > 0) {
+        volatile uint8_t* pointer = ecam_pointer(location, offset);
+        return pointer ? *reinterpret_cast<volatile T*>(pointer) : static_cast<T>(~T{0});
+    }
+
+    if (!legacy_reachable(location, offset)) {
+        return static_cast<T>(~T{0});
+    }
+
+    sync::spinlock_guard guard(g_legacy_lock);
+    outl(CONFIG_ADDRESS, legacy_address(location, offset));
+
+    uint16_t port = static_cast<uint16_t>(CONFIG_DATA + (offset & 0x3));
+    if constexpr (sizeof(T) == sizeof(uint32_t)) {
+        return inl(port);
+    } else if constexpr (sizeof(T) == sizeof(uint16_t)) {
+        return inw(port);
+    } else {
+        return inb(port);
+    }
+}
+
+template <typename T>
+static void config_write(const address& location, uint16_t offset, T value) {
+    if (g_ecam_region_count > 0) {
+        volatile uint8_t* pointer = ecam_pointer(location, offset);
+        if (pointer) {
+            *reinterpret_cast<volatile T*>(pointer) = value;
+        }
+        return;
+    }
+
+    if (!legacy_reachable(location, offset)) {
+        return;
+    }
+
+    sync::spinlock_guard guard(g_legacy_lock);
+    outl(CONFIG_ADDRESS, legacy_address(location, offset));
+
+    uint16_t port = static_cast<uint16_t>(CONFIG_DATA + (offset & 0x3));
+    if constexpr (sizeof(T) == sizeof(uint32_t)) {
+        outl(port, value);
+    } else if constexpr (sizeof(T) == sizeof(uint16_t)) {
+        outw(port, value);
+    } else {
+        outb(port, value);
+    }
+}
+
+uint8_t read8(const device* dev, uint16_t offset) {
+    return config_read<uint8_t>(dev->location, offset);
+}
+
+uint16_t read16(const device* dev, uint16_t offset) {
+    return config_read<uint16_t>(dev->location, offset);
+}
+
+uint32_t read32(const device* dev, uint16_t offset) {
+    return config_read<uint32_t>(dev->location, offset);
+}
+
+void write8(const device* dev, uint16_t offset, uint8_t value) {
+    config_write<uint8_t>(dev->location, offset, value);
+}
+
+void write16(const device* dev, uint16_t offset, uint16_t value) {
+    config_write<uint16_t>(dev->location, offset, value);
+}
+
+void write32(const device* dev, uint16_t offset, uint32_t value) {
+    config_write<uint32_t>(dev->location, offset, value);
+}
+
+void enable(const device* dev, uint16_t command_bits) {
+    write16(dev, REG_COMMAND, static_cast<uint16_t>(read16(dev, REG_COMMAND) | command_bits));
+}
+
+// Fields of the cached header, so enumeration reads each dword once
+static uint8_t header_byte(const device* dev, uint16_t offset) {
+    return static_cast<uint8_t>(dev->header[offset / 4] >> ((offset % 4) * 8));
+}
+
+static uint16_t header_word(const device* dev, uint16_t offset) {
+    return static_cast<uint16_t>(dev->header[offset / 4] >> ((offset % 4) * 8));
+}
+
+uint8_t find_capability(const device* dev, uint8_t id, uint8_t after) {
+    if (!(header_word(dev, REG_STATUS) & STATUS_CAPABILITIES)) {
+        return 0;
+    }
+
+    uint8_t offset = after != 0 ? read8(dev, static_cast<uint16_t>(after + 1))
+                                : header_byte(dev, REG_CAPABILITIES);
+
+    for (size_t i = 0; i < MAX_CAPABILITIES && offset >= CACHED_HEADER_SIZE; ++i) {
+        offset &= 0xFC;
+        if (read8(dev, offset) == id) {
+            return offset;
+        }
+        offset = read8(dev, static_cast<uint16_t>(offset + 1));
+    }
+    return 0;
+}
+
+// Sized with decoding off, the all-ones probe would otherwise claim a bogus address range
+static void size_bars(device* dev) {
+    size_t count = dev->header_type == HEADER_TYPE_GENERAL  ? BAR_COUNT
+                   : dev->header_type == HEADER_TYPE_BRIDGE ? 2
+                                                            : 0;
+    if (count == 0) {
+        return;
+    }
+
+    uint16_t command = header_word(dev, REG_COMMAND);
+    write16(dev, REG_COMMAND,
+            static_cast<uint16_t>(command & ~(COMMAND_IO_SPACE | COMMAND_MEMORY_SPACE)));
+
+    for (size_t i = 0; i < count; ++i) {
+        auto reg = static_cast<uint16_t>(REG_BAR0 + i * sizeof(uint32_t));
+        uint32_t original = dev->header[reg / 4];
+
+        write32(dev, reg, 0xFFFFFFFF);
+        uint32_t mask = read32(dev, reg);
+        write32(dev, reg, original);
+
+        bar* entry = &dev->bars[i];
+
+        if (original & BAR_IO) {
+            uint32_t size_mask = mask & BAR_IO_ADDRESS_MASK;
+            if (size_mask != 0) {
+                *entry = {.address = original & BAR_IO_ADDRESS_MASK,
+                          .size = (~size_mask + 1) & 0xFFFF,
+                          .type = bar_type::IO,
+                          .prefetchable = false};
+            }
+            continue;
+        }
+
+        bool wide = (original & BAR_MEMORY_TYPE_MASK) == BAR_MEMORY_TYPE_64 && i + 1 < count;
+        uint64_t address = original & BAR_MEMORY_ADDRESS_MASK;
+        uint32_t mask_high = 0xFFFFFFFF; // A 32-bit BAR decodes nothing above 4GB
+
+        if (wide) {
+            auto high_reg = static_cast<uint16_t>(reg + sizeof(uint32_t));
+            uint32_t original_high = dev->header[high_reg / 4];
+
+            write32(dev, high_reg, 0xFFFFFFFF);
+            mask_high = read32(dev, high_reg);
+            write32(dev, high_reg, original_high);
+
+            address |= static_cast<uint64_t>(original_high) << 32;
+        }
+
+        uint64_t size_mask =
+            (static_cast<uint64_t>(mask_high) << 32) | (mask & BAR_MEMORY_ADDRESS_MASK);
+
+        // Unimplemented BARs read back as zero
+        if ((mask & BAR_MEMORY_ADDRESS_MASK) != 0 || (wide && mask_high != 0)) {
+            *entry = {.address = address,
+                      .size = ~size_mask + 1,
+                      .type = wide ? bar_type::MEMORY64 : bar_type::MEMORY32,
+                      .prefetchable = (original & BAR_PREFETCHABLE) != 0};
+        }
+
+        if (wide) {
+            ++i;
+        }
+    }
+
+    write16(dev, REG_COMMAND, command);
+}
+
+static void scan_bus(uint16_t segment, uint8_t bus);
+
+static void scan_function(const address& location, uint32_t id_dword) {
+    device scratch = {};
+    bool kept = g_device_count < MAX_DEVICES;
+    device* dev = kept ? &g_devices[g_device_count] : &scratch;
+    if (!kept) {
+        g_truncated = true;
+    }
+
+    *dev = {};
+    dev->location = location;
+    dev->header[0] = id_dword;
+    for (size_t i = 1; i < CACHED_HEADER_SIZE / sizeof(uint32_t); ++i) {
+        dev->header[i] = config_read<uint32_t>(location, static_cast<uint16_t>(i * 4));
+    }
+
+    dev->vendor_id = header_word(dev, REG_VENDOR_ID);
+    dev->device_id = header_word(dev, REG_DEVICE_ID);
+    dev->revision = header_byte(dev, REG_REVISION);
+    dev->prog_if = header_byte(dev, REG_REVISION + 1);
+    dev->subclass = header_byte(dev, REG_REVISION + 2);
+    dev->class_code = header_byte(dev, REG_REVISION + 3);
+    dev->header_type = header_byte(dev, REG_HEADER_TYPE) & HEADER_TYPE_MASK;
+    dev->interrupt_line = header_byte(dev, REG_INTERRUPT_LINE);
+    dev->interrupt_pin = header_byte(dev, REG_INTERRUPT_PIN);
+
+    if (dev->header_type == HEADER_TYPE_GENERAL) {
+        dev->subsystem_vendor_id = header_word(dev, REG_SUBSYSTEM_VENDOR_ID);
+        dev->subsystem_id = header_word(dev, REG_SUBSYSTEM_ID);
+    }
+
+    if (kept) {
+        dev->msi_offset = find_capability(dev, CAPABILITY_MSI);
+        dev->msix_offset = find_capability(dev, CAPABILITY_MSIX);
+        dev->pcie_offset = find_capability(dev, CAPABILITY_PCIE);
+        size_bars(dev);
+        ++g_device_count;
+    }
+
+    // Secondary buses are numbered above their parent, anything else is unconfigured or bogus
+    uint8_t secondary = header_byte(dev, REG_SECONDARY_BUS);
+    if (dev->header_type == HEADER_TYPE_BRIDGE && secondary > location.bus) {
+        scan_bus(location.segment, secondary);
+    }
+}
+
+static void scan_bus(uint16_t segment, uint8_t bus) {
+    if (g_bus_scanned[bus]) {
+        return;
+    }
+    g_bus_scanned[bus] = true;
+    ++g_buses_scanned;
+
+    for (uint8_t slot = 0; slot < SLOT_COUNT; ++slot) {
+        address location = {.segment = segment, .bus = bus, .slot = slot, .function = 0};
+
+        uint32_t id_dword = config_read<uint32_t>(location, REG_VENDOR_ID);
+        if ((id_dword & 0xFFFF) == VENDOR_NONE) {
+            continue;
+        }
+
+        // Functions 1-7 are only decoded by multi-function devices
+        bool multi_function =
+            config_read<uint8_t>(location, REG_HEADER_TYPE) & HEADER_TYPE_MULTI_FUNCTION;
+        scan_function(location, id_dword);
+
+        for (uint8_t function = 1; multi_function && function < FUNCTION_COUNT; ++function) {
+            location.function = function;
+            id_dword = config_read<uint32_t>(location, REG_VENDOR_ID);
+            if ((id_dword & 0xFFFF) != VENDOR_NONE) {
+                scan_function(location, id_dword);
+            }
+        }
+    }
+}
+
+// A multi-function host bridge at 00.0 has one host controller per function, each for its bus
+static void scan_segment(uint16_t segment, uint8_t start_bus) {
+    for (size_t bus = 0; bus < BUS_COUNT; ++bus) {
+        g_bus_scanned[bus] = false;
+    }
+
+    address root = {.segment = segment, .bus = start_bus, .slot = 0, .function = 0};
+    bool multi_function = start_bus == 0 && (config_read<uint8_t>(root, REG_HEADER_TYPE) &
+                                             HEADER_TYPE_MULTI_FUNCTION);
+    if (!multi_function) {
+        scan_bus(segment, start_bus);
+        return;
+    }
+
+    for (uint8_t function = 0; function < FUNCTION_COUNT; ++function) {
+        root.function = function;
+        if (config_read<uint16_t>(root, REG_VENDOR_ID) != VENDOR_NONE) {
+            scan_bus(segment, function);
+        }
+    }
+}
+
+static void init_ecam() {
+    const arch::x86::acpi_table_header* mcfg = arch::x86::find_acpi_table("MCFG");
+    if (!mcfg || mcfg->length < MCFG_ENTRIES_OFFSET) {
+        return;
+    }
+
+    size_t count = (mcfg->length - MCFG_ENTRIES_OFFSET) / sizeof(mcfg_entry);
+    const auto* entries = reinterpret_cast<const mcfg_entry*>(
+        reinterpret_cast<const uint8_t*>(mcfg) + MCFG_ENTRIES_OFFSET);
+
+    for (size_t i = 0; i < count && g_ecam_region_count < MAX_ECAM_REGIONS; ++i) {
+        const mcfg_entry* entry = &entries[i];
+        if (entry->end_bus < entry->start_bus) {
+            continue;
+        }
+
+        // 1MB of configuration space per bus, mapped with 2MB pages to spare the early tables
+        size_t size = static_cast<size_t>(entry->end_bus - entry->start_bus + 1) << 20;
+        void* base = arch::x86::map_mmio_large(entry->base, size);
+        if (!base) {
+            continue;
+        }
+
+        g_ecam_regions[g_ecam_region_count++] = {.base = static_cast<volatile uint8_t*>(base),
+                                                 .segment = entry->segment,
+                                                 .start_bus = entry->start_bus,
+                                                 .end_bus = entry->end_bus};
+    }
+}
+
+static bool matches(const driver* drv, const device* dev) {
+    for (size_t i = 0; i < drv->id_count; ++i) {
+        if (drv->ids[i].vendor_id == dev->vendor_id && drv->ids[i].device_id == dev->device_id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Called with g_driver_lock held
+static void bind(const driver* drv, device* dev) {
+    if (dev->bound || !matches(drv, dev)) {
+        return;
+    }
+    if (drv->probe(dev)) {
+        dev->bound = drv;
+    }
+}
+
+bool register_driver(const driver* drv) {
+    sync::spinlock_guard guard(g_driver_lock);
+
+    if (g_driver_count >= MAX_DRIVERS) {
+        return false;
+    }
+    g_drivers[g_driver_count++] = drv;
+
+    for (size_t i = 0; i < g_device_count; ++i) {
+        bind(drv, &g_devices[i]);
+    }
+    return true;
+}
+
+static void emit_device(const device* dev) {
+    device_payload payload = {};
+    payload.segment = dev->location.segment;
+    payload.bus = dev->location.bus;
+    payload.slot = dev->location.slot;
+    payload.function = dev->location.function;
+    payload.class_code = dev->class_code;
+    payload.subclass = dev->subclass;
+    payload.prog_if = dev->prog_if;
+    payload.vendor_id = dev->vendor_id;
+    payload.device_id = dev->device_id;
+    payload.subsystem_vendor_id = dev->subsystem_vendor_id;
+    payload.subsystem_id = dev->subsystem_id;
+    payload.revision = dev->revision;
+    payload.header_type = dev->header_type;
+    payload.interrupt_pin = dev->interrupt_pin;
+    payload.capabilities = static_cast<uint8_t>((dev->msi_offset ? 1U << 0 : 0) |
+                                                (dev->msix_offset ? 1U << 1 : 0) |
+                                                (dev->pcie_offset ? 1U << 2 : 0));
+
+    const char* name = dev->bound ? dev->bound->name : "";
+    for (size_t i = 0; i < sizeof(payload.driver) && name[i]; ++i) {
+        payload.driver[i] = name[i];
+    }
+
+    iris::emit_with_payload(iris::EVENT_PCI_DEVICE, 0, 0, &payload, sizeof(payload));
+}
+
+void init() {
+    uint64_t start = arch::x86::rdtsc();
+
+    init_ecam();
+
+    if (g_ecam_region_count > 0) {
+        for (size_t i = 0; i < g_ecam_region_count; ++i) {
+            scan_segment(g_ecam_regions[i].segment, g_ecam_regions[i].start_bus);
+        }
+    } else {
+        scan_segment(0, 0);
+    }
+
+    size_t bound_count = 0;
+    {
+        sync::spinlock_guard guard(g_driver_lock);
+        for (size_t i = 0; i < g_device_count; ++i) {
+            for (size_t j = 0; j < g_driver_count; ++j) {
+                bind(g_drivers[j], &g_devices[i]);
+            }
+            bound_count += g_devices[i].bound ? 1 : 0;
+        }
+    }
+
+    uint64_t cycles = arch::x86::rdtsc() - start;
+    uint64_t tsc_frequency = arch::x86::tsc_frequency();
+
+    for (size_t i = 0; i < g_device_count; ++i) {
+        emit_device(&g_devices[i]);
+    }
+
+    enumeration_payload payload = {};
+    payload.cycles = cycles;
+    payload.device_count = static_cast<uint32_t>(g_device_count);
+    payload.bound_count = static_cast<uint32_t>(bound_count);
+    payload.buses_scanned = g_buses_scanned;
+    payload.ecam_regions = static_cast<uint8_t>(g_ecam_region_count);
+    payload.truncated = g_truncated ? 1 : 0;
+    if (tsc_frequency != 0) {
+        payload.nanoseconds = (cycles / tsc_frequency) * 1000000000ULL +
+                              ((cycles % tsc_frequency) * 1000000000ULL) / tsc_frequency;
+    }
+
+    iris::emit_with_payload(iris::EVENT_PCI_ENUMERATION, 0, 0, &payload, sizeof(payload));
+}
+
+size_t device_count() {
+    return g_device_count;
+}
+
+device* get_device(size_t index) {
+    return index < g_device_count ? &g_devices[index] : nullptr;
+}
+
+void* map_bar(const device* dev, size_t index) {
+    if (index >= BAR_COUNT) {
+        return nullptr;
+    }
+
+    const bar* entry = &dev->bars[index];
+    if (entry->type != bar_type::MEMORY32 && entry->type != bar_type::MEMORY64) {
+        return nullptr;
+    }
+
+    if (entry->size >= arch::x86::LARGE_PAGE_SIZE) {
+        return arch::x86::map_mmio_large(entry->address, entry->size);
+    }
+    return arch::x86::map_mmio(entry->address, entry->size);
+}
+
+bool enable_msi(const device* dev, arch::x86::irq_vector vector) {
+    arch::x86::msi_message message;
+    if (dev->msi_offset == 0 || !arch::x86::compose_msi_message(vector, &message)) {
+        return false;
+    }
+
+    uint16_t cap = dev->msi_offset;
+    uint16_t control = read16(dev, cap + MSI_CONTROL);
+    control &= static_cast<uint16_t>(~(MSI_CONTROL_ENABLE | MSI_CONTROL_MULTIPLE_ENABLE_MASK));
+    write16(dev, cap + MSI_CONTROL, control);
+
+    write32(dev, cap + MSI_ADDRESS_LOW, static_cast<uint32_t>(message.address));
+    if (control & MSI_CONTROL_64BIT) {
+        write32(dev, cap + MSI_ADDRESS_HIGH, static_cast<uint32_t>(message.address >> 32));
+        write16(dev, cap + MSI_DATA_64, static_cast<uint16_t>(message.data));
+    } else {
+        write16(dev, cap + MSI_DATA_32, static_cast<uint16_t>(message.data));
+    }
+
+    enable(dev, COMMAND_INTX_DISABLE);
+    write16(dev, cap + MSI_CONTROL, control | MSI_CONTROL_ENABLE);
+    return true;
+}
+
+bool enable_msix(const device* dev, uint16_t entry, arch::x86::irq_vector vector) {
+    if (dev->msix_offset == 0) {
+        return false;
+    }
+
+    uint16_t cap = dev->msix_offset;
+    uint16_t control = read16(dev, cap + MSIX_CONTROL);
+    if (entry > (control & MSIX_CONTROL_TABLE_SIZE_MASK)) {
+        return false;
+    }
+
+    arch::x86::msi_message message;
+    if (!arch::x86::compose_msi_message(vector, &message)) {
+        return false;
+    }
+
+    uint32_t table = read32(dev, cap + MSIX_TABLE);
+    auto* bar_base = static_cast<uint8_t*>(map_bar(dev, table & MSIX_TABLE_BIR_MASK));
+    if (!bar_base) {
+        return false;
+    }
+
+    auto* slot = reinterpret_cast<volatile uint32_t*>(
+        bar_base + (table & ~MSIX_TABLE_BIR_MASK) + entry * MSIX_ENTRY_SIZE);
+
+    // The table is only reachable with memory decoding on, the whole function stays
+    // masked while the entry changes
+    enable(dev, COMMAND_MEMORY_SPACE);
+    write16(dev, cap + MSIX_CONTROL,
+            control | MSIX_CONTROL_ENABLE | MSIX_CONTROL_FUNCTION_MASK);
+
+    slot[MSIX_ENTRY_CONTROL] = slot[MSIX_ENTRY_CONTROL] | MSIX_ENTRY_MASKED;
+    slot[MSIX_ENTRY_ADDRESS_LOW] = static_cast<uint32_t>(message.address);
+    slot[MSIX_ENTRY_ADDRESS_HIGH] = static_cast<uint32_t>(message.address >> 32);
+    slot[MSIX_ENTRY_DATA] = message.data;
+    slot[MSIX_ENTRY_CONTROL] = slot[MSIX_ENTRY_CONTROL] & ~MSIX_ENTRY_MASKED;
+
+    enable(dev, COMMAND_INTX_DISABLE);
+    write16(dev, cap + MSIX_CONTROL,
+            static_cast<uint16_t>((control | MSIX_CONTROL_ENABLE) & ~MSIX_CONTROL_FUNCTION_MASK));
+    return true;
+}
+
+} // namespace pci
@@ -0,0 +1,476 @@
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/percpu/percpu.h>
+#include <arch/x86/syscall/syscall.h>
+#include <fs/initramfs.h>
+#include <iris/iris.h>
+#include <memory/memory.h>
+#include <memory/pmm.h>
+#include <proc/elf.h>
+#include <proc/process.h>
+#include <sched/sched.h>
+#include <sync/spinlock.h>
+
+namespace proc {
+
+using arch::x86::PAGE_SIZE;
+
+static process g_processes[MAX_PROCESSES];
+static process* g_free_processes;
+static bool g_process_pool_ready = false;
+static sync::spinlock g_process_pool_lock;
+
+static uint32_t g_next_pid = 1;
+
+static bool g_event_tracing = true;
+
+static process* allocate_process() {
+    sync::irq_spinlock_guard guard(g_process_pool_lock);
+
+    if (!g_process_pool_ready) {
+        for (size_t i = MAX_PROCESSES; i > 0; --i) {
+            g_processes[i - 1].next_free = g_free_processes;
+            g_free_processes = &g_processes[i - 1];
+        }
+        g_process_pool_ready = true;
+    }
+
+    process* p = g_free_processes;
+    if (p) {
+        g_free_processes = p->next_free;
+    }
+
+    return p;
+}
+
+// Caller holds g_process_pool_lock
+static void put_reference_locked(process* p) {
+    if (--p->references != 0) {
+        return;
+    }
+
+    // A stale parent pointer would make the slot look like a child to wait()
+    p->parent = nullptr;
+    p->next_free = g_free_processes;
+    g_free_processes = p;
+}
+
+static void put_reference(process* p) {
+    sync::irq_spinlock_guard guard(g_process_pool_lock);
+    put_reference_locked(p);
+}
+
+static void free_process(process* p) {
+    sync::irq_spinlock_guard guard(g_process_pool_lock);
+
+    p->parent = nullptr;
+    p->next_free = g_free_processes;
+    g_free_processes = p;
+}
+
+static void init_process(process* p, uint64_t spawn_tsc) {
+    p->pid = __atomic_fetch_add(&g_next_pid, 1, __ATOMIC_RELAXED);
+    p->region_count = 0;
+    p->parent = nullptr;
+    p->references = 1;
+    p->state = process_state::RUNNING;
+    p->exit_code = 0;
+    p->spawn_tsc = spawn_tsc;
+    p->start_tsc = 0;
+    p->file_faults = 0;
+    p->zero_faults = 0;
+    p->cow_faults = 0;
+    p->fault_cycles = 0;
+    p->cr3 = 0;
+}
+
+static uint64_t page_align_down(uint64_t address) {
+    return address & ~(PAGE_SIZE - 1);
+}
+
+static uint64_t page_align_up(uint64_t address) {
+    return (address + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+}
+
+static bool add_region(process* p, const region& r) {
+    if (p->region_count >= MAX_REGIONS || r.start >= r.end ||
+        r.start < arch::x86::USER_SPACE_START || r.end > USER_STACK_TOP) {
+        return false;
+    }
+
+    // Segments sharing a page would need their contents and permissions merged
+    for (size_t i = 0; i < p->region_count; ++i) {
+        if (r.start < p->regions[i].end && r.end > p->regions[i].start) {
+            return false;
+        }
+    }
+
+    p->regions[p->region_count++] = r;
+    return true;
+}
+
+static bool is_valid_header(const elf::header* header, uint64_t size) {
+    if (size < sizeof(elf::header) ||
+        memory::memcmp(header->ident, elf::MAGIC, sizeof(elf::MAGIC)) != 0) {
+        return false;
+    }
+
+    if (header->ident[elf::IDENT_CLASS] != elf::CLASS_64 ||
+        header->ident[elf::IDENT_DATA] != elf::DATA_LITTLE_ENDIAN ||
+        header->ident[elf::IDENT_VERSION] != elf::VERSION_CURRENT) {
+        return false;
+    }
+
+    // Only static executables, there is no dynamic linker or relocation support
+    if (header->type != elf::TYPE_EXECUTABLE || header->machine != elf::MACHINE_X86_64 ||
+        header->program_header_size != sizeof(elf::program_header)) {
+        return false;
+    }
+
+    uint64_t table_size =
+        static_cast<uint64_t>(header->program_header_count) * sizeof(elf::program_header);
+    return header->program_header_offset <= size &&
+           table_size <= size - header->program_header_offset;
+}
+
+// Turns every PT_LOAD segment into a demand-paged region, nothing is copied yet
+static bool load_segments(process* p, const uint8_t* image, uint64_t size) {
+    const auto* header = reinterpret_cast<const elf::header*>(image);
+    if (!is_valid_header(header, size)) {
+        return false;
+    }
+
+    const auto* segments =
+        reinterpret_cast<const elf::program_header*>(image + header->program_header_offset);
+    bool entry_is_executable = false;
+
+    for (uint16_t i = 0; i < header->program_header_count; ++i) {
+        elf::program_header segment;
+        memory::memcpy(&segment, &segments[i], sizeof(segment));
+
+        if (segment.type != elf::SEGMENT_LOAD || segment.memory_size == 0) {
+            continue;
+        }
+
+        if (segment.file_size > segment.memory_size || segment.offset > size ||
+            segment.file_size > size - segment.offset ||
+            segment.memory_size > arch::x86::USER_SPACE_END ||
+            segment.vaddr > arch::x86::USER_SPACE_END - segment.memory_size) {
+            return false;
+        }
+
+        region r = {.start = page_align_down(segment.vaddr),
+                    .end = page_align_up(segment.vaddr + segment.memory_size),
+                    .pte_flags = arch::x86::PTE_PRESENT | arch::x86::PTE_USER,
+                    .file_data = image + segment.offset,
+                    .file_start = segment.vaddr,
+                    .file_size = segment.file_size};
+
+        if (segment.flags & elf::SEGMENT_WRITE) {
+            r.pte_flags |= arch::x86::PTE_WRITABLE;
+        }
+        if (!(segment.flags & elf::SEGMENT_EXECUTE)) {
+            r.pte_flags |= arch::x86::PTE_NO_EXECUTE;
+        }
+
+        if (!add_region(p, r)) {
+            return false;
+        }
+
+        if ((segment.flags & elf::SEGMENT_EXECUTE) && header->entry >= segment.vaddr &&
+            header->entry < segment.vaddr + segment.memory_size) {
+            entry_is_executable = true;
+        }
+    }
+
+    p->entry = header->entry;
+    return entry_is_executable;
+}
+
+static void emit_start_event(const process* p) {
+    if (!__atomic_load_n(&g_event_tracing, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    process_start_payload payload = {.spawn_tsc = p->spawn_tsc,
+                                     .startup_cycles = p->start_tsc - p->spawn_tsc,
+                                     .entry = p->entry,
+                                     .pid = p->pid,
+                                     .region_count = static_cast<uint16_t>(p->region_count),
+                                     .reserved = 0};
+    iris::emit_with_payload(iris::EVENT_PROCESS_START, 0,
+                            static_cast<uint8_t>(arch::x86::current_cpu()), &payload,
+                            sizeof(payload));
+}
+
+// Thread of a new process, adopts its address space and drops to ring 3
+static void process_main(void* arg) {
+    auto* p = static_cast<process*>(arg);
+
+    sched::current_task()->process = p;
+    sched::switch_address_space(p->cr3);
+
+    p->start_tsc = arch::x86::rdtsc();
+    emit_start_event(p);
+
+    arch::x86::enter_user_mode(p->entry, USER_STACK_TOP, p->arg);
+}
+
+// Thread of a forked process, resumes where the parent's fork returned
+static void fork_child_main(void* arg) {
+    auto* p = static_cast<process*>(arg);
+
+    sched::current_task()->process = p;
+    sched::switch_address_space(p->cr3);
+    sched::load_fpu_state(&p->fork_fpu);
+
+    p->start_tsc = arch::x86::rdtsc();
+    emit_start_event(p);
+
+    // Kept on this thread's stack, return_to_user_mode pops it from there
+    arch::x86::syscall_frame frame = p->fork_frame;
+    arch::x86::return_to_user_mode(&frame);
+}
+
+process* spawn(const char* path, uint64_t arg) {
+    uint64_t spawn_tsc = arch::x86::rdtsc();
+
+    fs::initramfs::file_handle handle;
+    if (!fs::initramfs::open(path, &handle)) {
+        return nullptr;
+    }
+
+    process* p = allocate_process();
+    if (!p) {
+        return nullptr;
+    }
+
+    init_process(p, spawn_tsc);
+    p->arg = arg;
+
+    region stack = {.start = USER_STACK_TOP - USER_STACK_SIZE,
+                    .end = USER_STACK_TOP,
+                    .pte_flags = arch::x86::PTE_PRESENT | arch::x86::PTE_USER |
+                                 arch::x86::PTE_WRITABLE | arch::x86::PTE_NO_EXECUTE,
+                    .file_data = nullptr,
+                    .file_start = 0,
+                    .file_size = 0};
+
+    if (!load_segments(p, fs::initramfs::contents(&handle), handle.node->size) ||
+        !add_region(p, stack)) {
+        free_process(p);
+        return nullptr;
+    }
+
+    p->cr3 = arch::x86::create_address_space();
+    if (!p->cr3) {
+        free_process(p);
+        return nullptr;
+    }
+
+    p->task = sched::spawn(process_main, p);
+    if (!p->task) {
+        release(p);
+        return nullptr;
+    }
+
+    return p;
+}
+
+process* fork(const arch::x86::syscall_frame* frame) {
+    uint64_t spawn_tsc = arch::x86::rdtsc();
+
+    process* parent = current_process();
+    if (!parent) {
+        return nullptr;
+    }
+
+    process* child = allocate_process();
+    if (!child) {
+        return nullptr;
+    }
+
+    init_process(child, spawn_tsc);
+    child->entry = parent->entry;
+    child->arg = parent->arg;
+    child->region_count = parent->region_count;
+    memory::memcpy(child->regions, parent->regions, parent->region_count * sizeof(region));
+
+    child->fork_frame = *frame;
+    child->fork_frame.rax = 0;
+    sched::copy_fpu_state(&child->fork_fpu);
+
+    child->cr3 = arch::x86::clone_address_space(parent->cr3);
+    if (!child->cr3) {
+        free_process(child);
+        return nullptr;
+    }
+
+    // Set before the thread can run, it may exit before sched::spawn returns
+    child->parent = parent;
+    child->references = 2;
+
+    child->task = sched::spawn(fork_child_main, child);
+    if (!child->task) {
+        child->parent = nullptr;
+        child->references = 1;
+        release(child);
+        return nullptr;
+    }
+
+    return child;
+}
+
+bool wait(uint32_t pid, int32_t* exit_code) {
+    process* parent = current_process();
+    process* child = nullptr;
+
+    {
+        sync::irq_spinlock_guard guard(g_process_pool_lock);
+
+        for (size_t i = 0; i < MAX_PROCESSES; ++i) {
+            if (parent && g_processes[i].parent == parent && g_processes[i].pid == pid) {
+                child = &g_processes[i];
+                break;
+            }
+        }
+    }
+
+    if (!child) {
+        return false;
+    }
+
+    while (__atomic_load_n(&child->state, __ATOMIC_ACQUIRE) != process_state::EXITED) {
+        sched::yield();
+    }
+
+    *exit_code = child->exit_code;
+
+    {
+        sync::irq_spinlock_guard guard(g_process_pool_lock);
+        child->parent = nullptr;
+        put_reference_locked(child);
+    }
+
+    return true;
+}
+
+void set_event_tracing(bool enabled) {
+    __atomic_store_n(&g_event_tracing, enabled, __ATOMIC_RELAXED);
+}
+
+process* current_process() {
+    return sched::current_task()->process;
+}
+
+bool handle_page_fault(uint64_t address, uint64_t error_code) {
+    uint64_t start_tsc = arch::x86::rdtsc();
+
+    process* p = current_process();
+    if (!p) {
+        return false;
+    }
+
+    // Only writes to pages shared by fork are allowed to fault on a present page
+    if (error_code & PAGE_FAULT_PRESENT) {
+        if (!(error_code & PAGE_FAULT_WRITE) ||
+            !arch::x86::resolve_copy_on_write(p->cr3, address)) {
+            return false;
+        }
+
+        ++p->cow_faults;
+        p->fault_cycles += arch::x86::rdtsc() - start_tsc;
+        return true;
+    }
+
+    const region* r = nullptr;
+    for (size_t i = 0; i < p->region_count; ++i) {
+        if (address >= p->regions[i].start && address < p->regions[i].end) {
+            r = &p->regions[i];
+            break;
+        }
+    }
+
+    if (!r) {
+        return false;
+    }
+
+    uint64_t frame = memory::pmm::allocate_frame();
+    if (!frame) {
+        return false;
+    }
+
+    uint64_t page = page_align_down(address);
+    auto* contents = static_cast<uint8_t*>(arch::x86::phys_to_virt(frame));
+
+    // Part of the page backed by the file, the rest is zero (.bss tail, stack)
+    uint64_t copy_start = r->file_start > page ? r->file_start : page;
+    uint64_t copy_end = r->file_start + r->file_size;
+    if (copy_end > page + PAGE_SIZE) {
+        copy_end = page + PAGE_SIZE;
+    }
+
+    if (copy_start < copy_end) {
+        memory::memzero(contents, copy_start - page);
+        memory::memcpy(contents + (copy_start - page), r->file_data + (copy_start - r->file_start),
+                       copy_end - copy_start);
+        memory::memzero(contents + (copy_end - page), page + PAGE_SIZE - copy_end);
+        ++p->file_faults;
+    } else {
+        memory::memzero(contents, PAGE_SIZE);
+        ++p->zero_faults;
+    }
+
+    if (!arch::x86::map_user_page(p->cr3, page, frame, r->pte_flags)) {
+        memory::pmm::free_frame(frame);
+        return false;
+    }
+
+    p->fault_cycles += arch::x86::rdtsc() - start_tsc;
+    return true;
+}
+
+void exit(int32_t code) {
+    process* p = current_process();
+
+    if (p) {
+        if (__atomic_load_n(&g_event_tracing, __ATOMIC_RELAXED)) {
+            process_exit_payload payload = {.runtime_cycles = arch::x86::rdtsc() - p->start_tsc,
+                                            .file_faults = p->file_faults,
+                                            .zero_faults = p->zero_faults,
+                                            .cow_faults = p->cow_faults,
+                                            .fault_cycles = p->fault_cycles,
+                                            .pid = p->pid,
+                                            .exit_code = code};
+            iris::emit_with_payload(iris::EVENT_PROCESS_EXIT, 0,
+                                    static_cast<uint8_t>(arch::x86::current_cpu()), &payload,
+                                    sizeof(payload));
+        }
+
+        sync::irq_spinlock_guard guard(g_process_pool_lock);
+
+        // Nobody will wait for the children anymore
+        for (size_t i = 0; i < MAX_PROCESSES; ++i) {
+            if (g_processes[i].parent == p) {
+                g_processes[i].parent = nullptr;
+                put_reference_locked(&g_processes[i]);
+            }
+        }
+
+        p->exit_code = code;
+        __atomic_store_n(&p->state, process_state::EXITED, __ATOMIC_RELEASE);
+    }
+
+    sched::exit();
+}
+
+void release(process* p) {
+    if (p->cr3) {
+        arch::x86::destroy_address_space(p->cr3);
+        p->cr3 = 0;
+    }
+
+    put_reference(p);
+}
+
+} // namespace proc
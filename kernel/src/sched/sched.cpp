@@ -0,0 +1,727 @@
+#include <arch/x86/apic/lapic.h>
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/cpu/features.h>
+#include <arch/x86/gdt/gdt.h>
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/paging/tlb.h>
+#include <arch/x86/percpu/percpu.h>
+#include <async/executor.h>
+#include <containers/spsc_ring.h>
+#include <iris/iris.h>
+#include <memory/memory.h>
+#include <proc/process.h>
+#include <sched/sched.h>
+#include <sync/rcu.h>
+#include <sync/spinlock.h>
+
+namespace sched {
+
+// Context switch primitives (context_switch.S)
+EXTERN_C task* asm_switch_to(task* prev, task* next);
+EXTERN_C void asm_task_entry();
+
+// Callee-saved registers pushed by asm_switch_to below its return address
+inline constexpr size_t SWITCH_FRAME_REGISTERS = 6;
+
+static_assert(__builtin_offsetof(task, saved_rsp) == 0, "context_switch.S expects saved_rsp first");
+static_assert(PRIORITY_COUNT <= 32, "Run queue priorities must fit the 32-bit bitmap");
+
+// Shallowest C-state, the wakeup latency stays close to HLT's
+inline constexpr uint32_t MWAIT_HINT_C1 = 0;
+
+// MWAIT extension: an interrupt ends the wait although interrupts are disabled
+inline constexpr uint32_t MWAIT_INTERRUPT_BREAK = 1U << 0;
+
+// Scheduler event waiting to be emitted, both payloads have the same size
+struct sched_event {
+    uint16_t type;
+    uint8_t payload[sizeof(context_switch_payload)];
+};
+
+static_assert(sizeof(task_migrated_payload) == sizeof(context_switch_payload),
+              "Scheduler event payloads must have the same size");
+
+// Produced by the owning CPU with interrupts off, consumed by flush_events
+struct sched_event_ring {
+    containers::spsc_ring<sched_event, SCHED_EVENT_BUFFER_SIZE> events;
+    uint64_t dropped;
+};
+
+// Monitored by the owning CPU's MWAIT, on its own cache line so only wakeups end the wait
+struct alignas(64) idle_wakeup {
+    uint32_t sleeping; // Owner armed the monitor and is about to wait or waiting
+    uint32_t kicks;    // Stored to by wake_idle_cpu()
+};
+
+/*
+    One run queue per CPU, indexed by CPU ID so idle CPUs can steal from the
+    others. Runnable tasks sit in one FIFO list per priority and the bitmap
+    has bit n set while list n is non-empty, so enqueue, dequeue and picking
+    the most important task are all O(1).
+
+    A task that is switched out is only put back on a queue by the next task
+    on the same CPU (finish_switch), once its registers are saved and no other
+    CPU can resume it on a half-saved stack.
+*/
+struct alignas(64) run_queue {
+    sync::spinlock lock;
+    uint32_t bitmap;
+    uint32_t nr_running; // Queued tasks, read without the lock by stealing CPUs
+    task* heads[PRIORITY_COUNT];
+    task* tails[PRIORITY_COUNT];
+
+    // Owned by the CPU itself and only touched with interrupts disabled
+    task idle;
+    uint32_t ticks; // Timer ticks the current task has run for
+    bool online;
+
+    uint64_t context_switches;
+    uint64_t migrations;
+    uint64_t tasks_completed;
+
+    // Written by the owner only, read by flush_utilization() on the BSP
+    uint64_t idle_cycles; // Cycles spent in completed idle waits
+    uint64_t idle_since;  // TSC at the start of the current idle wait, 0 while busy
+    uint64_t wakeups;     // Completed idle waits
+
+    idle_wakeup wakeup;
+
+    sched_event_ring events;
+};
+
+// Totals of one CPU at its previous EVENT_CPU_UTILIZATION report
+struct utilization_snapshot {
+    uint64_t tsc; // 0 until the first report established a baseline
+    uint64_t idle_cycles;
+    uint64_t wakeups;
+};
+
+DEFINE_PER_CPU(task*, g_current_task);
+
+// Task whose FPU state is loaded in this CPU's registers
+DEFINE_PER_CPU(task*, g_fpu_owner);
+
+// CR0.TS is clear, the owner has used the FPU since it was last switched in
+DEFINE_PER_CPU(bool, g_fpu_active);
+
+static run_queue g_run_queues[arch::x86::MAX_CPUS];
+
+alignas(16) static uint8_t g_task_stacks[MAX_TASKS][TASK_STACK_SIZE];
+static task g_tasks[MAX_TASKS];
+static task* g_free_tasks;
+static bool g_task_pool_ready = false;
+static sync::spinlock g_task_pool_lock;
+
+static uint32_t g_next_tid = 1;
+static bool g_event_tracing = true;
+
+static idle_method g_idle_method = idle_method::HALT;
+static utilization_snapshot g_utilization_snapshots[arch::x86::MAX_CPUS];
+static uint64_t g_last_utilization_report = 0;
+
+static task* allocate_task() {
+    sync::irq_spinlock_guard guard(g_task_pool_lock);
+
+    // Built on first use, nothing can spawn before the BSP's run queue is online
+    if (!g_task_pool_ready) {
+        for (size_t i = MAX_TASKS; i > 0; --i) {
+            g_tasks[i - 1].next = g_free_tasks;
+            g_tasks[i - 1].stack = g_task_stacks[i - 1];
+            g_free_tasks = &g_tasks[i - 1];
+        }
+        g_task_pool_ready = true;
+    }
+
+    task* t = g_free_tasks;
+    if (t) {
+        g_free_tasks = t->next;
+    }
+
+    return t;
+}
+
+static void free_task(task* t) {
+    sync::irq_spinlock_guard guard(g_task_pool_lock);
+
+    t->next = g_free_tasks;
+    g_free_tasks = t;
+}
+
+static void record_event(run_queue* rq, uint16_t type, const void* payload) {
+    if (!__atomic_load_n(&g_event_tracing, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    sched_event_ring* ring = &rq->events;
+
+    sched_event event;
+    event.type = type;
+    memory::memcpy(event.payload, payload, sizeof(event.payload));
+
+    if (!ring->events.try_push(event)) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+    }
+}
+
+// Caller holds rq->lock
+static void enqueue_locked(run_queue* rq, task* t) {
+    uint8_t priority = t->priority;
+
+    t->next = nullptr;
+    if (rq->tails[priority]) {
+        rq->tails[priority]->next = t;
+    } else {
+        rq->heads[priority] = t;
+    }
+    rq->tails[priority] = t;
+
+    rq->bitmap |= 1U << priority;
+    __atomic_store_n(&rq->nr_running, rq->nr_running + 1, __ATOMIC_RELAXED);
+}
+
+// Caller holds rq->lock, `before` is the task preceding `t` in its list or null
+static void unlink_locked(run_queue* rq, task* t, task* before) {
+    uint8_t priority = t->priority;
+
+    if (before) {
+        before->next = t->next;
+    } else {
+        rq->heads[priority] = t->next;
+    }
+    if (rq->tails[priority] == t) {
+        rq->tails[priority] = before;
+    }
+    if (!rq->heads[priority]) {
+        rq->bitmap &= ~(1U << priority);
+    }
+
+    t->next = nullptr;
+    __atomic_store_n(&rq->nr_running, rq->nr_running - 1, __ATOMIC_RELAXED);
+}
+
+// Caller holds rq->lock, returns the most important queued task or null
+static task* dequeue_locked(run_queue* rq) {
+    if (rq->bitmap == 0) {
+        return nullptr;
+    }
+
+    task* t = rq->heads[__builtin_ctz(rq->bitmap)];
+    unlink_locked(rq, t, nullptr);
+
+    return t;
+}
+
+static void enqueue(run_queue* rq, task* t) {
+    sync::spinlock_guard guard(rq->lock);
+    enqueue_locked(rq, t);
+}
+
+// Takes the most important task of the busiest other run queue that may run on `cpu`
+static task* steal(int cpu) {
+    run_queue* busiest = nullptr;
+    uint32_t busiest_running = 0;
+
+    for (int other = 0; other < arch::x86::MAX_CPUS; ++other) {
+        run_queue* rq = &g_run_queues[other];
+        if (other == cpu || !__atomic_load_n(&rq->online, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+
+        uint32_t running = __atomic_load_n(&rq->nr_running, __ATOMIC_RELAXED);
+        if (running > busiest_running) {
+            busiest = rq;
+            busiest_running = running;
+        }
+    }
+
+    if (!busiest) {
+        return nullptr;
+    }
+
+    sync::spinlock_guard guard(busiest->lock);
+    uint64_t cpu_bit = 1ULL << cpu;
+
+    for (uint32_t bitmap = busiest->bitmap; bitmap != 0; bitmap &= bitmap - 1) {
+        task* before = nullptr;
+
+        for (task* t = busiest->heads[__builtin_ctz(bitmap)]; t; before = t, t = t->next) {
+            if (t->affinity & cpu_bit) {
+                unlink_locked(busiest, t, before);
+                return t;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+// Runs on the CPU that switched, right after asm_switch_to, with interrupts disabled
+static void finish_switch(task* prev) {
+    run_queue* rq = &g_run_queues[arch::x86::current_cpu()];
+
+    if (prev->state == task_state::DEAD) {
+        ++rq->tasks_completed;
+
+        // This CPU has loaded the next task's address space, nothing else can be using it
+        if (prev->process) {
+            proc::release(prev->process);
+        }
+        free_task(prev);
+    } else if (!prev->is_idle) {
+        prev->state = task_state::RUNNABLE;
+        enqueue(rq, prev);
+    }
+}
+
+// Saves prev's FPU state if it used the FPU and arms #NM unless next still has its state loaded
+static void switch_fpu(task* prev, task* next, int cpu) {
+    bool active = arch::x86::this_cpu_read(&g_fpu_active);
+
+    if (active && prev->state != task_state::DEAD) {
+        arch::x86::save_fpu_state(&prev->fpu);
+    }
+
+    bool live = arch::x86::this_cpu_read(&g_fpu_owner) == next && next->fpu_cpu == cpu;
+    if (live == active) {
+        return;
+    }
+
+    if (live) {
+        arch::x86::clear_task_switched();
+    } else {
+        arch::x86::set_task_switched();
+    }
+    arch::x86::this_cpu_write(&g_fpu_active, live);
+}
+
+// Switches to the most important runnable task, caller has interrupts disabled
+static void schedule() {
+    int cpu = arch::x86::current_cpu();
+    run_queue* rq = &g_run_queues[cpu];
+    task* prev = arch::x86::this_cpu_read(&g_current_task);
+    bool prev_runnable = prev->state == task_state::RUNNING && !prev->is_idle;
+
+    task* next = nullptr;
+    {
+        sync::spinlock_guard guard(rq->lock);
+
+        // A running task keeps the CPU over less important ones
+        if (!prev_runnable || (rq->bitmap != 0 && __builtin_ctz(rq->bitmap) <= prev->priority)) {
+            next = dequeue_locked(rq);
+        }
+    }
+
+    if (!next && !prev_runnable) {
+        next = steal(cpu);
+
+        if (next) {
+            ++rq->migrations;
+
+            task_migrated_payload migrated = {.tsc = arch::x86::rdtsc(),
+                                              .tid = next->tid,
+                                              .from_cpu = static_cast<uint16_t>(next->cpu),
+                                              .to_cpu = static_cast<uint16_t>(cpu)};
+            record_event(rq, iris::EVENT_TASK_MIGRATED, &migrated);
+        }
+    }
+
+    if (!next) {
+        if (prev->state == task_state::RUNNING) {
+            return;
+        }
+        next = &rq->idle;
+    }
+
+    next->state = task_state::RUNNING;
+    next->cpu = cpu;
+    rq->ticks = 0;
+    ++rq->context_switches;
+    arch::x86::this_cpu_write(&g_current_task, next);
+
+    // Only rsp0 changes, the CPU reads it from the TSS on the next privilege change
+    arch::x86::set_kernel_stack(cpu, next->kernel_stack_top);
+    switch_fpu(prev, next, cpu);
+
+    // Kernel threads keep whatever address space is loaded (lazy TLB mode)
+    arch::x86::activate_address_space(next->cr3);
+
+    // No read-side critical section survives a context switch
+    sync::rcu_note_quiescent_state(cpu);
+
+    context_switch_payload switched = {
+        .tsc = arch::x86::rdtsc(), .prev_tid = prev->tid, .next_tid = next->tid};
+    record_event(rq, iris::EVENT_CONTEXT_SWITCH, &switched);
+
+    finish_switch(asm_switch_to(prev, next));
+}
+
+// First code of every task, entered from asm_task_entry with interrupts disabled
+EXTERN_C [[noreturn]] void task_bootstrap(task* prev) {
+    finish_switch(prev);
+    arch::x86::enable_interrupts();
+
+    task* self = arch::x86::this_cpu_read(&g_current_task);
+    self->entry(self->arg);
+
+    exit();
+}
+
+// MWAIT is only used with the interrupt break extension, so idle time ends before the handler runs
+static void detect_idle_method() {
+    using arch::x86::cpu_feature;
+
+    if (arch::x86::has_feature(cpu_feature::MONITOR) &&
+        arch::x86::has_feature(cpu_feature::MWAIT_EXTENSIONS) &&
+        arch::x86::has_feature(cpu_feature::MWAIT_INTERRUPT_BREAK)) {
+        g_idle_method = idle_method::MWAIT;
+    }
+}
+
+void init_cpu(int cpu) {
+    run_queue* rq = &g_run_queues[cpu];
+
+    // Every CPU is the same model, the BSP's answer holds for all of them
+    if (cpu == 0) {
+        detect_idle_method();
+    }
+
+    rq->idle.tid = 0;
+    rq->idle.cpu = cpu;
+    rq->idle.state = task_state::RUNNING;
+    rq->idle.priority = PRIORITY_COUNT - 1;
+    rq->idle.affinity = 1ULL << cpu;
+    rq->idle.is_idle = true;
+    rq->idle.kernel_stack_top = arch::x86::kernel_stack(cpu);
+    rq->idle.cr3 = arch::x86::kernel_address_space();
+    rq->idle.process = nullptr;
+    rq->idle.fpu_cpu = -1;
+
+    arch::x86::this_cpu_write(&g_current_task, &rq->idle);
+    __atomic_store_n(&rq->online, true, __ATOMIC_RELEASE);
+}
+
+task* spawn(task_fn fn, void* arg, uint8_t priority, uint64_t affinity) {
+    if (priority >= PRIORITY_COUNT || affinity == 0) {
+        return nullptr;
+    }
+
+    task* t = allocate_task();
+    if (!t) {
+        return nullptr;
+    }
+
+    t->entry = fn;
+    t->arg = arg;
+    t->affinity = affinity;
+    t->priority = priority;
+    t->tid = __atomic_fetch_add(&g_next_tid, 1, __ATOMIC_RELAXED);
+    t->state = task_state::RUNNABLE;
+    t->is_idle = false;
+    t->kernel_stack_top = reinterpret_cast<uint64_t>(t->stack + TASK_STACK_SIZE);
+    t->cr3 = arch::x86::kernel_address_space();
+    t->process = nullptr;
+
+    // A recycled slot may still be recorded as some CPU's FPU owner
+    t->fpu_cpu = -1;
+    t->fpu_used = false;
+
+    // asm_switch_to pops zeroed callee-saved registers and returns into asm_task_entry
+    auto* top = reinterpret_cast<uint64_t*>(t->stack + TASK_STACK_SIZE);
+    top[-1] = reinterpret_cast<uint64_t>(asm_task_entry);
+    memory::memzero(top - 1 - SWITCH_FRAME_REGISTERS, SWITCH_FRAME_REGISTERS * sizeof(uint64_t));
+    t->saved_rsp = reinterpret_cast<uint64_t>(top - 1 - SWITCH_FRAME_REGISTERS);
+
+    uint64_t rflags = arch::x86::save_and_disable_interrupts();
+
+    // Prefer the spawning CPU, idle CPUs pull from here when it gets busy
+    int cpu = arch::x86::current_cpu();
+    if (!(affinity & (1ULL << cpu))) {
+        cpu = __builtin_ctzll(affinity);
+    }
+
+    t->cpu = cpu;
+    enqueue(&g_run_queues[cpu], t);
+
+    if (cpu != arch::x86::current_cpu()) {
+        wake_idle_cpu(cpu);
+    }
+
+    arch::x86::restore_interrupts(rflags);
+
+    return t;
+}
+
+task* current_task() {
+    return arch::x86::this_cpu_read(&g_current_task);
+}
+
+void yield() {
+    uint64_t rflags = arch::x86::save_and_disable_interrupts();
+    schedule();
+    arch::x86::restore_interrupts(rflags);
+}
+
+void exit() {
+    arch::x86::disable_interrupts();
+
+    // Freed by finish_switch once the next task no longer runs on this stack
+    arch::x86::this_cpu_read(&g_current_task)->state = task_state::DEAD;
+    schedule();
+
+    __builtin_unreachable();
+}
+
+void switch_address_space(uint64_t cr3) {
+    uint64_t rflags = arch::x86::save_and_disable_interrupts();
+
+    arch::x86::this_cpu_read(&g_current_task)->cr3 = cr3;
+    arch::x86::activate_address_space(cr3);
+
+    arch::x86::restore_interrupts(rflags);
+}
+
+void tick() {
+    if (!arch::x86::per_cpu_online()) {
+        return;
+    }
+
+    run_queue* rq = &g_run_queues[arch::x86::current_cpu()];
+    if (!rq->online) {
+        return;
+    }
+
+    // The interrupted code had interrupts enabled, so it is only a reader if it says so
+    bool in_rcu_reader = sync::rcu_read_lock_held();
+    if (!in_rcu_reader) {
+        sync::rcu_quiescent_state();
+    }
+
+    // An idle CPU runs new work as soon as the interrupt returns into idle()
+    task* current = arch::x86::this_cpu_read(&g_current_task);
+    if (current->is_idle) {
+        return;
+    }
+
+    // A reader is preempted on the first tick after its critical section
+    if (++rq->ticks >= TIME_SLICE_TICKS && !in_rcu_reader) {
+        schedule();
+    }
+}
+
+void handle_fpu_trap() {
+    int cpu = arch::x86::current_cpu();
+    task* current = arch::x86::this_cpu_read(&g_current_task);
+
+    arch::x86::clear_task_switched();
+
+    // The previous owner's registers were saved when it was switched out
+    if (!current->fpu_used) {
+        arch::x86::reset_fpu_state(&current->fpu);
+        current->fpu_used = true;
+    }
+    arch::x86::restore_fpu_state(&current->fpu);
+
+    current->fpu_cpu = cpu;
+    arch::x86::this_cpu_write(&g_fpu_owner, current);
+    arch::x86::this_cpu_write(&g_fpu_active, true);
+}
+
+void copy_fpu_state(arch::x86::fpu_state* state) {
+    uint64_t rflags = arch::x86::save_and_disable_interrupts();
+    task* current = arch::x86::this_cpu_read(&g_current_task);
+
+    // Active means the current task owns the registers and may have changed them since saved
+    if (arch::x86::this_cpu_read(&g_fpu_active)) {
+        arch::x86::save_fpu_state(state);
+    } else if (current->fpu_used) {
+        memory::memcpy(state, &current->fpu, sizeof(arch::x86::fpu_state));
+    } else {
+        arch::x86::reset_fpu_state(state);
+    }
+
+    arch::x86::restore_interrupts(rflags);
+}
+
+void load_fpu_state(const arch::x86::fpu_state* state) {
+    uint64_t rflags = arch::x86::save_and_disable_interrupts();
+    task* current = arch::x86::this_cpu_read(&g_current_task);
+
+    memory::memcpy(&current->fpu, state, sizeof(arch::x86::fpu_state));
+    current->fpu_used = true;
+
+    if (arch::x86::this_cpu_read(&g_fpu_active)) {
+        arch::x86::restore_fpu_state(&current->fpu);
+    }
+
+    arch::x86::restore_interrupts(rflags);
+}
+
+// Caller has interrupts disabled
+static bool has_work(run_queue* rq) {
+    return __atomic_load_n(&rq->nr_running, __ATOMIC_RELAXED) != 0 || async::has_ready();
+}
+
+// Waits for work with interrupts disabled, returns once an interrupt or wakeup ended the wait
+static void wait_for_work(run_queue* rq) {
+    uint64_t start = arch::x86::rdtsc();
+    __atomic_store_n(&rq->idle_since, start, __ATOMIC_RELAXED);
+
+    if (g_idle_method == idle_method::MWAIT) {
+        // Announced before the re-check, so a waker either sees it or its work is seen below
+        __atomic_store_n(&rq->wakeup.sleeping, 1, __ATOMIC_SEQ_CST);
+        arch::x86::monitor(&rq->wakeup);
+
+        // Interrupts stay disabled and end the wait, they are serviced once the time is accounted
+        if (!has_work(rq)) {
+            arch::x86::mwait(MWAIT_HINT_C1, MWAIT_INTERRUPT_BREAK);
+        }
+
+        __atomic_store_n(&rq->wakeup.sleeping, 0, __ATOMIC_RELAXED);
+    } else {
+        // The interrupt that ends HLT is serviced before the time below is taken
+        arch::x86::enable_interrupts_and_halt();
+        arch::x86::disable_interrupts();
+    }
+
+    uint64_t end = arch::x86::rdtsc();
+
+    // Cleared before the total grows, a reader seeing the new total never adds the wait again
+    __atomic_store_n(&rq->idle_since, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&rq->idle_cycles, rq->idle_cycles + (end - start), __ATOMIC_RELEASE);
+    __atomic_store_n(&rq->wakeups, rq->wakeups + 1, __ATOMIC_RELAXED);
+}
+
+void idle() {
+    int cpu = arch::x86::current_cpu();
+    run_queue* rq = &g_run_queues[cpu];
+
+    arch::x86::disable_interrupts();
+
+    // Returns once this CPU's queue is empty and nothing could be stolen
+    schedule();
+
+    // Checked with interrupts off so a task or coroutine made ready for this CPU in the meantime
+    // is not slept on, work on other CPUs is stolen after the next timer tick
+    if (!has_work(rq)) {
+        wait_for_work(rq);
+    }
+
+    arch::x86::enable_interrupts();
+}
+
+void wake_idle_cpu(int cpu) {
+    idle_wakeup* wakeup = &g_run_queues[cpu].wakeup;
+
+    // Pairs with the sleeper's announcement, orders the caller's queueing before the check
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    // Only a sleeping CPU is stored to, busy ones keep the line in their cache
+    if (__atomic_load_n(&wakeup->sleeping, __ATOMIC_RELAXED)) {
+        __atomic_fetch_add(&wakeup->kicks, 1, __ATOMIC_RELAXED);
+    }
+}
+
+idle_method current_idle_method() {
+    return g_idle_method;
+}
+
+void set_event_tracing(bool enabled) {
+    __atomic_store_n(&g_event_tracing, enabled, __ATOMIC_RELAXED);
+}
+
+void flush_events() {
+    for (int cpu = 0; cpu < arch::x86::MAX_CPUS; ++cpu) {
+        run_queue* rq = &g_run_queues[cpu];
+        if (!__atomic_load_n(&rq->online, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+
+        // Popped copies free their slot before the slow serial transmission
+        sched_event entry;
+        while (rq->events.events.try_pop(&entry)) {
+            iris::emit_with_payload(entry.type, 0, static_cast<uint8_t>(cpu), entry.payload,
+                                    sizeof(entry.payload));
+        }
+    }
+}
+
+void emit_cpu_stats() {
+    for (int cpu = 0; cpu < arch::x86::MAX_CPUS; ++cpu) {
+        const run_queue* rq = &g_run_queues[cpu];
+        if (!__atomic_load_n(&rq->online, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+
+        cpu_stats_payload payload = {
+            .context_switches = __atomic_load_n(&rq->context_switches, __ATOMIC_RELAXED),
+            .migrations = __atomic_load_n(&rq->migrations, __ATOMIC_RELAXED),
+            .tasks_completed = __atomic_load_n(&rq->tasks_completed, __ATOMIC_RELAXED),
+            .dropped_events = __atomic_load_n(&rq->events.dropped, __ATOMIC_RELAXED)};
+
+        iris::emit_with_payload(iris::EVENT_SCHED_CPU_STATS, 0, static_cast<uint8_t>(cpu),
+                                &payload, sizeof(payload));
+    }
+}
+
+// Idle cycles of a CPU up to `now`, including the wait it may be in
+static uint64_t idle_cycles_until(const run_queue* rq, uint64_t now) {
+    // Total first, see wait_for_work for why this order cannot count a wait twice
+    uint64_t idle = __atomic_load_n(&rq->idle_cycles, __ATOMIC_ACQUIRE);
+    uint64_t since = __atomic_load_n(&rq->idle_since, __ATOMIC_RELAXED);
+
+    if (since != 0 && now > since) {
+        idle += now - since;
+    }
+    return idle;
+}
+
+void flush_utilization() {
+    uint64_t frequency = arch::x86::tsc_frequency();
+    if (frequency == 0) {
+        return;
+    }
+
+    uint64_t now = arch::x86::rdtsc();
+    if (now - g_last_utilization_report < frequency / 1000 * UTILIZATION_REPORT_INTERVAL_MS) {
+        return;
+    }
+    g_last_utilization_report = now;
+
+    for (int cpu = 0; cpu < arch::x86::MAX_CPUS; ++cpu) {
+        const run_queue* rq = &g_run_queues[cpu];
+        if (!__atomic_load_n(&rq->online, __ATOMIC_ACQUIRE)) {
+            continue;
+        }
+
+        utilization_snapshot* previous = &g_utilization_snapshots[cpu];
+        uint64_t idle = idle_cycles_until(rq, now);
+        uint64_t wakeups = __atomic_load_n(&rq->wakeups, __ATOMIC_RELAXED);
+
+        if (previous->tsc != 0) {
+            uint64_t window = now - previous->tsc;
+
+            // A wait that just ended may show up late, never report it as negative or over 100%
+            uint64_t idle_delta = idle > previous->idle_cycles ? idle - previous->idle_cycles : 0;
+
+            cpu_utilization_payload payload = {
+                .window_cycles = window,
+                .idle_cycles = idle_delta < window ? idle_delta : window,
+                .wakeups = wakeups - previous->wakeups,
+                .method = static_cast<uint8_t>(g_idle_method),
+                .reserved1 = 0,
+                .reserved2 = 0,
+                .reserved3 = 0};
+
+            iris::emit_with_payload(iris::EVENT_CPU_UTILIZATION, 0, static_cast<uint8_t>(cpu),
+                                    &payload, sizeof(payload));
+        }
+
+        previous->tsc = now;
+        if (idle > previous->idle_cycles) {
+            previous->idle_cycles = idle;
+        }
+        previous->wakeups = wakeups;
+    }
+}
+
+} // namespace sched
@@ -1,8 +1,100 @@
+#include <arch/x86/cpu/cpu.h>
+#include <async/completion.h>
+#include <iris/tracepoint.h>
 #include <serial/serial.h>
+#include <sync/spinlock.h>
 
 namespace serial {
 
+static_assert((RECEIVE_BUFFER_SIZE & (RECEIVE_BUFFER_SIZE - 1)) == 0,
+              "Receive buffer size must be a power of two");
+
+// Single-producer (receive interrupt) / single-consumer (readers) ring of one port
+struct receive_ring {
+    uint32_t head; // Written by the producer only
+    uint32_t tail; // Written by the consumer only
+    receive_stats stats;
+    async::completion data_ready; // Signalled when a burst was published
+    char data[RECEIVE_BUFFER_SIZE];
+};
+
+// Interrupt enable state of one port, the transmit interrupt is only armed while awaited
+struct transmit_state {
+    sync::spinlock lock;          // Serializes read-modify-write of the IER copy
+    uint8_t interrupts;           // Value last written to the IER
+    async::completion fifo_empty; // Signalled when the armed transmit interrupt fired
+};
+
+static receive_ring g_receive_rings[4];
+static transmit_state g_transmit_states[4];
+
+static int port_index(uint16_t port) {
+    switch (static_cast<port_base>(port)) {
+    case port_base::COM1:
+        return 0;
+    case port_base::COM2:
+        return 1;
+    case port_base::COM3:
+        return 2;
+    case port_base::COM4:
+        return 3;
+    }
+
+    return -1;
+}
+
+static receive_ring* receive_ring_for(uint16_t port) {
+    int index = port_index(port);
+    return index < 0 ? nullptr : &g_receive_rings[index];
+}
+
+static transmit_state* transmit_state_for(uint16_t port) {
+    int index = port_index(port);
+    return index < 0 ? nullptr : &g_transmit_states[index];
+}
+
+static void set_interrupts(uint16_t port, transmit_state* state, uint8_t interrupts) {
+    state->interrupts = interrupts;
+    outb(interrupt_enable_port_offset(port), interrupts);
+}
+
+// Moves every byte pending in the UART into the ring, must not race another producer
+static uint32_t drain_receive_fifo(uint16_t port, receive_ring* ring) {
+    uint32_t first = ring->head;
+    uint32_t head = first;
+
+    while (true) {
+        uint8_t status = inb(line_status_port_offset(port));
+
+        if (status & static_cast<uint8_t>(line_status_flags::OVERRUN_ERROR)) {
+            ++ring->stats.overruns;
+        }
+
+        if (!(status & static_cast<uint8_t>(line_status_flags::DATA_READY))) {
+            break;
+        }
+
+        auto chr = static_cast<char>(inb(data_port_offset(port)));
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+        if (head - tail >= RECEIVE_BUFFER_SIZE) {
+            ++ring->stats.dropped;
+            continue;
+        }
+
+        ring->data[head & (RECEIVE_BUFFER_SIZE - 1)] = chr;
+        ++head;
+        ++ring->stats.received;
+    }
+
+    // Publish the whole burst at once
+    __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+    return head - first;
+}
+
 void init_port(uint16_t port, baud_rate_divisor baud_divisor) {
+    iris::scope_trace<iris::tracepoint::SERIAL_INIT_PORT> trace;
+
     // Disable all interrupts
     outb(interrupt_enable_port_offset(port), 0x00);
 
@@ -26,7 +118,13 @@ void init_port(uint16_t port, baud_rate_divisor baud_divisor) {
     outb(modem_command_port_offset(port), modem_config);
 
     // Enable "Received Data Available" interrupt
-    outb(interrupt_enable_port_offset(port), 0x01);
+    auto interrupts = static_cast<uint8_t>(interrupt_enable_flags::RECEIVED_DATA_AVAILABLE);
+    if (transmit_state* state = transmit_state_for(port)) {
+        sync::irq_spinlock_guard guard(state->lock);
+        set_interrupts(port, state, interrupts);
+    } else {
+        outb(interrupt_enable_port_offset(port), interrupts);
+    }
 }
 
 void set_baud_rate(uint16_t port, baud_rate_divisor divisor) {
@@ -84,14 +182,173 @@ void write(uint16_t port, const char* str, uint32_t length) {
     }
 }
 
+void write_raw(uint16_t port, const void* data, uint32_t length) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (uint32_t i = 0; i < length; i++) {
+        write(port, static_cast<char>(bytes[i]));
+    }
+}
+
+uint32_t write_burst(uint16_t port, const void* data, uint32_t length) {
+    if (!is_transmit_queue_empty(port)) {
+        return 0;
+    }
+
+    // An empty FIFO takes a whole burst without checking the line status per byte
+    uint32_t burst = length < TRANSMIT_FIFO_SIZE ? length : TRANSMIT_FIFO_SIZE;
+    outsb(data_port_offset(port), data, burst);
+    return burst;
+}
+
+void handle_interrupt(uint16_t port) {
+    receive_ring* ring = receive_ring_for(port);
+    transmit_state* state = transmit_state_for(port);
+    if (!ring) {
+        return;
+    }
+
+    if (drain_receive_fifo(port, ring) > 0) {
+        ring->data_ready.signal();
+    }
+
+    constexpr auto TRANSMIT_INTERRUPT =
+        static_cast<uint8_t>(interrupt_enable_flags::TRANSMIT_HOLDING_EMPTY);
+    bool transmit_empty = false;
+
+    {
+        sync::irq_spinlock_guard guard(state->lock);
+
+        // Disarm once it fired, an empty FIFO would otherwise keep raising it
+        if ((state->interrupts & TRANSMIT_INTERRUPT) && is_transmit_queue_empty(port)) {
+            set_interrupts(port, state, state->interrupts & ~TRANSMIT_INTERRUPT);
+            transmit_empty = true;
+        }
+    }
+
+    if (transmit_empty) {
+        state->fifo_empty.signal();
+    }
+}
+
+bool try_read(uint16_t port, char* chr) {
+    return read(port, chr, 1) == 1;
+}
+
+uint32_t read(uint16_t port, char* buffer, uint32_t length) {
+    receive_ring* ring = receive_ring_for(port);
+    if (!ring) {
+        return 0;
+    }
+
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint32_t count = 0;
+
+    while (count < length && tail != head) {
+        buffer[count++] = ring->data[tail & (RECEIVE_BUFFER_SIZE - 1)];
+        ++tail;
+    }
+
+    // Release the slots only after they have been copied out
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    return count;
+}
+
 char read(uint16_t port) {
-    // Wait until data is available
-    while (!is_data_available(port)) {
-        // Busy wait
+    receive_ring* ring = receive_ring_for(port);
+    char chr;
+
+    if (!ring) {
+        // No ring for unknown ports, fall back to polling the UART
+        while (!is_data_available(port)) {
+            arch::x86::cpu_relax();
+        }
+        return static_cast<char>(inb(data_port_offset(port)));
+    }
+
+    bool interrupts_enabled = arch::x86::read_rflags() & arch::x86::RFLAGS_INTERRUPT_ENABLE;
+
+    while (true) {
+        // Keep the receive interrupt out while this context acts as the producer
+        arch::x86::disable_interrupts();
+        drain_receive_fifo(port, ring);
+
+        if (try_read(port, &chr)) {
+            break;
+        }
+
+        if (interrupts_enabled) {
+            arch::x86::enable_interrupts_and_halt();
+        } else {
+            arch::x86::cpu_relax();
+        }
+    }
+
+    if (interrupts_enabled) {
+        arch::x86::enable_interrupts();
+    }
+
+    return chr;
+}
+
+async::task<void> wait_transmit_empty(uint16_t port) {
+    transmit_state* state = transmit_state_for(port);
+
+    while (!is_transmit_queue_empty(port)) {
+        if (!state) {
+            // No interrupt state for unknown ports, fall back to polling the UART
+            arch::x86::cpu_relax();
+            continue;
+        }
+
+        {
+            sync::irq_spinlock_guard guard(state->lock);
+            auto transmit_interrupt =
+                static_cast<uint8_t>(interrupt_enable_flags::TRANSMIT_HOLDING_EMPTY);
+            set_interrupts(port, state, state->interrupts | transmit_interrupt);
+        }
+
+        // A signal left over from an earlier wait only costs another pass through the check
+        co_await state->fifo_empty;
+    }
+}
+
+async::task<uint32_t> read_async(uint16_t port, char* buffer, uint32_t length) {
+    receive_ring* ring = receive_ring_for(port);
+    if (!ring || length == 0) {
+        co_return 0;
+    }
+
+    while (true) {
+        uint32_t count = read(port, buffer, length);
+        if (count > 0) {
+            co_return count;
+        }
+
+        // A burst published since the read above has already signalled, so no wakeup is lost
+        co_await ring->data_ready;
+    }
+}
+
+async::task<void> write_async(uint16_t port, const void* data, uint32_t length) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+
+    while (length > 0) {
+        co_await wait_transmit_empty(port);
+
+        uint32_t burst = write_burst(port, bytes, length);
+        bytes += burst;
+        length -= burst;
+    }
+}
+
+receive_stats get_receive_stats(uint16_t port) {
+    receive_ring* ring = receive_ring_for(port);
+    if (!ring) {
+        return {};
     }
 
-    // Read and return the character from the data port
-    return static_cast<char>(inb(data_port_offset(port)));
+    return ring->stats;
 }
 
 } // namespace serial
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include <iris/iris.h>
+#include <sync/lock_stats.h>
+
+namespace sync {
+
+void emit_lock_stats(const char* name, const lock_stats* stats) {
+    if (!stats) {
+        return;
+    }
+
+    lock_stats_payload payload = {.acquisitions = stats->acquisitions,
+                                  .contended = stats->contended,
+                                  .spin_cycles = stats->spin_cycles,
+                                  .max_hold_cycles = stats->max_hold_cycles,
+                                  .name = {}};
+
+    for (size_t i = 0; i < LOCK_NAME_SIZE - 1 && name[i] != '\0'; ++i) {
+        payload.name[i] = name[i];
+    }
+
+    iris::emit_with_payload(iris::EVENT_LOCK_STATS, 0, 0, &payload, sizeof(payload));
+}
+
+} // namespace sync
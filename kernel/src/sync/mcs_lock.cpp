@@ -0,0 +1,30 @@
+#include <sync/mcs_lock.h>
+
+namespace sync {
+
+void mcs_lock::wait_for_handover(node* predecessor, node* self) {
+    uint64_t start = arch::x86::rdtsc();
+
+    __atomic_store_n(&predecessor->next, self, __ATOMIC_RELEASE);
+
+    // Spin on our own node only, the predecessor clears the flag on release
+    while (__atomic_load_n(&self->locked, __ATOMIC_ACQUIRE)) {
+        arch::x86::cpu_relax();
+    }
+
+    // A contended acquisition always counts at least one cycle of waiting
+    uint64_t waited = arch::x86::rdtsc() - start;
+    account_acquired(stats_storage(), waited != 0 ? waited : 1);
+}
+
+mcs_lock::node* mcs_lock::wait_for_successor(node* self) {
+    // A successor swapped itself into the tail but has not linked itself to us yet
+    node* successor;
+    while (!(successor = __atomic_load_n(&self->next, __ATOMIC_ACQUIRE))) {
+        arch::x86::cpu_relax();
+    }
+
+    return successor;
+}
+
+} // namespace sync
@@ -0,0 +1,155 @@
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/smp/smp.h>
+#include <sched/sched.h>
+#include <sync/rcu.h>
+#include <sync/spinlock.h>
+
+namespace sync {
+
+// Quiescent state counter and callbacks of one CPU, only the owner touches the lists
+struct alignas(64) rcu_cpu {
+    uint64_t quiescent_count; // Read by the CPU that checks for the end of a grace period
+    rcu_head* next;           // Queued, not waiting for a grace period yet
+    rcu_head** next_tail;
+    rcu_head* waiting; // Run once grace period `waiting_for` completed
+    uint64_t waiting_for;
+};
+
+/*
+    Grace periods are numbered. One is in progress while started != completed,
+    it ends once every CPU online at its start changed its quiescent counter
+    from the snapshot taken then. Callbacks queued while one is in progress may
+    race with readers that already passed it, so they wait for the next one.
+*/
+struct rcu_state {
+    spinlock lock;
+    uint64_t started;
+    uint64_t completed;
+    bool needed; // Callbacks wait for a grace period after the current one
+    int cpus;    // CPUs the current grace period waits for
+    uint64_t snapshot[arch::x86::MAX_CPUS];
+};
+
+DEFINE_PER_CPU(uint64_t, g_rcu_read_nesting);
+
+static rcu_cpu g_rcu_cpus[arch::x86::MAX_CPUS];
+static rcu_state g_rcu;
+
+// Caller holds g_rcu.lock
+static void start_grace_period_locked() {
+    g_rcu.cpus = arch::x86::online_cpu_count();
+    for (int cpu = 0; cpu < g_rcu.cpus; ++cpu) {
+        g_rcu.snapshot[cpu] = __atomic_load_n(&g_rcu_cpus[cpu].quiescent_count, __ATOMIC_ACQUIRE);
+    }
+
+    __atomic_store_n(&g_rcu.started, g_rcu.started + 1, __ATOMIC_RELEASE);
+}
+
+// Returns the grace period whose end makes everything removed so far safe to free
+static uint64_t request_grace_period() {
+    irq_spinlock_guard guard(g_rcu.lock);
+
+    if (g_rcu.started == g_rcu.completed) {
+        start_grace_period_locked();
+        return g_rcu.started;
+    }
+
+    g_rcu.needed = true;
+    return g_rcu.started + 1;
+}
+
+// Called with interrupts disabled
+static void advance_grace_period() {
+    if (__atomic_load_n(&g_rcu.started, __ATOMIC_ACQUIRE) ==
+        __atomic_load_n(&g_rcu.completed, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    // Whoever holds the lock checks for every CPU
+    if (!g_rcu.lock.try_lock()) {
+        return;
+    }
+
+    bool done = g_rcu.started != g_rcu.completed;
+    for (int cpu = 0; cpu < g_rcu.cpus && done; ++cpu) {
+        done = __atomic_load_n(&g_rcu_cpus[cpu].quiescent_count, __ATOMIC_ACQUIRE) !=
+               g_rcu.snapshot[cpu];
+    }
+
+    if (done) {
+        __atomic_store_n(&g_rcu.completed, g_rcu.started, __ATOMIC_RELEASE);
+
+        if (g_rcu.needed) {
+            g_rcu.needed = false;
+            start_grace_period_locked();
+        }
+    }
+
+    g_rcu.lock.unlock();
+}
+
+// Runs this CPU's finished batch and moves the queued callbacks up, interrupts disabled
+static void process_callbacks(rcu_cpu* rc) {
+    if (rc->waiting && __atomic_load_n(&g_rcu.completed, __ATOMIC_ACQUIRE) >= rc->waiting_for) {
+        rcu_head* head = rc->waiting;
+        rc->waiting = nullptr;
+
+        while (head) {
+            rcu_head* next = head->next;
+            head->callback(head);
+            head = next;
+        }
+    }
+
+    if (!rc->waiting && rc->next) {
+        rc->waiting = rc->next;
+        rc->next = nullptr;
+        rc->next_tail = &rc->next;
+        rc->waiting_for = request_grace_period();
+    }
+}
+
+void rcu_note_quiescent_state(int cpu) {
+    rcu_cpu* rc = &g_rcu_cpus[cpu];
+
+    // Orders the reads of this CPU's finished critical sections before the report
+    __atomic_store_n(&rc->quiescent_count, rc->quiescent_count + 1, __ATOMIC_RELEASE);
+}
+
+void rcu_quiescent_state() {
+    uint64_t rflags = arch::x86::save_and_disable_interrupts();
+    int cpu = arch::x86::current_cpu();
+
+    rcu_note_quiescent_state(cpu);
+    advance_grace_period();
+    process_callbacks(&g_rcu_cpus[cpu]);
+
+    arch::x86::restore_interrupts(rflags);
+}
+
+void call_rcu(rcu_head* head, rcu_callback callback) {
+    uint64_t rflags = arch::x86::save_and_disable_interrupts();
+    rcu_cpu* rc = &g_rcu_cpus[arch::x86::current_cpu()];
+
+    head->next = nullptr;
+    head->callback = callback;
+
+    if (!rc->next_tail) {
+        rc->next_tail = &rc->next;
+    }
+    *rc->next_tail = head;
+    rc->next_tail = &head->next;
+
+    arch::x86::restore_interrupts(rflags);
+}
+
+void synchronize_rcu() {
+    uint64_t target = request_grace_period();
+
+    while (__atomic_load_n(&g_rcu.completed, __ATOMIC_ACQUIRE) < target) {
+        rcu_quiescent_state();
+        sched::yield();
+    }
+}
+
+} // namespace sync
@@ -0,0 +1,28 @@
+#include <sync/spinlock.h>
+
+namespace sync {
+
+// PAUSE instructions per waiter ahead of us, roughly the cost of a short critical section
+inline constexpr uint32_t BACKOFF_PAUSES_PER_WAITER = 32;
+
+void spinlock::lock_slow(uint16_t ticket) {
+    uint64_t start = arch::x86::rdtsc();
+
+    while (true) {
+        uint16_t owner = __atomic_load_n(&m_owner, __ATOMIC_ACQUIRE);
+        if (owner == ticket) {
+            break;
+        }
+
+        auto waiters_ahead = static_cast<uint16_t>(ticket - owner);
+        for (uint32_t i = waiters_ahead * BACKOFF_PAUSES_PER_WAITER; i > 0; --i) {
+            arch::x86::cpu_relax();
+        }
+    }
+
+    // A contended acquisition always counts at least one cycle of waiting
+    uint64_t waited = arch::x86::rdtsc() - start;
+    account_acquired(stats_storage(), waited != 0 ? waited : 1);
+}
+
+} // namespace sync
@@ -0,0 +1,68 @@
+#include <proc/process.h>
+#include <sched/sched.h>
+#include <syscall/syscall.h>
+
+namespace syscall {
+
+static int64_t sys_null(uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t) {
+    return 0;
+}
+
+static int64_t sys_exit(uint64_t code, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t) {
+    if (proc::current_process()) {
+        proc::exit(static_cast<int32_t>(code));
+    }
+
+    sched::exit();
+}
+
+static int64_t sys_yield(uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t) {
+    sched::yield();
+    return 0;
+}
+
+static int64_t sys_fork(uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t) {
+    // The SYSCALL entry builds the frame at the very top of the kernel stack
+    const auto* frame = reinterpret_cast<const arch::x86::syscall_frame*>(
+        sched::current_task()->kernel_stack_top - sizeof(arch::x86::syscall_frame));
+
+    proc::process* child = proc::fork(frame);
+    if (!child) {
+        return ERROR_NO_MEMORY;
+    }
+
+    return child->pid;
+}
+
+static int64_t sys_wait(uint64_t pid, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t) {
+    int32_t exit_code;
+    if (!proc::wait(static_cast<uint32_t>(pid), &exit_code)) {
+        return ERROR_NO_CHILD;
+    }
+
+    return exit_code;
+}
+
+// Indexed by syscall_number
+static constexpr syscall_handler g_syscall_table[SYSCALL_COUNT] = {
+    sys_null,
+    sys_exit,
+    sys_yield,
+    sys_fork,
+    sys_wait,
+};
+
+} // namespace syscall
+
+void handle_syscall(arch::x86::syscall_frame* frame) {
+    uint64_t number = frame->rax;
+
+    if (number >= syscall::SYSCALL_COUNT) [[unlikely]] {
+        frame->rax = static_cast<uint64_t>(syscall::ERROR_NO_SYSCALL);
+        return;
+    }
+
+    int64_t result = syscall::g_syscall_table[number](frame->rdi, frame->rsi, frame->rdx,
+                                                      frame->r10, frame->r8, frame->r9);
+    frame->rax = static_cast<uint64_t>(result);
+}
@@ -0,0 +1,490 @@
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/smp/smp.h>
+#include <block/block.h>
+#include <iris/iris.h>
+#include <memory/memory.h>
+#include <memory/pmm.h>
+#include <virtio/blk.h>
+#include <virtio/virtio.h>
+
+namespace virtio::blk {
+
+// virtio_blk_config
+inline constexpr size_t CONFIG_CAPACITY = 0;
+inline constexpr size_t CONFIG_SEG_MAX = 12;
+inline constexpr size_t CONFIG_BLK_SIZE = 20;
+inline constexpr size_t CONFIG_NUM_QUEUES = 34;
+
+// Device feature bits
+inline constexpr uint32_t F_SEG_MAX = 2;
+inline constexpr uint32_t F_RO = 5;
+inline constexpr uint32_t F_BLK_SIZE = 6;
+inline constexpr uint32_t F_FLUSH = 9;
+inline constexpr uint32_t F_MQ = 12;
+
+// Command types
+inline constexpr uint32_t T_IN = 0;
+inline constexpr uint32_t T_OUT = 1;
+inline constexpr uint32_t T_FLUSH = 4;
+
+// Status byte the device writes last
+inline constexpr uint8_t S_OK = 0;
+inline constexpr uint8_t S_IOERR = 1;
+inline constexpr uint8_t S_UNSUPP = 2;
+
+struct command_header {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t sector;
+} __attribute__((packed));
+
+// Device-visible memory of one command: header, status byte and its indirect descriptor table
+inline constexpr size_t SLOT_SIZE = 512;
+inline constexpr size_t SLOT_STATUS_OFFSET = sizeof(command_header);
+inline constexpr size_t SLOT_TABLE_OFFSET = 32;
+inline constexpr size_t SLOT_DESCRIPTORS = (SLOT_SIZE - SLOT_TABLE_OFFSET) / sizeof(descriptor);
+inline constexpr size_t SLOTS_PER_FRAME = arch::x86::PAGE_SIZE / SLOT_SIZE;
+
+// Header and status take a descriptor each, the rest carry data
+inline constexpr size_t MAX_SEGMENTS = SLOT_DESCRIPTORS - 2;
+
+// Merged commands stop growing at 1MB
+inline constexpr uint32_t MAX_MERGED_SECTORS = 2048;
+
+inline constexpr uint16_t NO_SLOT = 0xFFFF;
+
+static_assert(MAX_IN_FLIGHT % SLOTS_PER_FRAME == 0, "Slots must fill whole frames");
+
+struct command_slot {
+    uint8_t* memory;
+    uint64_t phys;
+    block::request* requests; // Merged requests of the command, linked through next
+    uint16_t next_free;
+};
+
+struct blk_device;
+
+struct request_queue {
+    virtqueue vq;
+    blk_device* owner;
+    command_slot slots[MAX_IN_FLIGHT];
+    uint16_t free_slot;
+    bool interrupts;
+    arch::x86::irq_vector vector;
+    char irq_name[arch::x86::IRQ_NAME_LENGTH + 1];
+
+    // Updated with vq.lock held
+    uint64_t requests;
+    uint64_t commands;
+    uint64_t notifications;
+    uint64_t interrupt_count;
+};
+
+struct blk_device {
+    virtio::device transport;
+    block::device block;
+    request_queue queues[MAX_QUEUES];
+    uint32_t max_segments;
+    bool indirect;
+};
+
+static blk_device g_devices[MAX_DEVICES];
+static size_t g_device_count = 0;
+
+static int translate_status(uint8_t status) {
+    switch (status) {
+    case S_OK:
+        return block::STATUS_OK;
+    case S_UNSUPP:
+        return block::STATUS_UNSUPPORTED;
+    default:
+        return block::STATUS_IO_ERROR;
+    }
+}
+
+// Builds one device command from `count` requests and adds it to the queue, vq.lock held
+static bool issue(blk_device* dev, request_queue* queue, block::request* const* requests,
+                  size_t count) {
+    if (queue->free_slot == NO_SLOT) {
+        return false;
+    }
+
+    command_slot* slot = &queue->slots[queue->free_slot];
+    block::request* first = requests[0];
+
+    auto* header = reinterpret_cast<command_header*>(slot->memory);
+    header->type = first->op == block::operation::READ    ? T_IN
+                   : first->op == block::operation::WRITE ? T_OUT
+                                                          : T_FLUSH;
+    header->reserved = 0;
+    header->sector = first->op == block::operation::FLUSH ? 0 : first->sector;
+    slot->memory[SLOT_STATUS_OFFSET] = 0xFF;
+
+    buffer buffers[MAX_SEGMENTS + 2];
+    size_t buffer_count = 0;
+    buffers[buffer_count++] = {.address = slot->phys,
+                               .length = sizeof(command_header),
+                               .device_writable = false};
+
+    for (size_t i = 0; i < count; ++i) {
+        block::request* req = requests[i];
+        if (req->op != block::operation::FLUSH) {
+            buffers[buffer_count++] = {.address = req->buffer,
+                                       .length = req->sector_count * block::SECTOR_SIZE,
+                                       .device_writable = req->op == block::operation::READ};
+        }
+        req->next = i + 1 < count ? requests[i + 1] : nullptr;
+    }
+
+    buffers[buffer_count++] = {.address = slot->phys + SLOT_STATUS_OFFSET,
+                               .length = 1,
+                               .device_writable = true};
+
+    bool added;
+    if (dev->indirect) {
+        auto* table = reinterpret_cast<descriptor*>(slot->memory + SLOT_TABLE_OFFSET);
+        for (size_t i = 0; i < buffer_count; ++i) {
+            table[i] = {.address = buffers[i].address,
+                        .length = buffers[i].length,
+                        .flags = static_cast<uint16_t>(
+                            (buffers[i].device_writable ? DESC_F_WRITE : 0) |
+                            (i + 1 < buffer_count ? DESC_F_NEXT : 0)),
+                        .next = static_cast<uint16_t>(i + 1)};
+        }
+        added = add_indirect(&queue->vq, slot->phys + SLOT_TABLE_OFFSET, buffer_count, slot);
+    } else {
+        added = add_chain(&queue->vq, buffers, buffer_count, slot);
+    }
+
+    if (!added) {
+        return false;
+    }
+
+    slot->requests = first;
+    queue->free_slot = slot->next_free;
+    queue->requests += count;
+    ++queue->commands;
+    return true;
+}
+
+// Requests after `index` that continue the same transfer, so one command carries them all
+static size_t mergeable_run(const blk_device* dev, block::request* const* requests, size_t index,
+                            size_t count) {
+    const block::request* first = requests[index];
+    if (first->op == block::operation::FLUSH) {
+        return 1;
+    }
+
+    uint64_t end = first->sector + first->sector_count;
+    uint32_t sectors = first->sector_count;
+    size_t run = 1;
+
+    while (index + run < count && run < dev->max_segments) {
+        const block::request* next = requests[index + run];
+        if (next->op != first->op || next->sector != end ||
+            sectors + next->sector_count > MAX_MERGED_SECTORS) {
+            break;
+        }
+        end += next->sector_count;
+        sectors += next->sector_count;
+        ++run;
+    }
+    return run;
+}
+
+static size_t submit(block::device* bdev, uint16_t queue_index, block::request* const* requests,
+                     size_t count) {
+    auto* dev = static_cast<blk_device*>(bdev->driver_data);
+    request_queue* queue = &dev->queues[queue_index];
+
+    sync::irq_spinlock_guard guard(queue->vq.lock);
+
+    size_t accepted = 0;
+    while (accepted < count) {
+        size_t run = mergeable_run(dev, requests, accepted, count);
+        if (!issue(dev, queue, requests + accepted, run)) {
+            break;
+        }
+        accepted += run;
+    }
+
+    // One doorbell for the whole batch, skipped if the device is still working through it
+    if (kick(&queue->vq)) {
+        ++queue->notifications;
+    }
+    return accepted;
+}
+
+// Takes finished commands off the used ring, vq.lock held
+static block::request* reap(request_queue* queue, block::request* completed) {
+    block::request** tail = &completed;
+    while (*tail) {
+        tail = &(*tail)->next;
+    }
+
+    while (auto* slot = static_cast<command_slot*>(pop_used(&queue->vq, nullptr))) {
+        int status = translate_status(slot->memory[SLOT_STATUS_OFFSET]);
+        for (block::request* req = slot->requests; req; req = req->next) {
+            req->status = status;
+        }
+
+        *tail = slot->requests;
+        while (*tail) {
+            tail = &(*tail)->next;
+        }
+
+        slot->requests = nullptr;
+        slot->next_free = queue->free_slot;
+        queue->free_slot = static_cast<uint16_t>(slot - queue->slots);
+    }
+    return completed;
+}
+
+// Callbacks run without the queue lock, they may submit again
+static void finish(block::request* completed) {
+    while (completed) {
+        block::request* next = completed->next;
+        block::complete(completed, completed->status);
+        completed = next;
+    }
+}
+
+static void queue_interrupt_handler(void* context) {
+    auto* queue = static_cast<request_queue*>(context);
+    block::request* completed = nullptr;
+
+    {
+        sync::irq_spinlock_guard guard(queue->vq.lock);
+        ++queue->interrupt_count;
+
+        // Commands used while callbacks were re-armed raised no interrupt of their own
+        do {
+            completed = reap(queue, completed);
+        } while (!enable_callbacks(&queue->vq));
+    }
+
+    finish(completed);
+}
+
+static void poll(block::device* bdev, uint16_t queue_index) {
+    auto* dev = static_cast<blk_device*>(bdev->driver_data);
+    request_queue* queue = &dev->queues[queue_index];
+    block::request* completed;
+
+    {
+        sync::irq_spinlock_guard guard(queue->vq.lock);
+        completed = reap(queue, nullptr);
+    }
+
+    finish(completed);
+}
+
+static const block::device_operations g_operations = {.submit = submit, .poll = poll};
+
+static bool init_slots(request_queue* queue) {
+    for (size_t frame = 0; frame < MAX_IN_FLIGHT / SLOTS_PER_FRAME; ++frame) {
+        uint64_t phys = memory::pmm::allocate_frame();
+        if (!phys) {
+            return false;
+        }
+
+        auto* memory = static_cast<uint8_t*>(arch::x86::phys_to_virt(phys));
+        memory::memzero(memory, arch::x86::PAGE_SIZE);
+
+        for (size_t i = 0; i < SLOTS_PER_FRAME; ++i) {
+            command_slot* slot = &queue->slots[frame * SLOTS_PER_FRAME + i];
+            slot->memory = memory + i * SLOT_SIZE;
+            slot->phys = phys + i * SLOT_SIZE;
+        }
+    }
+
+    for (uint16_t i = 0; i < MAX_IN_FLIGHT; ++i) {
+        queue->slots[i].next_free = static_cast<uint16_t>(i + 1 < MAX_IN_FLIGHT ? i + 1 : NO_SLOT);
+    }
+    queue->free_slot = 0;
+    return true;
+}
+
+static void format_name(char* out, size_t size, const char* prefix, size_t prefix_length,
+                        char suffix, int number) {
+    size_t length = 0;
+    for (size_t i = 0; i < prefix_length && length + 1 < size; ++i) {
+        out[length++] = prefix[i];
+    }
+    if (suffix && length + 1 < size) {
+        out[length++] = suffix;
+    }
+    if (number >= 0 && length + 3 < size) {
+        out[length++] = '-';
+        out[length++] = 'q';
+        out[length++] = static_cast<char>('0' + number);
+    }
+    out[length] = '\0';
+}
+
+// Queue n is served by CPU n, its MSI-X entry is n
+static bool init_queue(blk_device* dev, uint16_t index) {
+    request_queue* queue = &dev->queues[index];
+    queue->owner = dev;
+    format_name(queue->irq_name, sizeof(queue->irq_name), dev->block.name,
+                sizeof(dev->block.name) - 1, '\0', index);
+
+    if (!init_slots(queue)) {
+        return false;
+    }
+
+    uint16_t msix_entry = NO_VECTOR;
+    if (dev->transport.msix &&
+        arch::x86::allocate_irq_vector(index, queue_interrupt_handler, queue, queue->irq_name,
+                                       &queue->vector)) {
+        msix_entry = index;
+    }
+
+    if (!setup_queue(&dev->transport, &queue->vq, index, MAX_QUEUE_SIZE, msix_entry,
+                     queue->vector)) {
+        if (msix_entry != NO_VECTOR) {
+            arch::x86::free_irq_vector(queue->vector);
+        }
+        return false;
+    }
+
+    // setup_queue() leaves callbacks disabled if the device refused the MSI-X entry
+    queue->interrupts = msix_entry != NO_VECTOR && !queue->vq.callbacks_disabled;
+    if (msix_entry != NO_VECTOR && !queue->interrupts) {
+        arch::x86::free_irq_vector(queue->vector);
+    }
+    return true;
+}
+
+static void emit_device(const blk_device* dev) {
+    device_payload payload = {};
+    payload.sector_count = dev->block.sector_count;
+    payload.features = dev->transport.features;
+    payload.block_size = dev->block.block_size;
+    payload.max_segments = dev->max_segments;
+    payload.queue_count = dev->block.queue_count;
+    payload.queue_size = dev->queues[0].vq.size;
+    payload.interrupts = dev->block.polled ? 0 : 1;
+    payload.read_only = dev->block.read_only ? 1 : 0;
+    memory::memcpy(payload.name, dev->block.name, sizeof(payload.name));
+
+    iris::emit_with_payload(iris::EVENT_BLOCK_DEVICE, 0, 0, &payload, sizeof(payload));
+}
+
+static bool probe(pci::device* pci) {
+    if (g_device_count >= MAX_DEVICES) {
+        return false;
+    }
+
+    blk_device* dev = &g_devices[g_device_count];
+    virtio::device* transport = &dev->transport;
+    if (!init_device(transport, pci)) {
+        return false;
+    }
+
+    uint64_t wanted = (1ULL << F_RING_INDIRECT_DESC) | (1ULL << F_RING_EVENT_IDX) |
+                      (1ULL << F_SEG_MAX) | (1ULL << F_RO) | (1ULL << F_BLK_SIZE) |
+                      (1ULL << F_FLUSH) | (1ULL << F_MQ);
+    if (!transport->device_config || !negotiate_features(transport, wanted)) {
+        fail(transport);
+        return false;
+    }
+
+    block::device* bdev = &dev->block;
+    format_name(bdev->name, sizeof(bdev->name), "vd", 2, static_cast<char>('a' + g_device_count),
+                -1);
+    bdev->sector_count = read_config64(transport, CONFIG_CAPACITY);
+    bdev->block_size = block::SECTOR_SIZE;
+    bdev->read_only = has_feature(transport, F_RO);
+    bdev->ops = &g_operations;
+    bdev->driver_data = dev;
+
+    if (has_feature(transport, F_BLK_SIZE)) {
+        uint32_t block_size = read_config32(transport, CONFIG_BLK_SIZE);
+        if (block_size >= block::SECTOR_SIZE && block_size % block::SECTOR_SIZE == 0) {
+            bdev->block_size = block_size;
+        }
+    }
+
+    // Without indirect descriptors a command takes ring descriptors for every segment
+    dev->indirect = has_feature(transport, F_RING_INDIRECT_DESC);
+    dev->max_segments = MAX_SEGMENTS;
+    if (has_feature(transport, F_SEG_MAX)) {
+        uint32_t seg_max = read_config32(transport, CONFIG_SEG_MAX);
+        if (seg_max != 0 && seg_max < dev->max_segments) {
+            dev->max_segments = seg_max;
+        }
+    }
+
+    size_t queue_count = 1;
+    if (has_feature(transport, F_MQ)) {
+        queue_count = read_config16(transport, CONFIG_NUM_QUEUES);
+    }
+    size_t cpu_count = static_cast<size_t>(arch::x86::online_cpu_count());
+    queue_count = queue_count < cpu_count ? queue_count : cpu_count;
+    queue_count = queue_count < MAX_QUEUES ? queue_count : MAX_QUEUES;
+
+    // A queue that cannot be set up ends the list, the device still works with fewer
+    uint16_t ready = 0;
+    while (ready < queue_count && init_queue(dev, ready)) {
+        ++ready;
+    }
+    if (ready == 0) {
+        fail(transport);
+        return false;
+    }
+
+    bdev->queue_count = ready;
+    bdev->polled = false;
+    for (uint16_t i = 0; i < ready; ++i) {
+        bdev->polled = bdev->polled || !dev->queues[i].interrupts;
+    }
+
+    driver_ok(transport);
+    if (!block::register_device(bdev)) {
+        fail(transport);
+        return false;
+    }
+
+    pci->driver_data = dev;
+    ++g_device_count;
+    emit_device(dev);
+    return true;
+}
+
+static const pci::device_id g_ids[] = {
+    {.vendor_id = PCI_VENDOR_ID, .device_id = PCI_DEVICE_ID_TRANSITIONAL},
+    {.vendor_id = PCI_VENDOR_ID, .device_id = PCI_DEVICE_ID_MODERN},
+};
+
+static const pci::driver g_driver = {.name = "virtio-blk",
+                                     .ids = g_ids,
+                                     .id_count = sizeof(g_ids) / sizeof(g_ids[0]),
+                                     .probe = probe};
+
+void init() {
+    pci::register_driver(&g_driver);
+}
+
+void emit_stats() {
+    for (size_t i = 0; i < g_device_count; ++i) {
+        const blk_device* dev = &g_devices[i];
+
+        for (uint16_t q = 0; q < dev->block.queue_count; ++q) {
+            const request_queue* queue = &dev->queues[q];
+
+            queue_stats_payload payload = {};
+            payload.requests = __atomic_load_n(&queue->requests, __ATOMIC_RELAXED);
+            payload.commands = __atomic_load_n(&queue->commands, __ATOMIC_RELAXED);
+            payload.notifications = __atomic_load_n(&queue->notifications, __ATOMIC_RELAXED);
+            payload.interrupts = __atomic_load_n(&queue->interrupt_count, __ATOMIC_RELAXED);
+            payload.queue = q;
+            memory::memcpy(payload.name, dev->block.name, sizeof(payload.name));
+
+            iris::emit_with_payload(iris::EVENT_BLOCK_QUEUE_STATS, 0, 0, &payload,
+                                    sizeof(payload));
+        }
+    }
+}
+
+} // namespace virtio::blk
@@ -0,0 +1,527 @@
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/paging/paging.h>
+#include <arch/x86/smp/smp.h>
+#include <iris/iris.h>
+#include <memory/memory.h>
+#include <memory/pmm.h>
+#include <net/net.h>
+#include <virtio/net.h>
+#include <virtio/virtio.h>
+
+namespace virtio::net {
+
+// virtio_net_config
+inline constexpr size_t CONFIG_MAC = 0;
+inline constexpr size_t CONFIG_MAX_QUEUE_PAIRS = 8;
+
+// Device feature bits
+inline constexpr uint32_t F_CSUM = 0;       // Device completes partial transmit checksums
+inline constexpr uint32_t F_GUEST_CSUM = 1; // Device reports checksum state of received frames
+inline constexpr uint32_t F_MAC = 5;
+inline constexpr uint32_t F_CTRL_VQ = 17;
+inline constexpr uint32_t F_MQ = 22;
+
+// net_header::flags
+inline constexpr uint8_t HDR_F_NEEDS_CSUM = 1;
+inline constexpr uint8_t HDR_F_DATA_VALID = 2;
+
+// Control commands
+inline constexpr uint8_t CTRL_MQ = 4;
+inline constexpr uint8_t CTRL_MQ_VQ_PAIRS_SET = 0;
+inline constexpr uint8_t CTRL_OK = 0;
+
+// Control command memory: class and command, data, then the status byte the device writes
+inline constexpr size_t CONTROL_DATA_OFFSET = 16;
+inline constexpr size_t CONTROL_ACK_OFFSET = 32;
+
+// Polls for a control command's answer before the device is given up on
+inline constexpr uint64_t CONTROL_SPIN_LIMIT = 1ULL << 24;
+
+// Without F_MTU the device sends standard 1500-byte MTU frames
+inline constexpr uint16_t DEFAULT_MTU = 1500;
+
+// Sent frames returned to the pool at once
+inline constexpr size_t REAP_BATCH = 64;
+
+// virtio_net_hdr, placed in the headroom right in front of every frame
+struct net_header {
+    uint8_t flags;
+    uint8_t gso_type;
+    uint16_t header_length;
+    uint16_t gso_size;
+    uint16_t checksum_start;
+    uint16_t checksum_offset;
+    uint16_t buffer_count; // Written by the device, always 1 without mergeable buffers
+} __attribute__((packed));
+
+static_assert(sizeof(net_header) == 12, "virtio-net header must be 12 bytes");
+static_assert(sizeof(net_header) <= ::net::PACKET_HEADROOM, "Header must fit the headroom");
+
+struct net_device;
+
+struct queue_pair {
+    virtqueue receive;
+    virtqueue transmit;
+    net_device* owner;
+    uint16_t index;
+    bool interrupts;
+    arch::x86::irq_vector vector;
+    char irq_name[arch::x86::IRQ_NAME_LENGTH + 1];
+
+    // Updated with receive.lock held
+    uint64_t receive_packets;
+    uint64_t receive_bytes;
+    uint64_t receive_notifications;
+    uint32_t refill_failures;
+
+    // Updated with transmit.lock held
+    uint64_t transmit_packets;
+    uint64_t transmit_bytes;
+    uint64_t transmit_reaps;
+    uint64_t transmit_notifications;
+
+    uint64_t interrupt_count;
+};
+
+struct net_device {
+    virtio::device transport;
+    ::net::device net;
+    queue_pair pairs[MAX_QUEUE_PAIRS];
+    virtqueue control;
+    uint8_t* control_memory;
+    uint64_t control_phys;
+    uint16_t max_queue_pairs;
+};
+
+static net_device g_devices[MAX_DEVICES];
+static size_t g_device_count = 0;
+
+static net_header* header_of(::net::packet* pkt) {
+    return reinterpret_cast<net_header*>(pkt->data - sizeof(net_header));
+}
+
+// Posts pool packets to a receive queue until it is full, receive.lock held
+static void refill(queue_pair* pair) {
+    ::net::packet* packets[RECEIVE_BATCH];
+
+    while (pair->receive.free_count > 0) {
+        size_t wanted = pair->receive.free_count < RECEIVE_BATCH ? pair->receive.free_count
+                                                                  : RECEIVE_BATCH;
+        size_t count = ::net::allocate_packets(packets, wanted);
+
+        // The header lands in the headroom, so the frame starts at packet::data without a copy
+        for (size_t i = 0; i < count; ++i) {
+            buffer buf = {.address = packets[i]->phys - sizeof(net_header),
+                          .length = sizeof(net_header) + ::net::MAX_FRAME_SIZE,
+                          .device_writable = true};
+            add_chain(&pair->receive, &buf, 1, packets[i]);
+        }
+
+        // The rest is posted by the next receive or poll()
+        if (count < wanted) {
+            ++pair->refill_failures;
+            break;
+        }
+    }
+}
+
+// Takes received frames off the used ring and reposts buffers, receive.lock held
+static size_t reap_received(queue_pair* pair, ::net::packet** packets) {
+    size_t count = 0;
+    uint32_t length;
+
+    while (count < RECEIVE_BATCH) {
+        auto* pkt = static_cast<::net::packet*>(pop_used(&pair->receive, &length));
+        if (!pkt) {
+            break;
+        }
+
+        if (length <= sizeof(net_header)) {
+            ::net::free_packet(pkt);
+            continue;
+        }
+
+        // A partial checksum comes from a sender on this host, the frame never crossed a wire
+        const net_header* header = header_of(pkt);
+        pkt->length = length - static_cast<uint32_t>(sizeof(net_header));
+        pkt->queue = pair->index;
+        pkt->flags = header->flags & (HDR_F_DATA_VALID | HDR_F_NEEDS_CSUM)
+                         ? ::net::PACKET_CHECKSUM_VALID
+                         : 0;
+
+        ++pair->receive_packets;
+        pair->receive_bytes += pkt->length;
+        packets[count++] = pkt;
+    }
+
+    refill(pair);
+    if (kick(&pair->receive)) {
+        ++pair->receive_notifications;
+    }
+    return count;
+}
+
+static void receive(queue_pair* pair, bool rearm) {
+    ::net::packet* packets[RECEIVE_BATCH];
+    bool more = true;
+
+    while (more) {
+        size_t count;
+        {
+            sync::irq_spinlock_guard guard(pair->receive.lock);
+            count = reap_received(pair, packets);
+
+            // Frames used while callbacks were re-armed raised no interrupt of their own
+            more = count == RECEIVE_BATCH || (rearm && !enable_callbacks(&pair->receive));
+        }
+
+        // Handlers run without the lock, they may transmit or poll
+        ::net::deliver(&pair->owner->net, packets, count);
+    }
+}
+
+// Returns every frame the device finished sending to the pool, transmit.lock held
+static void reap_sent(queue_pair* pair) {
+    ::net::packet* sent[REAP_BATCH];
+    size_t count = 0;
+    bool reaped = false;
+
+    while (auto* pkt = static_cast<::net::packet*>(pop_used(&pair->transmit, nullptr))) {
+        sent[count++] = pkt;
+        if (count == REAP_BATCH) {
+            ::net::free_packets(sent, count);
+            count = 0;
+            reaped = true;
+        }
+    }
+
+    if (count > 0) {
+        ::net::free_packets(sent, count);
+        reaped = true;
+    }
+    if (reaped) {
+        ++pair->transmit_reaps;
+    }
+}
+
+static size_t transmit(::net::device* ndev, uint16_t queue_index, ::net::packet* const* packets,
+                       size_t count) {
+    auto* dev = static_cast<net_device*>(ndev->driver_data);
+    queue_pair* pair = &dev->pairs[queue_index];
+
+    sync::irq_spinlock_guard guard(pair->transmit.lock);
+
+    // The transmit queue has no interrupt, frames sent since the last call are freed here
+    reap_sent(pair);
+
+    size_t accepted = 0;
+    for (; accepted < count; ++accepted) {
+        ::net::packet* pkt = packets[accepted];
+
+        net_header* header = header_of(pkt);
+        memory::memzero(header, sizeof(net_header));
+        if (pkt->flags & ::net::PACKET_CHECKSUM_PARTIAL) {
+            header->flags = HDR_F_NEEDS_CSUM;
+            header->checksum_start = pkt->checksum_start;
+            header->checksum_offset = pkt->checksum_offset;
+        }
+
+        buffer buf = {.address = pkt->phys - sizeof(net_header),
+                      .length = static_cast<uint32_t>(sizeof(net_header)) + pkt->length,
+                      .device_writable = false};
+        if (!add_chain(&pair->transmit, &buf, 1, pkt)) {
+            break;
+        }
+
+        ++pair->transmit_packets;
+        pair->transmit_bytes += pkt->length;
+    }
+
+    // One doorbell for the whole batch, skipped if the device is still working through it
+    if (kick(&pair->transmit)) {
+        ++pair->transmit_notifications;
+    }
+    return accepted;
+}
+
+static void poll(::net::device* ndev, uint16_t queue_index) {
+    auto* dev = static_cast<net_device*>(ndev->driver_data);
+    queue_pair* pair = &dev->pairs[queue_index];
+
+    receive(pair, false);
+
+    sync::irq_spinlock_guard guard(pair->transmit.lock);
+    reap_sent(pair);
+}
+
+static const ::net::device_operations g_operations = {.transmit = transmit, .poll = poll};
+
+static void receive_interrupt_handler(void* context) {
+    auto* pair = static_cast<queue_pair*>(context);
+    __atomic_add_fetch(&pair->interrupt_count, 1, __ATOMIC_RELAXED);
+    receive(pair, true);
+}
+
+static void format_name(char* out, size_t size, const char* prefix, size_t prefix_length,
+                        char suffix, int number) {
+    size_t length = 0;
+    for (size_t i = 0; i < prefix_length && length + 1 < size; ++i) {
+        out[length++] = prefix[i];
+    }
+    if (suffix && length + 1 < size) {
+        out[length++] = suffix;
+    }
+    if (number >= 0 && length + 3 < size) {
+        out[length++] = '-';
+        out[length++] = 'q';
+        out[length++] = static_cast<char>('0' + number);
+    }
+    out[length] = '\0';
+}
+
+// Pair n is served by CPU n, its receive queue interrupts through MSI-X entry n
+static bool init_pair(net_device* dev, uint16_t index) {
+    queue_pair* pair = &dev->pairs[index];
+    pair->owner = dev;
+    pair->index = index;
+    format_name(pair->irq_name, sizeof(pair->irq_name), "eth", 3,
+                static_cast<char>('0' + g_device_count), index);
+
+    uint16_t msix_entry = NO_VECTOR;
+    if (dev->transport.msix &&
+        arch::x86::allocate_irq_vector(index, receive_interrupt_handler, pair, pair->irq_name,
+                                       &pair->vector)) {
+        msix_entry = index;
+    }
+
+    // Sent frames are reaped by the next transmit, so the transmit queue never interrupts
+    if (!setup_queue(&dev->transport, &pair->receive, static_cast<uint16_t>(2 * index),
+                     MAX_QUEUE_SIZE, msix_entry, pair->vector) ||
+        !setup_queue(&dev->transport, &pair->transmit, static_cast<uint16_t>(2 * index + 1),
+                     MAX_QUEUE_SIZE, NO_VECTOR, pair->vector)) {
+        if (msix_entry != NO_VECTOR) {
+            arch::x86::free_irq_vector(pair->vector);
+        }
+        return false;
+    }
+
+    // setup_queue() leaves callbacks disabled if the device refused the MSI-X entry
+    pair->interrupts = msix_entry != NO_VECTOR && !pair->receive.callbacks_disabled;
+    if (msix_entry != NO_VECTOR && !pair->interrupts) {
+        arch::x86::free_irq_vector(pair->vector);
+    }
+
+    // Posted now, the device is notified once it is live
+    sync::irq_spinlock_guard guard(pair->receive.lock);
+    refill(pair);
+    return true;
+}
+
+static bool init_control(net_device* dev, uint16_t index) {
+    uint64_t phys = memory::pmm::allocate_frame();
+    if (!phys) {
+        return false;
+    }
+
+    if (!setup_queue(&dev->transport, &dev->control, index, MAX_QUEUE_SIZE, NO_VECTOR,
+                     arch::x86::irq_vector{})) {
+        memory::pmm::free_frame(phys);
+        return false;
+    }
+
+    dev->control_phys = phys;
+    dev->control_memory = static_cast<uint8_t*>(arch::x86::phys_to_virt(phys));
+    return true;
+}
+
+// Sends one control command and spins for the answer, only used while probing
+static bool control_command(net_device* dev, uint8_t command_class, uint8_t command,
+                            const void* data, uint32_t length) {
+    if (!dev->control_memory) {
+        return false;
+    }
+
+    uint8_t* memory = dev->control_memory;
+    volatile uint8_t* ack = memory + CONTROL_ACK_OFFSET;
+    memory[0] = command_class;
+    memory[1] = command;
+    memory::memcpy(memory + CONTROL_DATA_OFFSET, data, length);
+    *ack = 0xFF;
+
+    const buffer buffers[] = {
+        {.address = dev->control_phys, .length = 2, .device_writable = false},
+        {.address = dev->control_phys + CONTROL_DATA_OFFSET,
+         .length = length,
+         .device_writable = false},
+        {.address = dev->control_phys + CONTROL_ACK_OFFSET, .length = 1, .device_writable = true},
+    };
+
+    sync::irq_spinlock_guard guard(dev->control.lock);
+    if (!add_chain(&dev->control, buffers, 3, dev)) {
+        return false;
+    }
+    kick(&dev->control);
+
+    for (uint64_t spins = 0; spins < CONTROL_SPIN_LIMIT; ++spins) {
+        if (pop_used(&dev->control, nullptr)) {
+            return *ack == CTRL_OK;
+        }
+        arch::x86::cpu_relax();
+    }
+    return false;
+}
+
+static void emit_device(const net_device* dev) {
+    device_payload payload = {};
+    payload.features = dev->transport.features;
+    memory::memcpy(payload.mac, dev->net.mac, sizeof(payload.mac));
+    payload.mtu = dev->net.mtu;
+    payload.queue_pairs = dev->net.queue_count;
+    payload.max_queue_pairs = dev->max_queue_pairs;
+    payload.receive_queue_size = dev->pairs[0].receive.size;
+    payload.transmit_queue_size = dev->pairs[0].transmit.size;
+    payload.interrupts = dev->net.polled ? 0 : 1;
+    payload.checksum_offload = static_cast<uint8_t>(
+        (has_feature(&dev->transport, F_CSUM) ? 1 : 0) |
+        (has_feature(&dev->transport, F_GUEST_CSUM) ? 2 : 0));
+    memory::memcpy(payload.name, dev->net.name, sizeof(payload.name));
+
+    iris::emit_with_payload(iris::EVENT_NET_DEVICE, 0, 0, &payload, sizeof(payload));
+}
+
+static bool probe(pci::device* pci) {
+    if (g_device_count >= MAX_DEVICES || !::net::init_pool()) {
+        return false;
+    }
+
+    net_device* dev = &g_devices[g_device_count];
+    virtio::device* transport = &dev->transport;
+    if (!init_device(transport, pci)) {
+        return false;
+    }
+
+    uint64_t wanted = (1ULL << F_RING_EVENT_IDX) | (1ULL << F_CSUM) | (1ULL << F_GUEST_CSUM) |
+                      (1ULL << F_MAC) | (1ULL << F_CTRL_VQ) | (1ULL << F_MQ);
+    if (!transport->device_config || !negotiate_features(transport, wanted)) {
+        fail(transport);
+        return false;
+    }
+
+    ::net::device* ndev = &dev->net;
+    format_name(ndev->name, sizeof(ndev->name), "eth", 3, static_cast<char>('0' + g_device_count),
+                -1);
+    ndev->mtu = DEFAULT_MTU;
+    ndev->checksum_offload = has_feature(transport, F_CSUM);
+    ndev->ops = &g_operations;
+    ndev->driver_data = dev;
+
+    // Without an assigned address a locally administered one is made up
+    for (size_t i = 0; i < ::net::MAC_LENGTH; ++i) {
+        ndev->mac[i] = has_feature(transport, F_MAC) ? read_config8(transport, CONFIG_MAC + i) : 0;
+    }
+    if (!has_feature(transport, F_MAC)) {
+        ndev->mac[0] = 0x02;
+        ndev->mac[5] = static_cast<uint8_t>(g_device_count + 1);
+    }
+
+    // Multiqueue is switched on through the control queue, which follows the last pair
+    bool multiqueue = has_feature(transport, F_MQ) && has_feature(transport, F_CTRL_VQ);
+    dev->max_queue_pairs = multiqueue ? read_config16(transport, CONFIG_MAX_QUEUE_PAIRS) : 1;
+    if (dev->max_queue_pairs == 0) {
+        dev->max_queue_pairs = 1;
+    }
+
+    size_t pair_count = dev->max_queue_pairs;
+    size_t cpu_count = static_cast<size_t>(arch::x86::online_cpu_count());
+    pair_count = pair_count < cpu_count ? pair_count : cpu_count;
+    pair_count = pair_count < MAX_QUEUE_PAIRS ? pair_count : MAX_QUEUE_PAIRS;
+
+    // A pair that cannot be set up ends the list, the device still works with fewer
+    uint16_t ready = 0;
+    while (ready < pair_count && init_pair(dev, ready)) {
+        ++ready;
+    }
+    if (ready == 0) {
+        fail(transport);
+        return false;
+    }
+
+    if (has_feature(transport, F_CTRL_VQ) &&
+        !init_control(dev, static_cast<uint16_t>(2 * dev->max_queue_pairs))) {
+        ready = 1;
+    }
+
+    driver_ok(transport);
+
+    for (uint16_t i = 0; i < ready; ++i) {
+        sync::irq_spinlock_guard guard(dev->pairs[i].receive.lock);
+        if (kick(&dev->pairs[i].receive)) {
+            ++dev->pairs[i].receive_notifications;
+        }
+    }
+
+    // The device starts out with one pair, the others carry traffic once it agreed
+    uint16_t pairs = ready;
+    if (pairs > 1 && !control_command(dev, CTRL_MQ, CTRL_MQ_VQ_PAIRS_SET, &pairs, sizeof(pairs))) {
+        ready = 1;
+    }
+
+    ndev->queue_count = ready;
+    ndev->polled = false;
+    for (uint16_t i = 0; i < ready; ++i) {
+        ndev->polled = ndev->polled || !dev->pairs[i].interrupts;
+    }
+
+    if (!::net::register_device(ndev)) {
+        fail(transport);
+        return false;
+    }
+
+    pci->driver_data = dev;
+    ++g_device_count;
+    emit_device(dev);
+    return true;
+}
+
+static const pci::device_id g_ids[] = {
+    {.vendor_id = PCI_VENDOR_ID, .device_id = PCI_DEVICE_ID_TRANSITIONAL},
+    {.vendor_id = PCI_VENDOR_ID, .device_id = PCI_DEVICE_ID_MODERN},
+};
+
+static const pci::driver g_driver = {.name = "virtio-net",
+                                     .ids = g_ids,
+                                     .id_count = sizeof(g_ids) / sizeof(g_ids[0]),
+                                     .probe = probe};
+
+void init() {
+    pci::register_driver(&g_driver);
+}
+
+void emit_stats() {
+    for (size_t i = 0; i < g_device_count; ++i) {
+        const net_device* dev = &g_devices[i];
+
+        for (uint16_t q = 0; q < dev->net.queue_count; ++q) {
+            const queue_pair* pair = &dev->pairs[q];
+
+            queue_stats_payload payload = {};
+            payload.receive_packets = __atomic_load_n(&pair->receive_packets, __ATOMIC_RELAXED);
+            payload.receive_bytes = __atomic_load_n(&pair->receive_bytes, __ATOMIC_RELAXED);
+            payload.transmit_packets = __atomic_load_n(&pair->transmit_packets, __ATOMIC_RELAXED);
+            payload.transmit_bytes = __atomic_load_n(&pair->transmit_bytes, __ATOMIC_RELAXED);
+            payload.transmit_reaps = __atomic_load_n(&pair->transmit_reaps, __ATOMIC_RELAXED);
+            payload.notifications =
+                __atomic_load_n(&pair->receive_notifications, __ATOMIC_RELAXED) +
+                __atomic_load_n(&pair->transmit_notifications, __ATOMIC_RELAXED);
+            payload.interrupts = __atomic_load_n(&pair->interrupt_count, __ATOMIC_RELAXED);
+            payload.refill_failures = __atomic_load_n(&pair->refill_failures, __ATOMIC_RELAXED);
+            payload.queue = q;
+            memory::memcpy(payload.name, dev->net.name, sizeof(payload.name));
+
+            iris::emit_with_payload(iris::EVENT_NET_QUEUE_STATS, 0, 0, &payload,
+                                    sizeof(payload));
+        }
+    }
+}
+
+} // namespace virtio::net
@@ -0,0 +1,457 @@
+#include <arch/x86/cpu/cpu.h>
+#include <arch/x86/paging/paging.h>
+#include <memory/memory.h>
+#include <memory/pmm.h>
+#include <virtio/virtio.h>
+
+namespace virtio {
+
+// Vendor capability of the modern PCI transport, offsets from the capability
+inline constexpr uint16_t CAP_CONFIG_TYPE = 3;
+inline constexpr uint16_t CAP_BAR = 4;
+inline constexpr uint16_t CAP_OFFSET = 8;
+inline constexpr uint16_t CAP_NOTIFY_MULTIPLIER = 16;
+
+inline constexpr uint8_t CONFIG_TYPE_COMMON = 1;
+inline constexpr uint8_t CONFIG_TYPE_NOTIFY = 2;
+inline constexpr uint8_t CONFIG_TYPE_ISR = 3;
+inline constexpr uint8_t CONFIG_TYPE_DEVICE = 4;
+
+// virtio_pci_common_cfg
+inline constexpr size_t COMMON_DEVICE_FEATURE_SELECT = 0;
+inline constexpr size_t COMMON_DEVICE_FEATURE = 4;
+inline constexpr size_t COMMON_DRIVER_FEATURE_SELECT = 8;
+inline constexpr size_t COMMON_DRIVER_FEATURE = 12;
+inline constexpr size_t COMMON_CONFIG_MSIX_VECTOR = 16;
+inline constexpr size_t COMMON_NUM_QUEUES = 18;
+inline constexpr size_t COMMON_DEVICE_STATUS = 20;
+inline constexpr size_t COMMON_CONFIG_GENERATION = 21;
+inline constexpr size_t COMMON_QUEUE_SELECT = 22;
+inline constexpr size_t COMMON_QUEUE_SIZE = 24;
+inline constexpr size_t COMMON_QUEUE_MSIX_VECTOR = 26;
+inline constexpr size_t COMMON_QUEUE_ENABLE = 28;
+inline constexpr size_t COMMON_QUEUE_NOTIFY_OFF = 30;
+inline constexpr size_t COMMON_QUEUE_DESC = 32;
+inline constexpr size_t COMMON_QUEUE_DRIVER = 40;
+inline constexpr size_t COMMON_QUEUE_DEVICE = 48;
+
+// Device status bits
+inline constexpr uint8_t STATUS_ACKNOWLEDGE = 1U << 0;
+inline constexpr uint8_t STATUS_DRIVER = 1U << 1;
+inline constexpr uint8_t STATUS_DRIVER_OK = 1U << 2;
+inline constexpr uint8_t STATUS_FEATURES_OK = 1U << 3;
+inline constexpr uint8_t STATUS_FAILED = 1U << 7;
+
+// Split ring layout, in 16-bit words for the avail ring and bytes for the used ring
+inline constexpr size_t AVAIL_FLAGS = 0;
+inline constexpr size_t AVAIL_INDEX = 1;
+inline constexpr size_t AVAIL_RING = 2;
+inline constexpr uint16_t AVAIL_F_NO_INTERRUPT = 1U << 0;
+
+inline constexpr size_t USED_FLAGS = 0;
+inline constexpr size_t USED_INDEX = 2;
+inline constexpr size_t USED_RING = 4;
+inline constexpr size_t USED_ELEMENT_SIZE = 8;
+inline constexpr uint16_t USED_F_NO_NOTIFY = 1U << 0;
+
+// Both rings share a frame, the avail ring of MAX_QUEUE_SIZE entries ends before this
+inline constexpr size_t USED_RING_OFFSET = 1024;
+
+static_assert(sizeof(descriptor) * MAX_QUEUE_SIZE <= arch::x86::PAGE_SIZE,
+              "Descriptor table must fit in one frame");
+static_assert((AVAIL_RING + MAX_QUEUE_SIZE + 1) * sizeof(uint16_t) <= USED_RING_OFFSET,
+              "Avail ring must end before the used ring");
+static_assert(USED_RING_OFFSET + USED_RING + USED_ELEMENT_SIZE * MAX_QUEUE_SIZE +
+                      sizeof(uint16_t) <= arch::x86::PAGE_SIZE,
+              "Used ring must fit in the rings frame");
+
+template <typename T>
+static T mmio_read(volatile uint8_t* base, size_t offset) {
+    return *reinterpret_cast<volatile T*>(base + offset);
+}
+
+template <typename T>
+static void mmio_write(volatile uint8_t* base, size_t offset, T value) {
+    *reinterpret_cast<volatile T*>(base + offset) = value;
+}
+
+// 64-bit fields of the common configuration may only be accessed as two halves
+static void write_common64(const device* dev, size_t offset, uint64_t value) {
+    mmio_write<uint32_t>(dev->common, offset, static_cast<uint32_t>(value));
+    mmio_write<uint32_t>(dev->common, offset + 4, static_cast<uint32_t>(value >> 32));
+}
+
+static uint8_t status(const device* dev) {
+    return mmio_read<uint8_t>(dev->common, COMMON_DEVICE_STATUS);
+}
+
+static void add_status(const device* dev, uint8_t bits) {
+    mmio_write<uint8_t>(dev->common, COMMON_DEVICE_STATUS, status(dev) | bits);
+}
+
+static uint16_t used_index(const virtqueue* queue) {
+    return *reinterpret_cast<volatile uint16_t*>(queue->used + USED_INDEX);
+}
+
+// Event index the device publishes after the used ring: notify once avail passes it
+static uint16_t avail_event(const virtqueue* queue) {
+    return *reinterpret_cast<volatile uint16_t*>(queue->used + USED_RING +
+                                                 USED_ELEMENT_SIZE * queue->size);
+}
+
+// Event index the driver publishes after the avail ring: interrupt once used passes it
+static void set_used_event(virtqueue* queue, uint16_t event) {
+    queue->avail[AVAIL_RING + queue->size] = event;
+}
+
+// True if moving an index from `old` to `next` crosses `event`
+static bool need_event(uint16_t event, uint16_t next, uint16_t old) {
+    return static_cast<uint16_t>(next - event - 1) < static_cast<uint16_t>(next - old);
+}
+
+bool init_device(device* dev, pci::device* pci) {
+    *dev = {};
+    dev->pci = pci;
+
+    pci::enable(pci, pci::COMMAND_MEMORY_SPACE | pci::COMMAND_BUS_MASTER);
+
+    // Several capabilities usually point into the same BAR, each is mapped once
+    volatile uint8_t* bars[pci::BAR_COUNT] = {};
+
+    for (uint8_t cap = pci::find_capability(pci, pci::CAPABILITY_VENDOR); cap != 0;
+         cap = pci::find_capability(pci, pci::CAPABILITY_VENDOR, cap)) {
+        uint8_t type = pci::read8(pci, cap + CAP_CONFIG_TYPE);
+        uint8_t bar = pci::read8(pci, cap + CAP_BAR);
+        if (bar >= pci::BAR_COUNT) {
+            continue;
+        }
+
+        if (!bars[bar]) {
+            bars[bar] = static_cast<volatile uint8_t*>(pci::map_bar(pci, bar));
+            if (!bars[bar]) {
+                continue;
+            }
+        }
+        volatile uint8_t* region = bars[bar] + pci::read32(pci, cap + CAP_OFFSET);
+
+        // The first capability of a type is the preferred one
+        if (type == CONFIG_TYPE_COMMON && !dev->common) {
+            dev->common = region;
+        } else if (type == CONFIG_TYPE_NOTIFY && !dev->notify_base) {
+            dev->notify_base = region;
+            dev->notify_multiplier = pci::read32(pci, cap + CAP_NOTIFY_MULTIPLIER);
+        } else if (type == CONFIG_TYPE_ISR && !dev->isr) {
+            dev->isr = region;
+        } else if (type == CONFIG_TYPE_DEVICE && !dev->device_config) {
+            dev->device_config = region;
+        }
+    }
+
+    if (!dev->common || !dev->notify_base || !dev->isr) {
+        return false;
+    }
+
+    mmio_write<uint8_t>(dev->common, COMMON_DEVICE_STATUS, 0);
+    while (status(dev) != 0) {
+        arch::x86::cpu_relax();
+    }
+
+    add_status(dev, STATUS_ACKNOWLEDGE);
+    add_status(dev, STATUS_DRIVER);
+
+    dev->queue_count = mmio_read<uint16_t>(dev->common, COMMON_NUM_QUEUES);
+    dev->msix = pci->msix_offset != 0;
+    if (dev->msix) {
+        mmio_write<uint16_t>(dev->common, COMMON_CONFIG_MSIX_VECTOR, NO_VECTOR);
+    }
+    return true;
+}
+
+bool negotiate_features(device* dev, uint64_t wanted) {
+    mmio_write<uint32_t>(dev->common, COMMON_DEVICE_FEATURE_SELECT, 0);
+    uint64_t offered = mmio_read<uint32_t>(dev->common, COMMON_DEVICE_FEATURE);
+    mmio_write<uint32_t>(dev->common, COMMON_DEVICE_FEATURE_SELECT, 1);
+    offered |= static_cast<uint64_t>(mmio_read<uint32_t>(dev->common, COMMON_DEVICE_FEATURE))
+               << 32;
+
+    uint64_t accepted = offered & (wanted | (1ULL << F_VERSION_1));
+    if (!((accepted >> F_VERSION_1) & 1)) {
+        fail(dev);
+        return false;
+    }
+
+    mmio_write<uint32_t>(dev->common, COMMON_DRIVER_FEATURE_SELECT, 0);
+    mmio_write<uint32_t>(dev->common, COMMON_DRIVER_FEATURE, static_cast<uint32_t>(accepted));
+    mmio_write<uint32_t>(dev->common, COMMON_DRIVER_FEATURE_SELECT, 1);
+    mmio_write<uint32_t>(dev->common, COMMON_DRIVER_FEATURE,
+                         static_cast<uint32_t>(accepted >> 32));
+
+    // The device clears FEATURES_OK again if it cannot work with the subset
+    add_status(dev, STATUS_FEATURES_OK);
+    if (!(status(dev) & STATUS_FEATURES_OK)) {
+        fail(dev);
+        return false;
+    }
+
+    dev->features = accepted;
+    return true;
+}
+
+bool setup_queue(device* dev, virtqueue* queue, uint16_t index, uint16_t max_size,
+                 uint16_t msix_entry, arch::x86::irq_vector vector) {
+    mmio_write<uint16_t>(dev->common, COMMON_QUEUE_SELECT, index);
+
+    uint16_t size = mmio_read<uint16_t>(dev->common, COMMON_QUEUE_SIZE);
+    if (size == 0 || index >= dev->queue_count) {
+        return false;
+    }
+    if (size > max_size) {
+        size = max_size;
+    }
+    if (size > MAX_QUEUE_SIZE) {
+        size = MAX_QUEUE_SIZE;
+    }
+
+    // Split rings need a power of two
+    while (size & (size - 1)) {
+        size &= static_cast<uint16_t>(size - 1);
+    }
+
+    uint64_t descriptor_phys = memory::pmm::allocate_frame();
+    uint64_t rings_phys = memory::pmm::allocate_frame();
+    if (!descriptor_phys || !rings_phys) {
+        if (descriptor_phys) {
+            memory::pmm::free_frame(descriptor_phys);
+        }
+        if (rings_phys) {
+            memory::pmm::free_frame(rings_phys);
+        }
+        return false;
+    }
+
+    void* descriptors = arch::x86::phys_to_virt(descriptor_phys);
+    void* rings = arch::x86::phys_to_virt(rings_phys);
+    memory::memzero(descriptors, arch::x86::PAGE_SIZE);
+    memory::memzero(rings, arch::x86::PAGE_SIZE);
+
+    // Assigned field by field, the queue's lock is not copyable
+    queue->index = index;
+    queue->size = size;
+    queue->descriptors = static_cast<descriptor*>(descriptors);
+    queue->avail = static_cast<volatile uint16_t*>(rings);
+    queue->used = static_cast<volatile uint8_t*>(rings) + USED_RING_OFFSET;
+    queue->descriptor_phys = descriptor_phys;
+    queue->rings_phys = rings_phys;
+    queue->free_head = 0;
+    queue->free_count = size;
+    queue->avail_index = 0;
+    queue->kicked_index = 0;
+    queue->last_used = 0;
+    queue->event_index = has_feature(dev, F_RING_EVENT_IDX);
+    queue->callbacks_disabled = false;
+
+    // Free descriptors are linked through their next field
+    for (uint16_t i = 0; i < size; ++i) {
+        queue->descriptors[i].next = static_cast<uint16_t>(i + 1);
+        queue->tokens[i] = nullptr;
+    }
+
+    mmio_write<uint16_t>(dev->common, COMMON_QUEUE_SIZE, size);
+    write_common64(dev, COMMON_QUEUE_DESC, descriptor_phys);
+    write_common64(dev, COMMON_QUEUE_DRIVER, rings_phys);
+    write_common64(dev, COMMON_QUEUE_DEVICE, rings_phys + USED_RING_OFFSET);
+
+    if (dev->msix) {
+        if (msix_entry != NO_VECTOR && !pci::enable_msix(dev->pci, msix_entry, vector)) {
+            msix_entry = NO_VECTOR;
+        }
+
+        // The device answers NO_VECTOR if it could not allocate the entry
+        mmio_write<uint16_t>(dev->common, COMMON_QUEUE_MSIX_VECTOR, msix_entry);
+        if (mmio_read<uint16_t>(dev->common, COMMON_QUEUE_MSIX_VECTOR) != msix_entry) {
+            mmio_write<uint16_t>(dev->common, COMMON_QUEUE_MSIX_VECTOR, NO_VECTOR);
+            msix_entry = NO_VECTOR;
+        }
+    } else {
+        msix_entry = NO_VECTOR;
+    }
+
+    uint16_t notify_offset = mmio_read<uint16_t>(dev->common, COMMON_QUEUE_NOTIFY_OFF);
+    queue->notify = reinterpret_cast<volatile uint16_t*>(
+        dev->notify_base + static_cast<size_t>(notify_offset) * dev->notify_multiplier);
+
+    if (msix_entry == NO_VECTOR) {
+        disable_callbacks(queue);
+    }
+
+    mmio_write<uint16_t>(dev->common, COMMON_QUEUE_ENABLE, 1);
+    return true;
+}
+
+void driver_ok(device* dev) {
+    add_status(dev, STATUS_DRIVER_OK);
+}
+
+void fail(device* dev) {
+    add_status(dev, STATUS_FAILED);
+}
+
+uint8_t read_config8(const device* dev, size_t offset) {
+    return mmio_read<uint8_t>(dev->device_config, offset);
+}
+
+uint16_t read_config16(const device* dev, size_t offset) {
+    return mmio_read<uint16_t>(dev->device_config, offset);
+}
+
+uint32_t read_config32(const device* dev, size_t offset) {
+    return mmio_read<uint32_t>(dev->device_config, offset);
+}
+
+uint64_t read_config64(const device* dev, size_t offset) {
+    while (true) {
+        uint8_t generation = mmio_read<uint8_t>(dev->common, COMMON_CONFIG_GENERATION);
+        uint64_t value = mmio_read<uint32_t>(dev->device_config, offset) |
+                         static_cast<uint64_t>(
+                             mmio_read<uint32_t>(dev->device_config, offset + 4))
+                             << 32;
+        if (mmio_read<uint8_t>(dev->common, COMMON_CONFIG_GENERATION) == generation) {
+            return value;
+        }
+    }
+}
+
+// Makes a chain visible in the avail ring, the index itself is published by kick()
+static void publish(virtqueue* queue, uint16_t head, void* token) {
+    queue->tokens[head] = token;
+    queue->avail[AVAIL_RING + (queue->avail_index & (queue->size - 1))] = head;
+    ++queue->avail_index;
+}
+
+bool add_chain(virtqueue* queue, const buffer* buffers, size_t count, void* token) {
+    if (count == 0 || count > queue->free_count) {
+        return false;
+    }
+
+    uint16_t head = queue->free_head;
+    uint16_t index = head;
+
+    for (size_t i = 0; i < count; ++i) {
+        descriptor* desc = &queue->descriptors[index];
+        desc->address = buffers[i].address;
+        desc->length = buffers[i].length;
+        desc->flags = static_cast<uint16_t>((buffers[i].device_writable ? DESC_F_WRITE : 0) |
+                                            (i + 1 < count ? DESC_F_NEXT : 0));
+
+        // The free list already links the descriptors, the chain reuses those links
+        index = desc->next;
+    }
+
+    queue->free_head = index;
+    queue->free_count = static_cast<uint16_t>(queue->free_count - count);
+
+    publish(queue, head, token);
+    return true;
+}
+
+bool add_indirect(virtqueue* queue, uint64_t table_phys, size_t count, void* token) {
+    if (count == 0 || queue->free_count == 0) {
+        return false;
+    }
+
+    uint16_t head = queue->free_head;
+    descriptor* desc = &queue->descriptors[head];
+    desc->address = table_phys;
+    desc->length = static_cast<uint32_t>(count * sizeof(descriptor));
+    desc->flags = DESC_F_INDIRECT;
+
+    queue->free_head = desc->next;
+    --queue->free_count;
+
+    publish(queue, head, token);
+    return true;
+}
+
+bool kick(virtqueue* queue) {
+    uint16_t old = queue->kicked_index;
+    uint16_t next = queue->avail_index;
+    if (old == next) {
+        return false;
+    }
+
+    // Descriptors and ring entries before the index that hands them over
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    queue->avail[AVAIL_INDEX] = next;
+    queue->kicked_index = next;
+
+    // The index store must be visible before the device's suppression state is read,
+    // otherwise a device going idle in between would never see the new chains
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    bool needed = queue->event_index
+                      ? need_event(avail_event(queue), next, old)
+                      : !(*reinterpret_cast<volatile uint16_t*>(queue->used + USED_FLAGS) &
+                          USED_F_NO_NOTIFY);
+    if (needed) {
+        *queue->notify = queue->index;
+    }
+    return needed;
+}
+
+void* pop_used(virtqueue* queue, uint32_t* length) {
+    if (queue->last_used == used_index(queue)) {
+        return nullptr;
+    }
+
+    // The element is read after the index that published it
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    const volatile uint8_t* element =
+        queue->used + USED_RING + USED_ELEMENT_SIZE * (queue->last_used & (queue->size - 1));
+    auto head = static_cast<uint16_t>(*reinterpret_cast<const volatile uint32_t*>(element));
+    if (length) {
+        *length = *reinterpret_cast<const volatile uint32_t*>(element + 4);
+    }
+    ++queue->last_used;
+
+    // Back onto the free list, the chain's own links stay intact
+    uint16_t tail = head;
+    uint16_t count = 1;
+    while (queue->descriptors[tail].flags & DESC_F_NEXT) {
+        tail = queue->descriptors[tail].next;
+        ++count;
+    }
+    queue->descriptors[tail].next = queue->free_head;
+    queue->free_head = head;
+    queue->free_count = static_cast<uint16_t>(queue->free_count + count);
+
+    void* token = queue->tokens[head];
+    queue->tokens[head] = nullptr;
+    return token;
+}
+
+bool enable_callbacks(virtqueue* queue) {
+    queue->callbacks_disabled = false;
+    queue->avail[AVAIL_FLAGS] = 0;
+    if (queue->event_index) {
+        set_used_event(queue, queue->last_used);
+    }
+
+    // Pairs with the device's used index update, a chain used before the event index
+    // was visible raised no interrupt
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    return used_index(queue) == queue->last_used;
+}
+
+void disable_callbacks(virtqueue* queue) {
+    queue->callbacks_disabled = true;
+
+    // The device ignores the flag with event indices, those are parked half the index
+    // space ahead instead
+    queue->avail[AVAIL_FLAGS] = AVAIL_F_NO_INTERRUPT;
+    if (queue->event_index) {
+        set_used_event(queue, static_cast<uint16_t>(queue->last_used + 0x8000));
+    }
+}
+
+} // namespace virtio
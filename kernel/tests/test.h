@@ -0,0 +1,77 @@
+#ifndef TESTS_TEST_H
+#define TESTS_TEST_H
+
+#include <core/types.h>
+
+// Declared here, the C library headers would clash with core/types.h
+EXTERN_C int printf(const char* format, ...);
+
+namespace test {
+
+using test_fn = void (*)();
+
+struct test_case {
+    const char* name;
+    test_fn fn;
+    test_case* next;
+};
+
+inline test_case* g_first;
+inline test_case* g_last;
+inline int g_failures;
+
+// Appends a test at static initialization, tests run in the order they are defined
+struct registrar {
+    explicit registrar(test_case* test) {
+        if (g_last) {
+            g_last->next = test;
+        } else {
+            g_first = test;
+        }
+        g_last = test;
+    }
+};
+
+inline void fail(const char* file, int line, const char* condition) {
+    printf("%s:%d: expected %s\n", file, line, condition);
+    ++g_failures;
+}
+
+} // namespace test
+
+/**
+ * @brief Defines a test case, run by the main() below in definition order.
+ */
+#define TEST(name)                                                                           \
+    static void test_##name();                                                               \
+    static test::test_case test_case_##name = {#name, test_##name, nullptr};                 \
+    static test::registrar registrar_##name(&test_case_##name);                              \
+    static void test_##name()
+
+/**
+ * @brief Records a failure and continues the test if `condition` is false.
+ */
+#define EXPECT(condition)                                                                    \
+    do {                                                                                     \
+        if (!(condition)) {                                                                  \
+            test::fail(__FILE__, __LINE__, #condition);                                      \
+        }                                                                                    \
+    } while (0)
+
+// Each test file is its own executable, so the harness provides its entry point
+int main() {
+    int failed_tests = 0;
+
+    for (test::test_case* test = test::g_first; test; test = test->next) {
+        int failures = test::g_failures;
+        test->fn();
+
+        bool passed = test::g_failures == failures;
+        printf("[%s] %s\n", passed ? "PASS" : "FAIL", test->name);
+        failed_tests += passed ? 0 : 1;
+    }
+
+    return failed_tests == 0 ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,215 @@
+#!/bin/bash
+# =============================================================================
+# Nyros Boot Time Benchmark
+# =============================================================================
+# Boots the kernel repeatedly in QEMU and reports boot-to-idle latency from the
+# EVENT_BOOT_COMPLETE / EVENT_BOOT_PHASE packets streamed over IRIS (COM2).
+# =============================================================================
+
+set -e
+
+# Default values
+IMAGE_FILE="build/image/nyros.img"
+BOOT_COUNT=20
+TIMEOUT_SECONDS=30
+KEEP_LOGS=false
+
+# Colors for output
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+RED='\033[0;31m'
+NC='\033[0m'
+
+# Parse arguments
+while [[ $# -gt 0 ]]; do
+    case $1 in
+        --image|-i)
+            IMAGE_FILE="$2"
+            shift 2
+            ;;
+        --count|-c)
+            BOOT_COUNT="$2"
+            shift 2
+            ;;
+        --timeout|-t)
+            TIMEOUT_SECONDS="$2"
+            shift 2
+            ;;
+        --keep-logs|-k)
+            KEEP_LOGS=true
+            shift
+            ;;
+        --help|-h)
+            echo "Nyros Boot Time Benchmark"
+            echo ""
+            echo "Usage: $0 [options]"
+            echo ""
+            echo "Options:"
+            echo "  -i, --image FILE     Image to boot (default: build/image/nyros.img)"
+            echo "  -c, --count N        Number of boots (default: 20)"
+            echo "  -t, --timeout SEC    Per-boot timeout in seconds (default: 30)"
+            echo "  -k, --keep-logs      Keep the raw IRIS capture of every boot"
+            echo "  -h, --help           Show this help"
+            exit 0
+            ;;
+        *)
+            echo -e "${RED}Unknown option: $1${NC}"
+            echo "Use --help for usage information"
+            exit 1
+            ;;
+    esac
+done
+
+if [ ! -f "$IMAGE_FILE" ]; then
+    echo -e "${RED}Error: Image file not found: $IMAGE_FILE${NC}"
+    echo "Build the image first with: ninja -C build image"
+    exit 1
+fi
+
+if ! command -v qemu-system-x86_64 >/dev/null 2>&1; then
+    echo -e "${RED}Error: qemu-system-x86_64 not found${NC}"
+    exit 1
+fi
+
+SCRIPT_DIR="$(dirname "$0")"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+
+# Same OVMF lookup as run.sh
+OVMF_CODE=""
+OVMF_VARS=""
+for dir in "$PROJECT_ROOT/ovmf" /usr/share/ovmf /usr/share/qemu /usr/share/edk2/ovmf; do
+    if [ -f "$dir/OVMF_CODE.fd" ]; then
+        OVMF_CODE="$dir/OVMF_CODE.fd"
+        OVMF_VARS="$dir/OVMF_VARS.fd"
+        break
+    fi
+done
+
+WORK_DIR="$(mktemp -d /tmp/nyros-boot-bench.XXXXXX)"
+if [ "$KEEP_LOGS" = false ]; then
+    trap "rm -rf $WORK_DIR" EXIT
+fi
+
+# Returns success once the capture contains an EVENT_BOOT_COMPLETE packet
+has_boot_complete() {
+    python3 - "$1" <<'EOF'
+import struct, sys
+data = open(sys.argv[1], 'rb').read()
+pos = data.find(b'IRIS')
+while pos != -1 and pos + 24 <= len(data):
+    if struct.unpack_from('<H', data, pos + 16)[0] == 0x0108:
+        sys.exit(0)
+    pos = data.find(b'IRIS', pos + 1)
+sys.exit(1)
+EOF
+}
+
+echo -e "${GREEN}Booting $IMAGE_FILE $BOOT_COUNT times${NC}"
+
+for ((i = 0; i < BOOT_COUNT; i++)); do
+    CAPTURE="$WORK_DIR/boot-$i.iris"
+    : > "$CAPTURE"
+
+    QEMU_ARGS=(
+        -machine q35
+        -cpu qemu64,+fsgsbase
+        -m 4G
+        -smp 4
+        -drive "file=$IMAGE_FILE,format=raw,snapshot=on"
+        -net none
+        -display none
+        -serial null                 # COM1
+        -serial "file:$CAPTURE"      # COM2 - IRIS
+    )
+
+    if [ -n "$OVMF_CODE" ]; then
+        cp "$OVMF_VARS" "$WORK_DIR/vars.fd"
+        QEMU_ARGS+=(
+            -drive "if=pflash,format=raw,readonly=on,file=$OVMF_CODE"
+            -drive "if=pflash,format=raw,file=$WORK_DIR/vars.fd"
+        )
+    fi
+
+    qemu-system-x86_64 "${QEMU_ARGS[@]}" &
+    QEMU_PID=$!
+
+    DEADLINE=$((SECONDS + TIMEOUT_SECONDS))
+    until has_boot_complete "$CAPTURE"; do
+        if [ $SECONDS -ge $DEADLINE ] || ! kill -0 $QEMU_PID 2>/dev/null; then
+            echo -e "${YELLOW}Boot $i did not reach idle within ${TIMEOUT_SECONDS}s${NC}"
+            break
+        fi
+        sleep 0.2
+    done
+
+    kill $QEMU_PID 2>/dev/null || true
+    wait $QEMU_PID 2>/dev/null || true
+    echo "  boot $((i + 1))/$BOOT_COUNT done"
+done
+
+python3 - "$WORK_DIR" <<'EOF'
+import glob, math, os, struct, sys
+
+EVENT_BOOT_PHASE = 0x0107
+EVENT_BOOT_COMPLETE = 0x0108
+
+# Must match boot::boot_phase in kernel/include/boot/boot_timing.h
+PHASES = ['bootstrap_entry', 'page_tables_start', 'page_tables_done', 'long_mode_entry',
+          'serial_ready', 'iris_ready', 'gdt_ready', 'per_cpu_ready', 'idt_ready',
+          'lapic_ready', 'arch_ready', 'idle_reached']
+
+def packets(data):
+    pos = data.find(b'IRIS')
+    while pos != -1 and pos + 24 <= len(data):
+        length = struct.unpack_from('<H', data, pos + 4)[0]
+        event_type = struct.unpack_from('<H', data, pos + 16)[0]
+        end = pos + 6 + length
+        if end <= len(data):
+            yield event_type, data[pos + 24:end]
+        pos = data.find(b'IRIS', pos + 1)
+
+def percentile(values, p):
+    # Nearest-rank percentile
+    ordered = sorted(values)
+    index = max(0, math.ceil(p / 100.0 * len(ordered)) - 1)
+    return ordered[index]
+
+boot_ns, firmware_ns = [], []
+phase_cycles = {}
+
+for capture in sorted(glob.glob(os.path.join(sys.argv[1], 'boot-*.iris'))):
+    data = open(capture, 'rb').read()
+    for event_type, payload in packets(data):
+        if event_type == EVENT_BOOT_PHASE and len(payload) >= 24:
+            _, cycles, phase = struct.unpack_from('<QQH', payload)
+            phase_cycles.setdefault(phase, []).append(cycles)
+        elif event_type == EVENT_BOOT_COMPLETE and len(payload) >= 32:
+            entry_tsc, idle_tsc, tsc_hz, ns = struct.unpack_from('<QQQQ', payload)
+            if ns:
+                boot_ns.append(ns)
+            if tsc_hz:
+                firmware_ns.append(entry_tsc * 1e9 / tsc_hz)
+
+if not boot_ns:
+    print('No EVENT_BOOT_COMPLETE packets captured')
+    sys.exit(1)
+
+print()
+print('Boots measured: %d' % len(boot_ns))
+print('Kernel entry -> idle:     median %9.1f us   p99 %9.1f us' %
+      (percentile(boot_ns, 50) / 1e3, percentile(boot_ns, 99) / 1e3))
+if firmware_ns:
+    print('VM reset -> kernel entry: median %9.1f us   p99 %9.1f us' %
+          (percentile(firmware_ns, 50) / 1e3, percentile(firmware_ns, 99) / 1e3))
+print()
+print('%-20s %14s %14s' % ('phase', 'median cycles', 'p99 cycles'))
+for phase in sorted(phase_cycles):
+    name = PHASES[phase] if phase < len(PHASES) else 'phase_%d' % phase
+    values = phase_cycles[phase]
+    print('%-20s %14d %14d' % (name, percentile(values, 50), percentile(values, 99)))
+EOF
+
+if [ "$KEEP_LOGS" = true ]; then
+    echo ""
+    echo "Raw captures kept in $WORK_DIR"
+fi
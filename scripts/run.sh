@@ -7,6 +7,10 @@ set -e
 
 # Default values
 IMAGE_FILE="build/image/nyros.img"
+DISK_FILE="build/image/disk.img"
+DISK_SIZE="256M"
+USE_DISK=true
+NET_MODE="loopback"
 DEBUG_MODE=false
 HEADLESS=false
 BUILD_FIRST=false
@@ -24,6 +28,18 @@ while [[ $# -gt 0 ]]; do
             IMAGE_FILE="$2"
             shift 2
             ;;
+        --disk)
+            DISK_FILE="$2"
+            shift 2
+            ;;
+        --no-disk)
+            USE_DISK=false
+            shift
+            ;;
+        --net)
+            NET_MODE="$2"
+            shift 2
+            ;;
         --debug|-d)
             DEBUG_MODE=true
             shift
@@ -44,6 +60,9 @@ while [[ $# -gt 0 ]]; do
             echo "Options:"
             echo "  -i, --image FILE    Use custom image file (default: build/image/nyros.img)"
             echo "  -b, --build         Build before running"
+            echo "      --disk FILE     Scratch virtio-blk disk (default: build/image/disk.img)"
+            echo "      --no-disk       Run without the scratch disk"
+            echo "      --net MODE      virtio-net setup: loopback (default), user or none"
             echo "  -d, --debug         Enable GDB debugging"
             echo "  -n, --headless      Run without graphical output"
             echo "  -h, --help          Show this help"
@@ -52,6 +71,7 @@ while [[ $# -gt 0 ]]; do
             echo "  $0                  # Run with defaults"
             echo "  $0 --build          # Build and run"
             echo "  $0 --debug          # Run with GDB support"
+            echo "  $0 --net user       # One NIC behind QEMU's user-mode NAT"
             echo ""
             echo "Note: The terminal becomes the QEMU monitor (Ctrl-A X to exit)"
             exit 0
@@ -127,6 +147,45 @@ QEMU_ARGS=(
     -serial unix:/tmp/nyros-debug.sock,server,nowait  # COM2 - Debug inspector socket
 )
 
+# Scratch disk for the virtio-blk driver and the block benchmarks, one queue per CPU
+if [ "$USE_DISK" = true ]; then
+    if [ ! -f "$DISK_FILE" ]; then
+        echo -e "${YELLOW}Creating $DISK_SIZE scratch disk: $DISK_FILE${NC}"
+        mkdir -p "$(dirname "$DISK_FILE")"
+        truncate -s "$DISK_SIZE" "$DISK_FILE"
+    fi
+
+    QEMU_ARGS+=(
+        -drive "file=$DISK_FILE,if=none,id=disk0,format=raw"
+        -device "virtio-blk-pci,drive=disk0,num-queues=4,disable-legacy=on"
+    )
+fi
+
+# virtio-net devices. Loopback joins two NICs through a QEMU hub, so eth0 and eth1
+# reach each other and the network benchmarks run without anything on the host
+case "$NET_MODE" in
+    loopback)
+        QEMU_ARGS+=(
+            -netdev "hubport,id=net0,hubid=0"
+            -device "virtio-net-pci,netdev=net0,mac=52:54:00:12:34:01,disable-legacy=on"
+            -netdev "hubport,id=net1,hubid=0"
+            -device "virtio-net-pci,netdev=net1,mac=52:54:00:12:34:02,disable-legacy=on"
+        )
+        ;;
+    user)
+        QEMU_ARGS+=(
+            -netdev "user,id=net0"
+            -device "virtio-net-pci,netdev=net0,mac=52:54:00:12:34:01,disable-legacy=on"
+        )
+        ;;
+    none)
+        ;;
+    *)
+        echo -e "${RED}Unknown network mode: $NET_MODE${NC}"
+        exit 1
+        ;;
+esac
+
 # Add UEFI firmware if available
 if [ -n "$OVMF_CODE" ] && [ -f "$OVMF_CODE" ]; then
     # Create a copy of OVMF_VARS for this session
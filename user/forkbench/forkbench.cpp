@@ -0,0 +1,69 @@
+#include <syscall.h>
+
+// Spawned by the kernel's process benchmark (kernel/src/bench/proc_bench.cpp). Builds a
+// 64MB resident footprint, then measures fork followed by the child's exit and the wait
+// for it. Every fork shares all of it copy-on-write and every exit drops the references.
+
+inline constexpr uint64_t PAGE_SIZE = 0x1000;
+inline constexpr uint64_t FOOTPRINT_SIZE = 64 * 1024 * 1024;
+inline constexpr uint64_t MAX_ITERATIONS = 256;
+
+// Exit codes
+inline constexpr int EXIT_OK = 0;
+inline constexpr int EXIT_FORK_FAILED = 1;
+inline constexpr int EXIT_WAIT_FAILED = 2;
+
+// Same layout as bench::fork_bench_data, lives on a kernel-provided page
+struct fork_bench_data {
+    uint64_t iterations; // Written by the kernel
+    uint64_t completed;  // Valid cycles entries, fewer than iterations if fork failed
+    uint64_t done;       // Set once completed is final
+    uint64_t cycles[MAX_ITERATIONS];
+};
+
+static uint8_t g_footprint[FOOTPRINT_SIZE];
+
+static inline uint64_t rdtsc() {
+    uint32_t low;
+    uint32_t high;
+    asm volatile("lfence; rdtsc" : "=a"(low), "=d"(high) : : "memory");
+    return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+extern "C" int main(fork_bench_data* data) {
+    // Fault in every page so the parent's tables are fully populated
+    for (uint64_t offset = 0; offset < FOOTPRINT_SIZE; offset += PAGE_SIZE) {
+        g_footprint[offset] = 1;
+    }
+
+    uint64_t iterations = data->iterations;
+    if (iterations > MAX_ITERATIONS) {
+        iterations = MAX_ITERATIONS;
+    }
+
+    int exit_code = EXIT_OK;
+    uint64_t i = 0;
+
+    for (; i < iterations; ++i) {
+        uint64_t start = rdtsc();
+
+        int64_t pid = sys::fork();
+        if (pid == 0) {
+            sys::exit(0);
+        }
+        if (pid < 0) {
+            exit_code = EXIT_FORK_FAILED;
+            break;
+        }
+        if (sys::wait(pid) != 0) {
+            exit_code = EXIT_WAIT_FAILED;
+            break;
+        }
+
+        data->cycles[i] = rdtsc() - start;
+    }
+
+    data->completed = i;
+    __atomic_store_n(&data->done, 1, __ATOMIC_RELEASE);
+    return exit_code;
+}
@@ -0,0 +1,49 @@
+#ifndef USER_SYSCALL_H
+#define USER_SYSCALL_H
+
+#include <stdint.h>
+
+// System call wrappers, the numbers match syscall::syscall_number in kernel/include/syscall/syscall.h
+namespace sys {
+
+inline constexpr uint64_t NULL_CALL = 0;
+inline constexpr uint64_t EXIT = 1;
+inline constexpr uint64_t YIELD = 2;
+inline constexpr uint64_t FORK = 3;
+inline constexpr uint64_t WAIT = 4;
+
+// rcx and r11 are overwritten by SYSCALL with the return address and RFLAGS
+inline int64_t syscall0(uint64_t number) {
+    int64_t result;
+    asm volatile("syscall" : "=a"(result) : "a"(number) : "rcx", "r11", "memory");
+    return result;
+}
+
+inline int64_t syscall1(uint64_t number, uint64_t arg0) {
+    int64_t result;
+    asm volatile("syscall" : "=a"(result) : "a"(number), "D"(arg0) : "rcx", "r11", "memory");
+    return result;
+}
+
+[[noreturn]] inline void exit(int32_t code) {
+    syscall1(EXIT, static_cast<uint64_t>(code));
+    __builtin_unreachable();
+}
+
+inline void yield() {
+    syscall0(YIELD);
+}
+
+// Returns the child's PID in the parent, 0 in the child and a negative error code on failure
+inline int64_t fork() {
+    return syscall0(FORK);
+}
+
+// Returns the exit code of the child, or a negative error code if pid is not a child
+inline int64_t wait(int64_t pid) {
+    return syscall1(WAIT, static_cast<uint64_t>(pid));
+}
+
+} // namespace sys
+
+#endif
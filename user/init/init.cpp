@@ -0,0 +1,37 @@
+#include <syscall.h>
+
+// First user program started by the kernel. It touches a large sparse .bss and reads
+// initialized data, so its exit event shows both kinds of demand faults.
+
+inline constexpr uint64_t PAGE_SIZE = 0x1000;
+
+// Only every TOUCH_STRIDE-th page is ever faulted in
+inline constexpr uint64_t SPARSE_BSS_SIZE = 16 * 1024 * 1024;
+inline constexpr uint64_t TOUCH_STRIDE = 64 * PAGE_SIZE;
+
+inline constexpr uint32_t DATA_PATTERN = 0x6e79726f;
+
+// Exit codes
+inline constexpr int EXIT_OK = 0;
+inline constexpr int EXIT_BSS_NOT_ZERO = 1;
+inline constexpr int EXIT_DATA_CORRUPT = 2;
+
+static uint8_t g_sparse_bss[SPARSE_BSS_SIZE];
+
+// volatile keeps the value in .data instead of folding it into the comparison
+static volatile uint32_t g_data_pattern = DATA_PATTERN;
+
+extern "C" int main() {
+    if (g_data_pattern != DATA_PATTERN) {
+        return EXIT_DATA_CORRUPT;
+    }
+
+    for (uint64_t offset = 0; offset < SPARSE_BSS_SIZE; offset += TOUCH_STRIDE) {
+        if (g_sparse_bss[offset] != 0) {
+            return EXIT_BSS_NOT_ZERO;
+        }
+        g_sparse_bss[offset] = 1;
+    }
+
+    return EXIT_OK;
+}